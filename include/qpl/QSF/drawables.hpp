@@ -16,7 +16,11 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <future>
 #include <type_traits>
+#include <span>
 #include <SFML/Graphics.hpp>
 #include <cwctype>
 
@@ -2196,6 +2200,12 @@ namespace qsf {
 			this->chunks.clear();
 			this->color = color;
 
+			this->tiles.resize(indices.size());
+			for (qpl::size i = 0u; i < indices.size(); ++i) {
+				this->tiles[i] = std::make_pair(qpl::u32_cast(indices[i]), 0u);
+			}
+			this->store_layout(index_width, true, skip_index);
+
 			auto chunk_width = (index_width - 1) / this->max_chunk_size.x + 1;
 			auto chunk_height = (indices.size() / index_width - 1) / this->max_chunk_size.y + 1;
 			auto chunk_dim = chunk_width * chunk_height;
@@ -2279,9 +2289,20 @@ namespace qsf {
 
 		QPLDLL void set_color(qpl::rgba color);
 
+		//changes a single tile (rotation 0-7). only works on maps created from indices or 0-7 rotations.
+		//without skipping empty tiles the 4 vertices are rewritten in place, otherwise the chunk is marked dirty for update_chunks
+		QPLDLL void set(qpl::size x, qpl::size y, qpl::u32 index, qpl::u32 rotation = 0u);
+		QPLDLL std::pair<qpl::u32, qpl::u32> get(qpl::size x, qpl::size y) const;
+		//rebuilds dirty chunks. with background building the vertices are built on another thread and swapped in by a later call
+		QPLDLL void update_chunks();
+		QPLDLL void enable_background_building(bool enable = true);
+		QPLDLL bool has_pending_chunks() const;
+
+		//only chunks intersecting the visible area of the target (its view and states.transform) are drawn
 		QPLDLL void draw(sf::RenderTarget& window, sf::RenderStates states = sf::RenderStates::Default) const;
 		QPLDLL qpl::size size() const;
 		QPLDLL qpl::size chunk_count() const;
+		QPLDLL qpl::size chunk_height_count() const;
 		QPLDLL void set_chunk_dimension(qpl::u32 x, qpl::u32 y);
 		QPLDLL void clear();
 
@@ -2295,6 +2316,20 @@ namespace qsf {
 		qpl::vector2f position;
 
 		qpl::rgba color;
+
+		//pair.first = index - pair.second = rotation (0-7)
+		std::vector<std::pair<qpl::u32, qpl::u32>> tiles;
+		qpl::size index_width = 0u;
+		bool skip_empty = false;
+		qpl::u32 skip_index = 0u;
+		bool background_building = false;
+		std::unordered_set<qpl::size> dirty_chunks;
+		std::shared_future<std::vector<std::pair<qpl::size, sf::VertexArray>>> pending_chunks;
+
+	private:
+		QPLDLL void store_layout(qpl::size index_width, bool skip_empty, qpl::u32 skip_index);
+		QPLDLL void store_tiles(const std::vector<std::pair<qpl::u32, qpl::u32>>& indices, qpl::size index_width, bool skip_empty, qpl::u32 skip_index);
+		QPLDLL void store_tiles(const std::vector<qpl::u32>& indices, qpl::size index_width, bool skip_empty, qpl::u32 skip_index);
 	};
 
 	namespace detail {
@@ -2922,6 +2957,92 @@ namespace qsf {
 		qsf::rectangle background;
 	};
 
+	//retained graph for long series. values are kept in plain arrays and geometry is only rebuilt when data or the view changes.
+	//every pixel column of the visible range is reduced to its min and max sample, so the vertex count is bounded by the width
+	struct series_graph {
+		struct series {
+			struct column {
+				qpl::f64 low = qpl::f64_max;
+				qpl::f64 high = qpl::f64_min;
+				qpl::size low_index = 0u;
+				qpl::size high_index = 0u;
+			};
+
+			template<typename T>
+			void set_data(const std::vector<T>& data) {
+				this->values.resize(data.size());
+				for (qpl::size i = 0u; i < data.size(); ++i) {
+					this->values[i] = static_cast<qpl::f64>(data[i]);
+				}
+				this->mark_changed();
+			}
+			QPLDLL void add_data(qpl::f64 value);
+			QPLDLL void add_data(std::span<const qpl::f64> values);
+			QPLDLL void clear();
+			QPLDLL qpl::size size() const;
+			//call after modifying values other than appending through add_data
+			QPLDLL void mark_changed();
+
+			std::vector<qpl::f64> values;
+			qpl::rgba color = qpl::rgba::white();
+			qpl::f32 thickness = 1.0f;
+			bool visible = true;
+
+			qpl::u64 version = 0u;
+			qpl::u64 reset_version = 0u;
+
+			//aggregation cache, a ring of buckets keyed by absolute bucket index: columns[i] covers the column_width samples
+			//from (column_first + i) * column_width. when the view scrolls the leading buckets are dropped and new ones appended.
+			//column_head is the partial bucket between the visible begin and the first aligned bucket
+			mutable std::deque<column> columns;
+			mutable column column_head;
+			mutable qpl::size column_first = 0u;
+			mutable qpl::size column_end = 0u;
+			mutable qpl::size column_width = 0u;
+			mutable qpl::u64 column_reset_version = qpl::u64_max;
+			mutable qpl::u64 vertex_version = qpl::u64_max;
+			mutable qsf::vertex_array vertices;
+		};
+
+		QPLDLL series& add_series(std::string name);
+		QPLDLL series& add_series(std::string name, qpl::rgba color, qpl::f32 thickness = 1.0f);
+		QPLDLL series& get_series(std::string name);
+		QPLDLL const series& get_series(std::string name) const;
+		QPLDLL bool remove_series(std::string name);
+		QPLDLL void clear_data();
+
+		QPLDLL void set_position(qpl::vector2f position);
+		QPLDLL void set_dimension(qpl::vector2f dimension);
+		QPLDLL void set_visible_range(qpl::size begin, qpl::size end);
+		QPLDLL void set_visible_range_max();
+		//shows the last `width` entries and follows appended data
+		QPLDLL void enable_track_new_entries(qpl::size width);
+		QPLDLL void disable_track_new_entries();
+
+		QPLDLL qpl::size total_size() const;
+		QPLDLL std::pair<qpl::size, qpl::size> visible_index_range() const;
+		QPLDLL std::pair<qpl::f64, qpl::f64> get_low_high() const;
+		QPLDLL qpl::size vertex_count() const;
+
+		QPLDLL void update_geometry() const;
+		QPLDLL void draw(sf::RenderTarget& window, sf::RenderStates states = sf::RenderStates::Default) const;
+
+		std::unordered_map<std::string, series> series_map;
+		qpl::vector2f position;
+		qpl::vector2f dimension = { 500, 300 };
+		qpl::rgba background_color = qpl::rgba::black();
+		qpl::f64 y_margin = 0.05;
+
+		qpl::size visible_begin = 0u;
+		qpl::size visible_end = qpl::size_max;
+		qpl::size track_width = 0u;
+
+	private:
+		mutable std::array<qpl::f64, 8u> m_geometry_key = {};
+		mutable qpl::f64 m_low = 0.0;
+		mutable qpl::f64 m_high = 0.0;
+	};
+
 	struct border_graphic {
 		const sf::Texture* texture;
 		qpl::vector2f texture_dimension;
@@ -2957,6 +3078,22 @@ namespace qsf {
 
 	using glyph_quad = std::array<glyph_quad_vertex, 6u>;
 
+	namespace detail {
+		//glyph after the unicode font fallback was resolved
+		struct colored_text_glyph {
+			sf::Glyph glyph;
+			bool unicode = false;
+		};
+		//one row segment of an element, the glyphs and extent are resolved once and reused when the same row is laid out again
+		struct colored_text_run {
+			qpl::u32_string text;
+			std::vector<colored_text_glyph> glyphs;
+			qpl::f32 width = 0.f;
+			qpl::f32 top = 0.f;
+			qpl::f32 bottom = 0.f;
+		};
+	}
+
 	struct colored_text {
 		colored_text();
 		colored_text(const colored_text&);
@@ -2982,7 +3119,14 @@ namespace qsf {
 		QPLDLL const sf::Glyph& get_glyph(qpl::u32 character, qpl::u32 character_size, bool is_bold, qpl::f32 outline_thickness = 0.f);
 		QPLDLL const sf::Glyph& get_unicode_glyph(qpl::u32 character, qpl::u32 character_size, bool is_bold, qpl::f32 outline_thickness = 0.f);
 
+		//cached per (character, character size, bold) for the current fonts, cleared automatically when a font changes
+		QPLDLL const qsf::detail::colored_text_glyph& get_cached_glyph(qpl::u32 character, bool is_bold);
+		//cached per (row text, character size, bold, letter spacing), text[begin, end) must not contain a new line
+		QPLDLL const qsf::detail::colored_text_run& get_cached_run(const qpl::u32_string& text, qpl::size begin, qpl::size end, bool is_bold);
+		QPLDLL void clear_glyph_cache();
+
 		QPLDLL void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+		//rows outside of (visible_y_min, visible_y_max) get no vertices, they only advance the text position and extend the hitbox by their cached run
 		QPLDLL void add(const qpl::styled_string<qpl::u32_string>& string, qpl::f32 visible_y_min = qpl::f32_min, qpl::f32 visible_y_max = qpl::f32_max);
 		QPLDLL void create(const qpl::styled_string<qpl::u32_string>& string, qpl::f32 visible_y_min = qpl::f32_min, qpl::f32 visible_y_max = qpl::f32_max);
 		QPLDLL void clear();
@@ -3015,8 +3159,89 @@ namespace qsf {
 		qpl::hitbox hitbox;
 		qpl::vec2f text_position;
 		qpl::size rows = 0u;
+		std::unordered_map<qpl::u64, qsf::detail::colored_text_glyph> glyph_cache;
+		std::unordered_map<qpl::u64, qsf::detail::colored_text_run> run_cache;
+		const sf::Font* glyph_cache_font = nullptr;
+		const sf::Font* glyph_cache_unicode_font = nullptr;
 	};
 
+	//collects drawables into vertex streams that are merged per texture and primitive, so thousands of rectangles / sprites / texts
+	//end up in a handful of draw calls. shapes, sprites and glyphs become triangles, lines stay lines, all with their transform baked in.
+	//commands are ordered by layer, inside a layer they keep their submission order and only consecutive commands with the same texture merge.
+	//set_group_by_texture(true) groups everything of a layer that shares a texture (in order of first appearance) for fewer draw calls,
+	//overlapping drawables with different textures then have to be put onto different layers to keep their order
+	struct sprite_batch {
+		struct batch {
+			const sf::Texture* texture = nullptr;
+			qsf::vertex_array vertices;
+		};
+		struct command {
+			qpl::i32 layer = 0;
+			const sf::Texture* texture = nullptr;
+			qsf::primitive_type primitive_type = qsf::primitive_type::triangles;
+			qpl::size begin = 0u;
+			qpl::size size = 0u;
+		};
+		struct statistics {
+			qpl::size objects = 0u;
+			qpl::size commands = 0u;
+			qpl::size batches = 0u;
+			qpl::size vertices = 0u;
+			qpl::size draw_calls = 0u;
+		};
+
+		QPLDLL void clear();
+		QPLDLL void set_layer(qpl::i32 layer);
+		QPLDLL qpl::i32 get_layer() const;
+		QPLDLL void set_group_by_texture(bool group);
+		QPLDLL bool is_grouped_by_texture() const;
+
+		QPLDLL void add(const qsf::rectangle& rectangle);
+		QPLDLL void add(const qsf::vrectangle& rectangle);
+		QPLDLL void add(const qsf::circle& circle);
+		QPLDLL void add(const qsf::vcircle& circle);
+		QPLDLL void add(const qsf::line& line);
+		QPLDLL void add(const qsf::vline& line);
+		QPLDLL void add(const qsf::thick_line& line);
+		QPLDLL void add(const qsf::vthick_line& line);
+		QPLDLL void add(const qsf::sprite& sprite);
+		QPLDLL void add(const qsf::text& text);
+		QPLDLL void add(const qsf::vtext& text);
+		QPLDLL void add(const sf::Shape& shape);
+		QPLDLL void add(const sf::Sprite& sprite);
+		QPLDLL void add(const sf::Text& text);
+
+		template<typename C> requires (qpl::is_container<C>())
+		void add(const C& container) {
+			for (auto& i : container) {
+				this->add(i);
+			}
+		}
+
+		//vertices are expected in render target coordinates, texture coordinates in pixels
+		QPLDLL void add_triangles(std::span<const qsf::vertex> vertices, const sf::Texture* texture = nullptr);
+		QPLDLL void add_lines(std::span<const qsf::vertex> vertices);
+
+		//sorts and merges the commands, called lazily by get_batches / draw
+		QPLDLL void build() const;
+		QPLDLL const std::vector<qsf::sprite_batch::batch>& get_batches() const;
+		QPLDLL qsf::sprite_batch::statistics get_statistics() const;
+
+		QPLDLL void draw(sf::RenderTarget& window, sf::RenderStates states = sf::RenderStates::Default) const;
+
+		std::vector<qsf::vertex> staged_vertices;
+		std::vector<qsf::sprite_batch::command> commands;
+		qpl::i32 layer = 0;
+		qpl::size objects = 0u;
+		mutable std::vector<qsf::sprite_batch::batch> batches;
+		mutable qpl::size draw_calls = 0u;
+		mutable bool built = true;
+		bool group_by_texture = false;
+	};
+
+	//builds a few batches on the cpu and checks the generated quads and the texture grouping, throws a qpl::exception naming the failed check
+	QPLDLL void sprite_batch_self_check();
+
 	namespace detail {
 		QPLDLL extern std::unordered_map<std::string, qsf::text> texts;
 	}
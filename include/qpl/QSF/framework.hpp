@@ -10,6 +10,9 @@
 #include <SFML/Audio.hpp>
 #include <vector>
 #include <memory>
+#include <future>
+#include <functional>
+#include <mutex>
 
 #include <qpl/QSF/event_info.hpp>
 #include <qpl/QSF/drawables.hpp>
@@ -19,6 +22,7 @@
 #include <qpl/vector.hpp>
 #include <qpl/time.hpp>
 #include <qpl/camera.hpp>
+#include <qpl/thread_pool.hpp>
 
 namespace qsf {
 
@@ -32,6 +36,38 @@ namespace qsf {
 	};
 
 	struct base_state;
+
+	//durations of the stages of the last frame. the sfml framerate limit sleeps inside display, so without frame pacing that time is part of present
+	struct frame_timing {
+		qpl::time events;
+		qpl::time update;
+		qpl::time fixed_update;
+		qpl::time jobs;
+		qpl::time draw;
+		qpl::time present;
+		qpl::time idle;
+		qpl::time frame;
+		qpl::size fixed_steps = 0u;
+	};
+
+	//render state that is written by the update stage and read by the draw stage.
+	//publish swaps both buffers, so write() hands out the state of two frames ago - rebuild it completely every update
+	template<typename T>
+	struct double_buffer {
+		T& write() {
+			return this->buffers[this->front_index ^ 1u];
+		}
+		const T& read() const {
+			return this->buffers[this->front_index];
+		}
+		void publish() {
+			this->front_index ^= 1u;
+		}
+
+		std::array<T, 2> buffers;
+		qpl::size front_index = 0u;
+	};
+
 	/*
 	qsf::framework framework;
 	framework.set_dimension({ 1800, 720 });
@@ -46,6 +82,13 @@ namespace qsf {
 
 		template<typename C> requires (std::is_base_of_v<qsf::base_state, C>)
 		void add_state() {
+			if (this->defer_state_changes) {
+				std::lock_guard lock(this->deferred_state_mutex);
+				this->deferred_state_changes.push_back([this]() {
+					this->add_state<C>();
+				});
+				return;
+			}
 			this->states.push_back(std::make_unique<C>());
 			this->states.back()->framework = this;
 
@@ -69,6 +112,14 @@ namespace qsf {
 
 		template<typename C> requires (std::is_base_of_v<qsf::base_state, C>)
 		void add_state(C& state) {
+			if (this->defer_state_changes) {
+				auto copy = std::make_shared<C>(state);
+				std::lock_guard lock(this->deferred_state_mutex);
+				this->deferred_state_changes.push_back([this, copy]() {
+					this->add_state(*copy);
+				});
+				return;
+			}
 			this->states.push_back(std::make_unique<C>(state));
 			this->states.back()->framework = this;
 			this->states.back()->call_before_create();
@@ -81,9 +132,12 @@ namespace qsf {
 
 		QPLDLL void draw_call();
 		QPLDLL void init_back();
+		QPLDLL void apply_deferred_state_changes();
 
 		QPLDLL void display();
 		QPLDLL void internal_update();
+		QPLDLL void update_stage();
+		QPLDLL void pace_frame();
 		QPLDLL bool game_loop_segment();
 		QPLDLL void game_loop();
 
@@ -105,6 +159,27 @@ namespace qsf {
 		QPLDLL void set_framerate_limit(qpl::u32 value);
 		QPLDLL qpl::u32 get_framerate_limit() const;
 		QPLDLL void disable_framerate_limit();
+
+		//the framework sleeps (and spins for the last millisecond) until the frame limit instead of letting sfml sleep inside display
+		QPLDLL void enable_frame_pacing();
+		QPLDLL void disable_frame_pacing();
+		QPLDLL bool is_frame_pacing_enabled() const;
+
+		//base_state::fixed_updating is called with a constant step, as often as the accumulated frame time allows (at most max_fixed_steps per frame)
+		QPLDLL void enable_fixed_timestep(qpl::f64 step = 1.0 / 60);
+		QPLDLL void disable_fixed_timestep();
+		QPLDLL bool is_fixed_timestep_enabled() const;
+		QPLDLL void set_max_fixed_steps(qpl::size steps);
+		QPLDLL qpl::f64 get_fixed_timestep() const;
+		QPLDLL qpl::f64 get_interpolation() const;
+
+		//the update of frame N + 1 runs on a worker thread while frame N is drawn. updating must then not touch the window,
+		//drawing should only read state published in base_state::call_on_publish (e.g. qsf::double_buffer)
+		QPLDLL void enable_concurrent_update();
+		QPLDLL void disable_concurrent_update();
+		QPLDLL bool is_concurrent_update_enabled() const;
+
+		QPLDLL const qsf::frame_timing& get_frame_timing() const;
 		QPLDLL void enable_update_if_no_focus();
 		QPLDLL void disable_update_if_no_focus();
 		QPLDLL bool is_update_if_no_focus_enabled() const;
@@ -183,9 +258,19 @@ namespace qsf {
 		qpl::small_clock run_time_clock;
 		qpl::small_clock frametime_clock;
 		qpl::small_clock no_focus_timer;
+		qpl::small_clock frame_clock;
 		qpl::time frametime;
 		qpl::time no_focus_time;
 		qpl::size state_size_before = 0u;
+		qsf::frame_timing timing;
+		std::unique_ptr<qpl::thread_pool> update_thread;
+		//add_state calls made while the update runs concurrently to the draw, applied on the main thread after the join
+		std::vector<std::function<void()>> deferred_state_changes;
+		std::mutex deferred_state_mutex;
+		qpl::f64 fixed_timestep = 1.0 / 60;
+		qpl::f64 fixed_accumulator = 0.0;
+		qpl::f64 interpolation = 0.0;
+		qpl::size max_fixed_steps = 8u;
 		qpl::u32 framerate_limit = 144u;
 		qpl::u32 style = sf::Style::Default;
 		qpl::f64 speed_factor = 1.0;
@@ -199,6 +284,10 @@ namespace qsf {
 		bool use_gl = false;
 		bool use_vsync = false;
 		bool call_resize_call_on_init = true;
+		bool use_frame_pacing = false;
+		bool use_fixed_timestep = false;
+		bool use_concurrent_update = false;
+		bool defer_state_changes = false;
 	};
 
 	
@@ -227,11 +316,26 @@ namespace qsf {
 		QPLDLL virtual void call_on_close();
 		QPLDLL virtual void call_before_close();
 		QPLDLL virtual void call_on_activate();
+		QPLDLL virtual void call_on_publish();
+		QPLDLL virtual void fixed_updating();
 
 		QPLDLL void draw_call();
 		QPLDLL void display();
 		QPLDLL bool game_loop_segment();
 
+		//jobs run on qpl::default_thread_pool and are all finished before the frame is drawn, return values are discarded
+		template<typename F>
+		void submit_job(F&& function) {
+			this->jobs.push_back(qpl::default_thread_pool().submit([function = std::forward<F>(function)]() mutable {
+				function();
+			}).share());
+		}
+		template<typename F>
+		void parallel_for(qpl::size count, F&& function) {
+			qpl::default_thread_pool().parallel_for(count, std::forward<F>(function));
+		}
+		QPLDLL void wait_jobs();
+
 		QPLDLL void set_antialising_level(qpl::u32 antialising);
 		QPLDLL void set_sRGB(bool srgb);
 		QPLDLL void set_depth_bits(qpl::u32 depth_bits);
@@ -627,6 +731,9 @@ namespace qsf {
 		QPLDLL qpl::time frame_time() const;
 		QPLDLL qpl::f64 frame_time_f() const;
 		QPLDLL qpl::time run_time() const;
+		QPLDLL qpl::f64 fixed_time_step() const;
+		QPLDLL qpl::f64 interpolation() const;
+		QPLDLL const qsf::frame_timing& get_frame_timing() const;
 		QPLDLL const qsf::event_info& event() const;
 		QPLDLL qsf::event_info& event();
 
@@ -636,6 +743,7 @@ namespace qsf {
 	protected:
 		qpl::rgb clear_color = qpl::rgb::black();
 		sf::RenderStates render_states = sf::RenderStates::Default;
+		std::vector<std::shared_future<void>> jobs;
 		qpl::vector2i last_dimension;
 		qpl::f64 speed_factor = 1.0;
 		qpl::size frame_ctr = 0u;
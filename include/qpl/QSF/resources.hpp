@@ -7,9 +7,20 @@
 
 #include <qpl/qpldeclspec.hpp>
 #include <qpl/vardef.hpp>
+#include <qpl/thread_pool.hpp>
+#include <qpl/time.hpp>
+#include <qpl/flat_hash_map.hpp>
 #include <unordered_map>
 #include <string>
 #include <list>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 
@@ -67,7 +78,10 @@ namespace qsf {
 		QPLDLL const sf::Shader& get_shader(const std::string& name) const;
 		QPLDLL const sf::Image& get_image(const std::string& name) const;
 
+		//node based on purpose: sf::Sprite and sf::Text keep pointers to the textures and fonts, so they must never move
 		std::unordered_map<std::string, sf::Font> fonts;
+		//sf::Font reads from its memory for as long as it lives, fonts loaded from an archive keep their bytes here
+		std::unordered_map<std::string, std::shared_ptr<const std::string>> font_memory;
 		std::unordered_map<std::string, sf::SoundBuffer> sounds;
 		std::unordered_map<std::string, sf::Texture> textures;
 		std::unordered_map<std::string, sf::Sprite> sprites;
@@ -111,6 +125,130 @@ namespace qsf {
 	QPLDLL bool find_image(const std::string& name);
 	QPLDLL bool find_sprite(const std::string& name);
 	QPLDLL bool find_shader(const std::string& name);
+
+	//read only, memory mapped pack of resource files. the layout is "QSFPACK1", the entry count and per entry the name, offset and size (all u64),
+	//followed by the file contents. fonts read their data lazily, so qsf::resource_loader copies font entries out of the mapping
+	struct resource_archive {
+		resource_archive() {
+
+		}
+		resource_archive(const resource_archive&) = delete;
+		resource_archive& operator=(const resource_archive&) = delete;
+		~resource_archive() {
+			this->close();
+		}
+
+		QPLDLL void open(const std::string& path);
+		QPLDLL void close();
+		QPLDLL bool is_open() const;
+
+		QPLDLL bool contains(const std::string& name) const;
+		QPLDLL std::span<const char> find(const std::string& name) const;
+		QPLDLL std::vector<std::string> names() const;
+		QPLDLL qpl::size size() const;
+
+		const char* data = nullptr;
+		qpl::size data_size = 0u;
+		qpl::flat_hash_map<std::string, std::span<const char>> entries;
+#ifdef _WIN32
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+#else
+		int file_descriptor = -1;
+#endif
+	};
+
+	//names are the paths relative to root with '/' as separator
+	QPLDLL void pack_resource_archive(const std::string& output_path, const std::vector<std::string>& paths, std::string root = "");
+
+	enum class resource_type : qpl::u8 {
+		texture,
+		font,
+		sound,
+		image,
+	};
+
+	namespace detail {
+		struct resource_request {
+			qsf::resource_type type = qsf::resource_type::texture;
+			std::string path;
+			std::vector<std::string> names;
+			bool smooth = false;
+
+			sf::Image image;
+			sf::Font font;
+			std::shared_ptr<const std::string> font_memory;
+			std::vector<sf::Int16> samples;
+			qpl::u32 channel_count = 0u;
+			qpl::u32 sample_rate = 0u;
+
+			std::string error;
+			std::atomic<bool> finished = false;
+			std::promise<void> promise;
+			std::shared_future<void> future;
+		};
+	}
+
+	struct resource_handle {
+		QPLDLL bool valid() const;
+		QPLDLL bool is_ready() const;
+		QPLDLL bool failed() const;
+		QPLDLL std::string error() const;
+		QPLDLL const std::string& path() const;
+
+		//becomes ready after the resource was finalized by resource_loader::update on the main thread
+		QPLDLL std::shared_future<void> get_future() const;
+
+		std::shared_ptr<qsf::detail::resource_request> request;
+	};
+
+	//files are read and decoded on worker threads, everything that needs the gpu / audio device (textures, sound buffers)
+	//is finalized on the main thread inside update, within the given time budget.
+	//requests for the same type and path that are still in flight share one load and return the same handle
+	struct resource_loader {
+		resource_loader(qpl::size thread_count = 0u) : pool(thread_count) {
+
+		}
+		resource_loader(const resource_loader&) = delete;
+		resource_loader& operator=(const resource_loader&) = delete;
+		~resource_loader() {
+			this->pool.wait();
+			this->fail_remaining("resource_loader: destroyed before the resource was finalized");
+		}
+
+		QPLDLL void set_resources(qsf::resources& resources);
+
+		//paths found in an opened archive are loaded from the mapping instead of the disk
+		QPLDLL void open_archive(const std::string& path);
+		QPLDLL void close_archive();
+
+		QPLDLL qsf::resource_handle add_texture(const std::string& name, const std::string& path, bool smooth = false);
+		QPLDLL qsf::resource_handle add_font(const std::string& name, const std::string& path);
+		QPLDLL qsf::resource_handle add_sound(const std::string& name, const std::string& path);
+		QPLDLL qsf::resource_handle add_image(const std::string& name, const std::string& path);
+
+		//finalizes decoded resources until the budget is used up (at least one per call), returns how many were finalized
+		QPLDLL qpl::size update(qpl::time budget = qpl::msecs(2));
+		//blocks until every request is loaded and finalized
+		QPLDLL void finish();
+
+		QPLDLL qpl::size pending() const;
+		QPLDLL bool done() const;
+
+		QPLDLL qsf::resource_handle request(qsf::resource_type type, const std::string& name, const std::string& path, bool smooth);
+		QPLDLL void decode(qsf::detail::resource_request& request) const;
+		QPLDLL void finalize(qsf::detail::resource_request& request);
+		//fails every decoded but not yet finalized request with the given error, so their futures don't end with a broken promise
+		QPLDLL void fail_remaining(const std::string& error);
+
+		qsf::resources* resources = nullptr;
+		qsf::resource_archive archive;
+		qpl::thread_pool pool;
+		qpl::flat_hash_map<std::string, std::shared_ptr<qsf::detail::resource_request>> in_flight;
+		std::deque<std::shared_ptr<qsf::detail::resource_request>> decoded;
+		mutable std::mutex mutex;
+		std::condition_variable decoded_signal;
+	};
 };
 
 #endif
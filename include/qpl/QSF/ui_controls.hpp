@@ -1322,6 +1322,9 @@ namespace qsf {
 		qpl::isize visible_y_max = 0;
 		qpl::size visible_buffer = 100;
 
+		//maximum number of rows kept in string, 0 = unlimited. trimmed in batches of scrollback_limit / 8 rows
+		qpl::size scrollback_limit = 0u;
+
 		qpl::size before_input_vertices_size = qpl::size_max;
 		qpl::size before_input_outline_vertices_size = qpl::size_max;
 		qpl::size before_input_unicode_vertices_size = qpl::size_max;
@@ -1376,6 +1379,8 @@ namespace qsf {
 		QPLDLL void pop_character_at_cursor();
 		QPLDLL void update_cursor_dimension();
 		QPLDLL void update_text_range();
+		QPLDLL void set_scrollback_limit(qpl::size rows);
+		QPLDLL void trim_scrollback();
 		QPLDLL void process_character_size();
 		QPLDLL qpl::size get_text_height() const;
 		QPLDLL qpl::size get_text_width(qpl::size y) const;
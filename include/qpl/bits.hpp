@@ -10,6 +10,12 @@
 #include <qpl/memory.hpp>
 
 #include <array>
+#include <bit>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace qpl {
 	template<typename T> requires (qpl::is_arithmetic<T>())
@@ -92,6 +98,35 @@ namespace qpl {
 #endif
 
 
+	namespace detail {
+		//word parallel kernels behind qpl::bitset, qpl::dynamic_bitset and qpl::roaring_bitmap.
+		//they use AVX-512 / AVX2 when the library is built with it, otherwise plain 64 bit words
+		QPLDLL void bits_or(qpl::u64* destination, const qpl::u64* source, qpl::size words);
+		QPLDLL void bits_and(qpl::u64* destination, const qpl::u64* source, qpl::size words);
+		QPLDLL void bits_xor(qpl::u64* destination, const qpl::u64* source, qpl::size words);
+		QPLDLL void bits_and_not(qpl::u64* destination, const qpl::u64* source, qpl::size words);
+		QPLDLL qpl::size bits_count(const qpl::u64* data, qpl::size words);
+		QPLDLL bool bits_none(const qpl::u64* data, qpl::size words);
+		QPLDLL bool bits_equal(const qpl::u64* a, const qpl::u64* b, qpl::size words);
+
+		//first set bit at or after index, qpl::size_max if there is none
+		QPLDLL qpl::size bits_find_next(const qpl::u64* data, qpl::size words, qpl::size index);
+		//number of set bits before index
+		QPLDLL qpl::size bits_rank(const qpl::u64* data, qpl::size words, qpl::size index);
+		//position of the set bit with the given rank (counting from 0), qpl::size_max if there are not enough set bits
+		QPLDLL qpl::size bits_select(const qpl::u64* data, qpl::size words, qpl::size rank);
+		QPLDLL qpl::size bits_select_word(qpl::u64 word, qpl::size rank);
+
+		template<typename F>
+		void bits_for_each(const qpl::u64* data, qpl::size words, F&& function) {
+			for (qpl::size i = 0u; i < words; ++i) {
+				for (auto word = data[i]; word; word &= word - 1) {
+					function(i * 64u + qpl::size_cast(std::countr_zero(word)));
+				}
+			}
+		}
+	}
+
 	template<qpl::u64 bits, bool BOUNDARY_CHECK = detail::array_boundary_check>
 	class bitset {
 	public:
@@ -337,6 +372,9 @@ namespace qpl {
 		}
 		constexpr qpl::size number_of_set_bits() const {
 			if constexpr (is_array()) {
+				if (!std::is_constant_evaluated()) {
+					return qpl::detail::bits_count(this->data.data(), this->data.size());
+				}
 				qpl::size size = 0u;
 				for (qpl::u32 i = 0u; i < this->data.size(); ++i) {
 					size += qpl::number_of_set_bits(this->data[i]);
@@ -359,6 +397,10 @@ namespace qpl {
 
 		constexpr bitset& operator|=(const bitset& other) {
 			if constexpr (is_array()) {
+				if (!std::is_constant_evaluated()) {
+					qpl::detail::bits_or(this->data.data(), other.data.data(), this->data.size());
+					return *this;
+				}
 				for (qpl::u32 i = 0u; i < this->data.size(); ++i) {
 					this->data[i] |= other.data[i];
 				}
@@ -375,6 +417,10 @@ namespace qpl {
 
 		constexpr bitset& operator&=(const bitset& other) {
 			if constexpr (is_array()) {
+				if (!std::is_constant_evaluated()) {
+					qpl::detail::bits_and(this->data.data(), other.data.data(), this->data.size());
+					return *this;
+				}
 				for (qpl::u32 i = 0u; i < this->data.size(); ++i) {
 					this->data[i] &= other.data[i];
 				}
@@ -391,6 +437,10 @@ namespace qpl {
 
 		constexpr bitset& operator^=(const bitset& other) {
 			if constexpr (is_array()) {
+				if (!std::is_constant_evaluated()) {
+					qpl::detail::bits_xor(this->data.data(), other.data.data(), this->data.size());
+					return *this;
+				}
 				for (qpl::u32 i = 0u; i < this->data.size(); ++i) {
 					this->data[i] ^= other.data[i];
 				}
@@ -405,8 +455,15 @@ namespace qpl {
 			return result ^= other;
 		}
 
-		constexpr static auto last_bits_mask() {
-			return (uint_type{ 1 } << (bits % qpl::bits_in_type<uint_type>())) - 1;
+		//the valid bits of the last word, all of them if bits fills the word completely
+		constexpr static uint_type last_bits_mask() {
+			constexpr auto remainder = bits % qpl::bits_in_type<uint_type>();
+			if constexpr (remainder == 0u) {
+				return static_cast<uint_type>(~uint_type{});
+			}
+			else {
+				return static_cast<uint_type>((uint_type{ 1 } << remainder) - 1);
+			}
 		}
 		constexpr void clear() {
 			if constexpr (is_array()) {
@@ -437,6 +494,9 @@ namespace qpl {
 
 		constexpr bool operator==(const bitset& other) const {
 			if constexpr (is_array()) {
+				if (!std::is_constant_evaluated()) {
+					return qpl::detail::bits_equal(this->data.data(), other.data.data(), this->data.size());
+				}
 				for (qpl::u32 i = 0u; i < this->data.size(); ++i) {
 					if (this->data[i] != other.data[i]) {
 						return false;
@@ -517,6 +577,9 @@ namespace qpl {
 
 		constexpr bool empty() const {
 			if constexpr (is_array()) {
+				if (!std::is_constant_evaluated()) {
+					return qpl::detail::bits_none(this->data.data(), this->data.size());
+				}
 				for (auto& i : this->data) {
 					if (i) {
 						return false;
@@ -598,6 +661,47 @@ namespace qpl {
 		}
 
 
+		constexpr static qpl::size npos = qpl::size_max;
+
+		//index of the first set bit, npos if none is set
+		qpl::size find_first() const {
+			return this->find_from(0u);
+		}
+		//index of the first set bit after index, npos if there is none
+		qpl::size find_next(qpl::size index) const {
+			return this->find_from(index + 1);
+		}
+		//number of set bits before index
+		qpl::size rank(qpl::size index) const {
+			if constexpr (is_array()) {
+				return qpl::detail::bits_rank(this->data.data(), this->data.size(), qpl::min(index, this->size()));
+			}
+			else {
+				auto word = qpl::u64_cast(this->get_masked_data());
+				return index >= 64u ? qpl::size_cast(std::popcount(word)) : qpl::size_cast(std::popcount(word & ((qpl::u64{ 1 } << index) - 1)));
+			}
+		}
+		//index of the set bit with the given rank (counting from 0), npos if there are not enough set bits
+		qpl::size select(qpl::size rank) const {
+			if constexpr (is_array()) {
+				return qpl::detail::bits_select(this->data.data(), this->data.size(), rank);
+			}
+			else {
+				return qpl::detail::bits_select_word(qpl::u64_cast(this->get_masked_data()), rank);
+			}
+		}
+		//calls function with the index of every set bit, in ascending order
+		template<typename F>
+		void for_each_set_bit(F&& function) const {
+			if constexpr (is_array()) {
+				qpl::detail::bits_for_each(this->data.data(), this->data.size(), function);
+			}
+			else {
+				auto word = qpl::u64_cast(this->get_masked_data());
+				qpl::detail::bits_for_each(&word, 1u, function);
+			}
+		}
+
 		constexpr bitset_iterator begin() {
 			return bitset_iterator(*this, 0u);
 		}
@@ -650,6 +754,153 @@ namespace qpl {
 		}
 
 		holding_type data;
+
+	private:
+		qpl::size find_from(qpl::size index) const {
+			if (index >= this->size()) {
+				return npos;
+			}
+			if constexpr (is_array()) {
+				return qpl::detail::bits_find_next(this->data.data(), this->data.size(), index);
+			}
+			else {
+				auto word = qpl::u64_cast(this->get_masked_data()) >> index;
+				return word ? index + qpl::size_cast(std::countr_zero(word)) : npos;
+			}
+		}
+	};
+
+	static_assert(qpl::bitset<5>::last_bits_mask() == 0x1Fu);
+	static_assert(qpl::bitset<8>::last_bits_mask() == qpl::u8_max);
+	static_assert(qpl::bitset<16>::last_bits_mask() == qpl::u16_max);
+	static_assert(qpl::bitset<32>::last_bits_mask() == qpl::u32_max);
+	static_assert(qpl::bitset<64>::last_bits_mask() == qpl::u64_max);
+	static_assert(qpl::bitset<128>::last_bits_mask() == qpl::u64_max);
+	static_assert(qpl::bitset<130>::last_bits_mask() == 0x3u);
+	static_assert([]() {
+		qpl::bitset<64> full;
+		full.fill(true);
+		qpl::bitset<8> byte;
+		byte.fill(true);
+		return full.full() && byte.full();
+	}());
+
+	//runtime sized bitset with the bulk operations of qpl::bitset (and, or, xor, not, shifts, counting, rank / select).
+	//there are no range proxies or bit iterators, set bits are visited with for_each_set_bit or find_first / find_next.
+	//bits past size() are always kept zero
+	struct dynamic_bitset {
+		constexpr static qpl::size npos = qpl::size_max;
+
+		dynamic_bitset() {
+
+		}
+		QPLDLL explicit dynamic_bitset(qpl::size size, bool value = false);
+
+		QPLDLL qpl::size size() const;
+		QPLDLL void resize(qpl::size size, bool value = false);
+		QPLDLL void push_back(bool value);
+
+		QPLDLL void clear();
+		QPLDLL void fill(bool value);
+		QPLDLL bool get(qpl::size index) const;
+		QPLDLL void set(qpl::size index, bool value);
+		QPLDLL void flip(qpl::size index);
+		QPLDLL bool operator[](qpl::size index) const;
+
+		QPLDLL qpl::size number_of_set_bits() const;
+		QPLDLL bool empty() const;
+		QPLDLL bool full() const;
+		QPLDLL qpl::size find_first() const;
+		QPLDLL qpl::size find_next(qpl::size index) const;
+		QPLDLL qpl::size rank(qpl::size index) const;
+		QPLDLL qpl::size select(qpl::size rank) const;
+		template<typename F>
+		void for_each_set_bit(F&& function) const {
+			qpl::detail::bits_for_each(this->data.data(), this->data.size(), function);
+		}
+
+		QPLDLL dynamic_bitset& operator|=(const dynamic_bitset& other);
+		QPLDLL dynamic_bitset& operator&=(const dynamic_bitset& other);
+		QPLDLL dynamic_bitset& operator^=(const dynamic_bitset& other);
+		QPLDLL dynamic_bitset operator|(const dynamic_bitset& other) const;
+		QPLDLL dynamic_bitset operator&(const dynamic_bitset& other) const;
+		QPLDLL dynamic_bitset operator^(const dynamic_bitset& other) const;
+		QPLDLL dynamic_bitset operator~() const;
+		//like std::bitset, << moves bit i to i + shift, the size stays the same and the bits shifted out are dropped
+		QPLDLL dynamic_bitset& operator<<=(qpl::size shift);
+		QPLDLL dynamic_bitset& operator>>=(qpl::size shift);
+		QPLDLL dynamic_bitset operator<<(qpl::size shift) const;
+		QPLDLL dynamic_bitset operator>>(qpl::size shift) const;
+		QPLDLL bool operator==(const dynamic_bitset& other) const;
+
+		QPLDLL std::string string() const;
+
+		std::vector<qpl::u64> data;
+
+	private:
+		QPLDLL void size_check(const dynamic_bitset& other, const char* operation) const;
+		QPLDLL void clear_unused_bits();
+
+		qpl::size m_size = 0u;
+	};
+
+	//compressed bitmap for sparse sets of u32 values (roaring layout): the values are grouped by their upper 16 bits,
+	//a group is a sorted array of the lower 16 bits while it holds at most 4096 values and a 65536 bit bitmap once it is denser
+	struct roaring_bitmap {
+		QPLDLL bool add(qpl::u32 value);
+		QPLDLL bool remove(qpl::u32 value);
+		QPLDLL bool contains(qpl::u32 value) const;
+
+		QPLDLL qpl::size cardinality() const;
+		QPLDLL bool empty() const;
+		QPLDLL void clear();
+		QPLDLL qpl::u32 minimum() const;
+		QPLDLL qpl::u32 maximum() const;
+		//number of values smaller than value
+		QPLDLL qpl::size rank(qpl::u32 value) const;
+		QPLDLL qpl::size memory_size() const;
+		QPLDLL std::vector<qpl::u32> values() const;
+
+		//calls function with every value, in ascending order
+		template<typename F>
+		void for_each(F&& function) const {
+			for (auto& container : this->m_containers) {
+				auto high = qpl::u32_cast(container.key) << 16;
+				if (container.is_bitmap()) {
+					qpl::detail::bits_for_each(container.bitmap.data(), container.bitmap.size(), [&](qpl::size low) {
+						function(high | qpl::u32_cast(low));
+					});
+				}
+				else {
+					for (auto& low : container.array) {
+						function(high | low);
+					}
+				}
+			}
+		}
+
+		QPLDLL roaring_bitmap& operator|=(const roaring_bitmap& other);
+		QPLDLL roaring_bitmap& operator&=(const roaring_bitmap& other);
+		QPLDLL roaring_bitmap operator|(const roaring_bitmap& other) const;
+		QPLDLL roaring_bitmap operator&(const roaring_bitmap& other) const;
+		QPLDLL bool operator==(const roaring_bitmap& other) const;
+
+	private:
+		struct container {
+			qpl::u16 key = 0u;
+			qpl::size cardinality = 0u;
+			std::vector<qpl::u16> array;
+			std::vector<qpl::u64> bitmap;
+
+			bool is_bitmap() const {
+				return !this->bitmap.empty();
+			}
+			QPLDLL void to_bitmap();
+			QPLDLL void to_array();
+			QPLDLL void normalize();
+		};
+
+		std::vector<container> m_containers;
 	};
 
 	struct double_content {
@@ -840,6 +1091,145 @@ namespace qpl {
 			return value;
 		}
 	};
+
+	//writes bits most significant first into 64 bit words, the same layout as qpl::bit_string_ostream,
+	//but straight into one contiguous buffer. reserve() the expected size up front so writing never reallocates
+	struct bit_writer {
+		bit_writer() {
+
+		}
+		QPLDLL explicit bit_writer(qpl::size reserve_bytes);
+
+		QPLDLL void reserve(qpl::size bytes);
+		QPLDLL void clear();
+		//writes out the partially filled word, zero padded
+		QPLDLL void finish();
+		QPLDLL qpl::size size() const;
+		QPLDLL qpl::size bit_size() const;
+		QPLDLL std::span<const qpl::u8> span();
+		QPLDLL std::string string();
+
+		//width is at most 64 and value must not have bits set above width
+		void add_bits(qpl::u64 value, qpl::size width) {
+			auto free = qpl::bits_in_type<qpl::u64>() - this->m_count;
+			if (width < free) {
+				this->m_word |= (value << (free - width - 1u)) << 1u;
+				this->m_count += width;
+			}
+			else {
+				this->m_word |= value >> (width - free);
+				this->write_word();
+				this->m_count = width - free;
+				this->m_word = this->m_count ? value << (qpl::bits_in_type<qpl::u64>() - this->m_count) : qpl::u64{};
+			}
+			this->m_bit_size += width;
+		}
+		template<typename T> requires (qpl::is_unsigned<T>())
+		void add_bits(T n) {
+			this->add_bits(qpl::u64_cast(n), qpl::bits_in_type<T>());
+		}
+
+		//raw bytes, written after the current word like qpl::bit_string_ostream::add
+		QPLDLL void add(std::string_view bytes);
+		template<typename T> requires (qpl::is_arithmetic<T>())
+		void add(T n) {
+			this->add(std::string_view(reinterpret_cast<const char*>(&n), qpl::bytes_in_type<T>()));
+		}
+
+	private:
+		void write_word() {
+			if (this->m_size + qpl::bytes_in_type<qpl::u64>() > this->m_buffer.size()) {
+				this->grow(qpl::bytes_in_type<qpl::u64>());
+			}
+			std::memcpy(this->m_buffer.data() + this->m_size, &this->m_word, qpl::bytes_in_type<qpl::u64>());
+			this->m_size += qpl::bytes_in_type<qpl::u64>();
+		}
+		QPLDLL void grow(qpl::size bytes);
+
+		std::string m_buffer;
+		qpl::size m_size = 0u;
+		qpl::u64 m_word = 0u;
+		qpl::size m_count = 0u;
+		qpl::size m_bit_size = 0u;
+	};
+
+	//reads what qpl::bit_writer or qpl::bit_string_ostream wrote, directly from the given bytes without copying them.
+	//refill() loads the next 64 bits into a window (fewer only at the end of the data), peek() and consume() work on that window without branching
+	struct bit_reader {
+		bit_reader() {
+
+		}
+		QPLDLL bit_reader(std::span<const qpl::u8> data);
+		QPLDLL bit_reader(std::string_view data);
+
+		QPLDLL void set(std::span<const qpl::u8> data);
+		QPLDLL void set(std::string_view data);
+		QPLDLL bool is_done() const;
+		QPLDLL qpl::size remaining_bits() const;
+
+		void refill() {
+			auto word = this->m_position / qpl::bits_in_type<qpl::u64>();
+			auto offset = this->m_position % qpl::bits_in_type<qpl::u64>();
+			auto high = this->load_word(word);
+			auto low = this->load_word(word + 1u);
+			this->m_window = (high << offset) | ((low >> 1u) >> (qpl::bits_in_type<qpl::u64>() - 1u - offset));
+			this->m_available = qpl::min(qpl::size_cast(qpl::bits_in_type<qpl::u64>()), this->remaining_bits());
+		}
+		qpl::size available() const {
+			return this->m_available;
+		}
+		//width must not exceed available()
+		qpl::u64 peek(qpl::size width) const {
+			return width ? this->m_window >> (qpl::bits_in_type<qpl::u64>() - width) : qpl::u64{};
+		}
+		void consume(qpl::size width) {
+			this->m_window = width < qpl::bits_in_type<qpl::u64>() ? this->m_window << width : qpl::u64{};
+			this->m_available -= width;
+			this->m_position += width;
+		}
+
+		//reads past the end are zero padded
+		template<typename T>
+		T get_next_bits(qpl::size width) {
+			if (width > this->m_available) {
+				this->refill();
+			}
+			auto value = this->peek(width);
+			this->consume(qpl::min(width, this->m_available));
+			return static_cast<T>(value);
+		}
+
+		//raw bytes, read after the current word like qpl::bit_string_istream::get_next. the span points into the data
+		QPLDLL std::span<const qpl::u8> get_next_span(qpl::size bytes);
+		//skips the rest of the current word, like qpl::bit_string_istream::set_position_next_u64_multiple
+		QPLDLL void set_position_next_u64_multiple();
+		template<typename T> requires (qpl::is_arithmetic<T>())
+		T get_next() {
+			T value{};
+			auto bytes = this->get_next_span(qpl::bytes_in_type<T>());
+			std::memcpy(&value, bytes.data(), bytes.size());
+			return value;
+		}
+
+	private:
+		qpl::u64 load_word(qpl::size index) const {
+			auto offset = this->m_origin + index * qpl::bytes_in_type<qpl::u64>();
+			qpl::u64 result = 0u;
+			if (offset + qpl::bytes_in_type<qpl::u64>() <= this->m_data.size()) {
+				std::memcpy(&result, this->m_data.data() + offset, qpl::bytes_in_type<qpl::u64>());
+			}
+			else if (offset < this->m_data.size()) {
+				std::memcpy(&result, this->m_data.data() + offset, this->m_data.size() - offset);
+			}
+			return result;
+		}
+
+		std::span<const qpl::u8> m_data;
+		qpl::size m_origin = 0u;
+		qpl::size m_position = 0u;
+		qpl::u64 m_window = 0u;
+		qpl::size m_available = 0u;
+	};
 }
 
 #endif
\ No newline at end of file
@@ -14,9 +14,17 @@
 #include <qpl/vardef.hpp>
 
 #include <string>
+#include <stdexcept>
 #include <initializer_list>
 #include <array>
 #include <tuple>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace qpl {
 
@@ -1006,6 +1014,625 @@ namespace qpl {
 	QPLDLL qpl::rgb get_rainbow_color(qpl::f64 f);
 	QPLDLL qpl::rgb get_random_rainbow_color();
 
+	namespace detail {
+		template<typename T, typename F>
+		constexpr T color_from_unit(F value) {
+			if constexpr (qpl::is_floating_point<T>()) {
+				return static_cast<T>(value);
+			}
+			else {
+				constexpr auto max = static_cast<F>(qpl::type_max<T>());
+				auto scaled = value * max;
+				scaled = scaled < F{ 0 } ? F{ 0 } : (scaled > max ? max : scaled);
+				return static_cast<T>(scaled + F{ 0.5 });
+			}
+		}
+		template<typename T, qpl::size N, typename F>
+		void load_color_channels(std::span<const qpl::rgbN<T, N>> colors, F* r, F* g, F* b, F* a) {
+			constexpr auto factor = F{ 1 } / static_cast<F>(qpl::rgbN<T, N>::max_channel());
+			auto size = colors.size();
+			for (qpl::size i = 0u; i < size; ++i) {
+				r[i] = colors[i].data[0] * factor;
+			}
+			for (qpl::size i = 0u; i < size; ++i) {
+				g[i] = N >= 2 ? colors[i].data[qpl::min(N - 1, qpl::size{ 1 })] * factor : F{ 0 };
+			}
+			for (qpl::size i = 0u; i < size; ++i) {
+				b[i] = N >= 3 ? colors[i].data[qpl::min(N - 1, qpl::size{ 2 })] * factor : F{ 0 };
+			}
+			for (qpl::size i = 0u; i < size; ++i) {
+				a[i] = N >= 4 ? colors[i].data[N - 1] * factor : F{ 1 };
+			}
+		}
+		template<typename T, qpl::size N, typename F>
+		void store_color_channels(std::span<qpl::rgbN<T, N>> colors, const F* r, const F* g, const F* b, const F* a, qpl::size size) {
+			std::array<const F*, 4> channels = { r, g, b, a };
+			for (qpl::size c = 0u; c < N; ++c) {
+				auto channel = channels[c];
+				for (qpl::size i = 0u; i < size; ++i) {
+					colors[i].data[c] = color_from_unit<T>(channel[i]);
+				}
+			}
+		}
+
+		template<typename F>
+		constexpr F unit_clamp(F value) {
+			return value < F{ 0 } ? F{ 0 } : (value > F{ 1 } ? F{ 1 } : value);
+		}
+		template<typename F>
+		F wrap_hue(F hue) {
+			return hue - std::floor(hue);
+		}
+		//the part of chroma that channel n loses at this hue, n = 5 (r), 3 (g), 1 (b)
+		template<typename F>
+		F hue_factor(F n, F hue) {
+			auto k = n + hue * F{ 6 };
+			k = k >= F{ 6 } ? k - F{ 6 } : k;
+			auto t = k < F{ 4 } - k ? k : F{ 4 } - k;
+			return unit_clamp(t);
+		}
+		//channel n of hsv -> rgb with value = max and chroma = max - min
+		template<typename F>
+		F hue_channel(F n, F hue, F max, F chroma) {
+			return max - chroma * hue_factor(n, hue);
+		}
+		template<typename F>
+		F rgb_hue(F r, F g, F b, F max, F chroma) {
+			auto inverse = chroma > F{ 0 } ? F{ 1 } / chroma : F{ 0 };
+			auto hr = (g - b) * inverse;
+			auto hg = (b - r) * inverse + F{ 2 };
+			auto hb = (r - g) * inverse + F{ 4 };
+			auto hue = (max == r ? hr : (max == g ? hg : hb)) / F{ 6 };
+			return hue < F{ 0 } ? hue + F{ 1 } : hue;
+		}
+	}
+
+	//struct of arrays color storage for bulk operations, channels are in [0, 1].
+	//the bulk functions below work on whole channels with branchless loops so the compiler can vectorize them
+	template<typename F = qpl::f32> requires (qpl::is_floating_point<F>())
+	struct color_buffer {
+		std::vector<F> r;
+		std::vector<F> g;
+		std::vector<F> b;
+		std::vector<F> a;
+
+		qpl::size size() const {
+			return this->r.size();
+		}
+		bool empty() const {
+			return this->r.empty();
+		}
+		void resize(qpl::size size) {
+			this->r.resize(size);
+			this->g.resize(size);
+			this->b.resize(size);
+			this->a.resize(size, F{ 1 });
+		}
+		void clear() {
+			this->r.clear();
+			this->g.clear();
+			this->b.clear();
+			this->a.clear();
+		}
+
+		template<typename T, qpl::size N>
+		void set(qpl::size index, const qpl::rgbN<T, N>& color) {
+			constexpr auto factor = F{ 1 } / static_cast<F>(qpl::rgbN<T, N>::max_channel());
+			this->r[index] = color.data[0] * factor;
+			this->g[index] = N >= 2 ? color.data[qpl::min(N - 1, qpl::size{ 1 })] * factor : F{ 0 };
+			this->b[index] = N >= 3 ? color.data[qpl::min(N - 1, qpl::size{ 2 })] * factor : F{ 0 };
+			this->a[index] = N >= 4 ? color.data[N - 1] * factor : F{ 1 };
+		}
+		template<typename T = F, qpl::size N = 4>
+		qpl::rgbN<T, N> get(qpl::size index) const {
+			qpl::rgbN<T, N> result;
+			std::array<F, 4> channels = { this->r[index], this->g[index], this->b[index], this->a[index] };
+			for (qpl::size i = 0u; i < N; ++i) {
+				result.data[i] = qpl::detail::color_from_unit<T>(channels[i]);
+			}
+			return result;
+		}
+		template<typename T, qpl::size N>
+		void push_back(const qpl::rgbN<T, N>& color) {
+			this->resize(this->size() + 1);
+			this->set(this->size() - 1, color);
+		}
+
+		template<typename T, qpl::size N>
+		void load(std::span<const qpl::rgbN<T, N>> colors) {
+			this->resize(colors.size());
+			qpl::detail::load_color_channels(colors, this->r.data(), this->g.data(), this->b.data(), this->a.data());
+		}
+		template<typename T, qpl::size N>
+		void load(std::span<qpl::rgbN<T, N>> colors) {
+			this->load(std::span<const qpl::rgbN<T, N>>(colors));
+		}
+		template<typename T, qpl::size N>
+		void store(std::span<qpl::rgbN<T, N>> colors) const {
+			if (colors.size() < this->size()) {
+				throw std::out_of_range("qpl::color_buffer::store: span holds " + std::to_string(colors.size()) + " colors, need " + std::to_string(this->size()));
+			}
+			qpl::detail::store_color_channels(colors, this->r.data(), this->g.data(), this->b.data(), this->a.data(), this->size());
+		}
+	};
+	using frgb_buffer = color_buffer<qpl::f32>;
+
+	//hue is in [0, 1) like rgbN::get_hue
+	template<typename F = qpl::f32> requires (qpl::is_floating_point<F>())
+	struct hsv_buffer {
+		std::vector<F> h;
+		std::vector<F> s;
+		std::vector<F> v;
+		std::vector<F> a;
+
+		qpl::size size() const {
+			return this->h.size();
+		}
+		void resize(qpl::size size) {
+			this->h.resize(size);
+			this->s.resize(size);
+			this->v.resize(size);
+			this->a.resize(size, F{ 1 });
+		}
+	};
+	template<typename F = qpl::f32> requires (qpl::is_floating_point<F>())
+	struct hsl_buffer {
+		std::vector<F> h;
+		std::vector<F> s;
+		std::vector<F> l;
+		std::vector<F> a;
+
+		qpl::size size() const {
+			return this->h.size();
+		}
+		void resize(qpl::size size) {
+			this->h.resize(size);
+			this->s.resize(size);
+			this->l.resize(size);
+			this->a.resize(size, F{ 1 });
+		}
+	};
+
+	namespace detail {
+		//blends the rgb channels towards target(r, g, b) by delta, alpha is kept like in the rgbN member functions
+		template<typename F, typename Target>
+		void blend_colors(qpl::color_buffer<F>& colors, F delta, Target&& target) {
+			delta = unit_clamp(delta);
+			auto keep = F{ 1 } - delta;
+			auto size = colors.size();
+			auto r = colors.r.data();
+			auto g = colors.g.data();
+			auto b = colors.b.data();
+			for (qpl::size i = 0u; i < size; ++i) {
+				auto [tr, tg, tb] = target(r[i], g[i], b[i]);
+				r[i] = tr * delta + r[i] * keep;
+				g[i] = tg * delta + g[i] * keep;
+				b[i] = tb * delta + b[i] * keep;
+			}
+		}
+
+		constexpr qpl::size color_block_size = 1024u;
+
+		//the channel kernels below have AVX2 / SSE2 paths for f32 channels, f64 and the tails take the scalar loop.
+		//the vector code does the same operations in the same order, so the results match the scalar loop
+
+		//x[i] = x[i] * keep + add
+		template<typename F>
+		void scale_add_channel(F* x, qpl::size size, F keep, F add) {
+			qpl::size i = 0u;
+			if constexpr (std::is_same_v<F, qpl::f32>) {
+#if defined(__AVX2__)
+				auto k = _mm256_set1_ps(keep);
+				auto c = _mm256_set1_ps(add);
+				for (; i + 8u <= size; i += 8u) {
+					_mm256_storeu_ps(x + i, _mm256_add_ps(c, _mm256_mul_ps(_mm256_loadu_ps(x + i), k)));
+				}
+#elif defined(__SSE2__)
+				auto k = _mm_set1_ps(keep);
+				auto c = _mm_set1_ps(add);
+				for (; i + 4u <= size; i += 4u) {
+					_mm_storeu_ps(x + i, _mm_add_ps(c, _mm_mul_ps(_mm_loadu_ps(x + i), k)));
+				}
+#endif
+			}
+			for (; i < size; ++i) {
+				x[i] = add + x[i] * keep;
+			}
+		}
+		//x[i] = x[i] * keep + y[i] * delta
+		template<typename F>
+		void blend_channel(F* x, const F* y, qpl::size size, F keep, F delta) {
+			qpl::size i = 0u;
+			if constexpr (std::is_same_v<F, qpl::f32>) {
+#if defined(__AVX2__)
+				auto k = _mm256_set1_ps(keep);
+				auto d = _mm256_set1_ps(delta);
+				for (; i + 8u <= size; i += 8u) {
+					_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(x + i), k), _mm256_mul_ps(_mm256_loadu_ps(y + i), d)));
+				}
+#elif defined(__SSE2__)
+				auto k = _mm_set1_ps(keep);
+				auto d = _mm_set1_ps(delta);
+				for (; i + 4u <= size; i += 4u) {
+					_mm_storeu_ps(x + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x + i), k), _mm_mul_ps(_mm_loadu_ps(y + i), d)));
+				}
+#endif
+			}
+			for (; i < size; ++i) {
+				x[i] = x[i] * keep + y[i] * delta;
+			}
+		}
+		//blends r, g and b towards their gray value: the mean, or the perceived luminance
+		template<typename F>
+		void blend_gray(qpl::color_buffer<F>& colors, F delta, bool perceived) {
+			delta = unit_clamp(delta);
+			auto keep = F{ 1 } - delta;
+			auto size = colors.size();
+			auto r = colors.r.data();
+			auto g = colors.g.data();
+			auto b = colors.b.data();
+			qpl::size i = 0u;
+			if constexpr (std::is_same_v<F, qpl::f32>) {
+#if defined(__AVX2__)
+				auto k = _mm256_set1_ps(keep);
+				auto d = _mm256_set1_ps(delta);
+				auto wr = _mm256_set1_ps(0.2126f);
+				auto wg = _mm256_set1_ps(0.7152f);
+				auto wb = _mm256_set1_ps(0.0722f);
+				auto three = _mm256_set1_ps(3.0f);
+				for (; i + 8u <= size; i += 8u) {
+					auto vr = _mm256_loadu_ps(r + i);
+					auto vg = _mm256_loadu_ps(g + i);
+					auto vb = _mm256_loadu_ps(b + i);
+					auto gray = perceived ?
+						_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vr, wr), _mm256_mul_ps(vg, wg)), _mm256_mul_ps(vb, wb)) :
+						_mm256_div_ps(_mm256_add_ps(_mm256_add_ps(vr, vg), vb), three);
+					auto part = _mm256_mul_ps(gray, d);
+					_mm256_storeu_ps(r + i, _mm256_add_ps(part, _mm256_mul_ps(vr, k)));
+					_mm256_storeu_ps(g + i, _mm256_add_ps(part, _mm256_mul_ps(vg, k)));
+					_mm256_storeu_ps(b + i, _mm256_add_ps(part, _mm256_mul_ps(vb, k)));
+				}
+#elif defined(__SSE2__)
+				auto k = _mm_set1_ps(keep);
+				auto d = _mm_set1_ps(delta);
+				auto wr = _mm_set1_ps(0.2126f);
+				auto wg = _mm_set1_ps(0.7152f);
+				auto wb = _mm_set1_ps(0.0722f);
+				auto three = _mm_set1_ps(3.0f);
+				for (; i + 4u <= size; i += 4u) {
+					auto vr = _mm_loadu_ps(r + i);
+					auto vg = _mm_loadu_ps(g + i);
+					auto vb = _mm_loadu_ps(b + i);
+					auto gray = perceived ?
+						_mm_add_ps(_mm_add_ps(_mm_mul_ps(vr, wr), _mm_mul_ps(vg, wg)), _mm_mul_ps(vb, wb)) :
+						_mm_div_ps(_mm_add_ps(_mm_add_ps(vr, vg), vb), three);
+					auto part = _mm_mul_ps(gray, d);
+					_mm_storeu_ps(r + i, _mm_add_ps(part, _mm_mul_ps(vr, k)));
+					_mm_storeu_ps(g + i, _mm_add_ps(part, _mm_mul_ps(vg, k)));
+					_mm_storeu_ps(b + i, _mm_add_ps(part, _mm_mul_ps(vb, k)));
+				}
+#endif
+			}
+			for (; i < size; ++i) {
+				auto gray = perceived ? r[i] * F(0.2126) + g[i] * F(0.7152) + b[i] * F(0.0722) : (r[i] + g[i] + b[i]) / F{ 3 };
+				auto part = gray * delta;
+				r[i] = part + r[i] * keep;
+				g[i] = part + g[i] * keep;
+				b[i] = part + b[i] * keep;
+			}
+		}
+		//r, g, b = max - chroma * factor per channel, with min / max / chroma of every color
+		template<typename F>
+		void apply_hue_factors(qpl::color_buffer<F>& colors, F factor_r, F factor_g, F factor_b) {
+			auto size = colors.size();
+			auto r = colors.r.data();
+			auto g = colors.g.data();
+			auto b = colors.b.data();
+			qpl::size i = 0u;
+			if constexpr (std::is_same_v<F, qpl::f32>) {
+#if defined(__AVX2__)
+				auto fr = _mm256_set1_ps(factor_r);
+				auto fg = _mm256_set1_ps(factor_g);
+				auto fb = _mm256_set1_ps(factor_b);
+				for (; i + 8u <= size; i += 8u) {
+					auto vr = _mm256_loadu_ps(r + i);
+					auto vg = _mm256_loadu_ps(g + i);
+					auto vb = _mm256_loadu_ps(b + i);
+					auto min = _mm256_min_ps(vr, _mm256_min_ps(vg, vb));
+					auto max = _mm256_max_ps(vr, _mm256_max_ps(vg, vb));
+					auto chroma = _mm256_sub_ps(max, min);
+					_mm256_storeu_ps(r + i, _mm256_sub_ps(max, _mm256_mul_ps(chroma, fr)));
+					_mm256_storeu_ps(g + i, _mm256_sub_ps(max, _mm256_mul_ps(chroma, fg)));
+					_mm256_storeu_ps(b + i, _mm256_sub_ps(max, _mm256_mul_ps(chroma, fb)));
+				}
+#elif defined(__SSE2__)
+				auto fr = _mm_set1_ps(factor_r);
+				auto fg = _mm_set1_ps(factor_g);
+				auto fb = _mm_set1_ps(factor_b);
+				for (; i + 4u <= size; i += 4u) {
+					auto vr = _mm_loadu_ps(r + i);
+					auto vg = _mm_loadu_ps(g + i);
+					auto vb = _mm_loadu_ps(b + i);
+					auto min = _mm_min_ps(vr, _mm_min_ps(vg, vb));
+					auto max = _mm_max_ps(vr, _mm_max_ps(vg, vb));
+					auto chroma = _mm_sub_ps(max, min);
+					_mm_storeu_ps(r + i, _mm_sub_ps(max, _mm_mul_ps(chroma, fr)));
+					_mm_storeu_ps(g + i, _mm_sub_ps(max, _mm_mul_ps(chroma, fg)));
+					_mm_storeu_ps(b + i, _mm_sub_ps(max, _mm_mul_ps(chroma, fb)));
+				}
+#endif
+			}
+			for (; i < size; ++i) {
+				auto min = qpl::min(r[i], qpl::min(g[i], b[i]));
+				auto max = qpl::max(r[i], qpl::max(g[i], b[i]));
+				auto chroma = max - min;
+				r[i] = max - chroma * factor_r;
+				g[i] = max - chroma * factor_g;
+				b[i] = max - chroma * factor_b;
+			}
+		}
+	}
+
+	template<typename F>
+	void brighten_colors(qpl::color_buffer<F>& colors, F delta) {
+		delta = qpl::detail::unit_clamp(delta);
+		for (auto channel : { colors.r.data(), colors.g.data(), colors.b.data() }) {
+			qpl::detail::scale_add_channel(channel, colors.size(), F{ 1 } - delta, delta);
+		}
+	}
+	template<typename F>
+	void darken_colors(qpl::color_buffer<F>& colors, F delta) {
+		delta = qpl::detail::unit_clamp(delta);
+		for (auto channel : { colors.r.data(), colors.g.data(), colors.b.data() }) {
+			qpl::detail::scale_add_channel(channel, colors.size(), F{ 1 } - delta, F{ 0 });
+		}
+	}
+	template<typename F>
+	void light_colors(qpl::color_buffer<F>& colors, F delta) {
+		if (delta < 0) {
+			qpl::darken_colors(colors, -delta);
+		}
+		else {
+			qpl::brighten_colors(colors, delta);
+		}
+	}
+	template<typename F>
+	void grayify_colors(qpl::color_buffer<F>& colors, F delta) {
+		qpl::detail::blend_gray(colors, delta, false);
+	}
+	template<typename F>
+	void grayify_perceived_colors(qpl::color_buffer<F>& colors, F delta) {
+		qpl::detail::blend_gray(colors, delta, true);
+	}
+	//stretches the channels to the full range, colors without chroma stay unchanged
+	template<typename F>
+	void intensify_colors(qpl::color_buffer<F>& colors, F delta) {
+		qpl::detail::blend_colors(colors, delta, [](F r, F g, F b) {
+			auto min = qpl::min(r, qpl::min(g, b));
+			auto max = qpl::max(r, qpl::max(g, b));
+			auto chroma = max - min;
+			auto inverse = chroma > F{ 0 } ? F{ 1 } / chroma : F{ 0 };
+			auto keep = chroma > F{ 0 } ? F{ 0 } : F{ 1 };
+			return std::array<F, 3>{ (r - min) * inverse + r * keep, (g - min) * inverse + g * keep, (b - min) * inverse + b * keep };
+		});
+	}
+	template<typename F>
+	void saturate_colors(qpl::color_buffer<F>& colors, F delta) {
+		if (delta < 0) {
+			qpl::grayify_colors(colors, -delta);
+		}
+		else {
+			qpl::intensify_colors(colors, delta);
+		}
+	}
+	template<typename F>
+	void saturate_perceived_colors(qpl::color_buffer<F>& colors, F delta) {
+		if (delta < 0) {
+			qpl::grayify_perceived_colors(colors, -delta);
+		}
+		else {
+			qpl::intensify_colors(colors, delta);
+		}
+	}
+
+	//interpolates all four channels, like rgbN::interpolate
+	template<typename F>
+	void interpolate_colors(qpl::color_buffer<F>& colors, const qpl::color_buffer<F>& other, F delta) {
+		if (other.size() < colors.size()) {
+			throw std::invalid_argument("qpl::interpolate_colors: other holds " + std::to_string(other.size()) + " colors, need " + std::to_string(colors.size()));
+		}
+		auto keep = F{ 1 } - delta;
+		auto size = colors.size();
+		std::array<F*, 4> destination = { colors.r.data(), colors.g.data(), colors.b.data(), colors.a.data() };
+		std::array<const F*, 4> source = { other.r.data(), other.g.data(), other.b.data(), other.a.data() };
+		for (qpl::size c = 0u; c < 4u; ++c) {
+			qpl::detail::blend_channel(destination[c], source[c], size, keep, delta);
+		}
+	}
+	template<typename F, typename T, qpl::size N>
+	void interpolate_colors(qpl::color_buffer<F>& colors, const qpl::rgbN<T, N>& target, F delta) {
+		qpl::color_buffer<F> other;
+		other.resize(1);
+		other.set(0, target);
+		std::array<F, 4> channels = { other.r[0], other.g[0], other.b[0], other.a[0] };
+		std::array<F*, 4> destination = { colors.r.data(), colors.g.data(), colors.b.data(), colors.a.data() };
+		auto keep = F{ 1 } - delta;
+		auto size = colors.size();
+		for (qpl::size c = 0u; c < 4u; ++c) {
+			qpl::detail::scale_add_channel(destination[c], size, keep, channels[c] * delta);
+		}
+	}
+
+	//samples a gradient at every strength like rgbN::interpolation, output is resized to strengths.size()
+	template<typename F, typename T, qpl::size N>
+	void gradient_colors(std::span<const qpl::rgbN<T, N>> gradient, std::span<const F> strengths, qpl::color_buffer<F>& output) {
+		if (gradient.empty()) {
+			throw std::invalid_argument("qpl::gradient_colors: gradient is empty");
+		}
+		qpl::color_buffer<F> stops;
+		stops.load(gradient);
+		output.resize(strengths.size());
+
+		auto last = gradient.size() - 1;
+		std::array<const F*, 4> source = { stops.r.data(), stops.g.data(), stops.b.data(), stops.a.data() };
+		std::array<F*, 4> destination = { output.r.data(), output.g.data(), output.b.data(), output.a.data() };
+		for (qpl::size c = 0u; c < 4u; ++c) {
+			auto in = source[c];
+			auto out = destination[c];
+			for (qpl::size i = 0u; i < strengths.size(); ++i) {
+				auto position = qpl::detail::unit_clamp(strengths[i]) * last;
+				auto index = qpl::min(static_cast<qpl::size>(position), last);
+				auto next = qpl::min(index + 1, last);
+				auto left_over = position - index;
+				out[i] = in[index] * (F{ 1 } - left_over) + in[next] * left_over;
+			}
+		}
+	}
+
+	//keeps min and max of every color and replaces the hue, like rgbN::set_hue
+	template<typename F>
+	void set_colors_hue(qpl::color_buffer<F>& colors, F hue) {
+		hue = qpl::detail::wrap_hue(qpl::detail::unit_clamp(hue));
+		//with a fixed hue every channel is max - chroma * a constant factor
+		qpl::detail::apply_hue_factors(colors, qpl::detail::hue_factor(F{ 5 }, hue), qpl::detail::hue_factor(F{ 3 }, hue), qpl::detail::hue_factor(F{ 1 }, hue));
+	}
+	template<typename F>
+	void add_colors_hue(qpl::color_buffer<F>& colors, F delta_hue) {
+		auto size = colors.size();
+		auto r = colors.r.data();
+		auto g = colors.g.data();
+		auto b = colors.b.data();
+		for (qpl::size i = 0u; i < size; ++i) {
+			auto min = qpl::min(r[i], qpl::min(g[i], b[i]));
+			auto max = qpl::max(r[i], qpl::max(g[i], b[i]));
+			auto chroma = max - min;
+			auto hue = qpl::detail::wrap_hue(qpl::detail::rgb_hue(r[i], g[i], b[i], max, chroma) + delta_hue);
+			r[i] = qpl::detail::hue_channel(F{ 5 }, hue, max, chroma);
+			g[i] = qpl::detail::hue_channel(F{ 3 }, hue, max, chroma);
+			b[i] = qpl::detail::hue_channel(F{ 1 }, hue, max, chroma);
+		}
+	}
+
+	template<typename F>
+	void rgb_to_hsv(const qpl::color_buffer<F>& colors, qpl::hsv_buffer<F>& output) {
+		auto size = colors.size();
+		output.resize(size);
+		for (qpl::size i = 0u; i < size; ++i) {
+			auto r = colors.r[i];
+			auto g = colors.g[i];
+			auto b = colors.b[i];
+			auto min = qpl::min(r, qpl::min(g, b));
+			auto max = qpl::max(r, qpl::max(g, b));
+			auto chroma = max - min;
+			output.h[i] = qpl::detail::rgb_hue(r, g, b, max, chroma);
+			output.s[i] = max > F{ 0 } ? chroma / max : F{ 0 };
+			output.v[i] = max;
+		}
+		std::copy(colors.a.begin(), colors.a.end(), output.a.begin());
+	}
+	template<typename F>
+	void hsv_to_rgb(const qpl::hsv_buffer<F>& colors, qpl::color_buffer<F>& output) {
+		auto size = colors.size();
+		output.resize(size);
+		for (qpl::size i = 0u; i < size; ++i) {
+			auto hue = qpl::detail::wrap_hue(colors.h[i]);
+			auto max = colors.v[i];
+			auto chroma = max * colors.s[i];
+			output.r[i] = qpl::detail::hue_channel(F{ 5 }, hue, max, chroma);
+			output.g[i] = qpl::detail::hue_channel(F{ 3 }, hue, max, chroma);
+			output.b[i] = qpl::detail::hue_channel(F{ 1 }, hue, max, chroma);
+		}
+		std::copy(colors.a.begin(), colors.a.end(), output.a.begin());
+	}
+	template<typename F>
+	void rgb_to_hsl(const qpl::color_buffer<F>& colors, qpl::hsl_buffer<F>& output) {
+		auto size = colors.size();
+		output.resize(size);
+		for (qpl::size i = 0u; i < size; ++i) {
+			auto r = colors.r[i];
+			auto g = colors.g[i];
+			auto b = colors.b[i];
+			auto min = qpl::min(r, qpl::min(g, b));
+			auto max = qpl::max(r, qpl::max(g, b));
+			auto chroma = max - min;
+			auto lightness = (max + min) / F{ 2 };
+			auto denominator = F{ 1 } - std::abs(F{ 2 } * lightness - F{ 1 });
+			output.h[i] = qpl::detail::rgb_hue(r, g, b, max, chroma);
+			output.s[i] = denominator > F{ 0 } ? chroma / denominator : F{ 0 };
+			output.l[i] = lightness;
+		}
+		std::copy(colors.a.begin(), colors.a.end(), output.a.begin());
+	}
+	template<typename F>
+	void hsl_to_rgb(const qpl::hsl_buffer<F>& colors, qpl::color_buffer<F>& output) {
+		auto size = colors.size();
+		output.resize(size);
+		for (qpl::size i = 0u; i < size; ++i) {
+			auto hue = qpl::detail::wrap_hue(colors.h[i]);
+			auto lightness = colors.l[i];
+			auto chroma = (F{ 1 } - std::abs(F{ 2 } * lightness - F{ 1 })) * colors.s[i];
+			auto max = lightness + chroma / F{ 2 };
+			output.r[i] = qpl::detail::hue_channel(F{ 5 }, hue, max, chroma);
+			output.g[i] = qpl::detail::hue_channel(F{ 3 }, hue, max, chroma);
+			output.b[i] = qpl::detail::hue_channel(F{ 1 }, hue, max, chroma);
+		}
+		std::copy(colors.a.begin(), colors.a.end(), output.a.begin());
+	}
+
+	//runs function(qpl::color_buffer<qpl::f32>&) over colors in blocks and writes the result back
+	template<typename T, qpl::size N, typename Function>
+	void transform_colors(std::span<qpl::rgbN<T, N>> colors, Function&& function) {
+		qpl::color_buffer<qpl::f32> buffer;
+		for (qpl::size begin = 0u; begin < colors.size(); begin += qpl::detail::color_block_size) {
+			auto block = colors.subspan(begin, qpl::min(qpl::detail::color_block_size, colors.size() - begin));
+			buffer.load(block);
+			function(buffer);
+			buffer.store(block);
+		}
+	}
+	template<typename T, qpl::size N>
+	void brighten_colors(std::span<qpl::rgbN<T, N>> colors, qpl::f32 delta) {
+		qpl::transform_colors(colors, [&](qpl::color_buffer<qpl::f32>& buffer) {
+			qpl::brighten_colors(buffer, delta);
+		});
+	}
+	template<typename T, qpl::size N>
+	void darken_colors(std::span<qpl::rgbN<T, N>> colors, qpl::f32 delta) {
+		qpl::transform_colors(colors, [&](qpl::color_buffer<qpl::f32>& buffer) {
+			qpl::darken_colors(buffer, delta);
+		});
+	}
+	template<typename T, qpl::size N>
+	void saturate_colors(std::span<qpl::rgbN<T, N>> colors, qpl::f32 delta) {
+		qpl::transform_colors(colors, [&](qpl::color_buffer<qpl::f32>& buffer) {
+			qpl::saturate_colors(buffer, delta);
+		});
+	}
+	template<typename T, qpl::size N>
+	void grayify_perceived_colors(std::span<qpl::rgbN<T, N>> colors, qpl::f32 delta) {
+		qpl::transform_colors(colors, [&](qpl::color_buffer<qpl::f32>& buffer) {
+			qpl::grayify_perceived_colors(buffer, delta);
+		});
+	}
+	template<typename T, qpl::size N, typename U, qpl::size M>
+	void interpolate_colors(std::span<qpl::rgbN<T, N>> colors, const qpl::rgbN<U, M>& target, qpl::f32 delta) {
+		qpl::transform_colors(colors, [&](qpl::color_buffer<qpl::f32>& buffer) {
+			qpl::interpolate_colors(buffer, target, delta);
+		});
+	}
+	template<typename T, qpl::size N>
+	void set_colors_hue(std::span<qpl::rgbN<T, N>> colors, qpl::f32 hue) requires (N >= 3) {
+		qpl::transform_colors(colors, [&](qpl::color_buffer<qpl::f32>& buffer) {
+			qpl::set_colors_hue(buffer, hue);
+		});
+	}
+	template<typename T, qpl::size N>
+	void add_colors_hue(std::span<qpl::rgbN<T, N>> colors, qpl::f32 delta_hue) requires (N >= 3) {
+		qpl::transform_colors(colors, [&](qpl::color_buffer<qpl::f32>& buffer) {
+			qpl::add_colors_hue(buffer, delta_hue);
+		});
+	}
+
 
 
 	namespace detail {
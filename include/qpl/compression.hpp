@@ -1,8 +1,11 @@
 #pragma once
 #include <qpl/qpldeclspec.hpp>
 #include <qpl/vardef.hpp>
+#include <qpl/flat_hash_map.hpp>
+#include <qpl/memory_resource.hpp>
 #include <sstream>
 #include <string>
+#include <memory_resource>
 #include <unordered_map>
 #include <set>
 #include <optional>
@@ -18,10 +21,26 @@ namespace qpl {
 	struct huffman_compression {
 
 		struct fast_decompression_map {
-			std::vector<std::unordered_map<qpl::u32, char>> values;
+			struct lookup_entry {
+				char meaning = 0;
+				qpl::u8 width = 0;
+			};
+			constexpr static qpl::u8 max_lookup_bits = 12u;
+
+			std::vector<qpl::flat_hash_map<qpl::u32, char>> values;
+
+			//indexed by the next lookup_bits bits, every code up to lookup_bits wide fills all slots starting with it.
+			//a width of 0 means the code is longer and has to be found in values
+			std::vector<lookup_entry> lookup;
+			qpl::u8 lookup_bits = 0;
+			qpl::u8 max_bits = 0;
+
 			qpl::u32 bits = 0;
 			qpl::u32 length = 0;
 
+			QPLDLL void set_max_bits(qpl::u8 max_bits);
+			//false if the code doesn't fit its width or collides with another code
+			QPLDLL bool add(qpl::u32 bits, qpl::u8 width, char meaning);
 			QPLDLL void reset();
 			QPLDLL void add_bit(bool b);
 			QPLDLL bool is_found() const;
@@ -61,9 +80,9 @@ namespace qpl {
 			std::vector<character_info16> data16;
 			std::vector<character_info8> data8;
 
-			std::unordered_map<char, std::pair<qpl::u8, qpl::u8>> map8;
-			std::unordered_map<char, std::pair<qpl::u16, qpl::u8>> map16;
-			std::unordered_map<char, std::pair<qpl::u32, qpl::u8>> map32;
+			qpl::flat_hash_map<char, std::pair<qpl::u8, qpl::u8>> map8;
+			qpl::flat_hash_map<char, std::pair<qpl::u16, qpl::u8>> map16;
+			qpl::flat_hash_map<char, std::pair<qpl::u32, qpl::u8>> map32;
 
 			enum class mode {
 				b8, b16, b32
@@ -83,7 +102,7 @@ namespace qpl {
 			QPLDLL bool operator!=(const character_table& other) const;
 			QPLDLL qpl::size data_size() const;
 			QPLDLL std::string get_header_string() const;
-			QPLDLL bool create(qpl::bit_string_istream& stream, qpl::u16 data_size);
+			QPLDLL bool create(qpl::bit_reader& reader, qpl::u16 data_size);
 
 			void print() {
 				qpl::println("width = ", (int)this->max_width_length);
@@ -110,14 +129,28 @@ namespace qpl {
 			}
 		};
 
+		//allocator aware, so a whole tree can live in the memory resource of the container holding it
 		struct tree {
-			tree() {
+			using allocator_type = std::pmr::polymorphic_allocator<tree>;
+
+			tree(const allocator_type& allocator = {}) : nodes(allocator) {
 
 			}
-			tree(qpl::u8 c) {
+			tree(qpl::u8 c, const allocator_type& allocator = {}) : nodes(allocator) {
 				this->character = c;
 			}
-			std::vector<tree> nodes;
+			tree(const tree& other, const allocator_type& allocator) : nodes(other.nodes, allocator), character(other.character) {
+
+			}
+			tree(tree&& other, const allocator_type& allocator) : nodes(std::move(other.nodes), allocator), character(other.character) {
+
+			}
+			tree(const tree&) = default;
+			tree(tree&&) = default;
+			tree& operator=(const tree&) = default;
+			tree& operator=(tree&&) = default;
+
+			std::pmr::vector<tree> nodes;
 			qpl::u8 character = 0;
 
 			QPLDLL void get_table_helper32(character_table& result, qpl::u32 bits, qpl::u8 width) const;
@@ -143,7 +176,8 @@ namespace qpl {
 			}
 		};
 
-		QPLDLL void compress(const std::string& string);
+		//the tree nodes are taken from resource, if it's nullptr a local qpl::arena_resource is used
+		QPLDLL void compress(const std::string& string, std::pmr::memory_resource* resource = nullptr);
 		QPLDLL bool decompress(const std::string& string);
 		QPLDLL std::string get_result() const;
 
@@ -6,11 +6,14 @@
 #include <array>
 #include <vector>
 #include <string>
+#include <optional>
+#include <span>
 
 #include <qpl/qpldeclspec.hpp>
 #include <qpl/vardef.hpp>
 #include <qpl/memory.hpp>
 #include <qpl/random.hpp>
+#include <qpl/thread_pool.hpp>
 
 #ifdef QPL_RSA
 #pragma warning( push )
@@ -185,6 +188,43 @@ namespace qpl {
 		QPLDLL static std::string to_string(const qpl::sha512::hash_result& hash);
 	};
 
+	struct xxh64 {
+		constexpr static qpl::u64 prime1 = 0x9E3779B185EBCA87ull;
+		constexpr static qpl::u64 prime2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr static qpl::u64 prime3 = 0x165667B19E3779F9ull;
+		constexpr static qpl::u64 prime4 = 0x85EBCA77C2B2AE63ull;
+		constexpr static qpl::u64 prime5 = 0x27D4EB2F165667C5ull;
+		constexpr static qpl::size stripe_size = 32u;
+
+		std::array<qpl::u64, 4> state;
+		std::array<qpl::u8, stripe_size> buffer;
+		qpl::u64 seed;
+		qpl::u64 total_length;
+		qpl::size buffer_size;
+
+		xxh64(qpl::u64 seed = 0u) {
+			this->reset(seed);
+		}
+
+		static constexpr qpl::u64 rotl(qpl::u64 x, qpl::u64 n) {
+			return (x << n) | (x >> (64u - n));
+		}
+		static constexpr qpl::u64 round(qpl::u64 accumulator, qpl::u64 input) {
+			accumulator += input * prime2;
+			accumulator = rotl(accumulator, 31u);
+			return accumulator * prime1;
+		}
+		static constexpr qpl::u64 merge_round(qpl::u64 accumulator, qpl::u64 value) {
+			accumulator ^= round(0u, value);
+			return accumulator * prime1 + prime4;
+		}
+
+		QPLDLL void reset(qpl::u64 seed = 0u);
+		QPLDLL void update(const std::string_view& data);
+		QPLDLL qpl::u64 digest() const;
+		QPLDLL void consume_stripe(const qpl::u8* data);
+	};
+
 	namespace detail {
 		QPLDLL extern qpl::sha256 sha256_t;
 		QPLDLL extern qpl::sha512 sha512_t;
@@ -192,6 +232,7 @@ namespace qpl {
 
 	QPLDLL std::string sha256_hash(const std::string_view& string);
 	QPLDLL std::string sha512_hash(const std::string_view& string);
+	QPLDLL qpl::u64 xxh64_hash(const std::string_view& string, qpl::u64 seed = 0u);
 
 	constexpr auto sha256_object = std::make_pair(sha256_hash, 256u);
 	constexpr auto sha512_object = std::make_pair(sha512_hash, 512u);
@@ -1984,8 +2025,19 @@ namespace qpl {
 		mpz_class mod;
 		mpz_class key;
 
+		//optional, only private keys carry them: p, q, key mod (p - 1), key mod (q - 1) and q^-1 mod p.
+		//qpl::RSA picks them up in set_decryption_key / set_encryption_key and runs modulo p and q
+		mpz_class prime1;
+		mpz_class prime2;
+		mpz_class exponent1;
+		mpz_class exponent2;
+		mpz_class coefficient;
+
 		QPLDLL bool empty() const;
+		QPLDLL bool has_primes() const;
+		QPLDLL void clear_primes();
 		QPLDLL void set(const std::string_view& mod, const std::string_view& key);
+		QPLDLL void set(const std::string_view& mod, const std::string_view& key, const std::string_view& prime1, const std::string_view& prime2, const std::string_view& exponent1, const std::string_view& exponent2, const std::string_view& coefficient);
 		QPLDLL void set_base64(const std::string_view& mod, const std::string_view& key);
 		QPLDLL std::string string();
 		QPLDLL qpl::size bits() const;
@@ -1997,6 +2049,19 @@ namespace qpl {
 		mpz_class public_key;
 		qpl::size bits = 0;
 
+		//only known to whoever created the key. with them both exponentiations run modulo p and q (chinese remainder theorem)
+		mpz_class prime1;
+		mpz_class prime2;
+		mpz_class coefficient;
+		mpz_class private_exponent1;
+		mpz_class private_exponent2;
+		mpz_class public_exponent1;
+		mpz_class public_exponent2;
+
+		QPLDLL void set_primes(const mpz_class& prime1, const mpz_class& prime2);
+		QPLDLL void clear_primes();
+		QPLDLL bool has_primes() const;
+
 		QPLDLL void set_decryption_key(const mpz_class& key, const mpz_class& mod);
 		QPLDLL void set_encryption_key(const mpz_class& key, const mpz_class& mod);
 		QPLDLL void set_decryption_key(const RSA_key_pair& key);
@@ -2023,6 +2088,20 @@ namespace qpl {
 
 		QPLDLL std::string sign_RSASSA_PSS(const std::string_view& signature, qpl::hash_type hash_object = qpl::sha512_object, qpl::size salt_length = qpl::size_max) const;
 		QPLDLL bool verify_RSASSA_PSS(const std::string& message, const std::string_view& signature, qpl::hash_type hash_object = qpl::sha512_object, qpl::size salt_length = qpl::size_max) const;
+
+		//binary versions work on big endian blocks of get_bits() / 8 bytes, their output equals qpl::from_hex_string of the hex versions
+		QPLDLL std::string encrypt_block(const std::string_view& block) const;
+		QPLDLL std::string decrypt_block(const std::string_view& block) const;
+		QPLDLL std::optional<std::string> encrypt_binary(const std::string_view& message, std::string label = "", qpl::hash_type hash_object = qpl::sha512_object) const;
+		QPLDLL std::optional<std::string> decrypt_binary(const std::string_view& message, std::string label = "", qpl::hash_type hash_object = qpl::sha512_object) const;
+		QPLDLL std::string sign_RSASSA_PSS_binary(const std::string_view& signature, qpl::hash_type hash_object = qpl::sha512_object, qpl::size salt_length = qpl::size_max) const;
+		QPLDLL bool verify_RSASSA_PSS_binary(const std::string_view& message, const std::string_view& signature, qpl::hash_type hash_object = qpl::sha512_object, qpl::size salt_length = qpl::size_max) const;
+
+		//independent binary operations spread over the pool, results keep the input order
+		QPLDLL std::vector<std::optional<std::string>> encrypt_batch(std::span<const std::string> messages, std::string label = "", qpl::hash_type hash_object = qpl::sha512_object, qpl::thread_pool& pool = qpl::default_thread_pool()) const;
+		QPLDLL std::vector<std::optional<std::string>> decrypt_batch(std::span<const std::string> messages, std::string label = "", qpl::hash_type hash_object = qpl::sha512_object, qpl::thread_pool& pool = qpl::default_thread_pool()) const;
+		QPLDLL std::vector<std::string> sign_RSASSA_PSS_batch(std::span<const std::string> signatures, qpl::hash_type hash_object = qpl::sha512_object, qpl::thread_pool& pool = qpl::default_thread_pool()) const;
+		QPLDLL std::vector<bool> verify_RSASSA_PSS_batch(std::span<const std::string> messages, std::span<const std::string> signatures, qpl::hash_type hash_object = qpl::sha512_object, qpl::thread_pool& pool = qpl::default_thread_pool()) const;
 	};
 
 	QPLDLL std::optional<std::string> RSA_encrypt(const std::string_view& message, const RSA_key_pair& private_key, std::string label = "", qpl::hash_type hash_object = qpl::sha512_object);
@@ -2036,6 +2115,8 @@ namespace qpl {
 		qpl::RSA_key_pair cipher_key;
 
 		QPLDLL bool empty() const;
+		//the cipher key, a separator line and the signature key. every key is a mod and a key line,
+		//private keys may follow them with the 5 lines of their crt parameters (p, q, dP, dQ, qInv)
 		QPLDLL void load_keys(const std::string& path);
 		QPLDLL void load_keys_from_file(const std::string& path);
 		QPLDLL void set_signature_key(const std::string_view& mod, const std::string_view& key);
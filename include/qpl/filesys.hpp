@@ -6,17 +6,27 @@
 #include <qpl/vardef.hpp>
 #include <qpl/memory.hpp>
 #include <qpl/encryption.hpp>
+#include <qpl/thread_pool.hpp>
 #include <string>
 
 #include <filesystem>
 #include <functional>
 #include <regex>
 #include <fstream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <condition_variable>
+#include <exception>
+#include <unordered_map>
 
 namespace qpl {
 
   namespace filesys {
     class paths;
+    struct walk_filter;
 
     class path {
     public:
@@ -315,6 +325,7 @@ namespace qpl {
 
       QPLDLL qpl::filesys::paths search_recursively_directories() const;
       QPLDLL qpl::filesys::paths search_recursively_files() const;
+      QPLDLL qpl::filesys::paths search_recursively_where(const qpl::filesys::walk_filter& filter, qpl::size thread_count = 0u) const;
 
       QPLDLL void update() const;
 
@@ -606,6 +617,165 @@ namespace qpl {
     QPLDLL void file_encrypt_to(const std::string& source_path, const std::string& dest_path, const std::string& key, qpl::aes::mode mode = qpl::aes::mode::_256);
     QPLDLL std::string file_decrypt(const std::string& path, const std::string& key, qpl::aes::mode mode = qpl::aes::mode::_256);
     QPLDLL void file_decrypt_to(const std::string& source_path, const std::string& dest_path, const std::string& key, qpl::aes::mode mode = qpl::aes::mode::_256);
+
+
+    struct walk_entry {
+      std::string path;
+      std::filesystem::file_time_type last_write_time;
+      qpl::u64 file_size = 0u;
+      qpl::size depth = 0u;
+      bool is_file = false;
+      bool is_directory = false;
+
+      QPLDLL std::string_view get_full_name_view() const;
+      QPLDLL std::string_view get_file_extension_view() const;
+      QPLDLL qpl::filesys::path to_path() const;
+    };
+
+    //all filters are applied to the entry name before any qpl::filesys::path is constructed
+    struct walk_filter {
+      std::vector<std::string> extensions;
+      std::string name_equals;
+      std::string name_contains;
+      std::function<bool(const std::filesystem::directory_entry&)> predicate;
+      std::function<bool(const std::filesystem::directory_entry&)> descend_predicate;
+      qpl::size max_depth = qpl::size_max;
+      bool include_files = true;
+      bool include_directories = true;
+      bool read_metadata = false;
+
+      QPLDLL bool accepts_name(std::string_view full_name, bool is_directory) const;
+    };
+
+    //callback is invoked concurrently from the worker threads. thread_count = 0 uses all hardware threads
+    QPLDLL void walk_directory_tree(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, const std::function<void(const qpl::filesys::walk_entry&)>& callback, qpl::size thread_count = 0u);
+    QPLDLL std::vector<qpl::filesys::walk_entry> walk_directory_tree(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, qpl::size thread_count = 0u);
+    QPLDLL qpl::filesys::paths search_tree_parallel(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, qpl::size thread_count = 0u);
+
+    class walk_channel {
+    public:
+      walk_channel() {
+
+      }
+      walk_channel(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, qpl::size thread_count = 0u, qpl::size capacity = qpl::size_max) {
+        this->start(root, filter, thread_count, capacity);
+      }
+      walk_channel(const walk_channel&) = delete;
+      walk_channel& operator=(const walk_channel&) = delete;
+      ~walk_channel() {
+        this->stop();
+      }
+
+      QPLDLL void start(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, qpl::size thread_count = 0u, qpl::size capacity = qpl::size_max);
+      QPLDLL void stop();
+
+      //blocks until an entry is available. returns false once the walk is finished and every entry was consumed.
+      //if the walk failed (e.g. a throwing filter predicate), the exception is rethrown once the remaining entries were consumed
+      QPLDLL bool pop(qpl::filesys::walk_entry& entry);
+      QPLDLL bool try_pop(qpl::filesys::walk_entry& entry);
+      QPLDLL bool finished() const;
+      QPLDLL bool failed() const;
+
+    private:
+      QPLDLL void rethrow_failure();
+
+      std::thread m_thread;
+      mutable std::mutex m_mutex;
+      std::condition_variable m_pushed;
+      std::condition_variable m_popped;
+      std::deque<qpl::filesys::walk_entry> m_entries;
+      qpl::size m_capacity = qpl::size_max;
+      std::exception_ptr m_exception;
+      std::atomic_bool m_cancel = false;
+      bool m_finished = true;
+    };
+
+    class metadata_cache {
+    public:
+      struct entry {
+        std::filesystem::file_time_type last_write_time;
+        qpl::u64 file_size = 0u;
+        bool is_directory = false;
+        std::vector<std::string> children;
+      };
+
+      QPLDLL void build(const qpl::filesys::path& root, qpl::size thread_count = 0u);
+
+      //re-lists only directories whose last write time changed, returns the number of changed entries
+      QPLDLL qpl::size refresh(qpl::size thread_count = 0u);
+      QPLDLL void clear();
+
+      QPLDLL const entry* find(const qpl::filesys::path& path) const;
+      QPLDLL bool exists(const qpl::filesys::path& path) const;
+      QPLDLL bool is_file(const qpl::filesys::path& path) const;
+      QPLDLL bool is_directory(const qpl::filesys::path& path) const;
+      QPLDLL qpl::u64 file_size(const qpl::filesys::path& path) const;
+      QPLDLL std::filesystem::file_time_type last_write_time(const qpl::filesys::path& path) const;
+
+      QPLDLL qpl::filesys::paths search(const qpl::filesys::walk_filter& filter) const;
+      QPLDLL qpl::size size() const;
+      QPLDLL bool empty() const;
+      QPLDLL const std::string& root() const;
+
+    private:
+      QPLDLL void insert(const std::vector<qpl::filesys::walk_entry>& entries);
+      QPLDLL void erase_recursively(const std::string& key);
+
+      std::unordered_map<std::string, entry> m_entries;
+      std::string m_root;
+    };
+
+    //hashes the first and last "bytes" bytes together with the file size
+    QPLDLL qpl::u64 file_partial_hash(const qpl::filesys::path& path, qpl::size bytes = 4096u);
+    QPLDLL qpl::u64 file_content_hash(const qpl::filesys::path& path);
+
+    struct file_index_difference {
+      std::vector<std::string> added;
+      std::vector<std::string> removed;
+      std::vector<std::string> changed;
+      //files that couldn't be read (e.g. deleted during the scan). update() drops them from the index, difference() doesn't compare them
+      std::vector<std::string> failed;
+
+      QPLDLL bool empty() const;
+    };
+
+    struct file_index {
+      struct entry {
+        std::filesystem::file_time_type last_write_time;
+        qpl::u64 file_size = 0u;
+        qpl::u64 partial_hash = 0u;
+        qpl::u64 full_hash = 0u;
+        bool has_full_hash = false;
+      };
+
+      //keys are relative to root
+      std::unordered_map<std::string, entry> entries;
+      std::string root;
+      qpl::size partial_hash_bytes = 4096u;
+
+      QPLDLL void build(const qpl::filesys::path& root, qpl::size thread_count = 0u);
+
+      //only files whose size or last write time changed are hashed again
+      QPLDLL qpl::filesys::file_index_difference update(qpl::size thread_count = 0u);
+      QPLDLL void clear();
+
+      QPLDLL void save(qpl::save_state& state) const;
+      QPLDLL void load(qpl::load_state& state);
+      QPLDLL void file_save(const qpl::filesys::path& path) const;
+      QPLDLL void file_load(const qpl::filesys::path& path);
+
+      //files are grouped by size and partial hash first, only candidates of the same group get fully hashed
+      QPLDLL std::vector<qpl::filesys::paths> duplicate_groups(qpl::size thread_count = 0u);
+      QPLDLL qpl::filesys::file_index_difference difference(qpl::filesys::file_index& other, qpl::size thread_count = 0u);
+
+      QPLDLL const entry* find(const std::string& relative_path) const;
+      QPLDLL qpl::filesys::path full_path(const std::string& relative_path) const;
+      QPLDLL qpl::size size() const;
+      QPLDLL bool empty() const;
+
+      //returns the paths that couldn't be hashed
+      QPLDLL std::vector<std::string> ensure_full_hashes(const std::vector<std::string>& relative_paths, qpl::size thread_count = 0u);
+    };
   }
 
   QPLDLL std::string read_file(const std::string& path);
@@ -803,6 +973,74 @@ namespace qpl {
     }
   };
 
+  //streams files in chunk_size pieces through a thread pool and writes split parts while reading, so memory stays bounded.
+  //every chunk is encrypted on its own and the encrypted index at the end of the archive allows extracting single files
+  //chunks carry a nonce from a random per archive salt, their file index and chunk number. every chunk and the index are authenticated
+  //and parts are renamed from .tmp only once complete
+  struct encrypted_archive_writer {
+    qpl::filesys::paths paths;
+    qpl::filesys::path common_branch;
+    std::string keyword_string_part = "CIPHER_PART";
+    std::string keyword_string_enrypted = "ENCRYPTED";
+    qpl::aes::mode mode = qpl::aes::mode::_256;
+    qpl::size chunk_size = qpl::size{ 1u } << 22;
+    qpl::size thread_count = 0u;
+
+    QPLDLL void clear();
+    QPLDLL void add(const qpl::filesys::path& path);
+    QPLDLL qpl::filesys::paths write(const std::string& key, const std::string& output_name, qpl::filesys::path destination_path = "", qpl::size split_size = qpl::size_max);
+  };
+
+  struct encrypted_archive_reader {
+    struct chunk {
+      qpl::u64 offset = 0u;
+      qpl::u64 encrypted_size = 0u;
+      qpl::u64 size = 0u;
+    };
+    struct file_info {
+      std::string path;
+      qpl::u64 file_size = 0u;
+      bool is_file = false;
+      std::vector<chunk> chunks;
+    };
+    struct part {
+      qpl::filesys::path path;
+      qpl::u64 offset = 0u;
+      qpl::u64 size = 0u;
+    };
+
+    std::string keyword_string_part = "CIPHER_PART";
+    qpl::aes::mode mode = qpl::aes::mode::_256;
+    qpl::size thread_count = 0u;
+
+    //path is either the single archive file or any of its parts
+    QPLDLL void open(const qpl::filesys::path& path, const std::string& key);
+    QPLDLL void clear();
+
+    QPLDLL const std::vector<file_info>& files() const;
+    QPLDLL const file_info* find(const std::string& relative_path) const;
+    QPLDLL std::string read_file(const std::string& relative_path);
+    QPLDLL qpl::filesys::path extract_file(const std::string& relative_path, qpl::filesys::path destination_path = "");
+    QPLDLL qpl::filesys::paths extract_all(qpl::filesys::path destination_path = "");
+
+  private:
+    QPLDLL std::string read_range(qpl::u64 offset, qpl::u64 size) const;
+    QPLDLL qpl::thread_pool& pool();
+    QPLDLL void write_file(const file_info& file, std::ostream& stream);
+
+    std::vector<part> m_parts;
+    //one open stream per part, opened on first use
+    mutable std::vector<std::ifstream> m_streams;
+    //kept between calls so extracting single files doesn't start and join threads every time
+    std::unique_ptr<qpl::thread_pool> m_pool;
+    qpl::size m_pool_thread_count = 0u;
+    std::vector<file_info> m_files;
+    std::unordered_map<std::string, qpl::size> m_lookup;
+    std::string m_key;
+    std::string m_salt;
+    qpl::u64 m_size = 0u;
+  };
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,786 @@
+#ifndef QPL_FLAT_HASH_MAP_HPP
+#define QPL_FLAT_HASH_MAP_HPP
+#pragma once
+
+#include <qpl/qpldeclspec.hpp>
+#include <qpl/vardef.hpp>
+#include <qpl/type_traits.hpp>
+#include <qpl/exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QPL_FLAT_HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace qpl {
+	namespace detail {
+		constexpr qpl::u64 hash_mix(qpl::u64 value) {
+			value ^= value >> 33;
+			value *= 0xff51afd7ed558ccdull;
+			value ^= value >> 33;
+			value *= 0xc4ceb9fe1a85ec53ull;
+			value ^= value >> 33;
+			return value;
+		}
+		inline qpl::u64 hash_bytes(const void* data, qpl::size size) {
+			auto bytes = static_cast<const unsigned char*>(data);
+			qpl::u64 result = 0x9e3779b97f4a7c15ull ^ (qpl::u64_cast(size) * 0xbf58476d1ce4e5b9ull);
+			while (size >= 8u) {
+				qpl::u64 word;
+				std::memcpy(&word, bytes, 8u);
+				result = std::rotl(result ^ (word * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+				bytes += 8u;
+				size -= 8u;
+			}
+			if (size) {
+				qpl::u64 word = 0u;
+				std::memcpy(&word, bytes, size);
+				result = std::rotl(result ^ (word * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+			}
+			return qpl::detail::hash_mix(result);
+		}
+
+		template<typename T>
+		struct is_hash_array : std::false_type {};
+		template<typename T, qpl::size N>
+		struct is_hash_array<std::array<T, N>> : std::true_type {};
+
+		//qpl::vectorN, qpl::matrixN and similar types that keep their elements in a std::array called data
+		template<typename T>
+		concept has_array_data = requires(const T& value) {
+			value.data;
+			requires qpl::detail::is_hash_array<std::decay_t<decltype(value.data)>>::value;
+		};
+	}
+
+	//the result is always mixed, so H1 and H2 of the flat hash tables get well distributed bits even for small integers
+	template<typename T>
+	struct hash {
+		qpl::u64 operator()(const T& value) const {
+			if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+				return qpl::detail::hash_mix(static_cast<qpl::u64>(value));
+			}
+			else if constexpr (std::is_pointer_v<T>) {
+				return qpl::detail::hash_mix(static_cast<qpl::u64>(reinterpret_cast<std::uintptr_t>(value)));
+			}
+			else if constexpr (qpl::detail::is_hash_array<T>::value) {
+				qpl::u64 result = 0x9e3779b97f4a7c15ull;
+				for (auto& element : value) {
+					result = std::rotl((result ^ qpl::hash<std::decay_t<decltype(element)>>{}(element)) * 0x9e3779b97f4a7c15ull, 29);
+				}
+				return qpl::detail::hash_mix(result);
+			}
+			else if constexpr (qpl::detail::has_array_data<T>) {
+				return qpl::hash<std::decay_t<decltype(value.data)>>{}(value.data);
+			}
+			else {
+				return qpl::detail::hash_mix(static_cast<qpl::u64>(std::hash<T>{}(value)));
+			}
+		}
+	};
+
+	//transparent: a map keyed by std::string can be searched with a std::string_view or a string literal without creating a std::string
+	template<>
+	struct hash<std::string> {
+		using is_transparent = void;
+
+		qpl::u64 operator()(std::string_view value) const {
+			return qpl::detail::hash_bytes(value.data(), value.size());
+		}
+	};
+	template<>
+	struct hash<std::string_view> : qpl::hash<std::string> {};
+
+	template<>
+	struct hash<std::wstring> {
+		using is_transparent = void;
+
+		qpl::u64 operator()(std::wstring_view value) const {
+			return qpl::detail::hash_bytes(value.data(), value.size() * sizeof(wchar_t));
+		}
+	};
+	template<>
+	struct hash<std::wstring_view> : qpl::hash<std::wstring> {};
+
+	namespace detail {
+		using hash_control = qpl::i8;
+		constexpr hash_control hash_control_empty = -128;
+		constexpr hash_control hash_control_deleted = -2;
+		constexpr hash_control hash_control_sentinel = -1;
+		constexpr qpl::size hash_group_size = 16u;
+
+		//16 control bytes that are compared at once. every result has one bit per matching byte
+		struct hash_group {
+#ifdef QPL_FLAT_HASH_SSE2
+			explicit hash_group(const hash_control* position) {
+				this->data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+			}
+			qpl::u32 match(hash_control h2) const {
+				return static_cast<qpl::u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), this->data)));
+			}
+			qpl::u32 match_empty() const {
+				return this->match(hash_control_empty);
+			}
+			qpl::u32 match_empty_or_deleted() const {
+				return static_cast<qpl::u32>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(hash_control_sentinel), this->data)));
+			}
+
+			__m128i data;
+#else
+			explicit hash_group(const hash_control* position) {
+				std::memcpy(this->data, position, sizeof(this->data));
+			}
+			qpl::u32 match(hash_control h2) const {
+				constexpr qpl::u64 lsbs = 0x0101010101010101ull;
+				auto result = 0u;
+				for (qpl::size i = 0u; i < 2u; ++i) {
+					auto x = this->data[i] ^ (lsbs * static_cast<qpl::u8>(h2));
+					result |= to_mask((x - lsbs) & ~x) << (i * 8u);
+				}
+				return result;
+			}
+			qpl::u32 match_empty() const {
+				auto result = 0u;
+				for (qpl::size i = 0u; i < 2u; ++i) {
+					result |= to_mask(this->data[i] & ~(this->data[i] << 6)) << (i * 8u);
+				}
+				return result;
+			}
+			qpl::u32 match_empty_or_deleted() const {
+				auto result = 0u;
+				for (qpl::size i = 0u; i < 2u; ++i) {
+					result |= to_mask(this->data[i] & ~(this->data[i] << 7)) << (i * 8u);
+				}
+				return result;
+			}
+
+			//gathers the top bit of every byte into the low 8 bits
+			static qpl::u32 to_mask(qpl::u64 bits) {
+				return static_cast<qpl::u32>((((bits & 0x8080808080808080ull) >> 7) * 0x0102040810204080ull) >> 56);
+			}
+
+			qpl::u64 data[2];
+#endif
+		};
+
+		//open addressing with one control byte per slot: empty, deleted or the 7 low hash bits (H2) of a full slot.
+		//the high bits (H1) pick the starting group, a lookup compares H2 against 16 control bytes at once and only
+		//touches the slots that match. capacity is always 2^n - 1, control[capacity] is a sentinel that ends iteration
+		//and the first 15 control bytes are cloned behind it, so a group can be loaded at any position.
+		//the control bytes and slots come from Allocator (rebound as needed), std::pmr::polymorphic_allocator works as usual
+		template<typename Key, typename Slot, typename Hash, typename Equal, typename Allocator = std::allocator<Slot>>
+		class flat_hash_table {
+			using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+			using slot_traits = std::allocator_traits<slot_allocator>;
+			using control_allocator = typename slot_traits::template rebind_alloc<hash_control>;
+			using control_traits = std::allocator_traits<control_allocator>;
+		public:
+			using key_type = Key;
+			using value_type = Slot;
+			using size_type = qpl::size;
+			using difference_type = std::ptrdiff_t;
+			using hasher = Hash;
+			using key_equal = Equal;
+			using allocator_type = Allocator;
+			using reference = value_type&;
+			using const_reference = const value_type&;
+
+			constexpr static bool is_set = std::is_same_v<Key, Slot>;
+
+			template<bool CONST>
+			struct iterator_t {
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = Slot;
+				using difference_type = std::ptrdiff_t;
+				using pointer = qpl::conditional<qpl::if_true<CONST || is_set>, const Slot*, Slot*>;
+				using reference = qpl::conditional<qpl::if_true<CONST || is_set>, const Slot&, Slot&>;
+
+				iterator_t() = default;
+				iterator_t(const hash_control* control, Slot* slot) : control(control), slot(slot) {
+					this->skip_free();
+				}
+				operator iterator_t<true>() const {
+					iterator_t<true> result;
+					result.control = this->control;
+					result.slot = this->slot;
+					return result;
+				}
+
+				reference operator*() const {
+					return *this->slot;
+				}
+				pointer operator->() const {
+					return this->slot;
+				}
+				iterator_t& operator++() {
+					++this->control;
+					++this->slot;
+					this->skip_free();
+					return *this;
+				}
+				iterator_t operator++(int) {
+					auto copy = *this;
+					++*this;
+					return copy;
+				}
+				bool operator==(const iterator_t& other) const {
+					return this->control == other.control;
+				}
+
+				void skip_free() {
+					while (this->control && *this->control < hash_control_sentinel) {
+						++this->control;
+						++this->slot;
+					}
+				}
+
+				const hash_control* control = nullptr;
+				Slot* slot = nullptr;
+			};
+			using iterator = iterator_t<false>;
+			using const_iterator = iterator_t<true>;
+
+			flat_hash_table() {
+
+			}
+			explicit flat_hash_table(const Allocator& allocator) : m_allocator(allocator) {
+
+			}
+			explicit flat_hash_table(qpl::size capacity, const Hash& hash = Hash{}, const Equal& equal = Equal{}, const Allocator& allocator = Allocator{}) : m_hash(hash), m_equal(equal), m_allocator(allocator) {
+				this->reserve(capacity);
+			}
+			flat_hash_table(std::initializer_list<Slot> list, const Allocator& allocator = Allocator{}) : m_allocator(allocator) {
+				this->insert(list.begin(), list.end());
+			}
+			template<std::input_iterator I>
+			flat_hash_table(I first, I last, const Allocator& allocator = Allocator{}) : m_allocator(allocator) {
+				this->insert(first, last);
+			}
+			flat_hash_table(const flat_hash_table& other) : m_hash(other.m_hash), m_equal(other.m_equal), m_allocator(slot_traits::select_on_container_copy_construction(other.m_allocator)) {
+				this->reserve(other.size());
+				this->insert(other.begin(), other.end());
+			}
+			flat_hash_table(flat_hash_table&& other) noexcept : m_hash(std::move(other.m_hash)), m_equal(std::move(other.m_equal)), m_allocator(std::move(other.m_allocator)) {
+				this->take(other);
+			}
+			~flat_hash_table() {
+				this->destroy();
+			}
+
+			flat_hash_table& operator=(const flat_hash_table& other) {
+				if (this != &other) {
+					if constexpr (slot_traits::propagate_on_container_copy_assignment::value) {
+						if (this->m_allocator != other.m_allocator) {
+							this->destroy();
+						}
+						this->m_allocator = other.m_allocator;
+					}
+					this->clear();
+					this->m_hash = other.m_hash;
+					this->m_equal = other.m_equal;
+					this->reserve(other.size());
+					this->insert(other.begin(), other.end());
+				}
+				return *this;
+			}
+			flat_hash_table& operator=(flat_hash_table&& other) noexcept(slot_traits::propagate_on_container_move_assignment::value || slot_traits::is_always_equal::value) {
+				if (this == &other) {
+					return *this;
+				}
+				this->m_hash = std::move(other.m_hash);
+				this->m_equal = std::move(other.m_equal);
+				if constexpr (slot_traits::propagate_on_container_move_assignment::value) {
+					this->destroy();
+					this->m_allocator = std::move(other.m_allocator);
+					this->take(other);
+				}
+				else if (this->m_allocator == other.m_allocator) {
+					this->destroy();
+					this->take(other);
+				}
+				else {
+					//the memory can't change hands, so the elements are moved one by one
+					this->clear();
+					this->reserve(other.size());
+					for (qpl::size i = 0u; i < other.m_capacity; ++i) {
+						if (other.m_control[i] >= 0) {
+							this->insert(std::move(other.m_slots[i]));
+						}
+					}
+					other.clear();
+				}
+				return *this;
+			}
+			allocator_type get_allocator() const {
+				return allocator_type(this->m_allocator);
+			}
+
+			iterator begin() {
+				return iterator(this->m_control, this->m_slots);
+			}
+			const_iterator begin() const {
+				return const_iterator(this->m_control, this->m_slots);
+			}
+			const_iterator cbegin() const {
+				return this->begin();
+			}
+			iterator end() {
+				return iterator(this->m_control + this->m_capacity, this->m_slots + this->m_capacity);
+			}
+			const_iterator end() const {
+				return const_iterator(this->m_control + this->m_capacity, this->m_slots + this->m_capacity);
+			}
+			const_iterator cend() const {
+				return this->end();
+			}
+
+			qpl::size size() const {
+				return this->m_size;
+			}
+			bool empty() const {
+				return this->m_size == 0u;
+			}
+			qpl::size capacity() const {
+				return this->m_capacity;
+			}
+			qpl::f64 load_factor() const {
+				return this->m_capacity ? static_cast<qpl::f64>(this->m_size) / this->m_capacity : 0.0;
+			}
+			hasher hash_function() const {
+				return this->m_hash;
+			}
+			key_equal key_eq() const {
+				return this->m_equal;
+			}
+
+			void clear() {
+				if (!this->m_capacity) {
+					return;
+				}
+				for (qpl::size i = 0u; i < this->m_capacity; ++i) {
+					if (this->m_control[i] >= 0) {
+						slot_traits::destroy(this->m_allocator, this->m_slots + i);
+					}
+				}
+				this->m_size = 0u;
+				this->reset_control();
+			}
+			//makes room for size elements without rehashing
+			void reserve(qpl::size size) {
+				if (size > max_load(this->m_capacity)) {
+					auto capacity = qpl::size{ hash_group_size - 1 };
+					while (max_load(capacity) < size) {
+						capacity = capacity * 2u + 1u;
+					}
+					this->rehash(capacity);
+				}
+			}
+
+			template<typename K>
+			iterator find(const K& key) {
+				auto index = this->find_index(key);
+				return index == npos ? this->end() : this->iterator_at(index);
+			}
+			template<typename K>
+			const_iterator find(const K& key) const {
+				auto index = this->find_index(key);
+				return index == npos ? this->end() : this->iterator_at(index);
+			}
+			template<typename K>
+			bool contains(const K& key) const {
+				return this->find_index(key) != npos;
+			}
+			template<typename K>
+			qpl::size count(const K& key) const {
+				return this->contains(key) ? 1u : 0u;
+			}
+
+			std::pair<iterator, bool> insert(const Slot& value) {
+				return this->emplace_slot(key_of(value), value);
+			}
+			std::pair<iterator, bool> insert(Slot&& value) {
+				return this->emplace_slot(key_of(value), std::move(value));
+			}
+			template<std::input_iterator I>
+			void insert(I first, I last) {
+				if constexpr (std::forward_iterator<I>) {
+					this->reserve(this->m_size + qpl::size_cast(std::distance(first, last)));
+				}
+				for (; first != last; ++first) {
+					this->insert(*first);
+				}
+			}
+			void insert(std::initializer_list<Slot> list) {
+				this->insert(list.begin(), list.end());
+			}
+			template<typename... Args>
+			std::pair<iterator, bool> emplace(Args&&... args) {
+				Slot value(std::forward<Args>(args)...);
+				return this->emplace_slot(key_of(value), std::move(value));
+			}
+
+			template<typename K>
+			qpl::size erase(const K& key) {
+				auto index = this->find_index(key);
+				if (index == npos) {
+					return 0u;
+				}
+				this->erase_index(index);
+				return 1u;
+			}
+			iterator erase(const_iterator position) {
+				auto index = qpl::size_cast(position.control - this->m_control);
+				this->erase_index(index);
+				return this->iterator_at(index + 1);
+			}
+			iterator erase(iterator position) {
+				return this->erase(const_iterator(position));
+			}
+
+			void swap(flat_hash_table& other) noexcept {
+				std::swap(this->m_control, other.m_control);
+				std::swap(this->m_slots, other.m_slots);
+				std::swap(this->m_capacity, other.m_capacity);
+				std::swap(this->m_size, other.m_size);
+				std::swap(this->m_growth_left, other.m_growth_left);
+				std::swap(this->m_hash, other.m_hash);
+				std::swap(this->m_equal, other.m_equal);
+				if constexpr (slot_traits::propagate_on_container_swap::value) {
+					std::swap(this->m_allocator, other.m_allocator);
+				}
+			}
+
+		protected:
+			constexpr static qpl::size npos = ~qpl::size{};
+			constexpr static qpl::size cloned_bytes = hash_group_size - 1;
+
+			static const Key& key_of(const Slot& slot) {
+				if constexpr (is_set) {
+					return slot;
+				}
+				else {
+					return slot.first;
+				}
+			}
+			//a lookup with another type than Key needs a transparent hash and equal, otherwise it's converted to Key first
+			template<typename K>
+			static constexpr bool is_heterogeneous() {
+				return requires { typename Hash::is_transparent; typename Equal::is_transparent; };
+			}
+			template<typename K>
+			static decltype(auto) lookup_key(const K& key) {
+				if constexpr (std::is_same_v<K, Key> || is_heterogeneous<K>()) {
+					return (key);
+				}
+				else {
+					return Key(key);
+				}
+			}
+
+			//7/8 maximum load factor
+			static qpl::size max_load(qpl::size capacity) {
+				return capacity - capacity / 8u;
+			}
+			static hash_control h2(qpl::u64 hash) {
+				return static_cast<hash_control>(hash & 0x7Fu);
+			}
+			qpl::size h1(qpl::u64 hash) const {
+				return qpl::size_cast(hash >> 7) & this->m_capacity;
+			}
+
+			iterator iterator_at(qpl::size index) {
+				return iterator(this->m_control + index, this->m_slots + index);
+			}
+			const_iterator iterator_at(qpl::size index) const {
+				return const_iterator(this->m_control + index, this->m_slots + index);
+			}
+
+			template<typename K>
+			qpl::size find_index(const K& key) const {
+				if (!this->m_size) {
+					return npos;
+				}
+				decltype(auto) lookup = lookup_key(key);
+				auto hash = static_cast<qpl::u64>(this->m_hash(lookup));
+				return this->find_index(lookup, hash);
+			}
+			template<typename K>
+			qpl::size find_index(const K& key, qpl::u64 hash) const {
+				auto control = h2(hash);
+				auto position = this->h1(hash);
+				qpl::size step = 0u;
+				while (true) {
+					hash_group group(this->m_control + position);
+					for (auto bits = group.match(control); bits; bits &= bits - 1) {
+						auto index = (position + std::countr_zero(bits)) & this->m_capacity;
+						if (this->m_equal(key_of(this->m_slots[index]), key)) {
+							return index;
+						}
+					}
+					if (group.match_empty()) {
+						return npos;
+					}
+					step += hash_group_size;
+					position = (position + step) & this->m_capacity;
+				}
+			}
+			qpl::size find_free(qpl::u64 hash) const {
+				auto position = this->h1(hash);
+				qpl::size step = 0u;
+				while (true) {
+					hash_group group(this->m_control + position);
+					auto bits = group.match_empty_or_deleted();
+					if (bits) {
+						return (position + std::countr_zero(bits)) & this->m_capacity;
+					}
+					step += hash_group_size;
+					position = (position + step) & this->m_capacity;
+				}
+			}
+
+			//returns the slot index for key and whether it is still unconstructed. the caller has to construct it
+			template<typename K>
+			std::pair<qpl::size, bool> prepare_insert(const K& key) {
+				auto hash = static_cast<qpl::u64>(this->m_hash(key));
+				if (this->m_size) {
+					auto index = this->find_index(key, hash);
+					if (index != npos) {
+						return std::make_pair(index, false);
+					}
+				}
+				if (!this->m_growth_left) {
+					//mostly tombstones: rebuild at the same capacity instead of growing
+					if (this->m_capacity && this->m_size * 32u <= this->m_capacity * 25u) {
+						this->rehash(this->m_capacity);
+					}
+					else {
+						this->rehash(this->m_capacity ? this->m_capacity * 2u + 1u : hash_group_size - 1);
+					}
+				}
+				auto index = this->find_free(hash);
+				if (this->m_control[index] == hash_control_empty) {
+					--this->m_growth_left;
+				}
+				this->set_control(index, h2(hash));
+				++this->m_size;
+				return std::make_pair(index, true);
+			}
+			template<typename K, typename... Args>
+			std::pair<iterator, bool> emplace_slot(const K& key, Args&&... args) {
+				auto [index, inserted] = this->prepare_insert(key);
+				if (inserted) {
+					this->construct_at(index, std::forward<Args>(args)...);
+				}
+				return std::make_pair(this->iterator_at(index), inserted);
+			}
+			template<typename... Args>
+			void construct_at(qpl::size index, Args&&... args) {
+				try {
+					slot_traits::construct(this->m_allocator, this->m_slots + index, std::forward<Args>(args)...);
+				}
+				catch (...) {
+					this->set_control(index, hash_control_deleted);
+					--this->m_size;
+					throw;
+				}
+			}
+
+			void set_control(qpl::size index, hash_control control) {
+				this->m_control[index] = control;
+				this->m_control[((index - cloned_bytes) & this->m_capacity) + (cloned_bytes & this->m_capacity)] = control;
+			}
+			void erase_index(qpl::size index) {
+				slot_traits::destroy(this->m_allocator, this->m_slots + index);
+				--this->m_size;
+
+				//if there has never been a full group around this slot no probe sequence went past it, so it can become empty again
+				auto before = (index - hash_group_size) & this->m_capacity;
+				auto empty_after = hash_group(this->m_control + index).match_empty();
+				auto empty_before = hash_group(this->m_control + before).match_empty();
+				bool was_never_full = empty_before && empty_after &&
+					qpl::size_cast(std::countr_zero(empty_after) + std::countl_zero(static_cast<qpl::u16>(empty_before))) < hash_group_size;
+
+				if (was_never_full) {
+					this->set_control(index, hash_control_empty);
+					++this->m_growth_left;
+				}
+				else {
+					this->set_control(index, hash_control_deleted);
+				}
+			}
+
+			void reset_control() {
+				std::fill_n(this->m_control, this->m_capacity + 1u + cloned_bytes, hash_control_empty);
+				this->m_control[this->m_capacity] = hash_control_sentinel;
+				this->m_growth_left = max_load(this->m_capacity) - this->m_size;
+			}
+			void rehash(qpl::size capacity) {
+				auto old_control = this->m_control;
+				auto old_slots = this->m_slots;
+				auto old_capacity = this->m_capacity;
+
+				control_allocator controls(this->m_allocator);
+				this->m_control = control_traits::allocate(controls, capacity + 1u + cloned_bytes);
+				try {
+					this->m_slots = slot_traits::allocate(this->m_allocator, capacity);
+				}
+				catch (...) {
+					control_traits::deallocate(controls, this->m_control, capacity + 1u + cloned_bytes);
+					this->m_control = old_control;
+					this->m_slots = old_slots;
+					throw;
+				}
+				this->m_capacity = capacity;
+				this->reset_control();
+
+				for (qpl::size i = 0u; i < old_capacity; ++i) {
+					if (old_control[i] >= 0) {
+						auto hash = static_cast<qpl::u64>(this->m_hash(key_of(old_slots[i])));
+						auto index = this->find_free(hash);
+						this->set_control(index, h2(hash));
+						slot_traits::construct(this->m_allocator, this->m_slots + index, std::move(old_slots[i]));
+						slot_traits::destroy(this->m_allocator, old_slots + i);
+					}
+				}
+				this->m_growth_left = max_load(capacity) - this->m_size;
+
+				if (old_capacity) {
+					control_traits::deallocate(controls, old_control, old_capacity + 1u + cloned_bytes);
+					slot_traits::deallocate(this->m_allocator, old_slots, old_capacity);
+				}
+			}
+			void destroy() {
+				if (!this->m_capacity) {
+					return;
+				}
+				this->clear();
+				control_allocator controls(this->m_allocator);
+				control_traits::deallocate(controls, this->m_control, this->m_capacity + 1u + cloned_bytes);
+				slot_traits::deallocate(this->m_allocator, this->m_slots, this->m_capacity);
+				this->m_control = nullptr;
+				this->m_slots = nullptr;
+				this->m_capacity = 0u;
+				this->m_growth_left = 0u;
+			}
+			void take(flat_hash_table& other) {
+				this->m_control = std::exchange(other.m_control, nullptr);
+				this->m_slots = std::exchange(other.m_slots, nullptr);
+				this->m_capacity = std::exchange(other.m_capacity, 0u);
+				this->m_size = std::exchange(other.m_size, 0u);
+				this->m_growth_left = std::exchange(other.m_growth_left, 0u);
+			}
+
+			hash_control* m_control = nullptr;
+			Slot* m_slots = nullptr;
+			qpl::size m_capacity = 0u;
+			qpl::size m_size = 0u;
+			qpl::size m_growth_left = 0u;
+			Hash m_hash;
+			Equal m_equal;
+			slot_allocator m_allocator;
+		};
+	}
+
+	//SwissTable style open addressing hash map, the elements are stored inline in one array.
+	//unlike std::unordered_map, references and iterators are invalidated when the map grows
+	template<typename K, typename V, typename Hash = qpl::hash<K>, typename Equal = std::equal_to<>, typename Allocator = std::allocator<std::pair<const K, V>>>
+	class flat_hash_map : public qpl::detail::flat_hash_table<K, std::pair<const K, V>, Hash, Equal, Allocator> {
+		using base = qpl::detail::flat_hash_table<K, std::pair<const K, V>, Hash, Equal, Allocator>;
+	public:
+		using mapped_type = V;
+		using typename base::iterator;
+		using typename base::const_iterator;
+		using base::base;
+
+		flat_hash_map() {
+
+		}
+		flat_hash_map(std::initializer_list<std::pair<const K, V>> list, const Allocator& allocator = Allocator{}) : base(list, allocator) {
+
+		}
+
+		template<typename L, typename... Args>
+		std::pair<iterator, bool> try_emplace(L&& key, Args&&... args) {
+			decltype(auto) lookup = base::lookup_key(key);
+			auto [index, inserted] = this->prepare_insert(lookup);
+			if (inserted) {
+				this->construct_at(index, std::piecewise_construct, std::forward_as_tuple(std::forward<L>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			}
+			return std::make_pair(this->iterator_at(index), inserted);
+		}
+		template<typename L, typename M>
+		std::pair<iterator, bool> insert_or_assign(L&& key, M&& value) {
+			auto result = this->try_emplace(std::forward<L>(key), std::forward<M>(value));
+			if (!result.second) {
+				result.first->second = std::forward<M>(value);
+			}
+			return result;
+		}
+
+		V& operator[](const K& key) {
+			return this->try_emplace(key).first->second;
+		}
+		V& operator[](K&& key) {
+			return this->try_emplace(std::move(key)).first->second;
+		}
+		template<typename L> requires (!std::is_same_v<std::decay_t<L>, K> && base::template is_heterogeneous<L>() && std::is_constructible_v<K, L>)
+		V& operator[](L&& key) {
+			return this->try_emplace(std::forward<L>(key)).first->second;
+		}
+
+		template<typename L>
+		V& at(const L& key) {
+			auto index = this->find_index(key);
+			if (index == base::npos) {
+				throw qpl::exception("qpl::flat_hash_map::at: key not found");
+			}
+			return this->m_slots[index].second;
+		}
+		template<typename L>
+		const V& at(const L& key) const {
+			auto index = this->find_index(key);
+			if (index == base::npos) {
+				throw qpl::exception("qpl::flat_hash_map::at: key not found");
+			}
+			return this->m_slots[index].second;
+		}
+	};
+
+	//SwissTable style open addressing hash set, see qpl::flat_hash_map
+	template<typename K, typename Hash = qpl::hash<K>, typename Equal = std::equal_to<>, typename Allocator = std::allocator<K>>
+	class flat_hash_set : public qpl::detail::flat_hash_table<K, K, Hash, Equal, Allocator> {
+		using base = qpl::detail::flat_hash_table<K, K, Hash, Equal, Allocator>;
+	public:
+		using base::base;
+
+		flat_hash_set() {
+
+		}
+		flat_hash_set(std::initializer_list<K> list, const Allocator& allocator = Allocator{}) : base(list, allocator) {
+
+		}
+	};
+
+	namespace pmr {
+		//flat hash tables backed by a std::pmr::memory_resource, e.g. qpl::arena_resource or qpl::pool_resource
+		template<typename K, typename V, typename Hash = qpl::hash<K>, typename Equal = std::equal_to<>>
+		using flat_hash_map = qpl::flat_hash_map<K, V, Hash, Equal, std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+		template<typename K, typename Hash = qpl::hash<K>, typename Equal = std::equal_to<>>
+		using flat_hash_set = qpl::flat_hash_set<K, Hash, Equal, std::pmr::polymorphic_allocator<K>>;
+	}
+}
+
+#endif
@@ -6,114 +6,110 @@
 #include <qpl/vardef.hpp>
 #include <qpl/string.hpp>
 #include <qpl/bits.hpp>
+#include <qpl/exception.hpp>
+#include <qpl/thread_pool.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
 #include <cmath>
+#include <deque>
+#include <span>
 #include <sstream>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace qpl {
 
+	//deterministic Miller-Rabin (7 fixed bases), exact for every 64 bit value
+	QPLDLL bool is_prime_u64(qpl::u64 value);
+
+	//cache blocked segmented sieve of eratosthenes over [begin, end). only odd numbers are stored and multiples of 3, 5, 7, 11 and 13
+	//are copied in from a pre-sieved wheel pattern. segments run on qpl::default_thread_pool()
+	QPLDLL std::vector<qpl::u64> sieve_primes(qpl::u64 begin, qpl::u64 end);
+	QPLDLL qpl::size count_primes(qpl::u64 begin, qpl::u64 end);
+
+	//trial division by small primes, then pollard rho (brent). factors are sorted ascending
+	QPLDLL std::vector<qpl::u64> factorize(qpl::u64 value);
+
 	template<typename T>
 	bool is_prime(T value) {
-		if (value <= 7u) {
-			return value == 2u || value == 3u || value == 5u || value == 7u;
-		}
-		if (value % 2u == 0u || value % 3u == 0u) {
-			return false;
+		if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(qpl::u64)) {
+			if (value < T{ 2 }) {
+				return false;
+			}
+			return qpl::is_prime_u64(static_cast<qpl::u64>(value));
 		}
-
-		qpl::u32 add = 4u;
-		auto sqrt = std::sqrt(value);
-		for (qpl::u32 i = 5u; i <= sqrt; i += add) {
-			if (value % i == 0) {
+		else {
+			if (value <= 7u) {
+				return value == 2u || value == 3u || value == 5u || value == 7u;
+			}
+			if (value % 2u == 0u || value % 3u == 0u) {
 				return false;
 			}
 
-			add = 6u - add;
+			qpl::u32 add = 4u;
+			auto sqrt = std::sqrt(value);
+			for (qpl::u32 i = 5u; i <= sqrt; i += add) {
+				if (value % i == 0) {
+					return false;
+				}
+
+				add = 6u - add;
+			}
+			return true;
 		}
-		return true;
 	}
 
 	template<typename T>
 	std::vector<T> prime_factors(T value) {
-		if (qpl::is_prime(value)) {
-			return { value };
-		}
-		std::vector<T> result;
-
-		for (T i = 2; value > T{ 1 }; ++i) {
-			if (qpl::is_prime(i)) {
-				while (value % i == T{}) {
-					result.push_back(i);
-					value /= i;
-				}
+		if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(qpl::u64)) {
+			if (value < T{ 2 }) {
+				return {};
 			}
+			auto factors = qpl::factorize(static_cast<qpl::u64>(value));
+			return std::vector<T>(factors.cbegin(), factors.cend());
 		}
-		return result;
-	}
-	template<typename T, qpl::size N>
-	std::array<T, N> generate_primes() {
-		if (N == 1u) {
-			return { T{ 2u } };
-		}
-		else if (N == 2u) {
-			return { T{ 2u }, T{ 3u } };
-		}
-
-		std::array<T, N> primes;
-		primes[0u] = 2u;
-		primes[1u] = 3u;
-		primes[2u] = 5u;
+		else {
+			if (qpl::is_prime(value)) {
+				return { value };
+			}
+			std::vector<T> result;
 
-		qpl::size ctr = 3u;
-		qpl::size add = 4u;
-		for (qpl::size n = 5u; ctr < N; n += add) {
-			bool is_prime = true;
-			for (qpl::size p = 0u; p < ctr; ++p) {
-				if (n % primes[p] == 0) {
-					is_prime = false;
-					break;
+			for (T i = 2; value > T{ 1 }; ++i) {
+				if (qpl::is_prime(i)) {
+					while (value % i == T{}) {
+						result.push_back(i);
+						value /= i;
+					}
 				}
 			}
-			if (is_prime) {
-				primes[ctr] = n;
-				++ctr;
-			}
-			add = 6u - add;
+			return result;
 		}
-		return primes;
 	}
+	//the n-th prime is below n * (ln n + ln ln n) for n >= 6, so a single sieve pass covers the request
 	template<typename T>
 	std::vector<T> generate_primes(qpl::size size) {
-		if (size == 1u) {
-			return { 2u };
+		if (size == 0u) {
+			return {};
 		}
-		else if (size == 2u) {
-			return { 2u, 3u };
+		qpl::u64 bound = 15u;
+		if (size >= 6u) {
+			auto n = static_cast<qpl::f64>(size);
+			bound = static_cast<qpl::u64>(n * (std::log(n) + std::log(std::log(n)))) + 1u;
 		}
-
-		std::vector<T> primes(size);
-		primes[0u] = 2u;
-		primes[1u] = 3u;
-		primes[2u] = 5u;
-
-		qpl::size ctr = 3u;
-		qpl::u32 add = 4u;
-		for (qpl::size n = 5u; ctr < size; n += add) {
-			bool is_prime = true;
-			for (qpl::size p = 0u; p < ctr; ++p) {
-				if (n % primes[p] == 0) {
-					is_prime = false;
-					break;
-				}
-			}
-			if (is_prime) {
-				primes[ctr] = n;
-				++ctr;
-			}
-			add = 6u - add;
-		}
-		return primes;
+		auto primes = qpl::sieve_primes(0u, bound);
+		primes.resize(size);
+		return std::vector<T>(primes.cbegin(), primes.cend());
+	}
+	template<typename T, qpl::size N>
+	std::array<T, N> generate_primes() {
+		auto primes = qpl::generate_primes<T>(N);
+		std::array<T, N> result;
+		std::copy(primes.cbegin(), primes.cend(), result.begin());
+		return result;
 	}
 
 	template<typename T>
@@ -161,6 +157,451 @@ namespace qpl {
 		return n * (n + T{ 1 }) / T{ 2 };
 	}
 
+	//relative error quantile sketch with logarithmic buckets: a reported quantile is within relative_accuracy of a value in the data.
+	//values can be removed again, so the sketch can follow a sliding window
+	template<typename T>
+	struct quantile_sketch {
+		quantile_sketch(qpl::f64 relative_accuracy = 0.01) {
+			this->set_relative_accuracy(relative_accuracy);
+		}
+
+		void set_relative_accuracy(qpl::f64 relative_accuracy) {
+			this->m_relative_accuracy = qpl::clamp(1e-6, relative_accuracy, 0.5);
+			this->m_gamma = (1.0 + this->m_relative_accuracy) / (1.0 - this->m_relative_accuracy);
+			this->m_log_gamma = std::log(this->m_gamma);
+			this->clear();
+		}
+		qpl::f64 relative_accuracy() const {
+			return this->m_relative_accuracy;
+		}
+		void clear() {
+			this->m_positive = {};
+			this->m_negative = {};
+			this->m_zeros = 0u;
+			this->m_count = 0u;
+		}
+		void add(T value) {
+			this->update(static_cast<qpl::f64>(value), true);
+		}
+		void remove(T value) {
+			this->update(static_cast<qpl::f64>(value), false);
+		}
+		qpl::size size() const {
+			return this->m_count;
+		}
+		bool empty() const {
+			return this->m_count == 0u;
+		}
+
+		//q in [0, 1]
+		T quantile(qpl::f64 q) const {
+			if (this->empty()) {
+				return T{ 0 };
+			}
+			auto rank = static_cast<qpl::u64>(qpl::clamp(0.0, q, 1.0) * static_cast<qpl::f64>(this->m_count - 1u));
+			qpl::u64 seen = 0u;
+			for (auto i = this->m_negative.counts.size(); i-- > 0u;) {
+				seen += this->m_negative.counts[i];
+				if (seen > rank) {
+					return static_cast<T>(-this->bucket_value(this->m_negative.offset + qpl::i32_cast(i)));
+				}
+			}
+			seen += this->m_zeros;
+			if (seen > rank) {
+				return T{ 0 };
+			}
+			for (qpl::size i = 0u; i < this->m_positive.counts.size(); ++i) {
+				seen += this->m_positive.counts[i];
+				if (seen > rank) {
+					return static_cast<T>(this->bucket_value(this->m_positive.offset + qpl::i32_cast(i)));
+				}
+			}
+			return static_cast<T>(this->bucket_value(this->m_positive.offset + qpl::i32_cast(this->m_positive.counts.size()) - 1));
+		}
+
+	private:
+		struct buckets {
+			std::vector<qpl::u64> counts;
+			qpl::i32 offset = 0;
+
+			bool change(qpl::i32 key, bool insert) {
+				if (this->counts.empty()) {
+					if (!insert) {
+						return false;
+					}
+					this->offset = key;
+				}
+				if (key < this->offset) {
+					if (!insert) {
+						return false;
+					}
+					this->counts.insert(this->counts.begin(), qpl::size_cast(this->offset - key), 0u);
+					this->offset = key;
+				}
+				auto index = qpl::size_cast(key - this->offset);
+				if (index >= this->counts.size()) {
+					if (!insert) {
+						return false;
+					}
+					this->counts.resize(index + 1u);
+				}
+				if (insert) {
+					++this->counts[index];
+				}
+				else if (this->counts[index]) {
+					--this->counts[index];
+				}
+				else {
+					return false;
+				}
+				return true;
+			}
+		};
+
+		//magnitudes below this share the zero bucket, which keeps the bucket range bounded
+		constexpr static qpl::f64 minimum_magnitude = 1e-9;
+
+		qpl::i32 bucket_key(qpl::f64 magnitude) const {
+			return static_cast<qpl::i32>(std::ceil(std::log(magnitude) / this->m_log_gamma));
+		}
+		qpl::f64 bucket_value(qpl::i32 key) const {
+			return 2.0 * std::pow(this->m_gamma, key) / (this->m_gamma + 1.0);
+		}
+		void update(qpl::f64 value, bool insert) {
+			bool changed;
+			if (value > minimum_magnitude) {
+				changed = this->m_positive.change(this->bucket_key(value), insert);
+			}
+			else if (value < -minimum_magnitude) {
+				changed = this->m_negative.change(this->bucket_key(-value), insert);
+			}
+			else {
+				changed = insert || this->m_zeros;
+				if (changed) {
+					insert ? ++this->m_zeros : --this->m_zeros;
+				}
+			}
+			if (changed) {
+				insert ? ++this->m_count : --this->m_count;
+			}
+		}
+
+		buckets m_positive;
+		buckets m_negative;
+		qpl::u64 m_zeros = 0u;
+		qpl::u64 m_count = 0u;
+		qpl::f64 m_relative_accuracy = 0.01;
+		qpl::f64 m_gamma = 1.0;
+		qpl::f64 m_log_gamma = 0.0;
+	};
+
+	//statistics over the last window() values. mean / variance use welford updates that swap the evicted value for the new one,
+	//they are recomputed from the stored window once per window() evictions so rounding can't drift. min / max come from monotonic deques.
+	//a quantile_accuracy of 0 turns the quantile sketch off
+	template<typename T>
+	struct windowed_statistics {
+		windowed_statistics(qpl::size window = 5u, qpl::f64 quantile_accuracy = 0.01) : m_sketch(quantile_accuracy), m_quantiles(quantile_accuracy > 0.0) {
+			this->set_window(window);
+		}
+
+		void set_window(qpl::size window) {
+			this->m_values.resize(qpl::max(window, qpl::size{ 1u }));
+			this->clear();
+		}
+		qpl::size window() const {
+			return this->m_values.size();
+		}
+		void clear() {
+			this->m_head = 0u;
+			this->m_count = 0u;
+			this->m_evictions = 0u;
+			this->m_sequence = 0u;
+			this->m_mean = 0.0;
+			this->m_m2 = 0.0;
+			this->m_minimum.clear();
+			this->m_maximum.clear();
+			this->m_sketch.clear();
+		}
+		qpl::size size() const {
+			return this->m_count;
+		}
+		bool empty() const {
+			return this->m_count == 0u;
+		}
+		bool full() const {
+			return this->m_count == this->window();
+		}
+
+		void add(T value) {
+			auto x = static_cast<qpl::f64>(value);
+			if (this->full()) {
+				auto evicted = this->m_values[this->m_head];
+				this->m_values[this->m_head] = value;
+				this->m_head = (this->m_head + 1u) % this->window();
+				if (this->m_quantiles) {
+					this->m_sketch.remove(evicted);
+				}
+
+				auto y = static_cast<qpl::f64>(evicted);
+				auto old_mean = this->m_mean;
+				this->m_mean += (x - y) / static_cast<qpl::f64>(this->m_count);
+				this->m_m2 += (x - y) * (x - this->m_mean + y - old_mean);
+
+				++this->m_evictions;
+				if (this->m_evictions >= this->window()) {
+					this->recompute();
+				}
+			}
+			else {
+				this->m_values[(this->m_head + this->m_count) % this->window()] = value;
+				++this->m_count;
+				auto delta = x - this->m_mean;
+				this->m_mean += delta / static_cast<qpl::f64>(this->m_count);
+				this->m_m2 += delta * (x - this->m_mean);
+			}
+			this->m_m2 = qpl::max(this->m_m2, 0.0);
+			if (this->m_quantiles) {
+				this->m_sketch.add(value);
+			}
+
+			while (!this->m_minimum.empty() && !(this->m_minimum.back().second < value)) {
+				this->m_minimum.pop_back();
+			}
+			this->m_minimum.emplace_back(this->m_sequence, value);
+			while (!this->m_maximum.empty() && !(value < this->m_maximum.back().second)) {
+				this->m_maximum.pop_back();
+			}
+			this->m_maximum.emplace_back(this->m_sequence, value);
+
+			++this->m_sequence;
+			auto oldest = this->m_sequence - this->m_count;
+			while (this->m_minimum.front().first < oldest) {
+				this->m_minimum.pop_front();
+			}
+			while (this->m_maximum.front().first < oldest) {
+				this->m_maximum.pop_front();
+			}
+		}
+
+		qpl::f64 sum() const {
+			return this->m_mean * static_cast<qpl::f64>(this->m_count);
+		}
+		qpl::f64 mean() const {
+			return this->m_mean;
+		}
+		//population variance, sample_variance divides by size() - 1
+		qpl::f64 variance() const {
+			return this->m_count ? this->m_m2 / static_cast<qpl::f64>(this->m_count) : 0.0;
+		}
+		qpl::f64 sample_variance() const {
+			return this->m_count > 1u ? this->m_m2 / static_cast<qpl::f64>(this->m_count - 1u) : 0.0;
+		}
+		qpl::f64 standard_deviation() const {
+			return std::sqrt(this->variance());
+		}
+		T min() const {
+			return this->empty() ? T{} : this->m_minimum.front().second;
+		}
+		T max() const {
+			return this->empty() ? T{} : this->m_maximum.front().second;
+		}
+		//approximate, within the relative accuracy of the sketch
+		T quantile(qpl::f64 q) const {
+			return this->m_sketch.quantile(q);
+		}
+		T median() const {
+			return this->quantile(0.5);
+		}
+
+	private:
+		void recompute() {
+			this->m_evictions = 0u;
+			qpl::f64 mean = 0.0;
+			qpl::f64 m2 = 0.0;
+			for (qpl::size i = 0u; i < this->m_count; ++i) {
+				auto x = static_cast<qpl::f64>(this->m_values[i]);
+				auto delta = x - mean;
+				mean += delta / static_cast<qpl::f64>(i + 1u);
+				m2 += delta * (x - mean);
+			}
+			this->m_mean = mean;
+			this->m_m2 = m2;
+		}
+
+		std::vector<T> m_values;
+		qpl::size m_head = 0u;
+		qpl::size m_count = 0u;
+		qpl::size m_evictions = 0u;
+		qpl::u64 m_sequence = 0u;
+		qpl::f64 m_mean = 0.0;
+		qpl::f64 m_m2 = 0.0;
+		std::deque<std::pair<qpl::u64, T>> m_minimum;
+		std::deque<std::pair<qpl::u64, T>> m_maximum;
+		quantile_sketch<T> m_sketch;
+		bool m_quantiles = true;
+	};
+
+	//windowed_statistics for many series that receive their samples together. values are stored one row per time step,
+	//so add() runs the mean / variance update as one loop across all series
+	template<typename T>
+	struct windowed_statistics_columns {
+		windowed_statistics_columns(qpl::size series = 0u, qpl::size window = 5u) {
+			this->resize(series, window);
+		}
+
+		void resize(qpl::size series, qpl::size window) {
+			this->m_series = series;
+			this->m_window = qpl::max(window, qpl::size{ 1u });
+			this->m_values.resize(this->m_series * this->m_window);
+			this->m_mean.resize(this->m_series);
+			this->m_m2.resize(this->m_series);
+			this->m_minimum.resize(this->m_series);
+			this->m_maximum.resize(this->m_series);
+			this->clear();
+		}
+		void clear() {
+			this->m_head = 0u;
+			this->m_count = 0u;
+			this->m_evictions = 0u;
+			this->m_sequence = 0u;
+			std::fill(this->m_mean.begin(), this->m_mean.end(), 0.0);
+			std::fill(this->m_m2.begin(), this->m_m2.end(), 0.0);
+			for (qpl::size i = 0u; i < this->m_series; ++i) {
+				this->m_minimum[i].clear();
+				this->m_maximum[i].clear();
+			}
+		}
+		qpl::size series() const {
+			return this->m_series;
+		}
+		qpl::size window() const {
+			return this->m_window;
+		}
+		qpl::size size() const {
+			return this->m_count;
+		}
+		bool full() const {
+			return this->m_count == this->m_window;
+		}
+
+		//one sample per series
+		void add(std::span<const T> samples) {
+			if (samples.size() != this->m_series) {
+				throw qpl::exception("windowed_statistics_columns::add: ", samples.size(), " samples for ", this->m_series, " series");
+			}
+			auto mean = this->m_mean.data();
+			auto m2 = this->m_m2.data();
+			if (this->full()) {
+				auto row = this->m_values.data() + this->m_head * this->m_series;
+				auto n = static_cast<qpl::f64>(this->m_count);
+				for (qpl::size i = 0u; i < this->m_series; ++i) {
+					auto x = static_cast<qpl::f64>(samples[i]);
+					auto y = static_cast<qpl::f64>(row[i]);
+					auto old_mean = mean[i];
+					mean[i] += (x - y) / n;
+					m2[i] += (x - y) * (x - mean[i] + y - old_mean);
+					m2[i] = m2[i] < 0.0 ? 0.0 : m2[i];
+					row[i] = samples[i];
+				}
+				this->m_head = (this->m_head + 1u) % this->m_window;
+				++this->m_evictions;
+			}
+			else {
+				auto row = this->m_values.data() + ((this->m_head + this->m_count) % this->m_window) * this->m_series;
+				++this->m_count;
+				auto n = static_cast<qpl::f64>(this->m_count);
+				for (qpl::size i = 0u; i < this->m_series; ++i) {
+					auto x = static_cast<qpl::f64>(samples[i]);
+					auto delta = x - mean[i];
+					mean[i] += delta / n;
+					m2[i] += delta * (x - mean[i]);
+					row[i] = samples[i];
+				}
+			}
+			if (this->m_evictions >= this->m_window) {
+				this->recompute();
+			}
+
+			auto oldest = this->m_sequence + 1u - this->m_count;
+			for (qpl::size i = 0u; i < this->m_series; ++i) {
+				auto& minimum = this->m_minimum[i];
+				while (!minimum.empty() && !(minimum.back().second < samples[i])) {
+					minimum.pop_back();
+				}
+				minimum.emplace_back(this->m_sequence, samples[i]);
+				while (minimum.front().first < oldest) {
+					minimum.pop_front();
+				}
+
+				auto& maximum = this->m_maximum[i];
+				while (!maximum.empty() && !(samples[i] < maximum.back().second)) {
+					maximum.pop_back();
+				}
+				maximum.emplace_back(this->m_sequence, samples[i]);
+				while (maximum.front().first < oldest) {
+					maximum.pop_front();
+				}
+			}
+			++this->m_sequence;
+		}
+
+		std::span<const qpl::f64> means() const {
+			return this->m_mean;
+		}
+		qpl::f64 sum(qpl::size series) const {
+			return this->m_mean[series] * static_cast<qpl::f64>(this->m_count);
+		}
+		qpl::f64 mean(qpl::size series) const {
+			return this->m_mean[series];
+		}
+		qpl::f64 variance(qpl::size series) const {
+			return this->m_count ? this->m_m2[series] / static_cast<qpl::f64>(this->m_count) : 0.0;
+		}
+		qpl::f64 sample_variance(qpl::size series) const {
+			return this->m_count > 1u ? this->m_m2[series] / static_cast<qpl::f64>(this->m_count - 1u) : 0.0;
+		}
+		qpl::f64 standard_deviation(qpl::size series) const {
+			return std::sqrt(this->variance(series));
+		}
+		T min(qpl::size series) const {
+			return this->m_count ? this->m_minimum[series].front().second : T{};
+		}
+		T max(qpl::size series) const {
+			return this->m_count ? this->m_maximum[series].front().second : T{};
+		}
+
+	private:
+		void recompute() {
+			this->m_evictions = 0u;
+			std::fill(this->m_mean.begin(), this->m_mean.end(), 0.0);
+			std::fill(this->m_m2.begin(), this->m_m2.end(), 0.0);
+			auto mean = this->m_mean.data();
+			auto m2 = this->m_m2.data();
+			for (qpl::size r = 0u; r < this->m_count; ++r) {
+				auto row = this->m_values.data() + r * this->m_series;
+				auto n = static_cast<qpl::f64>(r + 1u);
+				for (qpl::size i = 0u; i < this->m_series; ++i) {
+					auto x = static_cast<qpl::f64>(row[i]);
+					auto delta = x - mean[i];
+					mean[i] += delta / n;
+					m2[i] += delta * (x - mean[i]);
+				}
+			}
+		}
+
+		qpl::size m_series = 0u;
+		qpl::size m_window = 1u;
+		qpl::size m_head = 0u;
+		qpl::size m_count = 0u;
+		qpl::size m_evictions = 0u;
+		qpl::u64 m_sequence = 0u;
+		std::vector<T> m_values;
+		std::vector<qpl::f64> m_mean;
+		std::vector<qpl::f64> m_m2;
+		std::vector<std::deque<std::pair<qpl::u64, T>>> m_minimum;
+		std::vector<std::deque<std::pair<qpl::u64, T>>> m_maximum;
+	};
+
 	struct exponential_moving_average {
 		exponential_moving_average(qpl::f64 time_period = 5.0) {
 			this->time_period = time_period;
@@ -178,7 +619,7 @@ namespace qpl {
 		moving_average(qpl::size time_period = 5) {
 			this->set_time_period(time_period);
 		}
-		qpl::circular_array<qpl::f64> array;
+		qpl::windowed_statistics<qpl::f64> statistics{ 5u, 0.0 };
 
 		QPLDLL void reset();
 		QPLDLL void add(qpl::f64 value);
@@ -240,6 +681,481 @@ namespace qpl {
 	};
 
 
+	//formula compiled into a flat register bytecode. precedence is resolved and constant subexpressions are folded once,
+	//evaluation runs the instructions over blocks of rows so every instruction is a tight, vectorizable loop
+	//syntax: + - * / ^ (right associative), unary -, parentheses, sqrt abs exp log sin cos. division by zero yields 0 like mathematical_functon.
+	//without variable names the variables are written v0, v1, ...
+	template<typename T>
+	struct mathematical_expression {
+		enum class opcode : qpl::u8 {
+			copy, negate, add, sub, mul, div, pow, sqrt, abs, exp, log, sin, cos
+		};
+		enum class operand_type : qpl::u8 {
+			reg, variable, constant
+		};
+		struct operand {
+			operand_type type = operand_type::reg;
+			qpl::u32 index = 0u;
+		};
+		struct instruction {
+			opcode op;
+			qpl::u32 destination;
+			operand left;
+			operand right;
+		};
+
+		constexpr static qpl::size block_size = 256u;
+		constexpr static qpl::size parallel_rows = 65536u;
+
+		std::vector<instruction> code;
+		std::vector<T> constants;
+		qpl::u32 register_count = 0u;
+		qpl::u32 variable_count = 0u;
+		qpl::u32 output = 0u;
+
+		mathematical_expression() = default;
+		mathematical_expression(std::string_view formula, const std::vector<std::string>& variable_names = {}) {
+			this->parse(formula, variable_names);
+		}
+
+		static T apply(opcode op, T a, T b) {
+			switch (op) {
+			case opcode::copy:
+				return a;
+			case opcode::negate:
+				return -a;
+			case opcode::add:
+				return a + b;
+			case opcode::sub:
+				return a - b;
+			case opcode::mul:
+				return a * b;
+			case opcode::div:
+				return b == T{ 0 } ? T{ 0 } : a / b;
+			case opcode::pow:
+				return static_cast<T>(std::pow(a, b));
+			case opcode::sqrt:
+				return static_cast<T>(std::sqrt(a));
+			case opcode::abs:
+				return a < T{ 0 } ? -a : a;
+			case opcode::exp:
+				return static_cast<T>(std::exp(a));
+			case opcode::log:
+				return static_cast<T>(std::log(a));
+			case opcode::sin:
+				return static_cast<T>(std::sin(a));
+			case opcode::cos:
+				return static_cast<T>(std::cos(a));
+			}
+			return T{ 0 };
+		}
+
+		//expression tree the bytecode is generated from. shared nodes refer to the result of an earlier root
+		enum class node_type : qpl::u8 {
+			constant, variable, shared, unary, binary
+		};
+		struct node {
+			node_type type;
+			opcode op = opcode::copy;
+			T value = T{ 0 };
+			qpl::u32 index = 0u;
+			qpl::u32 left = 0u;
+			qpl::u32 right = 0u;
+		};
+		struct builder {
+			std::vector<node> nodes;
+			qpl::u32 variable_count = 0u;
+
+			qpl::u32 add(const node& value) {
+				this->nodes.push_back(value);
+				return qpl::u32_cast(this->nodes.size() - 1u);
+			}
+			qpl::u32 constant(T value) {
+				return this->add({ node_type::constant, opcode::copy, value });
+			}
+			qpl::u32 variable(qpl::u32 index) {
+				this->variable_count = qpl::max(this->variable_count, index + 1u);
+				return this->add({ node_type::variable, opcode::copy, T{ 0 }, index });
+			}
+			qpl::u32 shared(qpl::u32 root) {
+				return this->add({ node_type::shared, opcode::copy, T{ 0 }, root });
+			}
+			qpl::u32 unary(opcode op, qpl::u32 a) {
+				if (this->nodes[a].type == node_type::constant) {
+					return this->constant(mathematical_expression::apply(op, this->nodes[a].value, T{ 0 }));
+				}
+				return this->add({ node_type::unary, op, T{ 0 }, 0u, a });
+			}
+			qpl::u32 binary(opcode op, qpl::u32 a, qpl::u32 b) {
+				if (this->nodes[a].type == node_type::constant && this->nodes[b].type == node_type::constant) {
+					return this->constant(mathematical_expression::apply(op, this->nodes[a].value, this->nodes[b].value));
+				}
+				return this->add({ node_type::binary, op, T{ 0 }, 0u, a, b });
+			}
+		};
+
+		void parse(std::string_view formula, const std::vector<std::string>& variable_names = {}) {
+			builder tree;
+			parser input{ formula, variable_names, tree };
+			auto root = input.expression();
+			input.skip();
+			if (input.position != formula.size()) {
+				input.error("unexpected character");
+			}
+			this->generate(tree, { root });
+		}
+
+		//every root is stored in its own register (in order) so later roots can use it through shared nodes. the last root is the output
+		void generate(const builder& tree, const std::vector<qpl::u32>& roots) {
+			this->code.clear();
+			this->constants.clear();
+			this->variable_count = tree.variable_count;
+
+			generator emitter{ tree, *this };
+			for (qpl::u32 i = 0u; i < roots.size(); ++i) {
+				emitter.root(roots[i], i);
+			}
+			auto stack = qpl::max(emitter.stack_registers, 1u);
+			auto map = [&](qpl::u32 index) {
+				return (index & generator::shared_bit) ? stack + (index & ~generator::shared_bit) : index;
+			};
+			for (auto& instruction : this->code) {
+				instruction.destination = map(instruction.destination);
+				if (instruction.left.type == operand_type::reg) {
+					instruction.left.index = map(instruction.left.index);
+				}
+				if (instruction.right.type == operand_type::reg) {
+					instruction.right.index = map(instruction.right.index);
+				}
+			}
+			this->register_count = stack + qpl::u32_cast(roots.size());
+			this->output = this->register_count - 1u;
+		}
+
+		T evaluate(std::span<const T> variables) const {
+			if (variables.size() < this->variable_count) {
+				throw qpl::exception("mathematical_expression::evaluate: ", variables.size(), " variables given but ", this->variable_count, " used");
+			}
+			thread_local std::vector<T> registers;
+			registers.resize(this->register_count);
+
+			auto load = [&](operand operand) {
+				switch (operand.type) {
+				case operand_type::reg:
+					return registers[operand.index];
+				case operand_type::variable:
+					return variables[operand.index];
+				default:
+					return this->constants[operand.index];
+				}
+			};
+			for (const auto& instruction : this->code) {
+				registers[instruction.destination] = mathematical_expression::apply(instruction.op, load(instruction.left), load(instruction.right));
+			}
+			return registers[this->output];
+		}
+		template<typename... Args>
+		T operator()(Args... variables) const {
+			auto array = qpl::to_array<T>(variables...);
+			return this->evaluate(std::span<const T>(array));
+		}
+
+		//columns[v][row] is variable v of that row, output receives one result per row
+		void evaluate(std::span<const std::span<const T>> columns, std::span<T> output) const {
+			this->check_columns(columns, output.size());
+			this->evaluate_rows(columns, output, 0u, output.size());
+		}
+		void evaluate(std::span<const std::span<const T>> columns, std::span<T> output, qpl::thread_pool& pool) const {
+			this->check_columns(columns, output.size());
+			if (output.size() < parallel_rows) {
+				this->evaluate_rows(columns, output, 0u, output.size());
+				return;
+			}
+			constexpr qpl::size chunk_size = block_size * 64u;
+			auto chunks = (output.size() - 1u) / chunk_size + 1u;
+			pool.parallel_for(chunks, [&](qpl::size i) {
+				auto begin = i * chunk_size;
+				this->evaluate_rows(columns, output, begin, qpl::min(begin + chunk_size, output.size()));
+			});
+		}
+
+		std::string string() const {
+			std::ostringstream stream;
+			auto operand_string = [&](operand operand) {
+				switch (operand.type) {
+				case operand_type::reg:
+					return qpl::to_string("r", operand.index);
+				case operand_type::variable:
+					return qpl::to_string("v", operand.index);
+				default:
+					return qpl::to_string(this->constants[operand.index]);
+				}
+			};
+			constexpr std::array names = { "copy", "negate", "add", "sub", "mul", "div", "pow", "sqrt", "abs", "exp", "log", "sin", "cos" };
+			for (const auto& instruction : this->code) {
+				stream << "r" << instruction.destination << " = " << names[qpl::size_cast(instruction.op)] << " " << operand_string(instruction.left);
+				if (instruction.op >= opcode::add && instruction.op <= opcode::pow) {
+					stream << ", " << operand_string(instruction.right);
+				}
+				stream << '\n';
+			}
+			return stream.str();
+		}
+
+	private:
+		struct parser {
+			std::string_view text;
+			const std::vector<std::string>& names;
+			builder& tree;
+			qpl::size position = 0u;
+
+			[[noreturn]] void error(std::string_view message) const {
+				throw qpl::exception("mathematical_expression::parse: ", message, " at position ", this->position, " in \"", this->text, "\"");
+			}
+			void skip() {
+				while (this->position < this->text.size() && std::isspace(static_cast<unsigned char>(this->text[this->position]))) {
+					++this->position;
+				}
+			}
+			bool accept(char c) {
+				this->skip();
+				if (this->position < this->text.size() && this->text[this->position] == c) {
+					++this->position;
+					return true;
+				}
+				return false;
+			}
+
+			qpl::u32 expression() {
+				auto left = this->term();
+				while (true) {
+					if (this->accept('+')) {
+						left = this->tree.binary(opcode::add, left, this->term());
+					}
+					else if (this->accept('-')) {
+						left = this->tree.binary(opcode::sub, left, this->term());
+					}
+					else {
+						return left;
+					}
+				}
+			}
+			qpl::u32 term() {
+				auto left = this->unary();
+				while (true) {
+					if (this->accept('*')) {
+						left = this->tree.binary(opcode::mul, left, this->unary());
+					}
+					else if (this->accept('/')) {
+						left = this->tree.binary(opcode::div, left, this->unary());
+					}
+					else {
+						return left;
+					}
+				}
+			}
+			qpl::u32 unary() {
+				if (this->accept('-')) {
+					return this->tree.unary(opcode::negate, this->unary());
+				}
+				if (this->accept('+')) {
+					return this->unary();
+				}
+				return this->power();
+			}
+			qpl::u32 power() {
+				auto base = this->primary();
+				if (this->accept('^')) {
+					return this->tree.binary(opcode::pow, base, this->unary());
+				}
+				return base;
+			}
+			qpl::u32 primary() {
+				if (this->accept('(')) {
+					auto result = this->expression();
+					if (!this->accept(')')) {
+						this->error("expected ')'");
+					}
+					return result;
+				}
+				if (this->position == this->text.size()) {
+					this->error("unexpected end");
+				}
+				auto c = this->text[this->position];
+				if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+					qpl::f64 value;
+					auto [end, error] = std::from_chars(this->text.data() + this->position, this->text.data() + this->text.size(), value);
+					if (error != std::errc{}) {
+						this->error("invalid number");
+					}
+					this->position = qpl::size_cast(end - this->text.data());
+					return this->tree.constant(static_cast<T>(value));
+				}
+				if (!std::isalpha(static_cast<unsigned char>(c)) && c != '_') {
+					this->error("unexpected character");
+				}
+				auto begin = this->position;
+				while (this->position < this->text.size() && (std::isalnum(static_cast<unsigned char>(this->text[this->position])) || this->text[this->position] == '_')) {
+					++this->position;
+				}
+				auto name = this->text.substr(begin, this->position - begin);
+
+				if (this->accept('(')) {
+					constexpr std::array<std::pair<std::string_view, opcode>, 6u> functions = { {
+						{ "sqrt", opcode::sqrt }, { "abs", opcode::abs }, { "exp", opcode::exp }, { "log", opcode::log }, { "sin", opcode::sin }, { "cos", opcode::cos }
+					} };
+					auto function = std::find_if(functions.cbegin(), functions.cend(), [&](const auto& pair) {
+						return pair.first == name;
+					});
+					if (function == functions.cend()) {
+						this->error("unknown function");
+					}
+					auto argument = this->expression();
+					if (!this->accept(')')) {
+						this->error("expected ')'");
+					}
+					return this->tree.unary(function->second, argument);
+				}
+
+				auto found = std::find(this->names.cbegin(), this->names.cend(), name);
+				if (found != this->names.cend()) {
+					return this->tree.variable(qpl::u32_cast(found - this->names.cbegin()));
+				}
+				if (this->names.empty() && name.size() > 1u && name[0] == 'v') {
+					qpl::u32 index;
+					auto [end, error] = std::from_chars(name.data() + 1, name.data() + name.size(), index);
+					if (error == std::errc{} && end == name.data() + name.size()) {
+						return this->tree.variable(index);
+					}
+				}
+				this->position = begin;
+				this->error("unknown variable");
+			}
+		};
+
+		//registers 0 .. stack_registers - 1 are reused like a stack (a node at depth d writes register d), roots get their own registers after them
+		struct generator {
+			constexpr static qpl::u32 shared_bit = 0x8000'0000u;
+
+			const builder& tree;
+			mathematical_expression& expression;
+			qpl::u32 stack_registers = 0u;
+
+			void push(opcode op, qpl::u32 destination, operand left, operand right = {}) {
+				this->expression.code.push_back({ op, destination, left, right });
+				if (!(destination & shared_bit)) {
+					this->stack_registers = qpl::max(this->stack_registers, destination + 1u);
+				}
+			}
+			operand emit(qpl::u32 index, qpl::u32 depth) {
+				const auto& node = this->tree.nodes[index];
+				switch (node.type) {
+				case node_type::constant:
+					this->expression.constants.push_back(node.value);
+					return { operand_type::constant, qpl::u32_cast(this->expression.constants.size() - 1u) };
+				case node_type::variable:
+					return { operand_type::variable, node.index };
+				case node_type::shared:
+					return { operand_type::reg, node.index | shared_bit };
+				case node_type::unary:
+					this->push(node.op, depth, this->emit(node.left, depth));
+					return { operand_type::reg, depth };
+				case node_type::binary: {
+					auto left = this->emit(node.left, depth);
+					auto right = this->emit(node.right, depth + 1u);
+					this->push(node.op, depth, left, right);
+					return { operand_type::reg, depth };
+				}
+				}
+				return {};
+			}
+			void root(qpl::u32 index, qpl::u32 root_index) {
+				auto result = this->emit(index, 0u);
+				auto destination = root_index | shared_bit;
+				if (result.type == operand_type::reg && result.index == 0u && !this->expression.code.empty() && this->expression.code.back().destination == 0u) {
+					this->expression.code.back().destination = destination;
+				}
+				else {
+					this->push(opcode::copy, destination, result);
+				}
+			}
+		};
+
+		void check_columns(std::span<const std::span<const T>> columns, qpl::size rows) const {
+			if (columns.size() < this->variable_count) {
+				throw qpl::exception("mathematical_expression::evaluate: ", columns.size(), " columns given but ", this->variable_count, " used");
+			}
+			for (qpl::size i = 0u; i < this->variable_count; ++i) {
+				if (columns[i].size() < rows) {
+					throw qpl::exception("mathematical_expression::evaluate: column ", i, " has ", columns[i].size(), " rows, expected ", rows);
+				}
+			}
+		}
+		static void run(opcode op, T* destination, const T* a, const T* b, qpl::size count) {
+			switch (op) {
+			case opcode::copy:
+				std::copy_n(a, count, destination);
+				break;
+			case opcode::negate:
+				for (qpl::size i = 0u; i < count; ++i) {
+					destination[i] = -a[i];
+				}
+				break;
+			case opcode::add:
+				for (qpl::size i = 0u; i < count; ++i) {
+					destination[i] = a[i] + b[i];
+				}
+				break;
+			case opcode::sub:
+				for (qpl::size i = 0u; i < count; ++i) {
+					destination[i] = a[i] - b[i];
+				}
+				break;
+			case opcode::mul:
+				for (qpl::size i = 0u; i < count; ++i) {
+					destination[i] = a[i] * b[i];
+				}
+				break;
+			case opcode::div:
+				for (qpl::size i = 0u; i < count; ++i) {
+					destination[i] = b[i] == T{ 0 } ? T{ 0 } : a[i] / b[i];
+				}
+				break;
+			default:
+				for (qpl::size i = 0u; i < count; ++i) {
+					destination[i] = mathematical_expression::apply(op, a[i], b[i]);
+				}
+				break;
+			}
+		}
+		void evaluate_rows(std::span<const std::span<const T>> columns, std::span<T> output, qpl::size begin, qpl::size end) const {
+			std::vector<T> registers(this->register_count * block_size);
+			std::vector<T> constants(this->constants.size() * block_size);
+			for (qpl::size i = 0u; i < this->constants.size(); ++i) {
+				std::fill_n(constants.data() + i * block_size, block_size, this->constants[i]);
+			}
+
+			for (auto row = begin; row < end; row += block_size) {
+				auto count = qpl::min(block_size, end - row);
+				auto pointer = [&](operand operand) -> const T* {
+					switch (operand.type) {
+					case operand_type::reg:
+						return registers.data() + operand.index * block_size;
+					case operand_type::variable:
+						return columns[operand.index].data() + row;
+					default:
+						return constants.data() + operand.index * block_size;
+					}
+				};
+				for (const auto& instruction : this->code) {
+					auto destination = registers.data() + instruction.destination * block_size;
+					mathematical_expression::run(instruction.op, destination, pointer(instruction.left), pointer(instruction.right), count);
+				}
+				std::copy_n(registers.data() + this->output * block_size, count, output.data() + row);
+			}
+		}
+	};
+
 	template<typename T>
 	struct mathematical_functon {
 		struct number_operation {
@@ -388,6 +1304,69 @@ namespace qpl {
 			return this->solve(qpl::to_array<T>(variables...));
 		}
 
+		//the chain lines become roots of one expression tree, links turn into references to earlier roots
+		mathematical_expression<T> compile() const {
+			using expression = mathematical_expression<T>;
+			typename expression::builder tree;
+			std::vector<qpl::u32> roots;
+			std::vector<qpl::u32> line_roots(this->chain.size(), qpl::u32_max);
+
+			auto load = [&](qpl::size index) {
+				const auto& element = this->chain[index];
+				qpl::u32 node;
+				if (element.is_link()) {
+					auto link = element.get_link();
+					if (link >= line_roots.size() || line_roots[link] == qpl::u32_max) {
+						throw qpl::exception("mathematical_functon::compile: #", link, " doesn't refer to the start of an earlier line");
+					}
+					node = tree.shared(line_roots[link]);
+				}
+				else if (element.is_variable()) {
+					node = tree.variable(element.get_variable());
+				}
+				else {
+					node = tree.constant(element.number);
+				}
+				if (element.get_prefix() == mathematical_prefix::negated) {
+					node = tree.unary(expression::opcode::negate, node);
+				}
+				return node;
+			};
+			auto opcode = [](mathematical_operation operation) {
+				switch (operation) {
+				case mathematical_operation::sub:
+					return expression::opcode::sub;
+				case mathematical_operation::mul:
+					return expression::opcode::mul;
+				case mathematical_operation::div:
+					return expression::opcode::div;
+				case mathematical_operation::pow:
+					return expression::opcode::pow;
+				default:
+					return expression::opcode::add;
+				}
+			};
+
+			for (qpl::size start = 0u; start < this->chain.size();) {
+				auto accumulator = load(start);
+				auto c = start;
+				while (c + 1u < this->chain.size() && this->chain[c].get_operation() != mathematical_operation::none) {
+					accumulator = tree.binary(opcode(this->chain[c].get_operation()), accumulator, load(c + 1u));
+					++c;
+				}
+				line_roots[start] = qpl::u32_cast(roots.size());
+				roots.push_back(accumulator);
+				start = c + 1u;
+			}
+			if (roots.empty()) {
+				throw qpl::exception("mathematical_functon::compile: empty chain");
+			}
+
+			expression result;
+			result.generate(tree, roots);
+			return result;
+		}
+
 		std::string string() const {
 			std::ostringstream stream;
 			for (auto& i : this->chain) {
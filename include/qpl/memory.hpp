@@ -7,11 +7,21 @@
 #include <qpl/qpldeclspec.hpp>
 #include <qpl/type_traits.hpp>
 #include <qpl/system.hpp>
+#include <qpl/shared_memory.hpp>
 #include <qpl/vardef.hpp>
 #include <qpl/exception.hpp>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <span>
 #include <string_view>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 
 
@@ -540,6 +550,275 @@ namespace qpl {
 		bool rotation_finished = false;
 	};
 
+	namespace detail {
+		constexpr qpl::size cache_line_size = 64u;
+
+		constexpr qpl::size ring_capacity(qpl::size size) {
+			qpl::size result = 1u;
+			while (result < size) {
+				result <<= 1u;
+			}
+			return result;
+		}
+	}
+
+	//lock-free single producer / single consumer circular_array. the capacity is a power of two (N or rounded up in resize).
+	//unlike circular_array::add a full ring can't drop its oldest value (the read index belongs to the consumer), add() returns false instead.
+	//iteration, front() and get() are consumer side and see the values from oldest to newest
+	template<typename T, qpl::size N = 0>
+	struct spsc_circular_array {
+		static_assert(N == 0u || !(N & (N - 1u)), "qpl::spsc_circular_array: N must be a power of two");
+
+		struct const_iterator {
+			const spsc_circular_array* data;
+			qpl::size index = 0u;
+
+			const_iterator(const spsc_circular_array& array, qpl::size index) : data(&array), index(index) {
+
+			}
+			const_iterator& operator++() {
+				++this->index;
+				return *this;
+			}
+			const_iterator operator++(int dummy) {
+				auto copy = *this;
+				++this->index;
+				return copy;
+			}
+			bool operator==(const const_iterator& other) const {
+				return this->index == other.index;
+			}
+			bool operator!=(const const_iterator& other) const {
+				return this->index != other.index;
+			}
+			const T& operator*() const {
+				return this->data->get(this->index);
+			}
+		};
+
+		spsc_circular_array(qpl::size size = N) {
+			this->resize(size);
+		}
+
+		//not thread safe, neither side may be running
+		void resize(qpl::size size) {
+			if constexpr (is_vector()) {
+				this->m_data.resize(qpl::detail::ring_capacity(qpl::max(size, qpl::size{ 1u })));
+			}
+			this->m_mask = this->m_data.size() - 1u;
+			this->m_head.store(0u, std::memory_order_relaxed);
+			this->m_tail.store(0u, std::memory_order_relaxed);
+			this->m_cached_head = 0u;
+			this->m_cached_tail = 0u;
+		}
+		qpl::size capacity() const {
+			return this->m_data.size();
+		}
+		qpl::size size() const {
+			auto head = this->m_head.load(std::memory_order_acquire);
+			auto tail = this->m_tail.load(std::memory_order_acquire);
+			return tail > head ? qpl::size_cast(tail - head) : qpl::size{ 0u };
+		}
+		bool empty() const {
+			return this->size() == 0u;
+		}
+		bool full() const {
+			return this->size() == this->capacity();
+		}
+
+		//producer
+		bool add(const T& value) {
+			return this->try_push(value);
+		}
+		bool try_push(const T& value) {
+			auto tail = this->m_tail.load(std::memory_order_relaxed);
+			if (tail - this->m_cached_head == this->capacity()) {
+				this->m_cached_head = this->m_head.load(std::memory_order_acquire);
+				if (tail - this->m_cached_head == this->capacity()) {
+					return false;
+				}
+			}
+			this->m_data[tail & this->m_mask] = value;
+			this->m_tail.store(tail + 1u, std::memory_order_release);
+			return true;
+		}
+		//pushes as many values as fit, returns how many
+		qpl::size push(std::span<const T> values) {
+			auto tail = this->m_tail.load(std::memory_order_relaxed);
+			auto free = this->capacity() - qpl::size_cast(tail - this->m_cached_head);
+			if (free < values.size()) {
+				this->m_cached_head = this->m_head.load(std::memory_order_acquire);
+				free = this->capacity() - qpl::size_cast(tail - this->m_cached_head);
+			}
+			auto count = qpl::min(free, values.size());
+			for (qpl::size i = 0u; i < count; ++i) {
+				this->m_data[(tail + i) & this->m_mask] = values[i];
+			}
+			this->m_tail.store(tail + count, std::memory_order_release);
+			return count;
+		}
+
+		//consumer
+		bool try_pop(T& value) {
+			auto head = this->m_head.load(std::memory_order_relaxed);
+			if (head == this->m_cached_tail) {
+				this->m_cached_tail = this->m_tail.load(std::memory_order_acquire);
+				if (head == this->m_cached_tail) {
+					return false;
+				}
+			}
+			value = std::move(this->m_data[head & this->m_mask]);
+			this->m_head.store(head + 1u, std::memory_order_release);
+			return true;
+		}
+		//pops up to values.size() values, returns how many
+		qpl::size pop(std::span<T> values) {
+			auto head = this->m_head.load(std::memory_order_relaxed);
+			auto available = qpl::size_cast(this->m_cached_tail - head);
+			if (available < values.size()) {
+				this->m_cached_tail = this->m_tail.load(std::memory_order_acquire);
+				available = qpl::size_cast(this->m_cached_tail - head);
+			}
+			auto count = qpl::min(available, values.size());
+			for (qpl::size i = 0u; i < count; ++i) {
+				values[i] = std::move(this->m_data[(head + i) & this->m_mask]);
+			}
+			this->m_head.store(head + count, std::memory_order_release);
+			return count;
+		}
+		void clear() {
+			this->m_cached_tail = this->m_tail.load(std::memory_order_acquire);
+			this->m_head.store(this->m_cached_tail, std::memory_order_release);
+		}
+		const T& get(qpl::size index) const {
+			return this->m_data[(this->m_head.load(std::memory_order_relaxed) + index) & this->m_mask];
+		}
+		const T& operator[](qpl::size index) const {
+			return this->get(index);
+		}
+		const T& front() const {
+			return this->get(0u);
+		}
+		auto begin() const {
+			return const_iterator(*this, 0u);
+		}
+		auto end() const {
+			return const_iterator(*this, this->size());
+		}
+		auto cbegin() const {
+			return this->begin();
+		}
+		auto cend() const {
+			return this->end();
+		}
+
+		constexpr static bool is_vector() {
+			return N == qpl::size{ 0u };
+		}
+		constexpr static bool is_array() {
+			return N != qpl::size{ 0 };
+		}
+
+	private:
+		alignas(qpl::detail::cache_line_size) std::atomic<qpl::u64> m_head = 0u;
+		qpl::u64 m_cached_tail = 0u;
+		alignas(qpl::detail::cache_line_size) std::atomic<qpl::u64> m_tail = 0u;
+		qpl::u64 m_cached_head = 0u;
+		alignas(qpl::detail::cache_line_size) qpl::size m_mask = 0u;
+		qpl::conditional<qpl::if_true<N == 0>, std::vector<T>, std::array<T, N>> m_data;
+	};
+
+	//bounded lock-free multi producer / multi consumer circular_array (every cell carries a sequence number).
+	//add() keeps circular_array's semantics: when full the oldest value is popped and dropped to make room
+	template<typename T, qpl::size N = 0>
+	struct mpmc_circular_array {
+		static_assert(N == 0u || !(N & (N - 1u)), "qpl::mpmc_circular_array: N must be a power of two");
+
+		mpmc_circular_array(qpl::size size = N) {
+			this->resize(size);
+		}
+
+		//not thread safe, no producer or consumer may be running
+		void resize(qpl::size size) {
+			if constexpr (is_vector()) {
+				this->m_capacity = qpl::detail::ring_capacity(qpl::max(size, qpl::size{ 1u }));
+				this->m_cells = std::make_unique<cell[]>(this->m_capacity);
+			}
+			else {
+				this->m_capacity = N;
+			}
+			qpl::detail::sequence_ring_reset(&this->m_cells[0], this->m_capacity);
+			this->m_head.store(0u, std::memory_order_relaxed);
+			this->m_tail.store(0u, std::memory_order_relaxed);
+		}
+		qpl::size capacity() const {
+			return this->m_capacity;
+		}
+		qpl::size size() const {
+			auto tail = this->m_tail.load(std::memory_order_acquire);
+			auto head = this->m_head.load(std::memory_order_acquire);
+			return tail > head ? qpl::size_cast(tail - head) : qpl::size{ 0u };
+		}
+		bool empty() const {
+			return this->size() == 0u;
+		}
+
+		bool try_push(const T& value) {
+			return qpl::detail::sequence_ring_push(&this->m_cells[0], this->m_capacity, this->m_tail, value);
+		}
+		bool try_pop(T& value) {
+			return qpl::detail::sequence_ring_pop(&this->m_cells[0], this->m_capacity, this->m_head, value);
+		}
+		void add(const T& value) {
+			while (!this->try_push(value)) {
+				T dropped;
+				this->try_pop(dropped);
+			}
+		}
+		//pushes values until the ring is full, returns how many
+		qpl::size push(std::span<const T> values) {
+			qpl::size count = 0u;
+			while (count < values.size() && this->try_push(values[count])) {
+				++count;
+			}
+			return count;
+		}
+		//pops up to values.size() values, returns how many
+		qpl::size pop(std::span<T> values) {
+			qpl::size count = 0u;
+			while (count < values.size() && this->try_pop(values[count])) {
+				++count;
+			}
+			return count;
+		}
+		//pops everything that is currently readable, oldest first
+		template<typename F>
+		qpl::size drain(F&& function) {
+			qpl::size count = 0u;
+			T value;
+			while (this->try_pop(value)) {
+				function(value);
+				++count;
+			}
+			return count;
+		}
+
+		constexpr static bool is_vector() {
+			return N == qpl::size{ 0u };
+		}
+		constexpr static bool is_array() {
+			return N != qpl::size{ 0 };
+		}
+
+	private:
+		using cell = qpl::detail::sequence_cell<T>;
+
+		alignas(qpl::detail::cache_line_size) std::atomic<qpl::u64> m_head = 0u;
+		alignas(qpl::detail::cache_line_size) std::atomic<qpl::u64> m_tail = 0u;
+		alignas(qpl::detail::cache_line_size) qpl::size m_capacity = 0u;
+		qpl::conditional<qpl::if_true<N == 0>, std::unique_ptr<cell[]>, std::array<cell, N>> m_cells;
+	};
+
 	
 	namespace detail {
 #ifdef QPL_NO_BOUNDARY_CHECK
@@ -611,10 +890,10 @@ namespace qpl {
 		}
 	};
 
-	template<typename T, bool BOUNDARY_CHECK = detail::vector_boundary_check>
-	struct vector : std::vector<T> {
+	template<typename T, bool BOUNDARY_CHECK = detail::vector_boundary_check, typename Allocator = std::allocator<T>>
+	struct vector : std::vector<T, Allocator> {
+		using std::vector<T, Allocator>::vector;
 
-	
 		constexpr void index_check(qpl::size index, bool at) const {
 			if (index >= this->size()) {
 				std::ostringstream stream;
@@ -635,36 +914,754 @@ namespace qpl {
 			}
 		}
 	public:
-		constexpr auto& operator=(const std::vector<T>& other) {
-			return std::vector<T>::operator=(other);
+		constexpr auto& operator=(const std::vector<T, Allocator>& other) {
+			return std::vector<T, Allocator>::operator=(other);
 		}
 
 		constexpr T& operator[](qpl::size index) {
 			if constexpr (BOUNDARY_CHECK) {
 				this->index_check(index, false);
 			}
-			return std::vector<T>::operator[](index);
+			return std::vector<T, Allocator>::operator[](index);
 		}
 		constexpr const T& operator[](qpl::size index) const {
 			if constexpr (BOUNDARY_CHECK) {
 				this->index_check(index, false);
 			}
-			return std::vector<T>::operator[](index);
+			return std::vector<T, Allocator>::operator[](index);
 		}
 
 		constexpr T& at(qpl::size index) {
 			if constexpr (BOUNDARY_CHECK) {
 				this->index_check(index, true);
 			}
-			return std::vector<T>::at(index);
+			return std::vector<T, Allocator>::at(index);
 		}
 		constexpr const T& at(qpl::size index) const {
 			if constexpr (BOUNDARY_CHECK) {
 				this->index_check(index, true);
 			}
-			return std::vector<T>::at(index);
+			return std::vector<T, Allocator>::at(index);
+		}
+	};
+	namespace pmr {
+		//qpl::vector backed by a std::pmr::memory_resource, e.g. qpl::arena_resource or qpl::pool_resource
+		template<typename T, bool BOUNDARY_CHECK = detail::vector_boundary_check>
+		using vector = qpl::vector<T, BOUNDARY_CHECK, std::pmr::polymorphic_allocator<T>>;
+	}
+
+	namespace detail {
+		template<typename T, qpl::size N, bool HEAP>
+		struct inline_vector_storage {
+			alignas(T) std::byte buffer[N * sizeof(T)];
+			T* heap = nullptr;
+			qpl::size capacity = N;
+
+			T* data() {
+				return this->heap ? this->heap : reinterpret_cast<T*>(this->buffer);
+			}
+			const T* data() const {
+				return this->heap ? this->heap : reinterpret_cast<const T*>(this->buffer);
+			}
+			void deallocate() {
+				if (this->heap) {
+					std::allocator<T>{}.deallocate(this->heap, this->capacity);
+					this->heap = nullptr;
+					this->capacity = N;
+				}
+			}
+		};
+		template<typename T, qpl::size N>
+		struct inline_vector_storage<T, N, false> {
+			alignas(T) std::byte buffer[N * sizeof(T)];
+			constexpr static qpl::size capacity = N;
+
+			T* data() {
+				return reinterpret_cast<T*>(this->buffer);
+			}
+			const T* data() const {
+				return reinterpret_cast<const T*>(this->buffer);
+			}
+			void deallocate() {
+
+			}
+		};
+
+		//the first N elements are stored inside the object. if HEAP is true it moves to the heap when it grows beyond N,
+		//otherwise exceeding N throws
+		template<typename T, qpl::size N, bool BOUNDARY_CHECK, bool HEAP>
+		struct inline_vector {
+			static_assert(N > 0u, "qpl::small_vector / qpl::static_vector: N must be greater than 0");
+
+			using value_type = T;
+			using size_type = qpl::size;
+			using difference_type = std::ptrdiff_t;
+			using reference = T&;
+			using const_reference = const T&;
+			using pointer = T*;
+			using const_pointer = const T*;
+			using iterator = T*;
+			using const_iterator = const T*;
+			using reverse_iterator = std::reverse_iterator<iterator>;
+			using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+			inline_vector() {
+
+			}
+			explicit inline_vector(qpl::size size) {
+				this->resize(size);
+			}
+			inline_vector(qpl::size size, const T& value) {
+				this->resize(size, value);
+			}
+			inline_vector(std::initializer_list<T> list) {
+				this->assign(list.begin(), list.end());
+			}
+			template<std::input_iterator I>
+			inline_vector(I first, I last) {
+				this->assign(first, last);
+			}
+			inline_vector(const inline_vector& other) {
+				this->assign(other.begin(), other.end());
+			}
+			inline_vector(inline_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+				this->take(other);
+			}
+			~inline_vector() {
+				this->clear();
+				this->m_storage.deallocate();
+			}
+
+			inline_vector& operator=(const inline_vector& other) {
+				if (this != &other) {
+					this->assign(other.begin(), other.end());
+				}
+				return *this;
+			}
+			inline_vector& operator=(inline_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+				if (this != &other) {
+					this->clear();
+					this->m_storage.deallocate();
+					this->take(other);
+				}
+				return *this;
+			}
+			inline_vector& operator=(std::initializer_list<T> list) {
+				this->assign(list.begin(), list.end());
+				return *this;
+			}
+
+			template<std::input_iterator I>
+			void assign(I first, I last) {
+				this->clear();
+				if constexpr (std::forward_iterator<I>) {
+					this->reserve(qpl::size_cast(std::distance(first, last)));
+				}
+				for (; first != last; ++first) {
+					this->emplace_back(*first);
+				}
+			}
+
+			constexpr static qpl::size inline_capacity() {
+				return N;
+			}
+			qpl::size size() const {
+				return this->m_size;
+			}
+			qpl::size capacity() const {
+				return this->m_storage.capacity;
+			}
+			bool empty() const {
+				return this->m_size == 0u;
+			}
+			bool is_inline() const {
+				if constexpr (HEAP) {
+					return this->m_storage.heap == nullptr;
+				}
+				else {
+					return true;
+				}
+			}
+
+			T* data() {
+				return this->m_storage.data();
+			}
+			const T* data() const {
+				return this->m_storage.data();
+			}
+
+			T& operator[](qpl::size index) {
+				if constexpr (BOUNDARY_CHECK) {
+					this->index_check(index, false);
+				}
+				return this->data()[index];
+			}
+			const T& operator[](qpl::size index) const {
+				if constexpr (BOUNDARY_CHECK) {
+					this->index_check(index, false);
+				}
+				return this->data()[index];
+			}
+			T& at(qpl::size index) {
+				this->index_check(index, true);
+				return this->data()[index];
+			}
+			const T& at(qpl::size index) const {
+				this->index_check(index, true);
+				return this->data()[index];
+			}
+			T& front() {
+				if constexpr (BOUNDARY_CHECK) {
+					this->front_check(true);
+				}
+				return this->data()[0];
+			}
+			const T& front() const {
+				if constexpr (BOUNDARY_CHECK) {
+					this->front_check(true);
+				}
+				return this->data()[0];
+			}
+			T& back() {
+				if constexpr (BOUNDARY_CHECK) {
+					this->front_check(false);
+				}
+				return this->data()[this->m_size - 1];
+			}
+			const T& back() const {
+				if constexpr (BOUNDARY_CHECK) {
+					this->front_check(false);
+				}
+				return this->data()[this->m_size - 1];
+			}
+
+			iterator begin() {
+				return this->data();
+			}
+			const_iterator begin() const {
+				return this->data();
+			}
+			const_iterator cbegin() const {
+				return this->data();
+			}
+			iterator end() {
+				return this->data() + this->m_size;
+			}
+			const_iterator end() const {
+				return this->data() + this->m_size;
+			}
+			const_iterator cend() const {
+				return this->data() + this->m_size;
+			}
+			reverse_iterator rbegin() {
+				return reverse_iterator(this->end());
+			}
+			const_reverse_iterator rbegin() const {
+				return const_reverse_iterator(this->end());
+			}
+			reverse_iterator rend() {
+				return reverse_iterator(this->begin());
+			}
+			const_reverse_iterator rend() const {
+				return const_reverse_iterator(this->begin());
+			}
+
+			void reserve(qpl::size capacity) {
+				if (capacity > this->capacity()) {
+					if constexpr (HEAP) {
+						this->relocate(std::allocator<T>{}.allocate(capacity), capacity);
+					}
+					else {
+						this->capacity_error(capacity);
+					}
+				}
+			}
+			void shrink_to_fit() {
+				if constexpr (HEAP) {
+					if (this->m_storage.heap && this->m_size <= N) {
+						auto heap = this->m_storage.heap;
+						auto capacity = this->m_storage.capacity;
+						this->m_storage.heap = nullptr;
+						this->m_storage.capacity = N;
+						std::uninitialized_move(heap, heap + this->m_size, this->data());
+						std::destroy(heap, heap + this->m_size);
+						std::allocator<T>{}.deallocate(heap, capacity);
+					}
+				}
+			}
+			void clear() {
+				std::destroy(this->begin(), this->end());
+				this->m_size = 0u;
+			}
+
+			template<typename... Args>
+			T& emplace_back(Args&&... args) {
+				if (this->m_size == this->capacity()) {
+					if constexpr (HEAP) {
+						return this->emplace_back_grow(std::forward<Args>(args)...);
+					}
+					else {
+						this->capacity_error(this->m_size + 1u);
+					}
+				}
+				auto ptr = std::construct_at(this->data() + this->m_size, std::forward<Args>(args)...);
+				++this->m_size;
+				return *ptr;
+			}
+			void push_back(const T& value) {
+				this->emplace_back(value);
+			}
+			void push_back(T&& value) {
+				this->emplace_back(std::move(value));
+			}
+			void pop_back() {
+				if constexpr (BOUNDARY_CHECK) {
+					this->front_check(false);
+				}
+				--this->m_size;
+				std::destroy_at(this->data() + this->m_size);
+			}
+
+			template<typename... Args>
+			iterator emplace(const_iterator position, Args&&... args) {
+				auto index = position - this->cbegin();
+				this->emplace_back(std::forward<Args>(args)...);
+				std::rotate(this->begin() + index, this->end() - 1, this->end());
+				return this->begin() + index;
+			}
+			iterator insert(const_iterator position, const T& value) {
+				return this->emplace(position, value);
+			}
+			iterator insert(const_iterator position, T&& value) {
+				return this->emplace(position, std::move(value));
+			}
+			iterator erase(const_iterator position) {
+				return this->erase(position, position + 1);
+			}
+			iterator erase(const_iterator first, const_iterator last) {
+				auto begin = this->begin() + (first - this->cbegin());
+				auto end = this->begin() + (last - this->cbegin());
+				if (begin != end) {
+					auto new_end = std::move(end, this->end(), begin);
+					std::destroy(new_end, this->end());
+					this->m_size -= qpl::size_cast(end - begin);
+				}
+				return begin;
+			}
+
+			void resize(qpl::size size) {
+				if (size < this->m_size) {
+					std::destroy(this->begin() + size, this->end());
+				}
+				else if (size > this->m_size) {
+					this->reserve(size);
+					std::uninitialized_value_construct(this->end(), this->begin() + size);
+				}
+				this->m_size = size;
+			}
+			void resize(qpl::size size, const T& value) {
+				if (size < this->m_size) {
+					std::destroy(this->begin() + size, this->end());
+				}
+				else if (size > this->capacity()) {
+					T copy = value;
+					this->reserve(size);
+					std::uninitialized_fill(this->end(), this->begin() + size, copy);
+				}
+				else if (size > this->m_size) {
+					std::uninitialized_fill(this->end(), this->begin() + size, value);
+				}
+				this->m_size = size;
+			}
+
+			bool operator==(const inline_vector& other) const {
+				return std::equal(this->begin(), this->end(), other.begin(), other.end());
+			}
+
+		private:
+			constexpr static const char* name() {
+				return HEAP ? "qpl::small_vector<" : "qpl::static_vector<";
+			}
+			void index_check(qpl::size index, bool at) const {
+				if (index >= this->m_size) {
+					throw qpl::exception(name(), qpl::type_name<T>(), ", ", N, ">", at ? ".at()" : "::operator[]", " : index is ", index, " - size is ", this->m_size);
+				}
+			}
+			void front_check(bool front) const {
+				if (this->empty()) {
+					throw qpl::exception(name(), qpl::type_name<T>(), ", ", N, ">", front ? ".front()" : ".back()", " : vector is empty");
+				}
+			}
+			[[noreturn]] void capacity_error(qpl::size size) const {
+				throw qpl::exception(name(), qpl::type_name<T>(), ", ", N, "> : size ", size, " exceeds the fixed capacity");
+			}
+
+			//constructs the new element before the old ones are moved, so args may refer to an element of this vector
+			template<typename... Args>
+			T& emplace_back_grow(Args&&... args) {
+				auto capacity = this->capacity() * 2u;
+				auto memory = std::allocator<T>{}.allocate(capacity);
+				T* ptr;
+				try {
+					ptr = std::construct_at(memory + this->m_size, std::forward<Args>(args)...);
+				}
+				catch (...) {
+					std::allocator<T>{}.deallocate(memory, capacity);
+					throw;
+				}
+				this->relocate(memory, capacity);
+				++this->m_size;
+				return *ptr;
+			}
+			void relocate(T* memory, qpl::size capacity) {
+				std::uninitialized_move(this->begin(), this->end(), memory);
+				std::destroy(this->begin(), this->end());
+				this->m_storage.deallocate();
+				this->m_storage.heap = memory;
+				this->m_storage.capacity = capacity;
+			}
+			void take(inline_vector& other) {
+				if constexpr (HEAP) {
+					if (other.m_storage.heap) {
+						this->m_storage.heap = std::exchange(other.m_storage.heap, nullptr);
+						this->m_storage.capacity = std::exchange(other.m_storage.capacity, N);
+						this->m_size = std::exchange(other.m_size, 0u);
+						return;
+					}
+				}
+				std::uninitialized_move(other.begin(), other.end(), this->data());
+				this->m_size = other.m_size;
+				other.clear();
+			}
+
+			detail::inline_vector_storage<T, N, HEAP> m_storage;
+			qpl::size m_size = 0u;
+		};
+	}
+
+	//stores up to N elements inside the object and only allocates when it grows beyond that
+	template<typename T, qpl::size N, bool BOUNDARY_CHECK = detail::vector_boundary_check>
+	using small_vector = detail::inline_vector<T, N, BOUNDARY_CHECK, true>;
+
+	//fixed capacity of N elements inside the object, never allocates. growing beyond N throws
+	template<typename T, qpl::size N, bool BOUNDARY_CHECK = detail::vector_boundary_check>
+	using static_vector = detail::inline_vector<T, N, BOUNDARY_CHECK, false>;
+
+	//elements live in chunks of CHUNK_SIZE that never move, so pointers and references stay valid when the vector grows.
+	//random access costs a shift and a mask, CHUNK_SIZE must be a power of two
+	template<typename T, qpl::size CHUNK_SIZE = 64u, bool BOUNDARY_CHECK = detail::vector_boundary_check>
+	struct stable_vector {
+		static_assert(CHUNK_SIZE && !(CHUNK_SIZE & (CHUNK_SIZE - 1)), "qpl::stable_vector: CHUNK_SIZE must be a power of two");
+
+		using value_type = T;
+		using size_type = qpl::size;
+		using difference_type = std::ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+
+		template<bool CONST>
+		struct iterator_t {
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::random_access_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = qpl::conditional<qpl::if_true<CONST>, const T*, T*>;
+			using reference = qpl::conditional<qpl::if_true<CONST>, const T&, T&>;
+			using container = qpl::conditional<qpl::if_true<CONST>, const stable_vector*, stable_vector*>;
+
+			iterator_t() = default;
+			iterator_t(container owner, qpl::size index) : owner(owner), index(index) {
+
+			}
+			operator iterator_t<true>() const {
+				return iterator_t<true>(this->owner, this->index);
+			}
+
+			reference operator*() const {
+				return this->owner->element(this->index);
+			}
+			pointer operator->() const {
+				return &this->owner->element(this->index);
+			}
+			reference operator[](difference_type n) const {
+				return this->owner->element(this->index + n);
+			}
+			iterator_t& operator++() {
+				++this->index;
+				return *this;
+			}
+			iterator_t operator++(int) {
+				auto copy = *this;
+				++this->index;
+				return copy;
+			}
+			iterator_t& operator--() {
+				--this->index;
+				return *this;
+			}
+			iterator_t operator--(int) {
+				auto copy = *this;
+				--this->index;
+				return copy;
+			}
+			iterator_t& operator+=(difference_type n) {
+				this->index += n;
+				return *this;
+			}
+			iterator_t& operator-=(difference_type n) {
+				this->index -= n;
+				return *this;
+			}
+			iterator_t operator+(difference_type n) const {
+				return iterator_t(this->owner, this->index + n);
+			}
+			friend iterator_t operator+(difference_type n, const iterator_t& it) {
+				return it + n;
+			}
+			iterator_t operator-(difference_type n) const {
+				return iterator_t(this->owner, this->index - n);
+			}
+			difference_type operator-(const iterator_t& other) const {
+				return static_cast<difference_type>(this->index) - static_cast<difference_type>(other.index);
+			}
+			bool operator==(const iterator_t& other) const {
+				return this->index == other.index;
+			}
+			auto operator<=>(const iterator_t& other) const {
+				return this->index <=> other.index;
+			}
+
+			container owner = nullptr;
+			qpl::size index = 0u;
+		};
+		using iterator = iterator_t<false>;
+		using const_iterator = iterator_t<true>;
+
+		stable_vector() {
+
+		}
+		explicit stable_vector(qpl::size size) {
+			this->resize(size);
 		}
+		stable_vector(qpl::size size, const T& value) {
+			this->resize(size, value);
+		}
+		stable_vector(std::initializer_list<T> list) {
+			this->assign(list.begin(), list.end());
+		}
+		template<std::input_iterator I>
+		stable_vector(I first, I last) {
+			this->assign(first, last);
+		}
+		stable_vector(const stable_vector& other) {
+			this->assign(other.begin(), other.end());
+		}
+		stable_vector(stable_vector&& other) noexcept : m_chunks(std::move(other.m_chunks)), m_size(std::exchange(other.m_size, 0u)) {
+
+		}
+		~stable_vector() {
+			this->clear();
+			this->shrink_to_fit();
+		}
+
+		stable_vector& operator=(const stable_vector& other) {
+			if (this != &other) {
+				this->assign(other.begin(), other.end());
+			}
+			return *this;
+		}
+		stable_vector& operator=(stable_vector&& other) noexcept {
+			if (this != &other) {
+				this->clear();
+				this->shrink_to_fit();
+				this->m_chunks = std::move(other.m_chunks);
+				this->m_size = std::exchange(other.m_size, 0u);
+			}
+			return *this;
+		}
+
+		template<std::input_iterator I>
+		void assign(I first, I last) {
+			this->clear();
+			if constexpr (std::forward_iterator<I>) {
+				this->reserve(qpl::size_cast(std::distance(first, last)));
+			}
+			for (; first != last; ++first) {
+				this->emplace_back(*first);
+			}
+		}
+
+		constexpr static qpl::size chunk_size() {
+			return CHUNK_SIZE;
+		}
+		qpl::size size() const {
+			return this->m_size;
+		}
+		qpl::size capacity() const {
+			return this->m_chunks.size() * CHUNK_SIZE;
+		}
+		bool empty() const {
+			return this->m_size == 0u;
+		}
+
+		T& operator[](qpl::size index) {
+			if constexpr (BOUNDARY_CHECK) {
+				this->index_check(index, false);
+			}
+			return this->element(index);
+		}
+		const T& operator[](qpl::size index) const {
+			if constexpr (BOUNDARY_CHECK) {
+				this->index_check(index, false);
+			}
+			return this->element(index);
+		}
+		T& at(qpl::size index) {
+			this->index_check(index, true);
+			return this->element(index);
+		}
+		const T& at(qpl::size index) const {
+			this->index_check(index, true);
+			return this->element(index);
+		}
+		T& front() {
+			if constexpr (BOUNDARY_CHECK) {
+				this->front_check(true);
+			}
+			return this->element(0u);
+		}
+		const T& front() const {
+			if constexpr (BOUNDARY_CHECK) {
+				this->front_check(true);
+			}
+			return this->element(0u);
+		}
+		T& back() {
+			if constexpr (BOUNDARY_CHECK) {
+				this->front_check(false);
+			}
+			return this->element(this->m_size - 1);
+		}
+		const T& back() const {
+			if constexpr (BOUNDARY_CHECK) {
+				this->front_check(false);
+			}
+			return this->element(this->m_size - 1);
+		}
+
+		iterator begin() {
+			return iterator(this, 0u);
+		}
+		const_iterator begin() const {
+			return const_iterator(this, 0u);
+		}
+		const_iterator cbegin() const {
+			return const_iterator(this, 0u);
+		}
+		iterator end() {
+			return iterator(this, this->m_size);
+		}
+		const_iterator end() const {
+			return const_iterator(this, this->m_size);
+		}
+		const_iterator cend() const {
+			return const_iterator(this, this->m_size);
+		}
+
+		void reserve(qpl::size capacity) {
+			this->m_chunks.reserve((capacity + CHUNK_SIZE - 1) / CHUNK_SIZE);
+			while (this->capacity() < capacity) {
+				this->m_chunks.push_back(std::allocator<T>{}.allocate(CHUNK_SIZE));
+			}
+		}
+		//frees the chunks that hold no elements
+		void shrink_to_fit() {
+			auto used = (this->m_size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			while (this->m_chunks.size() > used) {
+				std::allocator<T>{}.deallocate(this->m_chunks.back(), CHUNK_SIZE);
+				this->m_chunks.pop_back();
+			}
+		}
+		void clear() {
+			while (this->m_size) {
+				this->pop_back();
+			}
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args) {
+			if (this->m_size == this->capacity()) {
+				//grown geometrically up front, so the push_back after allocating can't throw and leak the chunk
+				if (this->m_chunks.size() == this->m_chunks.capacity()) {
+					this->m_chunks.reserve(qpl::max(this->m_chunks.size() * 2u, qpl::size{ 1u }));
+				}
+				this->m_chunks.push_back(std::allocator<T>{}.allocate(CHUNK_SIZE));
+			}
+			auto ptr = std::construct_at(&this->element(this->m_size), std::forward<Args>(args)...);
+			++this->m_size;
+			return *ptr;
+		}
+		void push_back(const T& value) {
+			this->emplace_back(value);
+		}
+		void push_back(T&& value) {
+			this->emplace_back(std::move(value));
+		}
+		void pop_back() {
+			if constexpr (BOUNDARY_CHECK) {
+				this->front_check(false);
+			}
+			--this->m_size;
+			std::destroy_at(&this->element(this->m_size));
+		}
+
+		void resize(qpl::size size) {
+			while (this->m_size > size) {
+				this->pop_back();
+			}
+			this->reserve(size);
+			while (this->m_size < size) {
+				this->emplace_back();
+			}
+		}
+		void resize(qpl::size size, const T& value) {
+			while (this->m_size > size) {
+				this->pop_back();
+			}
+			this->reserve(size);
+			while (this->m_size < size) {
+				this->emplace_back(value);
+			}
+		}
+
+		bool operator==(const stable_vector& other) const {
+			return std::equal(this->begin(), this->end(), other.begin(), other.end());
+		}
+
+	private:
+		constexpr static qpl::size chunk_shift = std::countr_zero(CHUNK_SIZE);
+
+		T& element(qpl::size index) {
+			return this->m_chunks[index >> chunk_shift][index & (CHUNK_SIZE - 1)];
+		}
+		const T& element(qpl::size index) const {
+			return this->m_chunks[index >> chunk_shift][index & (CHUNK_SIZE - 1)];
+		}
+		void index_check(qpl::size index, bool at) const {
+			if (index >= this->m_size) {
+				throw qpl::exception("qpl::stable_vector<", qpl::type_name<T>(), ", ", CHUNK_SIZE, ">", at ? ".at()" : "::operator[]", " : index is ", index, " - size is ", this->m_size);
+			}
+		}
+		void front_check(bool front) const {
+			if (this->empty()) {
+				throw qpl::exception("qpl::stable_vector<", qpl::type_name<T>(), ", ", CHUNK_SIZE, ">", front ? ".front()" : ".back()", " : vector is empty");
+			}
+		}
+
+		std::vector<T*> m_chunks;
+		qpl::size m_size = 0u;
 	};
+
 	struct save_state;
 	struct load_state;
 
@@ -0,0 +1,107 @@
+#ifndef QPL_MEMORY_RESOURCE_HPP
+#define QPL_MEMORY_RESOURCE_HPP
+#pragma once
+
+#include <qpl/qpldeclspec.hpp>
+#include <qpl/vardef.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace qpl {
+
+	//passes everything to upstream and counts it. the counters are atomic so a shared resource can be measured from several threads
+	struct counting_resource : std::pmr::memory_resource {
+		QPLDLL counting_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+		QPLDLL qpl::size allocations() const;
+		QPLDLL qpl::size deallocations() const;
+		QPLDLL qpl::size bytes_allocated() const;
+		QPLDLL qpl::size bytes_in_use() const;
+		QPLDLL qpl::size peak_bytes_in_use() const;
+		QPLDLL void reset_statistics();
+		QPLDLL std::pmr::memory_resource* upstream() const;
+
+	private:
+		QPLDLL void* do_allocate(qpl::size bytes, qpl::size alignment) override;
+		QPLDLL void do_deallocate(void* ptr, qpl::size bytes, qpl::size alignment) override;
+		QPLDLL bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		std::pmr::memory_resource* m_upstream;
+		std::atomic<qpl::size> m_allocations = 0u;
+		std::atomic<qpl::size> m_deallocations = 0u;
+		std::atomic<qpl::size> m_bytes_allocated = 0u;
+		std::atomic<qpl::size> m_bytes_in_use = 0u;
+		std::atomic<qpl::size> m_peak_bytes_in_use = 0u;
+	};
+
+	//monotonic bump allocator: deallocate does nothing, everything is given back at once with release() or on destruction.
+	//blocks grow geometrically, an optional initial buffer (e.g. on the stack) is used first. not thread safe
+	struct arena_resource : std::pmr::memory_resource {
+		QPLDLL arena_resource(qpl::size initial_block_size = 4096u, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+		QPLDLL arena_resource(std::span<std::byte> initial_buffer, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+		arena_resource(const arena_resource&) = delete;
+		arena_resource& operator=(const arena_resource&) = delete;
+		QPLDLL ~arena_resource();
+
+		QPLDLL void release();
+		QPLDLL qpl::size bytes_used() const;
+		QPLDLL qpl::size bytes_reserved() const;
+
+	private:
+		QPLDLL void* do_allocate(qpl::size bytes, qpl::size alignment) override;
+		QPLDLL void do_deallocate(void* ptr, qpl::size bytes, qpl::size alignment) override;
+		QPLDLL bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		struct block {
+			std::byte* data;
+			qpl::size size;
+			qpl::size alignment;
+		};
+
+		std::pmr::memory_resource* m_upstream;
+		std::span<std::byte> m_initial_buffer;
+		std::vector<block> m_blocks;
+		std::byte* m_current = nullptr;
+		qpl::size m_remaining = 0u;
+		qpl::size m_next_block_size = 0u;
+		qpl::size m_initial_block_size = 0u;
+		qpl::size m_bytes_used = 0u;
+	};
+
+	//fixed size object pool: every allocation up to object_size bytes gets one slot, freed slots go onto an intrusive free list.
+	//bigger or over-aligned requests are forwarded to upstream. not thread safe
+	struct pool_resource : std::pmr::memory_resource {
+		QPLDLL pool_resource(qpl::size object_size, qpl::size objects_per_chunk = 256u, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+		pool_resource(const pool_resource&) = delete;
+		pool_resource& operator=(const pool_resource&) = delete;
+		QPLDLL ~pool_resource();
+
+		QPLDLL void release();
+		QPLDLL qpl::size object_size() const;
+		QPLDLL qpl::size objects_in_use() const;
+		QPLDLL qpl::size capacity() const;
+
+	private:
+		QPLDLL void* do_allocate(qpl::size bytes, qpl::size alignment) override;
+		QPLDLL void do_deallocate(void* ptr, qpl::size bytes, qpl::size alignment) override;
+		QPLDLL bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		std::pmr::memory_resource* m_upstream;
+		std::vector<std::byte*> m_chunks;
+		void* m_free = nullptr;
+		qpl::size m_object_size;
+		qpl::size m_objects_per_chunk;
+		qpl::size m_in_use = 0u;
+	};
+
+	//size class free lists (16 to 1024 bytes) cached per thread, so allocating and freeing small objects takes no lock.
+	//a thread hands its cached blocks to a shared depot when it exits. the chunks behind the blocks are kept for the lifetime
+	//of the program, so a block may be freed on another thread than it was allocated on
+	QPLDLL std::pmr::memory_resource* thread_local_resource();
+}
+
+#endif
@@ -5,6 +5,9 @@
 #include <qpl/vector.hpp>
 #include <qpl/algorithm.hpp>
 #include <qpl/type_traits.hpp>
+#include <qpl/memory_resource.hpp>
+#include <qpl/flat_hash_map.hpp>
+#include <memory_resource>
 #include <queue>
 
 namespace qpl {
@@ -53,19 +56,25 @@ namespace qpl {
 	};
 
 	template<bool allow_diagonal, typename T, typename F> requires (std::is_integral_v<T> && qpl::is_callable<F>())
-	std::vector<qpl::vec2s> astar_path_finding(const std::vector<std::vector<T>>& maze, qpl::vec2s start, qpl::vec2s end, F valid_check) {
+	std::vector<qpl::vec2s> astar_path_finding(const std::vector<std::vector<T>>& maze, qpl::vec2s start, qpl::vec2s end, F valid_check, std::pmr::memory_resource* resource = nullptr) {
 		if (maze.empty()) {
 			return{};
 		}
+		//the nodes are taken from resource, if it's nullptr from a local arena that is released all at once
+		qpl::arena_resource arena;
+		if (!resource) {
+			resource = &arena;
+		}
+		std::pmr::polymorphic_allocator<qpl::astar_node> allocator(resource);
 
 		auto width = qpl::signed_cast(maze[0].size());
 		auto height = qpl::signed_cast(maze.size());
 
 		std::vector<std::shared_ptr<qpl::astar_node>> queue;
-		std::shared_ptr<qpl::astar_node> starting_node = std::make_shared<qpl::astar_node>(start, nullptr);
+		std::shared_ptr<qpl::astar_node> starting_node = std::allocate_shared<qpl::astar_node>(allocator, start, nullptr);
 		queue.push_back(starting_node);
 
-		std::unordered_set<qpl::vec2s> visited;
+		qpl::pmr::flat_hash_set<qpl::vec2s> visited(allocator);
 
 		constexpr auto direction = [&]() {
 			if constexpr (allow_diagonal) {
@@ -129,7 +138,7 @@ namespace qpl {
 						}
 
 						if (!found && !queue_found) {
-							auto next = std::make_shared<qpl::astar_node>(check, current_node);
+							auto next = std::allocate_shared<qpl::astar_node>(allocator, check, current_node);
 							children.push_back(next);
 						}
 					}
@@ -152,18 +161,24 @@ namespace qpl {
 
 
 	template<bool allow_diagonal, typename T, typename F> requires (std::is_integral_v<T> && qpl::is_callable<F>())
-	std::vector<qpl::vec2s> bfs_path_finding(const std::vector<std::vector<T>>& maze, qpl::vec2s start, qpl::vec2s end, F valid_check) {
+	std::vector<qpl::vec2s> bfs_path_finding(const std::vector<std::vector<T>>& maze, qpl::vec2s start, qpl::vec2s end, F valid_check, std::pmr::memory_resource* resource = nullptr) {
 		if (maze.empty()) {
 			return{};
 		}
+		//the nodes are taken from resource, if it's nullptr from a local arena that is released all at once
+		qpl::arena_resource arena;
+		if (!resource) {
+			resource = &arena;
+		}
+		std::pmr::polymorphic_allocator<qpl::bfs_node> allocator(resource);
 		auto width = qpl::signed_cast(maze[0].size());
 		auto height = qpl::signed_cast(maze.size());
 
 		std::queue<std::shared_ptr<qpl::bfs_node>> queue;
-		auto starting_node = std::make_shared<qpl::bfs_node>(start, nullptr);
+		auto starting_node = std::allocate_shared<qpl::bfs_node>(allocator, start, nullptr);
 		queue.push(starting_node);
 
-		std::unordered_set<qpl::vec2s> visited;
+		qpl::pmr::flat_hash_set<qpl::vec2s> visited(allocator);
 		visited.insert(start);
 
 		constexpr auto direction = [&]() {
@@ -209,7 +224,7 @@ namespace qpl {
 					if (valid) {
 						bool found = visited.find(check) != visited.cend();
 						if (!found) {
-							auto next = std::make_shared<qpl::bfs_node>(check, current_node);
+							auto next = std::allocate_shared<qpl::bfs_node>(allocator, check, current_node);
 							queue.push(next);
 							visited.insert(check);
 						}
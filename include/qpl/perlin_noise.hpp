@@ -6,8 +6,18 @@
 #include <qpl/random.hpp>
 #include <qpl/vardef.hpp>
 #include <qpl/bits.hpp>
+#include <qpl/exception.hpp>
+#include <qpl/thread_pool.hpp>
 #include <array>
+#include <cmath>
 #include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace qpl {
 	template<qpl::size bits, qpl::size N>
@@ -230,6 +240,321 @@ return array.back();
 			return fin / div;
 		}
 
+		//fills output (row-major, width * height) with get({ origin.x + x * step.x, origin.y + y * step.y }, freq, depth).
+		//the lattice hashes of a row are shared between neighbouring cells and rows are split across the pool
+		template<typename T>
+		void get_grid(std::span<T> output, qpl::size width, qpl::size height, qpl::vectorN<float_type, 2> origin, qpl::vectorN<float_type, 2> step, float_type freq, qpl::u32 depth, qpl::thread_pool& pool) const {
+			this->grid_2d(output, width, height, origin, step, freq, depth, &pool);
+		}
+		//thread_count = 1 runs on the calling thread, anything else uses qpl::default_thread_pool()
+		template<typename T>
+		void get_grid(std::span<T> output, qpl::size width, qpl::size height, qpl::vectorN<float_type, 2> origin, qpl::vectorN<float_type, 2> step, float_type freq, qpl::u32 depth, qpl::size thread_count = 1u) const {
+			this->grid_2d(output, width, height, origin, step, freq, depth, shared_pool(thread_count));
+		}
+		//fills output (x fastest, then y, then z) with get({ origin.x + x * step.x, origin.y + y * step.y, origin.z + z * step.z }, freq, depth)
+		template<typename T>
+		void get_grid(std::span<T> output, qpl::size width, qpl::size height, qpl::size length, qpl::vectorN<float_type, 3> origin, qpl::vectorN<float_type, 3> step, float_type freq, qpl::u32 depth, qpl::thread_pool& pool) const {
+			this->grid_3d(output, width, height, length, origin, step, freq, depth, &pool);
+		}
+		template<typename T>
+		void get_grid(std::span<T> output, qpl::size width, qpl::size height, qpl::size length, qpl::vectorN<float_type, 3> origin, qpl::vectorN<float_type, 3> step, float_type freq, qpl::u32 depth, qpl::size thread_count = 1u) const {
+			this->grid_3d(output, width, height, length, origin, step, freq, depth, shared_pool(thread_count));
+		}
+		//evaluates get for arbitrary coordinates. the lattice corners of the last cell are kept per octave,
+		//so coordinates that follow each other closely (paths, sorted or clustered points) skip the hashing
+		template<typename T, typename U, qpl::size M>
+		void get_many(std::span<const qpl::vectorN<U, M>> coords, std::span<T> output, float_type freq, qpl::u32 depth, qpl::thread_pool& pool) const {
+			this->many(coords, output, freq, depth, &pool);
+		}
+		template<typename T, typename U, qpl::size M>
+		void get_many(std::span<const qpl::vectorN<U, M>> coords, std::span<T> output, float_type freq, qpl::u32 depth, qpl::size thread_count = 1u) const {
+			this->many(coords, output, freq, depth, shared_pool(thread_count));
+		}
+
+	private:
+		static qpl::thread_pool* shared_pool(qpl::size thread_count) {
+			return thread_count == 1u ? nullptr : &qpl::default_thread_pool();
+		}
+		template<typename F>
+		static void for_each_row(qpl::size rows, qpl::thread_pool* pool, F&& function) {
+			if (!pool || rows < 2u) {
+				for (qpl::size i = 0u; i < rows; ++i) {
+					function(i);
+				}
+			}
+			else {
+				pool->parallel_for(rows, function);
+			}
+		}
+
+		template<typename T>
+		void grid_2d(std::span<T> output, qpl::size width, qpl::size height, qpl::vectorN<float_type, 2> origin, qpl::vectorN<float_type, 2> step, float_type freq, qpl::u32 depth, qpl::thread_pool* pool) const {
+			if (output.size() < width * height) {
+				throw qpl::exception("perlin_noise::get_grid: output holds ", output.size(), " values, ", width * height, " needed");
+			}
+			this->for_each_row(height, pool, [&](qpl::size y) {
+				this->grid_row(output.subspan(y * width, width), origin.x, step.x, std::array{ origin.y + y * step.y }, freq, depth);
+			});
+		}
+		template<typename T>
+		void grid_3d(std::span<T> output, qpl::size width, qpl::size height, qpl::size length, qpl::vectorN<float_type, 3> origin, qpl::vectorN<float_type, 3> step, float_type freq, qpl::u32 depth, qpl::thread_pool* pool) const {
+			if (output.size() < width * height * length) {
+				throw qpl::exception("perlin_noise::get_grid: output holds ", output.size(), " values, ", width * height * length, " needed");
+			}
+			this->for_each_row(height * length, pool, [&](qpl::size row) {
+				auto [z, y] = std::make_pair(row / height, row % height);
+				this->grid_row(output.subspan(row * width, width), origin.x, step.x, std::array{ origin.y + y * step.y, origin.z + z * step.z }, freq, depth);
+			});
+		}
+
+		template<qpl::size M>
+		struct lattice_cell {
+			std::array<int_type, M> floor;
+			std::array<float_type, qpl::size{ 1u } << M> corner;
+			bool valid = false;
+		};
+		//same corners and interpolation order as noise2d / noise3d, the hashes are only recomputed when the cell changes
+		template<qpl::size M>
+		float_type cell_noise(const std::array<float_type, M>& position, lattice_cell<M>& cell) const {
+			constexpr qpl::size corners = qpl::size{ 1u } << M;
+			std::array<int_type, M> floor;
+			std::array<float_type, M> delta;
+			for (qpl::size d = 0u; d < M; ++d) {
+				floor[d] = static_cast<int_type>(std::floor(position[d]));
+				delta[d] = position[d] - floor[d];
+			}
+			if (!cell.valid || floor != cell.floor) {
+				std::array<int_type, M> location;
+				for (qpl::size c = 0u; c < corners; ++c) {
+					for (qpl::size d = 0u; d < M; ++d) {
+						location[d] = static_cast<int_type>(floor[d] + qpl::get_bit(c, d));
+					}
+					cell.corner[c] = static_cast<float_type>(this->get_coord_hash(location));
+				}
+				cell.floor = floor;
+				cell.valid = true;
+			}
+			auto values = cell.corner;
+			for (qpl::size d = 0u; d < M; ++d) {
+				for (qpl::size i = 0u; i < (corners >> (d + 1)); ++i) {
+					values[i] = smooth_interpolation(values[i * 2], values[i * 2 + 1], delta[d]);
+				}
+			}
+			return values[0];
+		}
+		template<typename T, typename U, qpl::size M>
+		void many(std::span<const qpl::vectorN<U, M>> coords, std::span<T> output, float_type freq, qpl::u32 depth, qpl::thread_pool* pool) const {
+			if (output.size() < coords.size()) {
+				throw qpl::exception("perlin_noise::get_many: output holds ", output.size(), " values, ", coords.size(), " needed");
+			}
+			constexpr qpl::size block = 1024u;
+			this->for_each_row((coords.size() + block - 1) / block, pool, [&](qpl::size b) {
+				auto end = qpl::min(coords.size(), (b + 1) * block);
+				if constexpr (M == 2 || M == 3) {
+					std::vector<lattice_cell<M>> cells(depth);
+					for (auto i = b * block; i < end; ++i) {
+						float_type amp = 1.0;
+						float_type fin = 0;
+						float_type div = 0.0;
+						qpl::vectorN<float_type, M> pos = coords[i] * freq;
+						for (qpl::u32 octave = 0u; octave < depth; ++octave) {
+							div += N * amp;
+							fin += this->cell_noise(pos.data, cells[octave]) * amp;
+							amp /= 2;
+							pos *= 2;
+						}
+						output[i] = static_cast<T>(fin / div);
+					}
+				}
+				else {
+					for (auto i = b * block; i < end; ++i) {
+						output[i] = static_cast<T>(this->get(coords[i], freq, depth));
+					}
+				}
+			});
+		}
+
+		//result[x] += amp * interpolation of the lattice values of x, lattice holds corners * 2 planes of width values.
+		//the corner hashes are gathered by the scalar pass in grid_row, this is the part that vectorizes
+		template<qpl::size M>
+		static void interpolate_row(std::span<float_type> result, const std::vector<float_type>& lattice, const std::vector<float_type>& dx, std::array<float_type, M> fixed_delta, float_type amp) {
+			auto width = result.size();
+			auto plane = [&](qpl::size k) {
+				return lattice.data() + k * width;
+			};
+			std::array<float_type, M> fixed_factor;
+			for (qpl::size d = 0u; d < M; ++d) {
+				auto s = fixed_delta[d];
+				fixed_factor[d] = s * s * (3 - 2 * s);
+			}
+
+			qpl::size x = 0u;
+#if defined(__AVX2__)
+			if constexpr (std::is_same_v<float_type, qpl::f64>) {
+				auto lerp = [](__m256d a, __m256d b, __m256d t) {
+					return _mm256_add_pd(a, _mm256_mul_pd(t, _mm256_sub_pd(b, a)));
+				};
+				const auto three = _mm256_set1_pd(3.0);
+				const auto two = _mm256_set1_pd(2.0);
+				const auto amp_v = _mm256_set1_pd(amp);
+				std::array<__m256d, M> fixed_v;
+				for (qpl::size d = 0u; d < M; ++d) {
+					fixed_v[d] = _mm256_set1_pd(fixed_factor[d]);
+				}
+				for (; x + 4u <= width; x += 4u) {
+					auto s = _mm256_loadu_pd(dx.data() + x);
+					auto t = _mm256_mul_pd(_mm256_mul_pd(s, s), _mm256_sub_pd(three, _mm256_mul_pd(two, s)));
+					__m256d value;
+					if constexpr (M == 1) {
+						auto a = lerp(_mm256_loadu_pd(plane(0) + x), _mm256_loadu_pd(plane(1) + x), t);
+						auto b = lerp(_mm256_loadu_pd(plane(2) + x), _mm256_loadu_pd(plane(3) + x), t);
+						value = lerp(a, b, fixed_v[0]);
+					}
+					else {
+						auto x00 = lerp(_mm256_loadu_pd(plane(0) + x), _mm256_loadu_pd(plane(1) + x), t);
+						auto x10 = lerp(_mm256_loadu_pd(plane(2) + x), _mm256_loadu_pd(plane(3) + x), t);
+						auto x01 = lerp(_mm256_loadu_pd(plane(4) + x), _mm256_loadu_pd(plane(5) + x), t);
+						auto x11 = lerp(_mm256_loadu_pd(plane(6) + x), _mm256_loadu_pd(plane(7) + x), t);
+						auto y0 = lerp(x00, x10, fixed_v[0]);
+						auto y1 = lerp(x01, x11, fixed_v[0]);
+						value = lerp(y0, y1, fixed_v[1]);
+					}
+					auto sum = _mm256_add_pd(_mm256_loadu_pd(result.data() + x), _mm256_mul_pd(value, amp_v));
+					_mm256_storeu_pd(result.data() + x, sum);
+				}
+			}
+			else if constexpr (std::is_same_v<float_type, qpl::f32>) {
+				auto lerp = [](__m256 a, __m256 b, __m256 t) {
+					return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+				};
+				const auto three = _mm256_set1_ps(3.0f);
+				const auto two = _mm256_set1_ps(2.0f);
+				const auto amp_v = _mm256_set1_ps(amp);
+				std::array<__m256, M> fixed_v;
+				for (qpl::size d = 0u; d < M; ++d) {
+					fixed_v[d] = _mm256_set1_ps(fixed_factor[d]);
+				}
+				for (; x + 8u <= width; x += 8u) {
+					auto s = _mm256_loadu_ps(dx.data() + x);
+					auto t = _mm256_mul_ps(_mm256_mul_ps(s, s), _mm256_sub_ps(three, _mm256_mul_ps(two, s)));
+					__m256 value;
+					if constexpr (M == 1) {
+						auto a = lerp(_mm256_loadu_ps(plane(0) + x), _mm256_loadu_ps(plane(1) + x), t);
+						auto b = lerp(_mm256_loadu_ps(plane(2) + x), _mm256_loadu_ps(plane(3) + x), t);
+						value = lerp(a, b, fixed_v[0]);
+					}
+					else {
+						auto x00 = lerp(_mm256_loadu_ps(plane(0) + x), _mm256_loadu_ps(plane(1) + x), t);
+						auto x10 = lerp(_mm256_loadu_ps(plane(2) + x), _mm256_loadu_ps(plane(3) + x), t);
+						auto x01 = lerp(_mm256_loadu_ps(plane(4) + x), _mm256_loadu_ps(plane(5) + x), t);
+						auto x11 = lerp(_mm256_loadu_ps(plane(6) + x), _mm256_loadu_ps(plane(7) + x), t);
+						auto y0 = lerp(x00, x10, fixed_v[0]);
+						auto y1 = lerp(x01, x11, fixed_v[0]);
+						value = lerp(y0, y1, fixed_v[1]);
+					}
+					auto sum = _mm256_add_ps(_mm256_loadu_ps(result.data() + x), _mm256_mul_ps(value, amp_v));
+					_mm256_storeu_ps(result.data() + x, sum);
+				}
+			}
+#endif
+			for (; x < width; ++x) {
+				auto s = dx[x];
+				auto t = s * s * (3 - 2 * s);
+				float_type value;
+				if constexpr (M == 1) {
+					auto a = linear_interpolation(plane(0)[x], plane(1)[x], t);
+					auto b = linear_interpolation(plane(2)[x], plane(3)[x], t);
+					value = linear_interpolation(a, b, fixed_factor[0]);
+				}
+				else {
+					auto x00 = linear_interpolation(plane(0)[x], plane(1)[x], t);
+					auto x10 = linear_interpolation(plane(2)[x], plane(3)[x], t);
+					auto x01 = linear_interpolation(plane(4)[x], plane(5)[x], t);
+					auto x11 = linear_interpolation(plane(6)[x], plane(7)[x], t);
+					auto y0 = linear_interpolation(x00, x10, fixed_factor[0]);
+					auto y1 = linear_interpolation(x01, x11, fixed_factor[0]);
+					value = linear_interpolation(y0, y1, fixed_factor[1]);
+				}
+				result[x] += value * amp;
+			}
+		}
+
+		//one row along x. fixed holds the y (and z) coordinate of the row, the hash chain over them is computed once per octave
+		template<typename T, qpl::size M>
+		void grid_row(std::span<T> output, float_type origin_x, float_type step_x, std::array<float_type, M> fixed, float_type freq, qpl::u32 depth) const {
+			constexpr qpl::size corners = qpl::size{ 1u } << M;
+			auto width = output.size();
+
+			std::vector<float_type> position(width);
+			std::vector<float_type> result(width, float_type{ 0 });
+			std::vector<float_type> dx(width);
+			std::vector<float_type> lattice(width * corners * 2);
+			for (qpl::size x = 0u; x < width; ++x) {
+				position[x] = (origin_x + x * step_x) * freq;
+			}
+			for (auto& i : fixed) {
+				i *= freq;
+			}
+
+			float_type amp = 1.0;
+			float_type div = 0.0;
+			for (qpl::u32 octave = 0u; octave < depth; ++octave) {
+				div += N * amp;
+
+				//hash chain over the fixed coordinates: row_hash[c] for every combination c of floor / floor + 1
+				std::array<int_type, corners> row_hash;
+				std::array<float_type, M> fixed_delta;
+				std::array<int_type, M> fixed_floor;
+				for (qpl::size d = 0u; d < M; ++d) {
+					fixed_floor[d] = static_cast<int_type>(std::floor(fixed[d]));
+					fixed_delta[d] = fixed[d] - fixed_floor[d];
+				}
+				for (qpl::size c = 0u; c < corners; ++c) {
+					int_type h = 0;
+					for (qpl::size d = 0u; d < M; ++d) {
+						auto coord = static_cast<int_type>(fixed_floor[M - d - 1] + qpl::get_bit(c, M - d - 1));
+						h = this->m_hash[(h + coord) % N];
+					}
+					row_hash[c] = h;
+				}
+
+				int_type last_floor = 0;
+				bool has_last = false;
+				std::array<float_type, corners * 2> current{};
+
+				//the lattice hashes only change when the cell along x changes, same corners as noise2d / noise3d
+				for (qpl::size x = 0u; x < width; ++x) {
+					auto px = position[x];
+					auto ix = static_cast<int_type>(std::floor(px));
+					if (!has_last || ix != last_floor) {
+						for (qpl::size c = 0u; c < corners; ++c) {
+							current[c * 2 + 0] = static_cast<float_type>(this->m_hash[(row_hash[c] + ix) % N]);
+							current[c * 2 + 1] = static_cast<float_type>(this->m_hash[(row_hash[c] + ix + 1) % N]);
+						}
+						last_floor = ix;
+						has_last = true;
+					}
+					dx[x] = px - ix;
+					for (qpl::size k = 0u; k < corners * 2; ++k) {
+						lattice[k * width + x] = current[k];
+					}
+				}
+				interpolate_row(std::span<float_type>(result), lattice, dx, fixed_delta, amp);
+
+				amp /= 2;
+				for (auto& i : position) {
+					i *= 2;
+				}
+				for (auto& i : fixed) {
+					i *= 2;
+				}
+			}
+			for (qpl::size x = 0u; x < width; ++x) {
+				output[x] = static_cast<T>(result[x] / div);
+			}
+		}
+
+	public:
 
 
 		void construct() {
@@ -8,6 +8,8 @@
 #include <vector>
 #include <array>
 #include <string>
+#include <span>
+#include <type_traits>
 
 namespace qpl {
 	struct pixel_rgba {
@@ -48,15 +50,119 @@ namespace qpl {
 		QPLDLL std::string string() const;
 	};
 
+	static_assert(sizeof(pixel_rgb) == 3u && sizeof(pixel_rgba) == 4u, "qpl::pixel_rgb / qpl::pixel_rgba must be tightly packed");
+
+	namespace detail {
+		//out of line so this header doesn't need qpl/exception.hpp, which would include it back through winsys.hpp
+		[[noreturn]] QPLDLL void throw_image_view_sub(qpl::u32 x, qpl::u32 y, qpl::u32 width, qpl::u32 height, qpl::u32 view_width, qpl::u32 view_height);
+	}
+
+	//non owning view over rows of pixels. stride is the distance in bytes between the starts of two rows, so padded rows (bmp, GetDIBits) and sub rectangles work without copying.
+	//rows are in memory order: for qpl::pixels (bmp order) row 0 is the bottom row of the picture
+	template<typename P>
+	struct image_view {
+		using pixel_type = P;
+		using byte_type = std::conditional_t<std::is_const_v<P>, const char, char>;
+
+		P* data = nullptr;
+		qpl::u32 width = 0u;
+		qpl::u32 height = 0u;
+		qpl::size stride = 0u;
+
+		image_view() = default;
+		image_view(P* data, qpl::u32 width, qpl::u32 height, qpl::size stride) : data(data), width(width), height(height), stride(stride) {
+
+		}
+		image_view(P* data, qpl::u32 width, qpl::u32 height) : data(data), width(width), height(height), stride(width * sizeof(P)) {
+
+		}
+		operator image_view<const P>() const requires (!std::is_const_v<P>) {
+			return image_view<const P>(this->data, this->width, this->height, this->stride);
+		}
+
+		P* row(qpl::u32 y) const {
+			return reinterpret_cast<P*>(reinterpret_cast<byte_type*>(this->data) + y * this->stride);
+		}
+		P& at(qpl::u32 x, qpl::u32 y) const {
+			return this->row(y)[x];
+		}
+		image_view sub(qpl::u32 x, qpl::u32 y, qpl::u32 width, qpl::u32 height) const {
+			if (qpl::size{ x } + width > this->width || qpl::size{ y } + height > this->height) {
+				qpl::detail::throw_image_view_sub(x, y, width, height, this->width, this->height);
+			}
+			return image_view(this->row(y) + x, width, height, this->stride);
+		}
+		bool contiguous() const {
+			return this->stride == this->width * sizeof(P);
+		}
+		bool empty() const {
+			return !this->width || !this->height;
+		}
+		qpl::size size() const {
+			return qpl::size{ this->width } * this->height;
+		}
+	};
+
+	struct image_difference {
+		qpl::size different_pixels = 0u;
+		qpl::u64 total_difference = 0u;
+		qpl::u8 max_difference = 0u;
+	};
+	struct image_histogram {
+		std::array<qpl::u32, 256> r{};
+		std::array<qpl::u32, 256> g{};
+		std::array<qpl::u32, 256> b{};
+		std::array<qpl::u32, 256> a{};
+	};
+
+	//copies the overlapping region of source onto destination at (x, y), clipped to the destination
+	QPLDLL void blit(image_view<const pixel_rgb> source, image_view<pixel_rgb> destination, qpl::i32 x = 0, qpl::i32 y = 0);
+	QPLDLL void blit(image_view<const pixel_rgba> source, image_view<pixel_rgba> destination, qpl::i32 x = 0, qpl::i32 y = 0);
+
+	//resamples source to the dimension of destination. box averages all covered source pixels (use it to shrink), bilinear interpolates between the 4 nearest
+	QPLDLL void scale_box(image_view<const pixel_rgb> source, image_view<pixel_rgb> destination);
+	QPLDLL void scale_box(image_view<const pixel_rgba> source, image_view<pixel_rgba> destination);
+	QPLDLL void scale_bilinear(image_view<const pixel_rgb> source, image_view<pixel_rgb> destination);
+	QPLDLL void scale_bilinear(image_view<const pixel_rgba> source, image_view<pixel_rgba> destination);
+
+	QPLDLL void convert_pixels(image_view<const pixel_rgb> source, image_view<pixel_rgba> destination, qpl::u8 alpha = qpl::u8_max);
+	QPLDLL void convert_pixels(image_view<const pixel_rgba> source, image_view<pixel_rgb> destination);
+
+	//a pixel counts as different if any channel differs by more than threshold
+	QPLDLL qpl::image_difference image_compare(image_view<const pixel_rgb> a, image_view<const pixel_rgb> b, qpl::u8 threshold = 0u);
+	QPLDLL qpl::image_difference image_compare(image_view<const pixel_rgba> a, image_view<const pixel_rgba> b, qpl::u8 threshold = 0u);
+	//writes the absolute difference of every channel
+	QPLDLL void image_difference_map(image_view<const pixel_rgb> a, image_view<const pixel_rgb> b, image_view<pixel_rgb> destination);
+	QPLDLL void image_difference_map(image_view<const pixel_rgba> a, image_view<const pixel_rgba> b, image_view<pixel_rgba> destination);
+
+	QPLDLL qpl::image_histogram histogram(image_view<const pixel_rgb> source);
+	QPLDLL qpl::image_histogram histogram(image_view<const pixel_rgba> source);
+
+	//data is stored in bmp order: BGR, bottom row first
 	struct pixels {
 		QPLDLL void load(std::string_view sv);
+		//parses the bmp header (24 or 32 bit, bottom-up or top-down) and sets the dimension.
+		//before it copied the raw bytes after a fixed 64 byte offset and left width / height untouched
 		QPLDLL void load_bmp(std::string_view sv);
+		QPLDLL void load_ppm(std::string_view sv);
 		QPLDLL void set_dimension(qpl::u32 width, qpl::u32 height);
 		QPLDLL pixels rectangle(qpl::u32 x, qpl::u32 y, qpl::u32 width, qpl::u32 height) const;
+		QPLDLL void assign(image_view<const pixel_rgb> view);
 		qpl::size size() const;
 
+		QPLDLL image_view<pixel_rgb> view();
+		QPLDLL image_view<const pixel_rgb> view() const;
+
+		//encode_* write into a caller provided buffer (e.g. a preallocated string or a mapped file) of at least *_size() bytes and return the written size
+		QPLDLL qpl::size bmp_size() const;
+		QPLDLL qpl::size encode_bmp(std::span<char> output) const;
+		QPLDLL qpl::size ppm_size() const;
+		QPLDLL qpl::size encode_ppm(std::span<char> output) const;
+
 		QPLDLL std::string generate_bmp_string() const;
 		QPLDLL void generate_bmp(std::string filename) const;
+		QPLDLL std::string generate_ppm_string() const;
+		QPLDLL void generate_ppm(std::string filename) const;
 		
 		std::vector<pixel_rgb> data;
 		qpl::u32 width = 0u;
@@ -69,6 +175,7 @@ namespace qpl {
 
 		QPLDLL std::array<char, info_header_size> create_bitmap_info_header(qpl::size width, qpl::size height);
 		QPLDLL std::array<char, file_header_size> create_bitmap_file_header(qpl::size width, qpl::size height, qpl::size padding_size);
+		QPLDLL std::string ppm_header(qpl::size width, qpl::size height);
 	}
 }
 
@@ -44,6 +44,7 @@ freely, subject to the following restrictions:
 #include <qpl/encryption.hpp>
 #include <qpl/exception.hpp>
 #include <qpl/filesys.hpp>
+#include <qpl/flat_hash_map.hpp>
 #include <qpl/fraction.hpp>
 #include <qpl/intrinsics.hpp>
 #include <qpl/iterator.hpp>
@@ -51,16 +52,19 @@ freely, subject to the following restrictions:
 #include <qpl/number.hpp>
 #include <qpl/maths.hpp>
 #include <qpl/memory.hpp>
+#include <qpl/memory_resource.hpp>
 #include <qpl/obfuscate.hpp>
 #include <qpl/neural_net.hpp>
 #include <qpl/path_finding.hpp>
 #include <qpl/perlin_noise.hpp>
 #include <qpl/pictures.hpp>
 #include <qpl/random.hpp>
+#include <qpl/shared_memory.hpp>
 #include <qpl/smooth.hpp>
 #include <qpl/signal.hpp>
 #include <qpl/string.hpp>
 #include <qpl/system.hpp>
+#include <qpl/thread_pool.hpp>
 #include <qpl/time.hpp>
 #include <qpl/type_traits.hpp>
 #include <qpl/vardef.hpp>
@@ -13,6 +13,11 @@
 #include <type_traits>
 #include <random>
 #include <iostream>
+#include <span>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace qpl {
 	//2^19937-1
@@ -569,6 +574,155 @@ namespace qpl {
 		return result;
 	}
 
+	namespace detail {
+		//splitmix64 finalizer
+		constexpr qpl::u64 white_noise_mix(qpl::u64 z) {
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+		constexpr qpl::u64 white_noise_row_key(qpl::u64 seed, qpl::u64 y) {
+			return white_noise_mix(seed ^ (y * 0xD6E8FEB86659FD93ull) ^ 0x9E3779B97F4A7C15ull);
+		}
+		constexpr qpl::u64 white_noise_cell(qpl::u64 row_key, qpl::u64 x) {
+			return white_noise_mix(row_key ^ (x * 0xA0761D6478BD642Full));
+		}
+
+		//AVX2 and SSE2 have no 64 bit multiply, the low 64 bits are put together from three 32 bit multiplies.
+		//that is the same value as the scalar multiply, so the vector paths of white_noise_cells match white_noise_cell
+#if defined(__AVX2__)
+		inline __m256i white_noise_multiply(__m256i a, qpl::u64 b) {
+			auto low = _mm256_mul_epu32(a, _mm256_set1_epi64x(static_cast<long long>(b)));
+			auto cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_set1_epi64x(static_cast<long long>(b))), _mm256_mul_epu32(a, _mm256_set1_epi64x(static_cast<long long>(b >> 32))));
+			return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+		}
+		inline __m256i white_noise_mix(__m256i z) {
+			z = white_noise_multiply(_mm256_xor_si256(z, _mm256_srli_epi64(z, 30)), 0xBF58476D1CE4E5B9ull);
+			z = white_noise_multiply(_mm256_xor_si256(z, _mm256_srli_epi64(z, 27)), 0x94D049BB133111EBull);
+			return _mm256_xor_si256(z, _mm256_srli_epi64(z, 31));
+		}
+#elif defined(__SSE2__)
+		inline __m128i white_noise_multiply(__m128i a, qpl::u64 b) {
+			auto low = _mm_mul_epu32(a, _mm_set1_epi64x(static_cast<long long>(b)));
+			auto cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_set1_epi64x(static_cast<long long>(b))), _mm_mul_epu32(a, _mm_set1_epi64x(static_cast<long long>(b >> 32))));
+			return _mm_add_epi64(low, _mm_slli_epi64(cross, 32));
+		}
+		inline __m128i white_noise_mix(__m128i z) {
+			z = white_noise_multiply(_mm_xor_si128(z, _mm_srli_epi64(z, 30)), 0xBF58476D1CE4E5B9ull);
+			z = white_noise_multiply(_mm_xor_si128(z, _mm_srli_epi64(z, 27)), 0x94D049BB133111EBull);
+			return _mm_xor_si128(z, _mm_srli_epi64(z, 31));
+		}
+#endif
+
+		//output[i] = white_noise_cell(row_key, x + i), 4 (AVX2) or 2 (SSE2) cells at a time
+		inline void white_noise_cells(qpl::u64 row_key, qpl::u64 x, qpl::u64* output, qpl::size count) {
+			[[maybe_unused]] constexpr qpl::u64 step = 0xA0761D6478BD642Full;
+			qpl::size i = 0u;
+#if defined(__AVX2__)
+			auto key = _mm256_set1_epi64x(static_cast<long long>(row_key));
+			auto position = _mm256_set_epi64x(static_cast<long long>((x + 3u) * step), static_cast<long long>((x + 2u) * step), static_cast<long long>((x + 1u) * step), static_cast<long long>(x * step));
+			auto increment = _mm256_set1_epi64x(static_cast<long long>(4u * step));
+			for (; i + 4u <= count; i += 4u) {
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), white_noise_mix(_mm256_xor_si256(key, position)));
+				position = _mm256_add_epi64(position, increment);
+			}
+#elif defined(__SSE2__)
+			auto key = _mm_set1_epi64x(static_cast<long long>(row_key));
+			auto position = _mm_set_epi64x(static_cast<long long>((x + 1u) * step), static_cast<long long>(x * step));
+			auto increment = _mm_set1_epi64x(static_cast<long long>(2u * step));
+			for (; i + 2u <= count; i += 2u) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), white_noise_mix(_mm_xor_si128(key, position)));
+				position = _mm_add_epi64(position, increment);
+			}
+#endif
+			for (; i < count; ++i) {
+				output[i] = white_noise_cell(row_key, x + i);
+			}
+		}
+	}
+
+	//stateless coordinate hash: every value only depends on (seed, x, y), so it can be sampled in any order and shared between threads
+	template<qpl::size B = 64>
+	struct white_noise_hash_N {
+		using utype = qpl::ubit<B>;
+		using ftype = qpl::fbit<B>;
+
+		qpl::u64 seed = 5489ull;
+
+		constexpr void set_seed(qpl::u64 seed) {
+			this->seed = seed;
+		}
+
+		constexpr utype generate(qpl::i64 x, qpl::i64 y) const {
+			auto row = qpl::detail::white_noise_row_key(this->seed, qpl::u64_cast(y));
+			return convert(qpl::detail::white_noise_cell(row, qpl::u64_cast(x)));
+		}
+		constexpr ftype generate_0_1(qpl::i64 x, qpl::i64 y) const {
+			return this->generate(x, y) / static_cast<ftype>(qpl::type_max<utype>());
+		}
+
+		//fills a row-major width * height tile starting at (x, y), the rows go through qpl::detail::white_noise_cells
+		void fill(std::span<utype> output, qpl::i64 x, qpl::i64 y, qpl::size width, qpl::size height) const {
+			if (output.size() < width * height) {
+				throw qpl::exception("white_noise_hash_N::fill: output holds ", output.size(), " values, need ", width * height);
+			}
+			std::array<qpl::u64, 256u> buffer;
+			for (qpl::size j = 0u; j < height; ++j) {
+				auto row = qpl::detail::white_noise_row_key(this->seed, qpl::u64_cast(y) + j);
+				auto ptr = output.data() + j * width;
+				auto ux = qpl::u64_cast(x);
+				if constexpr (B == 64u) {
+					qpl::detail::white_noise_cells(row, ux, ptr, width);
+				}
+				else {
+					for (qpl::size i = 0u; i < width; i += buffer.size()) {
+						auto count = qpl::min(buffer.size(), width - i);
+						qpl::detail::white_noise_cells(row, ux + i, buffer.data(), count);
+						for (qpl::size k = 0u; k < count; ++k) {
+							ptr[i + k] = convert(buffer[k]);
+						}
+					}
+				}
+			}
+		}
+		void fill_0_1(std::span<ftype> output, qpl::i64 x, qpl::i64 y, qpl::size width, qpl::size height) const {
+			if (output.size() < width * height) {
+				throw qpl::exception("white_noise_hash_N::fill_0_1: output holds ", output.size(), " values, need ", width * height);
+			}
+			constexpr auto max = static_cast<ftype>(qpl::type_max<utype>());
+			std::array<qpl::u64, 256u> buffer;
+			for (qpl::size j = 0u; j < height; ++j) {
+				auto row = qpl::detail::white_noise_row_key(this->seed, qpl::u64_cast(y) + j);
+				auto ptr = output.data() + j * width;
+				auto ux = qpl::u64_cast(x);
+				for (qpl::size i = 0u; i < width; i += buffer.size()) {
+					auto count = qpl::min(buffer.size(), width - i);
+					qpl::detail::white_noise_cells(row, ux + i, buffer.data(), count);
+					for (qpl::size k = 0u; k < count; ++k) {
+						ptr[i + k] = convert(buffer[k]) / max;
+					}
+				}
+			}
+		}
+
+	private:
+		constexpr static utype convert(qpl::u64 value) {
+			if constexpr (B == 64u) {
+				return value;
+			}
+			else {
+				return static_cast<utype>(value >> (64u - B));
+			}
+		}
+	};
+	using white_noise_hash = white_noise_hash_N<64u>;
+
+	enum class white_noise_mode {
+		mersenne_twister,
+		hash,
+	};
+
+	//the mersenne_twister mode reproduces the values of older versions for the same seed. the hash mode is stateless and much faster for random access
 	template<qpl::size B = 64, qpl::size MN = 256u, qpl::u64 MX = 0xFA581ull, qpl::u64 MY = 0x17CD5ull >
 	struct white_noise_engine_N {
 		constexpr static qpl::u64 chunk_width = (B == 64u ? 17u : 24u);
@@ -583,9 +737,19 @@ namespace qpl {
 		qpl::u64 loaded_chunk = qpl::u64_max;
 		qpl::u64 loaded_seed_chunk = qpl::u64_max;
 		bool first = true;
+		qpl::white_noise_mode mode = qpl::white_noise_mode::mersenne_twister;
+		qpl::white_noise_hash_N<B> hasher;
+
+		void set_mode(qpl::white_noise_mode mode) {
+			this->mode = mode;
+		}
+		qpl::white_noise_mode get_mode() const {
+			return this->mode;
+		}
 
 		void set_seed(qpl::u64 seed) {
 			this->seed = seed;
+			this->hasher.set_seed(seed);
 
 			this->seed_engine.seed(this->seed);
 			this->seed_engine.engine.shuffle();
@@ -596,7 +760,10 @@ namespace qpl {
 			this->first = true;
 		}
 
-		auto generate(qpl::i64 x, qpl::i64 y) {
+		utype generate(qpl::i64 x, qpl::i64 y) {
+			if (this->mode == qpl::white_noise_mode::hash) {
+				return this->hasher.generate(x, y);
+			}
 			auto ux = qpl::u64_cast(x);
 			auto uy = qpl::u64_cast(y);
 
@@ -623,9 +790,39 @@ namespace qpl {
 			return this->chunk_engine.engine.get_at(index) ^ this->hash[magic];
 		}
 
-		auto generate_0_1(qpl::i64 x, qpl::i64 y) {
+		ftype generate_0_1(qpl::i64 x, qpl::i64 y) {
 			return this->generate(x, y) / static_cast<ftype>(qpl::type_max<utype>());
 		}
+
+		//row-major width * height tile starting at (x, y)
+		void fill(std::span<utype> output, qpl::i64 x, qpl::i64 y, qpl::size width, qpl::size height) {
+			if (this->mode == qpl::white_noise_mode::hash) {
+				this->hasher.fill(output, x, y, width, height);
+				return;
+			}
+			if (output.size() < width * height) {
+				throw qpl::exception("white_noise_engine_N::fill: output holds ", output.size(), " values, need ", width * height);
+			}
+			for (qpl::size j = 0u; j < height; ++j) {
+				for (qpl::size i = 0u; i < width; ++i) {
+					output[j * width + i] = this->generate(x + qpl::i64_cast(i), y + qpl::i64_cast(j));
+				}
+			}
+		}
+		void fill_0_1(std::span<ftype> output, qpl::i64 x, qpl::i64 y, qpl::size width, qpl::size height) {
+			if (this->mode == qpl::white_noise_mode::hash) {
+				this->hasher.fill_0_1(output, x, y, width, height);
+				return;
+			}
+			if (output.size() < width * height) {
+				throw qpl::exception("white_noise_engine_N::fill_0_1: output holds ", output.size(), " values, need ", width * height);
+			}
+			for (qpl::size j = 0u; j < height; ++j) {
+				for (qpl::size i = 0u; i < width; ++i) {
+					output[j * width + i] = this->generate_0_1(x + qpl::i64_cast(i), y + qpl::i64_cast(j));
+				}
+			}
+		}
 	};
 
 
@@ -0,0 +1,367 @@
+#ifndef QPL_SHARED_MEMORY_HPP
+#define QPL_SHARED_MEMORY_HPP
+#pragma once
+
+#include <qpl/qpldeclspec.hpp>
+#include <qpl/vardef.hpp>
+#include <qpl/type_traits.hpp>
+
+#include <atomic>
+#include <new>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace qpl {
+
+	//windows: named file mapping backed by the paging file
+	//posix: shm_open + mmap. the creating process unlinks the name on destroy, processes that already mapped it keep their view
+	struct shared_memory {
+#ifdef _WIN32
+		//HANDLE, kept as void* so <Windows.h> stays out of this header
+		void* hMapFile = nullptr;
+#else
+		int file_descriptor = -1;
+		qpl::size mapped_size = 0u;
+		bool owner = false;
+		std::string name;
+#endif
+		void* ptr = nullptr;
+		bool array = false;
+
+		~shared_memory() {
+			this->destroy();
+		}
+
+		template <typename T>
+		T* get() {
+			return reinterpret_cast<T*>(this->ptr);
+		}
+		template <typename T>
+		std::span<T> get_array() {
+			auto p = reinterpret_cast<T*>(reinterpret_cast<char*>(this->ptr) + qpl::bytes_in_type<qpl::size>());
+			auto size = this->array_byte_size() / sizeof(T);
+			std::span<T> result(p, p + size);
+			return result;
+		}
+		QPLDLL void* get();
+		QPLDLL qpl::size array_byte_size() const;
+		QPLDLL bool is_array() const;
+		QPLDLL bool create(const std::string& name, qpl::size size);
+		QPLDLL bool create_array(const std::string& name, qpl::size size);
+		QPLDLL bool open(const std::string& name, qpl::size size);
+		QPLDLL bool open_array(const std::string& name);
+		QPLDLL void destroy();
+	};
+
+	namespace detail {
+		extern std::unordered_map<std::string, shared_memory> shared_memories;
+	}
+
+	QPLDLL qpl::size get_shared_memory_array_byte_size(std::string name);
+	QPLDLL void create_shared_memory_array(std::string name, qpl::size size);
+	QPLDLL void open_shared_memory_array(std::string name);
+	QPLDLL void create_shared_memory(std::string name, qpl::size size);
+	QPLDLL void open_shared_memory(std::string name, qpl::size size);
+	QPLDLL bool find_shared_memory(std::string name);
+	template <typename T>
+	T* create_shared_memory(std::string name) {
+		qpl::create_shared_memory(name, sizeof(T));
+		return qpl::detail::shared_memories[name].get<T>();
+	}
+	template <typename T>
+	std::span<T> create_shared_memory_array(std::string name, qpl::size size) {
+		qpl::create_shared_memory_array(name, sizeof(T) * size);
+		return qpl::detail::shared_memories[name].get_array<T>();
+	}
+	template <typename T>
+	T* get_shared_memory(std::string name) {
+		if (qpl::detail::shared_memories.find(name) == qpl::detail::shared_memories.cend()) {
+			if (qpl::find_shared_memory(name)){
+				qpl::open_shared_memory(name, sizeof(T));
+				return qpl::detail::shared_memories[name].get<T>();
+			}
+			else {
+				return qpl::create_shared_memory<T>(name);
+			}
+		}
+		return qpl::detail::shared_memories[name].get<T>();
+	}
+
+	template <typename T>
+	std::span<T> get_shared_memory_array(std::string name) {
+		if (qpl::detail::shared_memories.find(name) == qpl::detail::shared_memories.cend()) {
+			if (qpl::find_shared_memory(name)) {
+				qpl::open_shared_memory_array(name);
+			}
+			else {
+				return {};
+			}
+		}
+		return qpl::detail::shared_memories[name].get_array<T>();
+	}
+
+	namespace detail {
+		constexpr qpl::size shared_cache_line = 64u;
+		constexpr qpl::u64 shared_queue_magic = 0x5150'4c51'5545'5545u;
+
+		//blocks while *address == expected. uses a process shared futex on linux, elsewhere it backs off with yield / sleep
+		QPLDLL void shared_wait(std::atomic<qpl::u32>* address, qpl::u32 expected);
+		QPLDLL void shared_wake(std::atomic<qpl::u32>* address);
+
+		//counts events so a waiter can detect whether something happened between checking its condition and going to sleep
+		struct shared_signal {
+			std::atomic<qpl::u32> events = 0u;
+			std::atomic<qpl::u32> waiters = 0u;
+
+			//the fences pair up with the ones in wait_until: either the notifier sees the waiter or the waiter sees the new state
+			void notify() {
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (this->waiters.load(std::memory_order_relaxed)) {
+					this->events.fetch_add(1u);
+					qpl::detail::shared_wake(&this->events);
+				}
+			}
+			template<typename F>
+			void wait_until(F&& condition) {
+				for (qpl::size i = 0u; i < 256u; ++i) {
+					if (condition()) {
+						return;
+					}
+				}
+				this->waiters.fetch_add(1u);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				while (true) {
+					auto events = this->events.load();
+					if (condition()) {
+						break;
+					}
+					qpl::detail::shared_wait(&this->events, events);
+				}
+				this->waiters.fetch_sub(1u);
+			}
+		};
+
+		//cell of a bounded mpmc ring: the sequence number tells producers and consumers whose turn the cell is.
+		//shared by qpl::shared_mpmc_queue and qpl::mpmc_circular_array, capacity must be a power of two
+		template<typename T>
+		struct sequence_cell {
+			std::atomic<qpl::u64> sequence;
+			T value;
+		};
+
+		template<typename T>
+		void sequence_ring_reset(sequence_cell<T>* cells, qpl::size capacity) {
+			for (qpl::size i = 0u; i < capacity; ++i) {
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		//claims the cell at index (tail for push with offset 0, head for pop with offset 1), nullptr when the ring is full / empty
+		template<typename T>
+		sequence_cell<T>* sequence_ring_claim(sequence_cell<T>* cells, qpl::size capacity, std::atomic<qpl::u64>& index, qpl::u64 offset, qpl::u64& position) {
+			auto mask = capacity - 1u;
+			position = index.load(std::memory_order_relaxed);
+			while (true) {
+				auto current = &cells[position & mask];
+				auto sequence = current->sequence.load(std::memory_order_acquire);
+				auto difference = static_cast<qpl::i64>(sequence - (position + offset));
+				if (difference == 0) {
+					if (index.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed)) {
+						return current;
+					}
+				}
+				else if (difference < 0) {
+					return nullptr;
+				}
+				else {
+					position = index.load(std::memory_order_relaxed);
+				}
+			}
+		}
+		template<typename T>
+		bool sequence_ring_push(sequence_cell<T>* cells, qpl::size capacity, std::atomic<qpl::u64>& tail, const T& value) {
+			qpl::u64 position;
+			auto current = sequence_ring_claim(cells, capacity, tail, 0u, position);
+			if (!current) {
+				return false;
+			}
+			current->value = value;
+			current->sequence.store(position + 1u, std::memory_order_release);
+			return true;
+		}
+		template<typename T>
+		bool sequence_ring_pop(sequence_cell<T>* cells, qpl::size capacity, std::atomic<qpl::u64>& head, T& value) {
+			qpl::u64 position;
+			auto current = sequence_ring_claim(cells, capacity, head, 1u, position);
+			if (!current) {
+				return false;
+			}
+			value = std::move(current->value);
+			current->sequence.store(position + capacity, std::memory_order_release);
+			return true;
+		}
+	}
+
+	//single producer / single consumer ring buffer that can be placed into a shared memory segment.
+	//N must be a power of two, T must be trivially copyable since the storage is shared between processes
+	template<typename T, qpl::size N>
+	struct shared_spsc_queue {
+		static_assert(std::is_trivially_copyable_v<T>, "qpl::shared_spsc_queue: T must be trivially copyable");
+		static_assert(N && !(N & (N - 1)), "qpl::shared_spsc_queue: N must be a power of two");
+
+		constexpr static qpl::size capacity() {
+			return N;
+		}
+		qpl::size size() const {
+			return qpl::size_cast(this->m_tail.load(std::memory_order_acquire) - this->m_head.load(std::memory_order_acquire));
+		}
+		bool empty() const {
+			return this->size() == 0u;
+		}
+
+		bool try_push(const T& value) {
+			auto tail = this->m_tail.load(std::memory_order_relaxed);
+			if (tail - this->m_head.load(std::memory_order_acquire) == N) {
+				return false;
+			}
+			this->m_data[tail & (N - 1)] = value;
+			this->m_tail.store(tail + 1, std::memory_order_release);
+			this->m_signal.notify();
+			return true;
+		}
+		bool try_pop(T& value) {
+			auto head = this->m_head.load(std::memory_order_relaxed);
+			if (head == this->m_tail.load(std::memory_order_acquire)) {
+				return false;
+			}
+			value = this->m_data[head & (N - 1)];
+			this->m_head.store(head + 1, std::memory_order_release);
+			this->m_signal.notify();
+			return true;
+		}
+		void push(const T& value) {
+			this->m_signal.wait_until([&]() {
+				return this->try_push(value);
+			});
+		}
+		T pop() {
+			T value;
+			this->m_signal.wait_until([&]() {
+				return this->try_pop(value);
+			});
+			return value;
+		}
+
+	private:
+		alignas(qpl::detail::shared_cache_line) std::atomic<qpl::u64> m_head = 0u;
+		alignas(qpl::detail::shared_cache_line) std::atomic<qpl::u64> m_tail = 0u;
+		alignas(qpl::detail::shared_cache_line) qpl::detail::shared_signal m_signal;
+		alignas(qpl::detail::shared_cache_line) T m_data[N];
+	};
+
+	//bounded multi producer / multi consumer ring buffer (every cell carries a sequence number), also placeable into shared memory
+	template<typename T, qpl::size N>
+	struct shared_mpmc_queue {
+		static_assert(std::is_trivially_copyable_v<T>, "qpl::shared_mpmc_queue: T must be trivially copyable");
+		static_assert(N && !(N & (N - 1)), "qpl::shared_mpmc_queue: N must be a power of two");
+
+		shared_mpmc_queue() {
+			qpl::detail::sequence_ring_reset(this->m_cells, N);
+		}
+
+		constexpr static qpl::size capacity() {
+			return N;
+		}
+		qpl::size size() const {
+			auto tail = this->m_tail.load(std::memory_order_acquire);
+			auto head = this->m_head.load(std::memory_order_acquire);
+			return tail > head ? qpl::size_cast(tail - head) : qpl::size{ 0u };
+		}
+		bool empty() const {
+			return this->size() == 0u;
+		}
+
+		bool try_push(const T& value) {
+			if (!qpl::detail::sequence_ring_push(this->m_cells, N, this->m_tail, value)) {
+				return false;
+			}
+			this->m_signal.notify();
+			return true;
+		}
+		bool try_pop(T& value) {
+			if (!qpl::detail::sequence_ring_pop(this->m_cells, N, this->m_head, value)) {
+				return false;
+			}
+			this->m_signal.notify();
+			return true;
+		}
+		void push(const T& value) {
+			this->m_signal.wait_until([&]() {
+				return this->try_push(value);
+			});
+		}
+		T pop() {
+			T value;
+			this->m_signal.wait_until([&]() {
+				return this->try_pop(value);
+			});
+			return value;
+		}
+
+	private:
+		alignas(qpl::detail::shared_cache_line) std::atomic<qpl::u64> m_head = 0u;
+		alignas(qpl::detail::shared_cache_line) std::atomic<qpl::u64> m_tail = 0u;
+		alignas(qpl::detail::shared_cache_line) qpl::detail::shared_signal m_signal;
+		alignas(qpl::detail::shared_cache_line) qpl::detail::sequence_cell<T> m_cells[N];
+	};
+
+	namespace detail {
+		//the creator publishes the magic only after the queue is constructed, a fresh segment is zero filled
+		template<typename Q>
+		struct shared_queue_segment {
+			std::atomic<qpl::u64> initialized = 0u;
+			qpl::u64 queue_size = 0u;
+			Q queue;
+		};
+	}
+
+	//creates the segment and constructs the queue in it. other processes use qpl::open_shared_queue.
+	//returns nullptr if the segment already exists, its queue may be in use and is never constructed over
+	template<typename Q>
+	Q* create_shared_queue(std::string name) {
+		auto ptr = qpl::create_shared_memory<qpl::detail::shared_queue_segment<Q>>(name);
+		if (!ptr) {
+			qpl::detail::shared_memories.erase(name);
+			return nullptr;
+		}
+		auto segment = new (ptr) qpl::detail::shared_queue_segment<Q>();
+		segment->queue_size = sizeof(Q);
+		segment->initialized.store(qpl::detail::shared_queue_magic, std::memory_order_release);
+		return &segment->queue;
+	}
+	//returns nullptr while the segment doesn't exist, isn't initialized yet or holds a different queue type, so callers can retry
+	template<typename Q>
+	Q* open_shared_queue(std::string name) {
+		using segment_type = qpl::detail::shared_queue_segment<Q>;
+		if (qpl::detail::shared_memories.find(name) == qpl::detail::shared_memories.cend()) {
+			if (!qpl::find_shared_memory(name)) {
+				return nullptr;
+			}
+			qpl::open_shared_memory(name, sizeof(segment_type));
+		}
+		auto segment = qpl::detail::shared_memories[name].get<segment_type>();
+		if (!segment) {
+			qpl::detail::shared_memories.erase(name);
+			return nullptr;
+		}
+		if (segment->initialized.load(std::memory_order_acquire) != qpl::detail::shared_queue_magic || segment->queue_size != sizeof(Q)) {
+			return nullptr;
+		}
+		return &segment->queue;
+	}
+}
+
+#endif
@@ -3392,6 +3392,31 @@ namespace qpl {
 				y = new_y;
 			}
 		}
+		//removes the first count rows (up to and including their '\n'), keeping the styles of what remains
+		void remove_leading_lines(qpl::size count) {
+			qpl::size consumed = 0u;
+			for (qpl::size i = 0u; i < this->elements.size() && count; ++i) {
+				auto& text = this->elements[i].text;
+				qpl::size position = 0u;
+				while (count) {
+					auto next = text.find(typename T::value_type('\n'), position);
+					if (next == T::npos) {
+						break;
+					}
+					position = next + 1;
+					--count;
+				}
+				if (!count) {
+					text.erase(0u, position);
+					consumed = i;
+					break;
+				}
+				text.clear();
+				consumed = i + 1;
+			}
+			consumed = qpl::min(consumed, this->elements.size() - 1);
+			this->elements.erase(this->elements.begin(), this->elements.begin() + consumed);
+		}
 		void clear_last_line() {
 			auto& text = this->elements.back().text;
 			auto ctr = qpl::signed_cast(text.length()) - 1;
@@ -0,0 +1,128 @@
+#ifndef QPL_THREAD_POOL_HPP
+#define QPL_THREAD_POOL_HPP
+#pragma once
+
+#include <qpl/qpldeclspec.hpp>
+#include <qpl/vardef.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace qpl {
+	QPLDLL qpl::size hardware_thread_count();
+
+	class thread_pool {
+	public:
+		thread_pool(qpl::size thread_count = 0u) {
+			this->start(thread_count);
+		}
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+		~thread_pool() {
+			this->stop();
+		}
+
+		//thread_count = 0 uses all hardware threads
+		QPLDLL void start(qpl::size thread_count = 0u);
+		QPLDLL void stop();
+		QPLDLL void push(std::function<void()> task);
+		QPLDLL void wait();
+		QPLDLL qpl::size size() const;
+		QPLDLL qpl::size pending() const;
+
+		template<typename F, typename... Args>
+		auto submit(F&& function, Args&&... args) {
+			using result_type = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+			auto task = std::make_shared<std::packaged_task<result_type()>>(std::bind(std::forward<F>(function), std::forward<Args>(args)...));
+			auto future = task->get_future();
+			this->push([task]() {
+				(*task)();
+			});
+			return future;
+		}
+
+		//the calling thread takes part in the work, so this is safe to call from inside a pool task
+		template<typename F>
+		void parallel_for(qpl::size count, F&& function) {
+			if (!count) {
+				return;
+			}
+			if (count == 1u || this->size() == 0u) {
+				for (qpl::size i = 0u; i < count; ++i) {
+					function(i);
+				}
+				return;
+			}
+
+			struct state_t {
+				std::atomic<qpl::size> next = 0u;
+				std::atomic<qpl::size> busy = 0u;
+				std::mutex mutex;
+				std::condition_variable done;
+				std::exception_ptr exception;
+			};
+			auto state = std::make_shared<state_t>();
+
+			auto work = [state, count, &function]() {
+				++state->busy;
+				try {
+					for (auto index = state->next.fetch_add(1u); index < count; index = state->next.fetch_add(1u)) {
+						function(index);
+					}
+				}
+				catch (...) {
+					std::lock_guard lock(state->mutex);
+					if (!state->exception) {
+						state->exception = std::current_exception();
+					}
+					state->next = count;
+				}
+				std::lock_guard lock(state->mutex);
+				--state->busy;
+				state->done.notify_all();
+			};
+
+			auto helpers = qpl::size{ this->size() < count - 1 ? this->size() : count - 1 };
+			for (qpl::size i = 0u; i < helpers; ++i) {
+				this->push([state, count, &function, work]() {
+					if (state->next.load() < count) {
+						work();
+					}
+				});
+			}
+			work();
+
+			std::unique_lock lock(state->mutex);
+			state->done.wait(lock, [&]() {
+				return state->busy.load() == 0u;
+			});
+			if (state->exception) {
+				std::rethrow_exception(state->exception);
+			}
+		}
+
+	private:
+		QPLDLL void work();
+
+		std::vector<std::thread> m_threads;
+		std::deque<std::function<void()>> m_tasks;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_task_available;
+		std::condition_variable m_idle;
+		qpl::size m_active = 0u;
+		bool m_stop = false;
+	};
+
+	QPLDLL qpl::thread_pool& default_thread_pool();
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <qpl/type_traits.hpp>
 #include <qpl/maths.hpp>
 #include <qpl/vardef.hpp>
+#include <qpl/flat_hash_map.hpp>
 
 #include <string>
 #include <vector>
@@ -461,8 +462,8 @@ namespace qpl {
 	}
 
 	namespace detail {
-		QPLDLL extern std::unordered_map<std::string, std::unordered_map<std::string, qpl::halted_clock>> sub_benchmark_clocks;
-		QPLDLL extern std::unordered_map<std::string, qpl::halted_clock> benchmark_clocks;
+		QPLDLL extern qpl::flat_hash_map<std::string, qpl::flat_hash_map<std::string, qpl::halted_clock>> sub_benchmark_clocks;
+		QPLDLL extern qpl::flat_hash_map<std::string, qpl::halted_clock> benchmark_clocks;
 		QPLDLL extern std::string last_benchmark_name;
 		QPLDLL extern std::string last_sub_benchmark_name;
 
@@ -24,6 +24,11 @@
 #include <string>
 #include <iomanip>
 #include <sstream>
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include <queue>
+#include <limits>
 
 namespace qpl {
 
@@ -2483,6 +2488,429 @@ namespace qpl {
 	std::ostream& operator<<(std::ostream& os, const qpl::hitbox_t<T>& hitbox) {
 		return os << hitbox.string();
 	}
+
+	//dynamic bounding volume hierarchy over hitboxes, every hitbox is stored with a user id.
+	//leaves keep a box enlarged by margin, so small moves don't restructure the tree
+	template<typename T, typename ID = qpl::size>
+	struct hitbox_tree_t {
+		constexpr static qpl::u32 null = qpl::u32_max;
+
+		struct bounds {
+			qpl::vector2<T> min;
+			qpl::vector2<T> max;
+
+			constexpr static bounds from(const qpl::hitbox_t<T>& hitbox) {
+				return bounds{ hitbox.position, hitbox.position + hitbox.dimension };
+			}
+			constexpr static bounds merged(const bounds& a, const bounds& b) {
+				return bounds{
+					qpl::vector2<T>(qpl::min(a.min.x, b.min.x), qpl::min(a.min.y, b.min.y)),
+					qpl::vector2<T>(qpl::max(a.max.x, b.max.x), qpl::max(a.max.y, b.max.y))
+				};
+			}
+			constexpr T perimeter() const {
+				return (this->max.x - this->min.x + this->max.y - this->min.y) * 2;
+			}
+			constexpr bool overlaps(const bounds& other) const {
+				return this->min.x <= other.max.x && this->max.x >= other.min.x && this->min.y <= other.max.y && this->max.y >= other.min.y;
+			}
+			constexpr bool contains(const bounds& other) const {
+				return this->min.x <= other.min.x && this->min.y <= other.min.y && this->max.x >= other.max.x && this->max.y >= other.max.y;
+			}
+			constexpr bool contains(qpl::vector2<T> position) const {
+				return position.x >= this->min.x && position.x <= this->max.x && position.y >= this->min.y && position.y <= this->max.y;
+			}
+			constexpr T distance_squared(qpl::vector2<T> position) const {
+				auto dx = qpl::max(qpl::max(this->min.x - position.x, T{ 0 }), position.x - this->max.x);
+				auto dy = qpl::max(qpl::max(this->min.y - position.y, T{ 0 }), position.y - this->max.y);
+				return dx * dx + dy * dy;
+			}
+		};
+
+		struct node {
+			bounds fat;
+			qpl::hitbox_t<T> hitbox;
+			ID id;
+			qpl::u32 parent = null;
+			qpl::u32 left = null;
+			qpl::u32 right = null;
+			qpl::i32 height = 0;
+
+			constexpr bool is_leaf() const {
+				return this->left == null;
+			}
+		};
+
+		T margin = T{ 0 };
+
+		void clear() {
+			this->m_nodes.clear();
+			this->m_lookup.clear();
+			this->m_root = null;
+			this->m_free = null;
+		}
+		qpl::size size() const {
+			return this->m_lookup.size();
+		}
+		bool empty() const {
+			return this->m_lookup.empty();
+		}
+		bool contains(const ID& id) const {
+			return this->m_lookup.find(id) != this->m_lookup.cend();
+		}
+		qpl::i32 height() const {
+			return this->m_root == null ? 0 : this->m_nodes[this->m_root].height;
+		}
+		const qpl::hitbox_t<T>& get(const ID& id) const {
+			return this->m_nodes[this->m_lookup.at(id)].hitbox;
+		}
+
+		//replaces the hitbox if the id already exists
+		void insert(const ID& id, const qpl::hitbox_t<T>& hitbox) {
+			if (this->contains(id)) {
+				this->move(id, hitbox);
+				return;
+			}
+			auto leaf = this->allocate_node();
+			auto& node = this->m_nodes[leaf];
+			node.hitbox = hitbox;
+			node.fat = bounds::from(hitbox.increased(this->margin));
+			node.id = id;
+			node.height = 0;
+			this->m_lookup[id] = leaf;
+			this->insert_leaf(leaf);
+		}
+		bool remove(const ID& id) {
+			auto it = this->m_lookup.find(id);
+			if (it == this->m_lookup.cend()) {
+				return false;
+			}
+			auto leaf = it->second;
+			this->m_lookup.erase(it);
+			this->remove_leaf(leaf);
+			this->free_node(leaf);
+			return true;
+		}
+		//returns true if the tree had to be restructured
+		bool move(const ID& id, const qpl::hitbox_t<T>& hitbox) {
+			auto leaf = this->m_lookup.at(id);
+			auto& node = this->m_nodes[leaf];
+			node.hitbox = hitbox;
+			auto box = bounds::from(hitbox);
+			if (node.fat.contains(box)) {
+				return false;
+			}
+			this->remove_leaf(leaf);
+			this->m_nodes[leaf].fat = bounds::from(hitbox.increased(this->margin));
+			this->insert_leaf(leaf);
+			return true;
+		}
+
+		template<typename F>
+		void query(const qpl::hitbox_t<T>& hitbox, F&& function) const {
+			auto box = bounds::from(hitbox);
+			this->traverse([&](const bounds& fat) {
+				return fat.overlaps(box);
+			}, [&](const node& node) {
+				if (bounds::from(node.hitbox).overlaps(box)) {
+					function(node.id);
+				}
+			});
+		}
+		std::vector<ID> query(const qpl::hitbox_t<T>& hitbox) const {
+			std::vector<ID> result;
+			this->query(hitbox, [&](const ID& id) {
+				result.push_back(id);
+			});
+			return result;
+		}
+		template<typename F>
+		void query(qpl::vector2<T> position, F&& function) const {
+			this->traverse([&](const bounds& fat) {
+				return fat.contains(position);
+			}, [&](const node& node) {
+				if (node.hitbox.contains(position)) {
+					function(node.id);
+				}
+			});
+		}
+		std::vector<ID> query(qpl::vector2<T> position) const {
+			std::vector<ID> result;
+			this->query(position, [&](const ID& id) {
+				result.push_back(id);
+			});
+			return result;
+		}
+
+		//id of the hitbox closest to position (distance 0 if position lies inside)
+		std::optional<ID> nearest(qpl::vector2<T> position) const {
+			if (this->m_root == null) {
+				return std::nullopt;
+			}
+			using entry = std::pair<T, qpl::u32>;
+			std::priority_queue<entry, std::vector<entry>, std::greater<entry>> queue;
+			queue.push(std::make_pair(this->m_nodes[this->m_root].fat.distance_squared(position), this->m_root));
+
+			std::optional<ID> result;
+			auto best = std::numeric_limits<T>::max();
+			while (!queue.empty()) {
+				auto [distance, index] = queue.top();
+				queue.pop();
+				if (distance > best) {
+					break;
+				}
+				const auto& node = this->m_nodes[index];
+				if (node.is_leaf()) {
+					auto exact = bounds::from(node.hitbox).distance_squared(position);
+					if (exact < best || !result.has_value()) {
+						best = exact;
+						result = node.id;
+					}
+					continue;
+				}
+				queue.push(std::make_pair(this->m_nodes[node.left].fat.distance_squared(position), node.left));
+				queue.push(std::make_pair(this->m_nodes[node.right].fat.distance_squared(position), node.right));
+			}
+			return result;
+		}
+
+		//calls function(a, b) once for every pair of colliding hitboxes
+		template<typename F>
+		void overlapping_pairs(F&& function) const {
+			std::vector<qpl::u32> stack;
+			for (const auto& [id, leaf] : this->m_lookup) {
+				const auto& a = this->m_nodes[leaf];
+				auto box = bounds::from(a.hitbox);
+				stack.clear();
+				stack.push_back(this->m_root);
+				while (!stack.empty()) {
+					auto index = stack.back();
+					stack.pop_back();
+					const auto& node = this->m_nodes[index];
+					if (!node.fat.overlaps(a.fat)) {
+						continue;
+					}
+					if (node.is_leaf()) {
+						if (index > leaf && bounds::from(node.hitbox).overlaps(box)) {
+							function(a.id, node.id);
+						}
+						continue;
+					}
+					stack.push_back(node.left);
+					stack.push_back(node.right);
+				}
+			}
+		}
+		std::vector<std::pair<ID, ID>> overlapping_pairs() const {
+			std::vector<std::pair<ID, ID>> result;
+			this->overlapping_pairs([&](const ID& a, const ID& b) {
+				result.push_back(std::make_pair(a, b));
+			});
+			return result;
+		}
+
+	private:
+		template<typename P, typename F>
+		void traverse(P&& predicate, F&& function) const {
+			if (this->m_root == null) {
+				return;
+			}
+			std::vector<qpl::u32> stack;
+			stack.reserve(64u);
+			stack.push_back(this->m_root);
+			while (!stack.empty()) {
+				auto index = stack.back();
+				stack.pop_back();
+				const auto& node = this->m_nodes[index];
+				if (!predicate(node.fat)) {
+					continue;
+				}
+				if (node.is_leaf()) {
+					function(node);
+					continue;
+				}
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+
+		qpl::u32 allocate_node() {
+			if (this->m_free == null) {
+				this->m_nodes.emplace_back();
+				return static_cast<qpl::u32>(this->m_nodes.size() - 1);
+			}
+			auto index = this->m_free;
+			this->m_free = this->m_nodes[index].parent;
+			this->m_nodes[index] = node{};
+			return index;
+		}
+		void free_node(qpl::u32 index) {
+			this->m_nodes[index].parent = this->m_free;
+			this->m_nodes[index].height = -1;
+			this->m_free = index;
+		}
+
+		void insert_leaf(qpl::u32 leaf) {
+			if (this->m_root == null) {
+				this->m_root = leaf;
+				this->m_nodes[leaf].parent = null;
+				return;
+			}
+
+			//find the sibling that increases the total perimeter the least
+			auto box = this->m_nodes[leaf].fat;
+			auto index = this->m_root;
+			while (!this->m_nodes[index].is_leaf()) {
+				const auto& current = this->m_nodes[index];
+				auto perimeter = current.fat.perimeter();
+				auto combined = bounds::merged(current.fat, box).perimeter();
+
+				auto cost = combined * 2;
+				auto inheritance = (combined - perimeter) * 2;
+
+				auto child_cost = [&](qpl::u32 child) {
+					auto merged = bounds::merged(this->m_nodes[child].fat, box).perimeter();
+					if (this->m_nodes[child].is_leaf()) {
+						return merged + inheritance;
+					}
+					return merged - this->m_nodes[child].fat.perimeter() + inheritance;
+				};
+				auto cost_left = child_cost(current.left);
+				auto cost_right = child_cost(current.right);
+
+				if (cost < cost_left && cost < cost_right) {
+					break;
+				}
+				index = cost_left < cost_right ? current.left : current.right;
+			}
+
+			auto sibling = index;
+			auto old_parent = this->m_nodes[sibling].parent;
+			auto new_parent = this->allocate_node();
+			this->m_nodes[new_parent].parent = old_parent;
+			this->m_nodes[new_parent].fat = bounds::merged(box, this->m_nodes[sibling].fat);
+			this->m_nodes[new_parent].height = this->m_nodes[sibling].height + 1;
+			this->m_nodes[new_parent].left = sibling;
+			this->m_nodes[new_parent].right = leaf;
+			this->m_nodes[sibling].parent = new_parent;
+			this->m_nodes[leaf].parent = new_parent;
+
+			if (old_parent == null) {
+				this->m_root = new_parent;
+			}
+			else if (this->m_nodes[old_parent].left == sibling) {
+				this->m_nodes[old_parent].left = new_parent;
+			}
+			else {
+				this->m_nodes[old_parent].right = new_parent;
+			}
+			this->refit(new_parent);
+		}
+		void remove_leaf(qpl::u32 leaf) {
+			if (leaf == this->m_root) {
+				this->m_root = null;
+				return;
+			}
+			auto parent = this->m_nodes[leaf].parent;
+			auto grand_parent = this->m_nodes[parent].parent;
+			auto sibling = this->m_nodes[parent].left == leaf ? this->m_nodes[parent].right : this->m_nodes[parent].left;
+
+			if (grand_parent == null) {
+				this->m_root = sibling;
+				this->m_nodes[sibling].parent = null;
+			}
+			else {
+				if (this->m_nodes[grand_parent].left == parent) {
+					this->m_nodes[grand_parent].left = sibling;
+				}
+				else {
+					this->m_nodes[grand_parent].right = sibling;
+				}
+				this->m_nodes[sibling].parent = grand_parent;
+				this->refit(grand_parent);
+			}
+			this->free_node(parent);
+		}
+		void refit(qpl::u32 index) {
+			while (index != null) {
+				index = this->balance(index);
+				auto& node = this->m_nodes[index];
+				const auto& left = this->m_nodes[node.left];
+				const auto& right = this->m_nodes[node.right];
+				node.height = 1 + qpl::max(left.height, right.height);
+				node.fat = bounds::merged(left.fat, right.fat);
+				index = node.parent;
+			}
+		}
+
+		//rotates the taller grand child up if the subtrees of a are unbalanced, returns the new subtree root
+		qpl::u32 balance(qpl::u32 a) {
+			auto& A = this->m_nodes[a];
+			if (A.is_leaf() || A.height < 2) {
+				return a;
+			}
+			auto b = A.left;
+			auto c = A.right;
+			auto difference = this->m_nodes[c].height - this->m_nodes[b].height;
+			if (difference > 1) {
+				return this->rotate(a, c, b, true);
+			}
+			if (difference < -1) {
+				return this->rotate(a, b, c, false);
+			}
+			return a;
+		}
+		//promotes child (the taller side of a), other is the remaining child of a
+		qpl::u32 rotate(qpl::u32 a, qpl::u32 child, qpl::u32 other, bool child_is_right) {
+			auto& A = this->m_nodes[a];
+			auto& C = this->m_nodes[child];
+			auto f = C.left;
+			auto g = C.right;
+			auto& F = this->m_nodes[f];
+			auto& G = this->m_nodes[g];
+
+			C.left = a;
+			C.parent = A.parent;
+			A.parent = child;
+
+			if (C.parent == null) {
+				this->m_root = child;
+			}
+			else if (this->m_nodes[C.parent].left == a) {
+				this->m_nodes[C.parent].left = child;
+			}
+			else {
+				this->m_nodes[C.parent].right = child;
+			}
+
+			auto keep = F.height > G.height ? f : g;
+			auto move = F.height > G.height ? g : f;
+			C.right = keep;
+			if (child_is_right) {
+				A.right = move;
+			}
+			else {
+				A.left = move;
+			}
+			this->m_nodes[move].parent = a;
+
+			const auto& other_node = this->m_nodes[other];
+			const auto& moved_node = this->m_nodes[move];
+			const auto& kept_node = this->m_nodes[keep];
+			A.fat = bounds::merged(other_node.fat, moved_node.fat);
+			A.height = 1 + qpl::max(other_node.height, moved_node.height);
+			C.fat = bounds::merged(A.fat, kept_node.fat);
+			C.height = 1 + qpl::max(A.height, kept_node.height);
+			return child;
+		}
+
+		std::vector<node> m_nodes;
+		std::unordered_map<ID, qpl::u32> m_lookup;
+		qpl::u32 m_root = null;
+		qpl::u32 m_free = null;
+	};
+
+	using hitbox_tree = hitbox_tree_t<qpl::f32>;
 }
 
 namespace std {
@@ -12,6 +12,11 @@
 #include <qpl/system.hpp>
 #include <qpl/memory.hpp>
 
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <tuple>
+
 namespace qsf {
 
 	qpl::hitbox qsf::get_text_hitbox(const sf::Text& text, bool ignore_outline) {
@@ -3150,6 +3155,7 @@ namespace qsf {
 
 		this->chunks.clear();
 		this->color = color;
+		this->store_tiles(indices, width, false, 0u);
 		auto chunk_width = (width - 1) / this->max_chunk_size.x + 1;
 		auto chunk_height = (indices.size() / width - 1) / this->max_chunk_size.y + 1;
 		auto chunk_dim = chunk_width * chunk_height;
@@ -3332,6 +3338,8 @@ namespace qsf {
 
 		this->chunks.clear();
 		this->color = color;
+		this->tiles.clear();
+		this->store_layout(width, false, 0u);
 		auto chunk_width = (width - 1) / this->max_chunk_size.x + 1;
 		auto chunk_height = (indices.size() / width - 1) / this->max_chunk_size.y + 1;
 		auto chunk_dim = chunk_width * chunk_height;
@@ -3486,6 +3494,7 @@ namespace qsf {
 
 		this->chunks.clear();
 		this->color = color;
+		this->store_tiles(indices, width, false, 0u);
 
 		auto chunk_width = (width - 1) / this->max_chunk_size.x + 1;
 		auto chunk_height = (indices.size() / width - 1) / this->max_chunk_size.y + 1;
@@ -3570,6 +3579,7 @@ namespace qsf {
 
 		this->chunks.clear();
 		this->color = color;
+		this->store_tiles(indices, width, true, skip_index);
 		auto texture_row_tile_count = texture_ptr->getSize().x / this->texture_tile_dimension.x;
 
 		auto chunk_width = (width - 1) / this->max_chunk_size.x + 1;
@@ -3771,6 +3781,8 @@ namespace qsf {
 
 		this->chunks.clear();
 		this->color = color;
+		this->tiles.clear();
+		this->store_layout(width, true, skip_index);
 		auto texture_row_tile_count = texture_ptr->getSize().x / this->texture_tile_dimension.x;
 
 		auto chunk_width = (width - 1) / this->max_chunk_size.x + 1;
@@ -3891,6 +3903,7 @@ namespace qsf {
 
 		this->chunks.clear();
 		this->color = color;
+		this->store_tiles(indices, width, true, skip_index);
 
 		auto chunk_width = (width - 1) / this->max_chunk_size.x + 1;
 		auto chunk_height = (indices.size() / width - 1) / this->max_chunk_size.y + 1;
@@ -3985,23 +3998,258 @@ namespace qsf {
 		}
 	}
 
-	void qsf::tile_map::draw(sf::RenderTarget& window, sf::RenderStates states) const {
-		states.texture = this->texture_ptr;
+	namespace detail {
+		//texture corner order of a quad for each of the 8 tile rotations
+		constexpr std::array<std::array<qpl::u32, 4u>, 8u> tile_rotation_corners = { {
+			{ 0u, 1u, 2u, 3u },
+			{ 1u, 0u, 3u, 2u },
+			{ 3u, 2u, 1u, 0u },
+			{ 2u, 3u, 0u, 1u },
+			{ 3u, 0u, 1u, 2u },
+			{ 2u, 1u, 0u, 3u },
+			{ 0u, 3u, 2u, 1u },
+			{ 1u, 2u, 3u, 0u },
+		} };
+
+		struct tile_map_layout {
+			qpl::vector2f position;
+			qpl::vector2u position_tile_dimension;
+			qpl::vector2u texture_tile_dimension;
+			qpl::vector2u max_chunk_size;
+			qpl::u32 texture_row_tile_count = 1u;
+			qpl::rgba color;
+			bool skip_empty = false;
+			qpl::u32 skip_index = 0u;
+		};
+
+		void set_tile_quad(sf::Vertex* quad, const tile_map_layout& layout, qpl::size x, qpl::size y, std::pair<qpl::u32, qpl::u32> tile) {
+			auto tile_x = (tile.first % layout.texture_row_tile_count);
+			auto tile_y = (tile.first / layout.texture_row_tile_count);
+
+			quad[0].position = layout.position + qpl::vector2u(qpl::u32_cast(x) * layout.position_tile_dimension.x, qpl::u32_cast(y) * layout.position_tile_dimension.y);
+			quad[1].position = layout.position + qpl::vector2u(qpl::u32_cast(x + 1) * layout.position_tile_dimension.x, qpl::u32_cast(y) * layout.position_tile_dimension.y);
+			quad[2].position = layout.position + qpl::vector2u(qpl::u32_cast(x + 1) * layout.position_tile_dimension.x, qpl::u32_cast(y + 1) * layout.position_tile_dimension.y);
+			quad[3].position = layout.position + qpl::vector2u(qpl::u32_cast(x) * layout.position_tile_dimension.x, qpl::u32_cast(y + 1) * layout.position_tile_dimension.y);
+
+			std::array<qpl::vector2u, 4u> tex = {
+				qpl::vector2u(tile_x * layout.texture_tile_dimension.x, tile_y * layout.texture_tile_dimension.y),
+				qpl::vector2u((tile_x + 1) * layout.texture_tile_dimension.x, tile_y * layout.texture_tile_dimension.y),
+				qpl::vector2u((tile_x + 1) * layout.texture_tile_dimension.x, (tile_y + 1) * layout.texture_tile_dimension.y),
+				qpl::vector2u(tile_x * layout.texture_tile_dimension.x, (tile_y + 1) * layout.texture_tile_dimension.y)
+			};
+			const auto& corners = tile_rotation_corners[tile.second % 8u];
+			for (qpl::size i = 0u; i < 4u; ++i) {
+				quad[i].texCoords = tex[corners[i]];
+				quad[i].color = layout.color;
+			}
+		}
 
-		for (qpl::u32 i = 0u; i < this->chunks.size(); ++i) {
-			auto x = i % this->chunk_width_count;
-			auto y = i / this->chunk_width_count;
+		//tiles is the row-major sub grid of the chunk starting at (chunk_x, chunk_y) in tile coordinates
+		sf::VertexArray build_tile_chunk(const tile_map_layout& layout, const std::vector<std::pair<qpl::u32, qpl::u32>>& tiles, qpl::size tiles_width, qpl::size chunk_x, qpl::size chunk_y) {
+			sf::VertexArray chunk;
+			chunk.setPrimitiveType(sf::Quads);
+			if (!tiles_width) {
+				return chunk;
+			}
+			auto tiles_height = tiles.size() / tiles_width;
+			if (!layout.skip_empty) {
+				chunk.resize(qpl::size_cast(layout.max_chunk_size.x) * layout.max_chunk_size.y * 4u);
+			}
+			for (qpl::size y = 0u; y < tiles_height; ++y) {
+				for (qpl::size x = 0u; x < tiles_width; ++x) {
+					auto tile = tiles[x + y * tiles_width];
+					if (layout.skip_empty) {
+						if (tile.first == layout.skip_index) {
+							continue;
+						}
+						auto ctr = chunk.getVertexCount();
+						chunk.resize(ctr + 4);
+						set_tile_quad(&chunk[ctr], layout, chunk_x + x, chunk_y + y, tile);
+					}
+					else {
+						auto slot = x + y * layout.max_chunk_size.x;
+						set_tile_quad(&chunk[slot * 4], layout, chunk_x + x, chunk_y + y, tile);
+					}
+				}
+			}
+			return chunk;
+		}
+	}
 
-			auto rx = qpl::f32_cast(x * this->max_chunk_size.x * this->texture_tile_dimension.x);
-			auto ry = qpl::f32_cast(y * this->max_chunk_size.y * this->texture_tile_dimension.y);
-			auto rw = qpl::f32_cast(this->max_chunk_size.x * this->texture_tile_dimension.x);
-			auto rh = qpl::f32_cast(this->max_chunk_size.y * this->texture_tile_dimension.y);
+	void qsf::tile_map::store_layout(qpl::size index_width, bool skip_empty, qpl::u32 skip_index) {
+		this->index_width = index_width;
+		this->skip_empty = skip_empty;
+		this->skip_index = skip_index;
+		this->dirty_chunks.clear();
+		this->pending_chunks = {};
+	}
+	void qsf::tile_map::store_tiles(const std::vector<std::pair<qpl::u32, qpl::u32>>& indices, qpl::size index_width, bool skip_empty, qpl::u32 skip_index) {
+		this->tiles = indices;
+		this->store_layout(index_width, skip_empty, skip_index);
+	}
+	void qsf::tile_map::store_tiles(const std::vector<qpl::u32>& indices, qpl::size index_width, bool skip_empty, qpl::u32 skip_index) {
+		this->tiles.resize(indices.size());
+		for (qpl::size i = 0u; i < indices.size(); ++i) {
+			this->tiles[i] = std::make_pair(indices[i], 0u);
+		}
+		this->store_layout(index_width, skip_empty, skip_index);
+	}
+	void qsf::tile_map::set(qpl::size x, qpl::size y, qpl::u32 index, qpl::u32 rotation) {
+		if (this->tiles.empty() || !this->index_width) {
+			throw qpl::exception("tile_map::set: map was not created from indices or 0-7 rotations");
+		}
+		auto tile_index = x + y * this->index_width;
+		if (x >= this->index_width || tile_index >= this->tiles.size()) {
+			throw qpl::exception("tile_map::set: (", x, ", ", y, ") is out of range");
+		}
+		auto tile = std::make_pair(index, rotation);
+		if (this->tiles[tile_index] == tile) {
+			return;
+		}
+		this->tiles[tile_index] = tile;
+
+		auto chunk_x = x / this->max_chunk_size.x;
+		auto chunk_y = y / this->max_chunk_size.y;
+		auto chunk_index = chunk_x + chunk_y * this->chunk_width_count;
+
+		auto in_place = !this->skip_empty && !this->background_building && chunk_index < this->chunks.size();
+		if (in_place) {
+			auto slot = (x % this->max_chunk_size.x) + (y % this->max_chunk_size.y) * this->max_chunk_size.x;
+			auto& chunk = this->chunks[chunk_index];
+			if (slot * 4 + 4 <= chunk.getVertexCount()) {
+				detail::tile_map_layout layout;
+				layout.position = this->position;
+				layout.position_tile_dimension = this->position_tile_dimension;
+				layout.texture_tile_dimension = this->texture_tile_dimension;
+				layout.max_chunk_size = this->max_chunk_size;
+				layout.texture_row_tile_count = qpl::max(1u, this->texture_ptr->getSize().x / this->texture_tile_dimension.x);
+				layout.color = this->color;
+				detail::set_tile_quad(&chunk[slot * 4], layout, x, y, tile);
+				return;
+			}
+		}
+		this->dirty_chunks.insert(chunk_index);
+	}
+	std::pair<qpl::u32, qpl::u32> qsf::tile_map::get(qpl::size x, qpl::size y) const {
+		return this->tiles.at(x + y * this->index_width);
+	}
+	void qsf::tile_map::update_chunks() {
+		if (this->pending_chunks.valid()) {
+			if (this->pending_chunks.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				return;
+			}
+			for (auto& [index, chunk] : this->pending_chunks.get()) {
+				if (index < this->chunks.size()) {
+					this->chunks[index] = chunk;
+				}
+			}
+			this->pending_chunks = {};
+		}
+		if (this->dirty_chunks.empty() || !this->texture_ptr_set) {
+			return;
+		}
 
-			auto rect = states.transform.transformRect(sf::FloatRect(rx, ry, rw, rh));
-			auto fov = sf::FloatRect(0.f, 0.f, qpl::f32_cast(window.getSize().x), qpl::f32_cast(window.getSize().y));
+		detail::tile_map_layout layout;
+		layout.position = this->position;
+		layout.position_tile_dimension = this->position_tile_dimension;
+		layout.texture_tile_dimension = this->texture_tile_dimension;
+		layout.max_chunk_size = this->max_chunk_size;
+		layout.texture_row_tile_count = qpl::max(1u, this->texture_ptr->getSize().x / this->texture_tile_dimension.x);
+		layout.color = this->color;
+		layout.skip_empty = this->skip_empty;
+		layout.skip_index = this->skip_index;
+
+		struct chunk_tiles {
+			qpl::size index;
+			qpl::size x;
+			qpl::size y;
+			qpl::size width;
+			std::vector<std::pair<qpl::u32, qpl::u32>> tiles;
+		};
+
+		//copy the tiles of every dirty chunk, so set() can keep changing the map while a background build runs
+		std::vector<chunk_tiles> jobs;
+		jobs.reserve(this->dirty_chunks.size());
+		auto map_height = this->tiles.size() / this->index_width;
+		for (auto index : this->dirty_chunks) {
+			if (index >= this->chunks.size()) {
+				continue;
+			}
+			chunk_tiles job;
+			job.index = index;
+			job.x = (index % this->chunk_width_count) * this->max_chunk_size.x;
+			job.y = (index / this->chunk_width_count) * this->max_chunk_size.y;
+			job.width = qpl::min(qpl::size_cast(this->max_chunk_size.x), this->index_width - job.x);
+			auto height = qpl::min(qpl::size_cast(this->max_chunk_size.y), map_height - job.y);
+			job.tiles.resize(job.width * height);
+			for (qpl::size y = 0u; y < height; ++y) {
+				auto begin = this->tiles.begin() + (job.x + (job.y + y) * this->index_width);
+				std::copy(begin, begin + job.width, job.tiles.begin() + y * job.width);
+			}
+			jobs.push_back(std::move(job));
+		}
+		this->dirty_chunks.clear();
 
-			if (rect.intersects(fov)) {
-				window.draw(this->chunks[i], states);
+		auto build = [layout](std::vector<chunk_tiles> jobs) {
+			std::vector<std::pair<qpl::size, sf::VertexArray>> result;
+			result.reserve(jobs.size());
+			for (auto& job : jobs) {
+				result.emplace_back(job.index, detail::build_tile_chunk(layout, job.tiles, job.width, job.x, job.y));
+			}
+			return result;
+		};
+
+		if (this->background_building) {
+			this->pending_chunks = std::async(std::launch::async, build, std::move(jobs)).share();
+		}
+		else {
+			for (auto& [index, chunk] : build(std::move(jobs))) {
+				this->chunks[index] = std::move(chunk);
+			}
+		}
+	}
+	void qsf::tile_map::enable_background_building(bool enable) {
+		this->background_building = enable;
+	}
+	bool qsf::tile_map::has_pending_chunks() const {
+		return this->pending_chunks.valid() || !this->dirty_chunks.empty();
+	}
+
+	void qsf::tile_map::draw(sf::RenderTarget& window, sf::RenderStates states) const {
+		if (this->chunks.empty() || !this->chunk_width_count) {
+			return;
+		}
+		states.texture = this->texture_ptr;
+
+		//visible area of the target in the local coordinates of the map
+		auto view_rect = window.getView().getInverseTransform().transformRect(sf::FloatRect(-1.f, -1.f, 2.f, 2.f));
+		auto local = states.transform.getInverse().transformRect(view_rect);
+
+		auto chunk_pixel_width = static_cast<qpl::f64>(this->max_chunk_size.x) * this->position_tile_dimension.x;
+		auto chunk_pixel_height = static_cast<qpl::f64>(this->max_chunk_size.y) * this->position_tile_dimension.y;
+		auto chunk_height = this->chunk_height_count();
+
+		auto range = [](qpl::f64 begin, qpl::f64 size, qpl::f64 chunk_size, qpl::size count) {
+			auto first = std::floor(begin / chunk_size);
+			auto last = std::floor((begin + size) / chunk_size);
+			auto max = static_cast<qpl::f64>(count) - 1.0;
+			return std::make_pair(qpl::size_cast(qpl::clamp(0.0, first, max)), qpl::size_cast(qpl::clamp(0.0, last, max)));
+		};
+		if (local.left + local.width < this->position.x || local.top + local.height < this->position.y) {
+			return;
+		}
+		if (local.left - this->position.x > chunk_pixel_width * this->chunk_width_count || local.top - this->position.y > chunk_pixel_height * chunk_height) {
+			return;
+		}
+		auto [x1, x2] = range(local.left - this->position.x, local.width, chunk_pixel_width, this->chunk_width_count);
+		auto [y1, y2] = range(local.top - this->position.y, local.height, chunk_pixel_height, chunk_height);
+
+		for (auto y = y1; y <= y2; ++y) {
+			for (auto x = x1; x <= x2; ++x) {
+				auto index = x + y * this->chunk_width_count;
+				if (index < this->chunks.size()) {
+					window.draw(this->chunks[index], states);
+				}
 			}
 		}
 	}
@@ -4016,11 +4264,20 @@ namespace qsf {
 	qpl::size qsf::tile_map::chunk_count() const {
 		return this->chunks.size();
 	}
+	qpl::size qsf::tile_map::chunk_height_count() const {
+		if (!this->chunk_width_count) {
+			return 0u;
+		}
+		return (this->chunks.size() - 1) / this->chunk_width_count + 1;
+	}
 	void qsf::tile_map::set_chunk_dimension(qpl::u32 x, qpl::u32 y) {
 		this->max_chunk_size = qpl::vector2u(x, y);
 	}
 	void qsf::tile_map::clear() {
 		this->chunks.clear();
+		this->tiles.clear();
+		this->dirty_chunks.clear();
+		this->pending_chunks = {};
 	}
 
 	void qsf::small_tile_map::set_texture(const sf::Texture& texture, qpl::u32 texture_tile_width) {
@@ -5526,6 +5783,264 @@ namespace qsf {
 		}
 	}
 
+	void qsf::series_graph::series::add_data(qpl::f64 value) {
+		this->values.push_back(value);
+		++this->version;
+	}
+	void qsf::series_graph::series::add_data(std::span<const qpl::f64> values) {
+		this->values.insert(this->values.end(), values.begin(), values.end());
+		++this->version;
+	}
+	void qsf::series_graph::series::clear() {
+		this->values.clear();
+		this->mark_changed();
+	}
+	qpl::size qsf::series_graph::series::size() const {
+		return this->values.size();
+	}
+	void qsf::series_graph::series::mark_changed() {
+		++this->version;
+		++this->reset_version;
+	}
+
+	qsf::series_graph::series& qsf::series_graph::add_series(std::string name) {
+		return this->series_map[name];
+	}
+	qsf::series_graph::series& qsf::series_graph::add_series(std::string name, qpl::rgba color, qpl::f32 thickness) {
+		auto& series = this->series_map[name];
+		series.color = color;
+		series.thickness = thickness;
+		series.vertex_version = qpl::u64_max;
+		return series;
+	}
+	qsf::series_graph::series& qsf::series_graph::get_series(std::string name) {
+		return this->series_map[name];
+	}
+	const qsf::series_graph::series& qsf::series_graph::get_series(std::string name) const {
+		return this->series_map.at(name);
+	}
+	bool qsf::series_graph::remove_series(std::string name) {
+		return this->series_map.erase(name) != 0u;
+	}
+	void qsf::series_graph::clear_data() {
+		for (auto& i : this->series_map) {
+			i.second.clear();
+		}
+	}
+	void qsf::series_graph::set_position(qpl::vector2f position) {
+		this->position = position;
+	}
+	void qsf::series_graph::set_dimension(qpl::vector2f dimension) {
+		this->dimension = dimension;
+	}
+	void qsf::series_graph::set_visible_range(qpl::size begin, qpl::size end) {
+		this->visible_begin = begin;
+		this->visible_end = end;
+		this->track_width = 0u;
+	}
+	void qsf::series_graph::set_visible_range_max() {
+		this->set_visible_range(0u, qpl::size_max);
+	}
+	void qsf::series_graph::enable_track_new_entries(qpl::size width) {
+		this->track_width = width;
+	}
+	void qsf::series_graph::disable_track_new_entries() {
+		auto range = this->visible_index_range();
+		this->set_visible_range(range.first, range.second);
+	}
+	qpl::size qsf::series_graph::total_size() const {
+		qpl::size result = 0u;
+		for (auto& i : this->series_map) {
+			result = qpl::max(result, i.second.size());
+		}
+		return result;
+	}
+	std::pair<qpl::size, qpl::size> qsf::series_graph::visible_index_range() const {
+		auto total = this->total_size();
+		if (this->track_width) {
+			return std::make_pair(total > this->track_width ? total - this->track_width : qpl::size{ 0u }, total);
+		}
+		auto end = qpl::min(this->visible_end, total);
+		return std::make_pair(qpl::min(this->visible_begin, end), end);
+	}
+	std::pair<qpl::f64, qpl::f64> qsf::series_graph::get_low_high() const {
+		this->update_geometry();
+		return std::make_pair(this->m_low, this->m_high);
+	}
+	qpl::size qsf::series_graph::vertex_count() const {
+		qpl::size result = 0u;
+		for (auto& i : this->series_map) {
+			if (i.second.visible) {
+				result += i.second.vertices.size();
+			}
+		}
+		return result;
+	}
+	void qsf::series_graph::update_geometry() const {
+		auto [begin, end] = this->visible_index_range();
+		auto count = end - begin;
+		auto pixels = qpl::max(qpl::size{ 1u }, qpl::size_cast(this->dimension.x));
+
+		//power of two column widths, so appending data only aggregates the newest column(s)
+		qpl::size width = 1u;
+		while (width * pixels < count) {
+			width <<= 1;
+		}
+
+		auto low = qpl::f64_max;
+		auto high = qpl::f64_min;
+		for (auto& [name, series] : this->series_map) {
+			if (!series.visible) {
+				continue;
+			}
+			auto series_end = qpl::max(begin, qpl::min(end, series.values.size()));
+
+			auto aggregate = [&](qpl::size from, qpl::size to) {
+				qsf::series_graph::series::column column;
+				for (auto j = from; j < to; ++j) {
+					auto value = series.values[j];
+					if (value < column.low) {
+						column.low = value;
+						column.low_index = j;
+					}
+					if (value > column.high) {
+						column.high = value;
+						column.high_index = j;
+					}
+				}
+				return column;
+			};
+
+			//buckets are aligned to absolute indices, so a window that moves with appended data keeps all but its edges
+			auto first = (begin + width - 1u) / width;
+			auto aligned = first * width;
+			auto reuse = series.column_width == width && series.column_reset_version == series.reset_version &&
+				series.column_first <= first && aligned <= series.column_end && series.column_end <= series_end;
+
+			auto start = aligned;
+			if (reuse) {
+				auto dropped = qpl::min(first - series.column_first, series.columns.size());
+				series.columns.erase(series.columns.begin(), series.columns.begin() + dropped);
+				start = qpl::max(aligned, (series.column_end / width) * width);
+				if (series.column_end % width && !series.columns.empty()) {
+					series.columns.pop_back();
+				}
+			}
+			else {
+				series.columns.clear();
+			}
+			for (auto i = start; i < series_end; i += width) {
+				series.columns.push_back(aggregate(i, qpl::min(i + width, series_end)));
+			}
+			series.column_head = aggregate(begin, qpl::min(aligned, series_end));
+			series.column_first = first;
+			series.column_end = qpl::max(aligned, series_end);
+			series.column_width = width;
+			series.column_reset_version = series.reset_version;
+
+			auto add_range = [&](const qsf::series_graph::series::column& column) {
+				if (column.low <= column.high) {
+					low = qpl::min(low, column.low);
+					high = qpl::max(high, column.high);
+				}
+			};
+			add_range(series.column_head);
+			for (auto& column : series.columns) {
+				add_range(column);
+			}
+		}
+		if (low > high) {
+			low = 0.0;
+			high = 1.0;
+		}
+		auto margin = (high - low) * this->y_margin;
+		low -= margin;
+		high += margin;
+
+		std::array<qpl::f64, 8u> key = {
+			this->position.x, this->position.y, this->dimension.x, this->dimension.y,
+			static_cast<qpl::f64>(begin), static_cast<qpl::f64>(end), low, high
+		};
+		auto key_changed = key != this->m_geometry_key;
+		this->m_geometry_key = key;
+		this->m_low = low;
+		this->m_high = high;
+
+		auto x_scale = count > 1u ? this->dimension.x / static_cast<qpl::f64>(count - 1) : 0.0;
+		auto y_scale = high > low ? this->dimension.y / (high - low) : 0.0;
+		auto map = [&](qpl::size index, qpl::f64 value) {
+			auto x = count > 1u ? static_cast<qpl::f64>(index - begin) * x_scale : this->dimension.x / 2.0;
+			auto y = y_scale ? this->dimension.y - (value - low) * y_scale : this->dimension.y / 2.0;
+			return qpl::vector2f(this->position.x + static_cast<qpl::f32>(x), this->position.y + static_cast<qpl::f32>(y));
+		};
+
+		std::vector<qpl::vector2f> points;
+		for (auto& [name, series] : this->series_map) {
+			if (!series.visible || (!key_changed && series.vertex_version == series.version)) {
+				continue;
+			}
+			series.vertex_version = series.version;
+
+			points.clear();
+			auto add_points = [&](const qsf::series_graph::series::column& column) {
+				if (column.low > column.high) {
+					return;
+				}
+				if (column.low_index == column.high_index) {
+					points.push_back(map(column.low_index, column.low));
+				}
+				else if (column.low_index < column.high_index) {
+					points.push_back(map(column.low_index, column.low));
+					points.push_back(map(column.high_index, column.high));
+				}
+				else {
+					points.push_back(map(column.high_index, column.high));
+					points.push_back(map(column.low_index, column.low));
+				}
+			};
+			add_points(series.column_head);
+			for (auto& column : series.columns) {
+				add_points(column);
+			}
+
+			auto& vertices = series.vertices;
+			vertices.set_primitive_type(qsf::primitive_type::triangles);
+			vertices.clear();
+			vertices.reserve(points.size() * 6u);
+			auto half = series.thickness / 2.0f;
+			for (qpl::size i = 1u; i < points.size(); ++i) {
+				auto a = points[i - 1];
+				auto b = points[i];
+				auto delta = b - a;
+				auto length = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+				if (length == 0.0f) {
+					continue;
+				}
+				auto normal = qpl::vector2f(-delta.y, delta.x) * (half / length);
+				vertices.add(qsf::vertex(a + normal, series.color));
+				vertices.add(qsf::vertex(a - normal, series.color));
+				vertices.add(qsf::vertex(b + normal, series.color));
+				vertices.add(qsf::vertex(b + normal, series.color));
+				vertices.add(qsf::vertex(a - normal, series.color));
+				vertices.add(qsf::vertex(b - normal, series.color));
+			}
+		}
+	}
+	void qsf::series_graph::draw(sf::RenderTarget& window, sf::RenderStates states) const {
+		this->update_geometry();
+
+		sf::RectangleShape background(this->dimension);
+		background.setPosition(this->position);
+		background.setFillColor(this->background_color);
+		window.draw(background, states);
+
+		for (auto& [name, series] : this->series_map) {
+			if (series.visible) {
+				series.vertices.draw(window, states);
+			}
+		}
+	}
+
 	void qsf::border_graphic::set_dimension(qpl::vector2f dimension) {
 		this->dimension = dimension;
 	}
@@ -5695,6 +6210,26 @@ namespace qsf {
 	}
 
 	namespace {
+		constexpr qpl::size colored_text_run_cache_limit = 4096u;
+
+		qpl::u64 colored_text_run_hash(const qpl::u32* text, qpl::size length, qpl::u32 character_size, bool is_bold, qpl::f32 letter_spacing_factor) {
+			qpl::u32 letter_spacing_bits;
+			std::memcpy(&letter_spacing_bits, &letter_spacing_factor, sizeof(letter_spacing_bits));
+
+			auto hash = 0xcbf2'9ce4'8422'2325ull;
+			auto mix = [&](qpl::u64 value) {
+				hash ^= value;
+				hash *= 0x100'0000'01b3ull;
+			};
+			for (qpl::size i = 0u; i < length; ++i) {
+				mix(text[i]);
+			}
+			mix(character_size);
+			mix(is_bold);
+			mix(letter_spacing_bits);
+			return hash;
+		}
+
 		void add_line(qsf::vertex_array& vertices,
 			qpl::f32 line_length,
 			qpl::f32 lineTop,
@@ -5824,6 +6359,98 @@ namespace qsf {
 	const sf::Glyph& qsf::colored_text::get_unicode_glyph(qpl::u32 character, qpl::u32 character_size, bool is_bold, qpl::f32 outline_thickness) {
 		return this->unicode_font->getGlyph(character, character_size, is_bold, outline_thickness);
 	}
+	const qsf::detail::colored_text_glyph& qsf::colored_text::get_cached_glyph(qpl::u32 character, bool is_bold) {
+		if (this->glyph_cache_font != this->font || this->glyph_cache_unicode_font != this->unicode_font) {
+			this->clear_glyph_cache();
+			this->glyph_cache_font = this->font;
+			this->glyph_cache_unicode_font = this->unicode_font;
+		}
+		auto key = qpl::u64_cast(character) | (qpl::u64_cast(this->character_size) << 32) | (qpl::u64_cast(is_bold) << 63);
+		auto found = this->glyph_cache.find(key);
+		if (found != this->glyph_cache.cend()) {
+			return found->second;
+		}
+
+		qsf::detail::colored_text_glyph result;
+		result.glyph = this->get_glyph(character, this->character_size, is_bold);
+
+		if (this->unicode_font) {
+			auto glyph_bounds = result.glyph.textureRect;
+			auto unreadable_glyph_texture = this->get_glyph(63744u, this->character_size, is_bold).textureRect;
+			if (glyph_bounds.left == unreadable_glyph_texture.left && glyph_bounds.top == unreadable_glyph_texture.top &&
+				glyph_bounds.width == unreadable_glyph_texture.width && glyph_bounds.height == unreadable_glyph_texture.height) {
+
+				auto default_advance = this->get_glyph(U'x', this->character_size, is_bold).advance;
+				auto default_unicode_advance = this->get_unicode_glyph(U'x', this->character_size, is_bold).advance;
+				result.glyph = this->get_unicode_glyph(character, this->character_size, is_bold);
+
+				auto factor = result.glyph.advance / default_unicode_advance;
+				if (factor >= 1.5) {
+					result.glyph.advance = default_advance * 2u;
+				}
+				else {
+					result.glyph.advance = default_advance;
+				}
+				result.unicode = true;
+			}
+		}
+		return this->glyph_cache.emplace(key, result).first->second;
+	}
+	const qsf::detail::colored_text_run& qsf::colored_text::get_cached_run(const qpl::u32_string& text, qpl::size begin, qpl::size end, bool is_bold) {
+		if (this->glyph_cache_font != this->font || this->glyph_cache_unicode_font != this->unicode_font) {
+			this->clear_glyph_cache();
+			this->glyph_cache_font = this->font;
+			this->glyph_cache_unicode_font = this->unicode_font;
+		}
+		auto length = end - begin;
+		auto key = colored_text_run_hash(text.data() + begin, length, this->character_size, is_bold, this->letter_spacing_factor);
+		auto found = this->run_cache.find(key);
+		if (found != this->run_cache.cend() && found->second.text.compare(0u, found->second.text.length(), text, begin, length) == 0) {
+			return found->second;
+		}
+		if (this->run_cache.size() >= colored_text_run_cache_limit) {
+			this->run_cache.clear();
+		}
+
+		qsf::detail::colored_text_run run;
+		run.text = text.substr(begin, length);
+		run.glyphs.reserve(length);
+
+		auto whitespace_width = this->font->getGlyph(U' ', this->character_size, is_bold).advance;
+		auto letter_spacing = (whitespace_width / 3.f) * (this->letter_spacing_factor - 1.f);
+		whitespace_width += letter_spacing;
+
+		qpl::u32 previous = 0;
+		for (auto c : run.text) {
+			if (c == U'\r') {
+				run.glyphs.emplace_back();
+				continue;
+			}
+			run.glyphs.push_back(this->get_cached_glyph(c, is_bold));
+			const auto& glyph = run.glyphs.back().glyph;
+
+			run.width += this->font->getKerning(previous, c, this->character_size);
+			previous = c;
+			switch (c) {
+			case U' ':
+				run.width += whitespace_width;
+				break;
+			case U'\t':
+				run.width += whitespace_width * 4;
+				break;
+			default:
+				run.width += glyph.advance + letter_spacing;
+				run.top = std::min(run.top, glyph.bounds.top);
+				run.bottom = std::max(run.bottom, glyph.bounds.top + glyph.bounds.height);
+				break;
+			}
+		}
+		return this->run_cache.insert_or_assign(key, std::move(run)).first->second;
+	}
+	void qsf::colored_text::clear_glyph_cache() {
+		this->glyph_cache.clear();
+		this->run_cache.clear();
+	}
 	qpl::u32 qsf::colored_text::get_style() const {
 		return this->style;
 	}
@@ -5918,46 +6545,54 @@ namespace qsf {
 			const auto& default_glyph = this->get_glyph(U'x', this->character_size, is_bold);
 			sf::FloatRect default_bounds = default_glyph.bounds;
 
-			sf::Glyph default_unicode_glyph;
-			if (this->unicode_font) {
-				default_unicode_glyph = this->get_unicode_glyph(U'x', this->character_size, is_bold);
-			}
-
-			auto unreadable_glyph_texture = this->get_glyph(63744u, this->character_size, is_bold).textureRect;
-
 			auto strike_through_offset = default_bounds.top + default_bounds.height / 2.f;
 			auto whitespace_width = this->font->getGlyph(U' ', this->character_size, is_bold).advance;
 			auto letter_spacing = (whitespace_width / 3.f) * (this->letter_spacing_factor - 1.f);
 			whitespace_width += letter_spacing;
 
+			//glyphs are resolved once per row of this element via the run cache
+			const qsf::detail::colored_text_run* run = nullptr;
+			qpl::size run_begin = 0u;
+			qpl::size run_end = 0u;
+
 			for (qpl::size i = 0u; i < element.text.length(); ++i) {
 				qpl::u32 c = element.text[i];
 
+				if (c != U'\n' && (!run || i >= run_end)) {
+					run_begin = i;
+					run_end = qpl::min(element.text.find(U'\n', i), element.text.length());
+					run = &this->get_cached_run(element.text, run_begin, run_end, is_bold);
+				}
+
 				if (c == U'\r') {
 					continue;
 				}
 
-				sf::Glyph character_glyph;
-				character_glyph = this->get_glyph(c, this->character_size, is_bold);
-				auto glyph_bounds = character_glyph.textureRect;
-
-				bool is_unicode_character = false;
-				if (this->unicode_font && glyph_bounds.left == unreadable_glyph_texture.left && glyph_bounds.top == unreadable_glyph_texture.top &&
-					glyph_bounds.width == unreadable_glyph_texture.width && glyph_bounds.height == unreadable_glyph_texture.height) {
-
-					character_glyph = this->get_unicode_glyph(c, this->character_size, is_bold);
+				bool row_in_range = (this->text_position.y - line_spacing) > visible_y_min && (this->text_position.y + line_spacing) < visible_y_max;
+				if (!row_in_range && c != U'\n') {
+					//skip the rest of the row, it gets no vertices but its extent from the run still counts for the hitbox
+					minX = std::min(minX, this->text_position.x);
+					minY = std::min(minY, this->text_position.y + run->top);
+					this->text_position.x += run->width;
+					maxX = std::max(maxX, this->text_position.x);
+					maxY = std::max(maxY, this->text_position.y + run->bottom);
 
-					auto factor = character_glyph.advance / default_unicode_glyph.advance;
-					if (factor >= 1.5) {
-						character_glyph.advance = default_glyph.advance * 2u;
-					}
-					else {
-						character_glyph.advance = default_glyph.advance;
+					if (run_end == element.text.length()) {
+						break;
 					}
-
-					is_unicode_character = true;
+					i = run_end;
+					this->text_position.y += line_spacing;
+					this->text_position.x = 0;
+					++this->rows;
+					maxY = std::max(maxY, this->text_position.y);
+					previous = U'\n';
+					continue;
 				}
 
+				const auto& cached_glyph = (c == U'\n') ? this->get_cached_glyph(c, is_bold) : run->glyphs[i - run_begin];
+				const auto& character_glyph = cached_glyph.glyph;
+				bool is_unicode_character = cached_glyph.unicode;
+
 
 				qpl::f32 left = character_glyph.bounds.left;
 				qpl::f32 top = character_glyph.bounds.top;
@@ -6057,6 +6692,471 @@ namespace qsf {
 		this->hitbox.dimension.y = maxY - minY;
 	}
 
+	namespace {
+		qsf::vertex transformed_vertex(const sf::Transform& transform, sf::Vector2f position, qpl::rgba color, qpl::vec2f tex_coords = {}) {
+			return qsf::vertex(transform.transformPoint(position), color, tex_coords);
+		}
+
+		//mirrors sf::Shape::update / updateOutline, fill as a triangle fan around the bounds center, outline as a ring of quads
+		void add_shape_vertices(std::vector<qsf::vertex>& fill, std::vector<qsf::vertex>& outline, const sf::Shape& shape) {
+			auto count = shape.getPointCount();
+			if (count < 3u) {
+				return;
+			}
+			const auto& transform = shape.getTransform();
+
+			std::vector<sf::Vector2f> points(count);
+			auto min = shape.getPoint(0u);
+			auto max = min;
+			for (qpl::size i = 0u; i < count; ++i) {
+				points[i] = shape.getPoint(i);
+				min.x = std::min(min.x, points[i].x);
+				min.y = std::min(min.y, points[i].y);
+				max.x = std::max(max.x, points[i].x);
+				max.y = std::max(max.y, points[i].y);
+			}
+			sf::Vector2f center((min.x + max.x) / 2.f, (min.y + max.y) / 2.f);
+
+			auto texture_rect = shape.getTextureRect();
+			auto tex_coords = [&](sf::Vector2f point) {
+				auto x = max.x > min.x ? (point.x - min.x) / (max.x - min.x) : 0.f;
+				auto y = max.y > min.y ? (point.y - min.y) / (max.y - min.y) : 0.f;
+				return qpl::vec2f(texture_rect.left + texture_rect.width * x, texture_rect.top + texture_rect.height * y);
+			};
+
+			auto fill_color = shape.getFillColor();
+			if (fill_color.a) {
+				fill.reserve(fill.size() + count * 3u);
+				auto center_vertex = transformed_vertex(transform, center, fill_color, tex_coords(center));
+				for (qpl::size i = 0u; i < count; ++i) {
+					const auto& a = points[i];
+					const auto& b = points[(i + 1) % count];
+					fill.push_back(center_vertex);
+					fill.push_back(transformed_vertex(transform, a, fill_color, tex_coords(a)));
+					fill.push_back(transformed_vertex(transform, b, fill_color, tex_coords(b)));
+				}
+			}
+
+			auto thickness = shape.getOutlineThickness();
+			if (thickness == 0.f) {
+				return;
+			}
+			auto normal = [&](sf::Vector2f a, sf::Vector2f b) {
+				sf::Vector2f result(a.y - b.y, b.x - a.x);
+				auto length = std::sqrt(result.x * result.x + result.y * result.y);
+				if (length != 0.f) {
+					result /= length;
+				}
+				if (result.x * (center.x - a.x) + result.y * (center.y - a.y) > 0.f) {
+					result = -result;
+				}
+				return result;
+			};
+
+			std::vector<sf::Vector2f> outer(count);
+			for (qpl::size i = 0u; i < count; ++i) {
+				const auto& previous = points[(i + count - 1) % count];
+				const auto& current = points[i];
+				const auto& next = points[(i + 1) % count];
+
+				auto n1 = normal(previous, current);
+				auto n2 = normal(current, next);
+				auto factor = 1.f + (n1.x * n2.x + n1.y * n2.y);
+				outer[i] = current + (n1 + n2) / factor * thickness;
+			}
+
+			auto outline_color = shape.getOutlineColor();
+			outline.reserve(outline.size() + count * 6u);
+			for (qpl::size i = 0u; i < count; ++i) {
+				auto j = (i + 1) % count;
+				auto inner_a = transformed_vertex(transform, points[i], outline_color);
+				auto inner_b = transformed_vertex(transform, points[j], outline_color);
+				auto outer_a = transformed_vertex(transform, outer[i], outline_color);
+				auto outer_b = transformed_vertex(transform, outer[j], outline_color);
+				outline.push_back(inner_a);
+				outline.push_back(outer_a);
+				outline.push_back(inner_b);
+				outline.push_back(inner_b);
+				outline.push_back(outer_a);
+				outline.push_back(outer_b);
+			}
+		}
+
+		//mirrors sf::Text::ensureGeometryUpdate, the outline glyphs come first so they end up below the fill
+		void add_text_vertices(qsf::vertex_array& vertices, const sf::Text& text) {
+			const auto* font = text.getFont();
+			const auto& string = text.getString();
+			if (!font || string.isEmpty()) {
+				return;
+			}
+
+			auto character_size = text.getCharacterSize();
+			auto style = text.getStyle();
+			bool is_bold = style & sf::Text::Style::Bold;
+			bool is_underlined = style & sf::Text::Style::Underlined;
+			bool is_strike_through = style & sf::Text::Style::StrikeThrough;
+			auto italic_shear = (style & sf::Text::Style::Italic) ? 0.2094395102393f : 0.f;
+			auto underline_offset = font->getUnderlinePosition(character_size);
+			auto underline_thickness = font->getUnderlineThickness(character_size);
+
+			auto x_bounds = font->getGlyph(U'x', character_size, is_bold).bounds;
+			auto strike_through_offset = x_bounds.top + x_bounds.height / 2.f;
+
+			auto whitespace_width = font->getGlyph(U' ', character_size, is_bold).advance;
+			auto letter_spacing = (whitespace_width / 3.f) * (text.getLetterSpacing() - 1.f);
+			whitespace_width += letter_spacing;
+			auto line_spacing = font->getLineSpacing(character_size) * text.getLineSpacing();
+
+			qpl::rgba fill_color = text.getFillColor();
+			qpl::rgba outline_color = text.getOutlineColor();
+			auto outline_thickness = text.getOutlineThickness();
+
+			qsf::vertex_array fill;
+			qsf::vertex_array outline;
+
+			auto add_lines = [&](qpl::vec2f position) {
+				if (is_underlined) {
+					add_line(fill, position.x, position.y, fill_color, underline_offset, underline_thickness);
+					if (outline_thickness != 0) {
+						add_line(outline, position.x, position.y, outline_color, underline_offset, underline_thickness, outline_thickness);
+					}
+				}
+				if (is_strike_through) {
+					add_line(fill, position.x, position.y, fill_color, strike_through_offset, underline_thickness);
+					if (outline_thickness != 0) {
+						add_line(outline, position.x, position.y, outline_color, strike_through_offset, underline_thickness, outline_thickness);
+					}
+				}
+			};
+
+			qpl::vec2f position(0.f, qpl::f32_cast(character_size));
+			qpl::u32 previous = 0u;
+			for (auto c : string) {
+				if (c == U'\r') {
+					continue;
+				}
+				position.x += font->getKerning(previous, c, character_size);
+				if (c == U'\n' && previous != U'\n') {
+					add_lines(position);
+				}
+				previous = c;
+
+				if ((c == U' ') || (c == U'\n') || (c == U'\t')) {
+					switch (c) {
+					case U' ':
+						position.x += whitespace_width;
+						break;
+					case U'\t':
+						position.x += whitespace_width * 4;
+						break;
+					case U'\n':
+						position.y += line_spacing;
+						position.x = 0;
+						break;
+					}
+					continue;
+				}
+
+				if (outline_thickness != 0) {
+					add_glyph_quad(outline, position, outline_color, font->getGlyph(c, character_size, is_bold, outline_thickness), italic_shear);
+				}
+				const auto& glyph = font->getGlyph(c, character_size, is_bold);
+				add_glyph_quad(fill, position, fill_color, glyph, italic_shear);
+				position.x += glyph.advance + letter_spacing;
+			}
+			if (position.x > 0) {
+				add_lines(position);
+			}
+
+			const auto& transform = text.getTransform();
+			vertices.reserve(vertices.size() + outline.size() + fill.size());
+			for (const auto& vertex : outline) {
+				vertices.add(transformed_vertex(transform, vertex.position, vertex.color, vertex.tex_coords));
+			}
+			for (const auto& vertex : fill) {
+				vertices.add(transformed_vertex(transform, vertex.position, vertex.color, vertex.tex_coords));
+			}
+		}
+	}
+
+	void qsf::sprite_batch::clear() {
+		this->staged_vertices.clear();
+		this->commands.clear();
+		this->batches.clear();
+		this->objects = 0u;
+		this->draw_calls = 0u;
+		this->built = true;
+	}
+	void qsf::sprite_batch::set_layer(qpl::i32 layer) {
+		this->layer = layer;
+	}
+	qpl::i32 qsf::sprite_batch::get_layer() const {
+		return this->layer;
+	}
+	void qsf::sprite_batch::set_group_by_texture(bool group) {
+		if (this->group_by_texture != group) {
+			this->group_by_texture = group;
+			this->built = this->commands.empty();
+		}
+	}
+	bool qsf::sprite_batch::is_grouped_by_texture() const {
+		return this->group_by_texture;
+	}
+
+	void qsf::sprite_batch::add(const qsf::rectangle& rectangle) {
+		this->add(rectangle.m_rect);
+	}
+	void qsf::sprite_batch::add(const qsf::vrectangle& rectangle) {
+		qsf::detail::rectangle = rectangle;
+		this->add(qsf::detail::rectangle);
+	}
+	void qsf::sprite_batch::add(const qsf::circle& circle) {
+		this->add(circle.circle_shape);
+	}
+	void qsf::sprite_batch::add(const qsf::vcircle& circle) {
+		qsf::detail::circle = circle;
+		this->add(qsf::detail::circle);
+	}
+	void qsf::sprite_batch::add(const qsf::line& line) {
+		std::array<qsf::vertex, 2> vertices;
+		for (qpl::size i = 0u; i < vertices.size(); ++i) {
+			vertices[i] = qsf::vertex(line.vertices[i].position, line.vertices[i].color, line.vertices[i].texCoords);
+		}
+		this->add_lines(vertices);
+	}
+	void qsf::sprite_batch::add(const qsf::vline& line) {
+		qsf::detail::line = line;
+		this->add(qsf::detail::line);
+	}
+	void qsf::sprite_batch::add(const qsf::thick_line& line) {
+		std::array<qsf::vertex, 6> vertices;
+		constexpr std::array<qpl::size, 6> quad_indices = { 0u, 1u, 2u, 0u, 2u, 3u };
+		for (qpl::size i = 0u; i < vertices.size(); ++i) {
+			const auto& vertex = line.vertices[quad_indices[i]];
+			vertices[i] = qsf::vertex(vertex.position, vertex.color, vertex.texCoords);
+		}
+		this->add_triangles(vertices);
+	}
+	void qsf::sprite_batch::add(const qsf::vthick_line& line) {
+		qsf::detail::thick_line = line;
+		this->add(qsf::detail::thick_line);
+	}
+	void qsf::sprite_batch::add(const qsf::sprite& sprite) {
+		this->add(sprite.m_sprite);
+	}
+	void qsf::sprite_batch::add(const qsf::text& text) {
+		this->add(text.m_text);
+	}
+	void qsf::sprite_batch::add(const qsf::vtext& text) {
+		qsf::detail::text = text;
+		this->add(qsf::detail::text);
+	}
+	void qsf::sprite_batch::add(const sf::Shape& shape) {
+		std::vector<qsf::vertex> fill;
+		std::vector<qsf::vertex> outline;
+		add_shape_vertices(fill, outline, shape);
+
+		auto objects = this->objects;
+		this->add_triangles(fill, shape.getTexture());
+		this->add_triangles(outline);
+		this->objects = objects + 1;
+	}
+	void qsf::sprite_batch::add(const sf::Sprite& sprite) {
+		auto rect = sprite.getTextureRect();
+		auto width = qpl::f32_cast(std::abs(rect.width));
+		auto height = qpl::f32_cast(std::abs(rect.height));
+		auto left = qpl::f32_cast(rect.left);
+		auto right = left + rect.width;
+		auto top = qpl::f32_cast(rect.top);
+		auto bottom = top + rect.height;
+
+		const auto& transform = sprite.getTransform();
+		qpl::rgba color = sprite.getColor();
+		auto top_left = transformed_vertex(transform, { 0.f, 0.f }, color, { left, top });
+		auto bottom_left = transformed_vertex(transform, { 0.f, height }, color, { left, bottom });
+		auto top_right = transformed_vertex(transform, { width, 0.f }, color, { right, top });
+		auto bottom_right = transformed_vertex(transform, { width, height }, color, { right, bottom });
+
+		std::array<qsf::vertex, 6> vertices = { top_left, bottom_left, top_right, top_right, bottom_left, bottom_right };
+		this->add_triangles(vertices, sprite.getTexture());
+	}
+	void qsf::sprite_batch::add(const sf::Text& text) {
+		const auto* font = text.getFont();
+		if (!font) {
+			return;
+		}
+		qsf::vertex_array vertices;
+		add_text_vertices(vertices, text);
+		this->add_triangles(vertices.vertices, &font->getTexture(text.getCharacterSize()));
+	}
+
+	void qsf::sprite_batch::add_triangles(std::span<const qsf::vertex> vertices, const sf::Texture* texture) {
+		++this->objects;
+		if (vertices.empty()) {
+			return;
+		}
+		qsf::sprite_batch::command command;
+		command.layer = this->layer;
+		command.texture = texture;
+		command.primitive_type = qsf::primitive_type::triangles;
+		command.begin = this->staged_vertices.size();
+		command.size = vertices.size();
+		this->staged_vertices.insert(this->staged_vertices.end(), vertices.begin(), vertices.end());
+		this->commands.push_back(command);
+		this->built = false;
+	}
+	void qsf::sprite_batch::add_lines(std::span<const qsf::vertex> vertices) {
+		++this->objects;
+		if (vertices.empty()) {
+			return;
+		}
+		qsf::sprite_batch::command command;
+		command.layer = this->layer;
+		command.texture = nullptr;
+		command.primitive_type = qsf::primitive_type::lines;
+		command.begin = this->staged_vertices.size();
+		command.size = vertices.size();
+		this->staged_vertices.insert(this->staged_vertices.end(), vertices.begin(), vertices.end());
+		this->commands.push_back(command);
+		this->built = false;
+	}
+
+	void qsf::sprite_batch::build() const {
+		if (this->built) {
+			return;
+		}
+		this->built = true;
+		this->batches.clear();
+
+		//a group is (layer, texture, primitive type), groups of a layer keep the order in which they first appeared.
+		//without grouping every command is its own rank, so a layer keeps the submission order
+		std::vector<qpl::size> ranks(this->commands.size());
+		if (this->group_by_texture) {
+			std::map<std::tuple<qpl::i32, const sf::Texture*, qsf::primitive_type>, qpl::size> group_ranks;
+			for (qpl::size i = 0u; i < this->commands.size(); ++i) {
+				const auto& command = this->commands[i];
+				auto key = std::make_tuple(command.layer, command.texture, command.primitive_type);
+				ranks[i] = group_ranks.try_emplace(key, group_ranks.size()).first->second;
+			}
+		}
+		else {
+			std::iota(ranks.begin(), ranks.end(), qpl::size{ 0u });
+		}
+
+		std::vector<qpl::size> order(this->commands.size());
+		std::iota(order.begin(), order.end(), qpl::size{ 0u });
+		std::stable_sort(order.begin(), order.end(), [&](qpl::size a, qpl::size b) {
+			if (this->commands[a].layer != this->commands[b].layer) {
+				return this->commands[a].layer < this->commands[b].layer;
+			}
+			return ranks[a] < ranks[b];
+		});
+
+		for (auto index : order) {
+			const auto& command = this->commands[index];
+			if (this->batches.empty() || this->batches.back().texture != command.texture || this->batches.back().vertices.primitive_type != command.primitive_type) {
+				this->batches.emplace_back();
+				this->batches.back().texture = command.texture;
+				this->batches.back().vertices.set_primitive_type(command.primitive_type);
+			}
+			auto begin = this->staged_vertices.begin() + command.begin;
+			auto& vertices = this->batches.back().vertices.vertices;
+			vertices.insert(vertices.end(), begin, begin + command.size);
+		}
+	}
+	const std::vector<qsf::sprite_batch::batch>& qsf::sprite_batch::get_batches() const {
+		this->build();
+		return this->batches;
+	}
+	qsf::sprite_batch::statistics qsf::sprite_batch::get_statistics() const {
+		this->build();
+		qsf::sprite_batch::statistics result;
+		result.objects = this->objects;
+		result.commands = this->commands.size();
+		result.batches = this->batches.size();
+		result.vertices = this->staged_vertices.size();
+		result.draw_calls = this->draw_calls;
+		return result;
+	}
+	void qsf::sprite_batch::draw(sf::RenderTarget& window, sf::RenderStates states) const {
+		this->build();
+		this->draw_calls = 0u;
+		for (const auto& batch : this->batches) {
+			states.texture = batch.texture;
+			batch.vertices.draw(window, states);
+			++this->draw_calls;
+		}
+	}
+
+	void qsf::sprite_batch_self_check() {
+		auto check = [](bool condition, const char* what) {
+			if (!condition) {
+				throw qpl::exception("qsf::sprite_batch_self_check : ", what);
+			}
+		};
+		auto vertex_equals = [](const qsf::vertex& vertex, qpl::vec2f position, qpl::vec2f tex_coords) {
+			return vertex.position == position && vertex.tex_coords == tex_coords && vertex.color == qpl::rgba::white();
+		};
+
+		//the textures are only compared by address, they are never uploaded
+		sf::Texture texture_a;
+		sf::Texture texture_b;
+
+		qsf::sprite_batch batch;
+		sf::Sprite sprite;
+		sprite.setTextureRect(sf::IntRect(10, 20, 30, 40));
+		sprite.setPosition(5.f, 6.f);
+		batch.add(sprite);
+
+		const auto& quad = batch.get_batches();
+		check(quad.size() == 1u && quad[0].vertices.size() == 6u, "sprite does not produce one quad");
+		const auto& v = quad[0].vertices.vertices;
+		check(vertex_equals(v[0], { 5.f, 6.f }, { 10.f, 20.f }), "sprite top left vertex");
+		check(vertex_equals(v[1], { 5.f, 46.f }, { 10.f, 60.f }), "sprite bottom left vertex");
+		check(vertex_equals(v[2], { 35.f, 6.f }, { 40.f, 20.f }), "sprite top right vertex");
+		check(vertex_equals(v[3], { 35.f, 6.f }, { 40.f, 20.f }), "sprite top right vertex");
+		check(vertex_equals(v[4], { 5.f, 46.f }, { 10.f, 60.f }), "sprite bottom left vertex");
+		check(vertex_equals(v[5], { 35.f, 46.f }, { 40.f, 60.f }), "sprite bottom right vertex");
+
+		std::array<qsf::vertex, 3> triangle;
+		for (qpl::size i = 0u; i < triangle.size(); ++i) {
+			triangle[i] = qsf::vertex(qpl::vec2f(qpl::f32_cast(i), 0.f), qpl::rgba::white());
+		}
+		std::array<qsf::vertex, 2> line = { triangle[0], triangle[1] };
+
+		auto fill = [&](qsf::sprite_batch& batch) {
+			batch.clear();
+			batch.add_triangles(triangle, &texture_a);
+			batch.add_triangles(triangle, &texture_a);
+			batch.add_triangles(triangle, &texture_b);
+			batch.add_triangles(triangle, &texture_a);
+			batch.add_lines(line);
+			batch.set_layer(-1);
+			batch.add_triangles(triangle, &texture_b);
+			batch.set_layer(0);
+		};
+		auto matches = [](const std::vector<qsf::sprite_batch::batch>& batches, const std::vector<std::pair<const sf::Texture*, qpl::size>>& expected) {
+			if (batches.size() != expected.size()) {
+				return false;
+			}
+			for (qpl::size i = 0u; i < batches.size(); ++i) {
+				if (batches[i].texture != expected[i].first || batches[i].vertices.size() != expected[i].second) {
+					return false;
+				}
+			}
+			return true;
+		};
+
+		fill(batch);
+		check(!batch.is_grouped_by_texture(), "grouping by texture is not opt-in");
+		check(matches(batch.get_batches(), { { &texture_b, 3u }, { &texture_a, 6u }, { &texture_b, 3u }, { &texture_a, 3u }, { nullptr, 2u } }), "submission order within a layer is not kept");
+		check(batch.get_batches().back().vertices.primitive_type == qsf::primitive_type::lines, "lines are not batched as lines");
+
+		batch.set_group_by_texture(true);
+		check(matches(batch.get_batches(), { { &texture_b, 3u }, { &texture_a, 9u }, { &texture_b, 3u }, { nullptr, 2u } }), "textures of a layer are not grouped");
+		check(batch.get_statistics().objects == 6u && batch.get_statistics().vertices == 17u, "statistics do not match the added objects");
+	}
+
 	std::unordered_map<std::string, qsf::text> qsf::detail::texts;
 
 	qsf::text& qsf::get_text(const std::string& name) {
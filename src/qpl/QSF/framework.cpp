@@ -6,6 +6,8 @@
 #include <qpl/QGL/shader.hpp>
 #endif
 
+#include <thread>
+
 namespace qsf {
 	qsf::framework::framework() {
 		this->set_title(" ");
@@ -25,6 +27,7 @@ namespace qsf {
 	}
 
 	void qsf::framework::draw_call() {
+		qpl::small_clock clock;
 		if (this->states.back()->is_clear_allowed()) {
 			this->states.back()->clear();
 			for (auto& i : this->render_textures) {
@@ -34,11 +37,20 @@ namespace qsf {
 			}
 		}
 		this->states.back()->drawing();
+		this->timing.draw = clock.elapsed_reset();
 		if (this->states.back()->is_display_allowed()) {
 			this->window.display();
 		}
+		this->timing.present = clock.elapsed();
 	}
 
+	void qsf::framework::apply_deferred_state_changes() {
+		auto changes = std::move(this->deferred_state_changes);
+		this->deferred_state_changes.clear();
+		for (auto& change : changes) {
+			change();
+		}
+	}
 	void qsf::framework::init_back() {
 		if (this->states.size() && !this->states.back()->is_initalized) {
 			this->states.back()->init();
@@ -101,27 +113,105 @@ namespace qsf {
 			this->no_focus_time = this->no_focus_timer.elapsed();
 		}
 	}
+	void qsf::framework::update_stage() {
+		auto& state = *this->states.back();
+		qpl::small_clock clock;
+
+		state.updating();
+		this->timing.update = clock.elapsed_reset();
+
+		this->timing.fixed_steps = 0u;
+		if (this->use_fixed_timestep) {
+			this->fixed_accumulator += this->event.m_frame_time.secs_f();
+			while (this->fixed_accumulator >= this->fixed_timestep && this->timing.fixed_steps < this->max_fixed_steps) {
+				state.fixed_updating();
+				this->fixed_accumulator -= this->fixed_timestep;
+				++this->timing.fixed_steps;
+			}
+			if (this->fixed_accumulator >= this->fixed_timestep) {
+				//too far behind, drop the backlog instead of spiraling
+				this->fixed_accumulator = std::fmod(this->fixed_accumulator, this->fixed_timestep);
+			}
+			this->interpolation = this->fixed_accumulator / this->fixed_timestep;
+		}
+		this->timing.fixed_update = clock.elapsed_reset();
+
+		state.wait_jobs();
+		this->timing.jobs = clock.elapsed();
+	}
+	void qsf::framework::pace_frame() {
+		this->timing.idle = qpl::time(0);
+		if (!this->use_frame_pacing || !this->framerate_limit) {
+			return;
+		}
+		auto target = 1.0 / this->framerate_limit;
+		auto remaining = target - this->frame_clock.elapsed_f();
+		if (remaining <= 0.0) {
+			return;
+		}
+		qpl::small_clock clock;
+		if (remaining > 0.002) {
+			qpl::wait(remaining - 0.001);
+		}
+		while (this->frame_clock.elapsed_f() < target) {
+			std::this_thread::yield();
+		}
+		this->timing.idle = clock.elapsed();
+	}
 	bool qsf::framework::game_loop_segment() {
 		if (!this->is_created()) {
 			this->create();
 		}
 
+		this->frame_clock.reset();
+		this->timing.update = this->timing.fixed_update = this->timing.jobs = qpl::time(0);
+		this->timing.draw = this->timing.present = qpl::time(0);
+		this->timing.fixed_steps = 0u;
+
 		auto focus_before = this->focus;
 		this->internal_update();
+		this->timing.events = this->frame_clock.elapsed();
 
 		if (this->state_size_before != this->states.size()) {
 			this->states.back()->call_on_activate();
 			this->state_size_before = this->states.size();
 		}
 		
+		bool drawn = false;
 		if (this->update_if_no_focus || this->focus || (focus_before != this->focus)) {
-			this->states.back()->updating();
+			if (this->use_concurrent_update && this->update_thread && this->states.back()->is_initalized) {
+				//states pushed from either thread are queued, the worker only holds a reference to the current back state
+				this->defer_state_changes = true;
+				auto future = this->update_thread->submit([this]() {
+					this->update_stage();
+				});
+				{
+					//also runs if draw_call throws, the worker must be done before the states are touched again
+					struct update_guard {
+						qsf::framework* framework;
+						std::future<void>& future;
+						~update_guard() {
+							this->future.wait();
+							this->framework->defer_state_changes = false;
+						}
+					} guard{ this, future };
+					this->draw_call();
+				}
+				drawn = true;
+				future.get();
+				this->apply_deferred_state_changes();
+				this->states.back()->call_on_publish();
+			}
+			else {
+				this->update_stage();
+				this->states.back()->call_on_publish();
+			}
 			this->states.back()->last_dimension = this->dimension;
 			++this->states.back()->frame_ctr;
 		}
 		this->states.back()->update_close_window();
 		
-		bool allow_draw = this->states.size() == this->state_size_before;
+		bool allow_draw = !drawn && this->states.size() == this->state_size_before;
 		if (this->states.back()->is_pop_this_state) {
 			this->states.pop_back();
 			if (this->states.empty()) {
@@ -138,6 +228,8 @@ namespace qsf {
 		if (allow_draw) {
 			this->draw_call();
 		}
+		this->pace_frame();
+		this->timing.frame = this->frame_clock.elapsed();
 		return true;
 	}
 	void qsf::framework::game_loop() {
@@ -228,6 +320,62 @@ namespace qsf {
 	void qsf::framework::disable_framerate_limit() {
 		this->framerate_limit = 0u;
 	}
+	void qsf::framework::enable_frame_pacing() {
+		this->use_frame_pacing = true;
+		if (this->created) {
+			this->window.setFramerateLimit(0u);
+		}
+	}
+	void qsf::framework::disable_frame_pacing() {
+		this->use_frame_pacing = false;
+		if (this->created) {
+			this->window.setFramerateLimit(this->framerate_limit);
+		}
+	}
+	bool qsf::framework::is_frame_pacing_enabled() const {
+		return this->use_frame_pacing;
+	}
+	void qsf::framework::enable_fixed_timestep(qpl::f64 step) {
+		if (step <= 0.0) {
+			throw qpl::exception("framework::enable_fixed_timestep: step must be positive, is ", step);
+		}
+		this->use_fixed_timestep = true;
+		this->fixed_timestep = step;
+		this->fixed_accumulator = 0.0;
+		this->interpolation = 0.0;
+	}
+	void qsf::framework::disable_fixed_timestep() {
+		this->use_fixed_timestep = false;
+		this->interpolation = 0.0;
+	}
+	bool qsf::framework::is_fixed_timestep_enabled() const {
+		return this->use_fixed_timestep;
+	}
+	void qsf::framework::set_max_fixed_steps(qpl::size steps) {
+		this->max_fixed_steps = qpl::max(steps, qpl::size{ 1u });
+	}
+	qpl::f64 qsf::framework::get_fixed_timestep() const {
+		return this->fixed_timestep;
+	}
+	qpl::f64 qsf::framework::get_interpolation() const {
+		return this->interpolation;
+	}
+	void qsf::framework::enable_concurrent_update() {
+		this->use_concurrent_update = true;
+		if (!this->update_thread) {
+			this->update_thread = std::make_unique<qpl::thread_pool>(1u);
+		}
+	}
+	void qsf::framework::disable_concurrent_update() {
+		this->use_concurrent_update = false;
+		this->update_thread.reset();
+	}
+	bool qsf::framework::is_concurrent_update_enabled() const {
+		return this->use_concurrent_update;
+	}
+	const qsf::frame_timing& qsf::framework::get_frame_timing() const {
+		return this->timing;
+	}
 	void qsf::framework::enable_update_if_no_focus() {
 		this->update_if_no_focus = true;
 	}
@@ -387,7 +535,7 @@ namespace qsf {
 
 			this->event.m_screen_dimension = this->dimension;
 			this->window.create(sf::VideoMode({ this->dimension.x, this->dimension.y }), s, this->style, this->context_settings);
-			this->window.setFramerateLimit(this->framerate_limit);
+			this->window.setFramerateLimit(this->use_frame_pacing ? 0u : this->framerate_limit);
 			this->created = true;
 
 #if defined QPL_INTERN_GLEW_USE
@@ -500,6 +648,32 @@ namespace qsf {
 	}
 	void qsf::base_state::call_on_activate() {
 
+	}
+	void qsf::base_state::call_on_publish() {
+
+	}
+	void qsf::base_state::fixed_updating() {
+
+	}
+	void qsf::base_state::wait_jobs() {
+		auto jobs = std::move(this->jobs);
+		this->jobs.clear();
+
+		//every job has to finish before the frame continues, even if an earlier one threw
+		std::exception_ptr exception;
+		for (auto& job : jobs) {
+			try {
+				job.get();
+			}
+			catch (...) {
+				if (!exception) {
+					exception = std::current_exception();
+				}
+			}
+		}
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
 	}
 	void qsf::base_state::draw_call() {
 		this->framework->draw_call();
@@ -757,6 +931,15 @@ namespace qsf {
 	qpl::time qsf::base_state::run_time() const {
 		return this->framework->run_time();
 	}
+	qpl::f64 qsf::base_state::fixed_time_step() const {
+		return this->framework->get_fixed_timestep();
+	}
+	qpl::f64 qsf::base_state::interpolation() const {
+		return this->framework->get_interpolation();
+	}
+	const qsf::frame_timing& qsf::base_state::get_frame_timing() const {
+		return this->framework->get_frame_timing();
+	}
 	const qsf::event_info& qsf::base_state::event() const {
 		return this->framework->event;
 	}
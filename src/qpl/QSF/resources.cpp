@@ -4,6 +4,24 @@
 #if defined QPL_INTERN_SFML_USE
 #include <qpl/string.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace qsf {
 
 	void qsf::load_font(sf::Font& font, const std::string& path) {
@@ -109,6 +127,7 @@ namespace qsf {
 
 	void qsf::resources::add_font(const std::string& name, const std::string& path) {
 		qsf::load_font(this->fonts[name], path);
+		this->font_memory.erase(name);
 	}
 	void qsf::resources::add_sound(const std::string& name, const std::string& path) {
 		qsf::load_sound(this->sounds[name], path);
@@ -138,6 +157,7 @@ namespace qsf {
 
 	void qsf::resources::add_font_from_memory(const std::string& name, const std::string& memory) {
 		qsf::load_font_from_memory(this->fonts[name], memory);
+		this->font_memory.erase(name);
 	}
 	void qsf::resources::add_sound_from_memory(const std::string& name, const std::string& memory) {
 		qsf::load_sound_from_memory(this->sounds[name], memory);
@@ -327,5 +347,435 @@ namespace qsf {
 	bool qsf::find_shader(const std::string& name) {
 		return qsf::detail::resources.find_shader(name);
 	}
+
+	namespace {
+		std::string normalized_resource_name(std::string name) {
+			std::replace(name.begin(), name.end(), '\\', '/');
+			while (name.starts_with("./")) {
+				name.erase(0u, 2u);
+			}
+			return name;
+		}
+		std::string resource_request_key(qsf::resource_type type, const std::string& path) {
+			return qpl::to_string(static_cast<qpl::u32>(type), '|', path);
+		}
+		constexpr std::string_view resource_archive_magic = "QSFPACK1";
+	}
+
+	void qsf::resource_archive::open(const std::string& path) {
+		this->close();
+#ifdef _WIN32
+		auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw qpl::exception("resource_archive::open: couldn't open \"", path, "\"");
+		}
+		this->file_handle = file;
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+			this->close();
+			throw qpl::exception("resource_archive::open: \"", path, "\" is empty");
+		}
+		this->mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!this->mapping_handle) {
+			this->close();
+			throw qpl::exception("resource_archive::open: couldn't map \"", path, "\" (", GetLastError(), ")");
+		}
+		this->data = static_cast<const char*>(MapViewOfFile(this->mapping_handle, FILE_MAP_READ, 0, 0, 0));
+		if (!this->data) {
+			this->close();
+			throw qpl::exception("resource_archive::open: couldn't map \"", path, "\" (", GetLastError(), ")");
+		}
+		this->data_size = qpl::size_cast(file_size.QuadPart);
+#else
+		this->file_descriptor = ::open(path.c_str(), O_RDONLY);
+		if (this->file_descriptor < 0) {
+			throw qpl::exception("resource_archive::open: couldn't open \"", path, "\"");
+		}
+		struct stat file_stat;
+		if (fstat(this->file_descriptor, &file_stat) != 0 || file_stat.st_size == 0) {
+			this->close();
+			throw qpl::exception("resource_archive::open: \"", path, "\" is empty");
+		}
+		auto mapping = mmap(nullptr, qpl::size_cast(file_stat.st_size), PROT_READ, MAP_PRIVATE, this->file_descriptor, 0);
+		if (mapping == MAP_FAILED) {
+			this->close();
+			throw qpl::exception("resource_archive::open: couldn't map \"", path, "\"");
+		}
+		this->data = static_cast<const char*>(mapping);
+		this->data_size = qpl::size_cast(file_stat.st_size);
+#endif
+
+		qpl::size position = 0u;
+		auto corrupted = [&]() {
+			this->close();
+			return qpl::exception("resource_archive::open: \"", path, "\" is not a valid archive");
+		};
+		auto read_u64 = [&]() {
+			if (this->data_size - position < sizeof(qpl::u64)) {
+				throw corrupted();
+			}
+			qpl::u64 value;
+			std::memcpy(&value, this->data + position, sizeof(value));
+			position += sizeof(value);
+			return value;
+		};
+
+		if (this->data_size < resource_archive_magic.size() || std::string_view(this->data, resource_archive_magic.size()) != resource_archive_magic) {
+			throw corrupted();
+		}
+		position = resource_archive_magic.size();
+
+		auto count = read_u64();
+		for (qpl::u64 i = 0u; i < count; ++i) {
+			auto name_size = read_u64();
+			if (this->data_size - position < name_size) {
+				throw corrupted();
+			}
+			std::string name(this->data + position, qpl::size_cast(name_size));
+			position += qpl::size_cast(name_size);
+
+			auto offset = read_u64();
+			auto size = read_u64();
+			if (offset > this->data_size || size > this->data_size - offset) {
+				throw corrupted();
+			}
+			this->entries[name] = std::span<const char>(this->data + offset, qpl::size_cast(size));
+		}
+	}
+	void qsf::resource_archive::close() {
+		this->entries.clear();
+#ifdef _WIN32
+		if (this->data) {
+			UnmapViewOfFile(this->data);
+		}
+		if (this->mapping_handle) {
+			CloseHandle(this->mapping_handle);
+			this->mapping_handle = nullptr;
+		}
+		if (this->file_handle) {
+			CloseHandle(this->file_handle);
+			this->file_handle = nullptr;
+		}
+#else
+		if (this->data) {
+			munmap(const_cast<char*>(this->data), this->data_size);
+		}
+		if (this->file_descriptor >= 0) {
+			::close(this->file_descriptor);
+			this->file_descriptor = -1;
+		}
+#endif
+		this->data = nullptr;
+		this->data_size = 0u;
+	}
+	bool qsf::resource_archive::is_open() const {
+		return this->data != nullptr;
+	}
+	bool qsf::resource_archive::contains(const std::string& name) const {
+		return this->entries.find(normalized_resource_name(name)) != this->entries.cend();
+	}
+	std::span<const char> qsf::resource_archive::find(const std::string& name) const {
+		auto found = this->entries.find(normalized_resource_name(name));
+		if (found == this->entries.cend()) {
+			return {};
+		}
+		return found->second;
+	}
+	std::vector<std::string> qsf::resource_archive::names() const {
+		std::vector<std::string> result;
+		result.reserve(this->entries.size());
+		for (auto& i : this->entries) {
+			result.push_back(i.first);
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+	qpl::size qsf::resource_archive::size() const {
+		return this->entries.size();
+	}
+
+	void qsf::pack_resource_archive(const std::string& output_path, const std::vector<std::string>& paths, std::string root) {
+		root = normalized_resource_name(root);
+		if (!root.empty() && root.back() != '/') {
+			root.push_back('/');
+		}
+
+		std::vector<std::string> names(paths.size());
+		std::vector<qpl::u64> sizes(paths.size());
+		qpl::u64 header_size = resource_archive_magic.size() + sizeof(qpl::u64);
+		for (qpl::size i = 0u; i < paths.size(); ++i) {
+			names[i] = normalized_resource_name(paths[i]);
+			if (!root.empty() && names[i].starts_with(root)) {
+				names[i].erase(0u, root.size());
+			}
+			std::error_code error;
+			sizes[i] = std::filesystem::file_size(paths[i], error);
+			if (error) {
+				throw qpl::exception("pack_resource_archive: couldn't find \"", paths[i], "\"");
+			}
+			header_size += sizeof(qpl::u64) * 3 + names[i].size();
+		}
+
+		std::ofstream file(output_path, std::ios::binary);
+		if (!file.good()) {
+			throw qpl::exception("pack_resource_archive: couldn't create \"", output_path, "\"");
+		}
+		auto write_u64 = [&](qpl::u64 value) {
+			file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		};
+
+		file.write(resource_archive_magic.data(), resource_archive_magic.size());
+		write_u64(paths.size());
+		auto offset = header_size;
+		for (qpl::size i = 0u; i < paths.size(); ++i) {
+			write_u64(names[i].size());
+			file.write(names[i].data(), names[i].size());
+			write_u64(offset);
+			write_u64(sizes[i]);
+			offset += sizes[i];
+		}
+		for (qpl::size i = 0u; i < paths.size(); ++i) {
+			std::ifstream input(paths[i], std::ios::binary);
+			file << input.rdbuf();
+		}
+		if (!file.good()) {
+			throw qpl::exception("pack_resource_archive: couldn't write \"", output_path, "\"");
+		}
+	}
+
+	bool qsf::resource_handle::valid() const {
+		return this->request != nullptr;
+	}
+	bool qsf::resource_handle::is_ready() const {
+		return this->valid() && this->request->finished.load();
+	}
+	bool qsf::resource_handle::failed() const {
+		return this->is_ready() && !this->request->error.empty();
+	}
+	std::string qsf::resource_handle::error() const {
+		if (!this->is_ready()) {
+			return "";
+		}
+		return this->request->error;
+	}
+	const std::string& qsf::resource_handle::path() const {
+		return this->request->path;
+	}
+	std::shared_future<void> qsf::resource_handle::get_future() const {
+		return this->request->future;
+	}
+
+	void qsf::resource_loader::set_resources(qsf::resources& resources) {
+		this->resources = &resources;
+	}
+	void qsf::resource_loader::open_archive(const std::string& path) {
+		this->pool.wait();
+		this->archive.open(path);
+	}
+	void qsf::resource_loader::close_archive() {
+		this->pool.wait();
+		this->archive.close();
+	}
+	qsf::resource_handle qsf::resource_loader::add_texture(const std::string& name, const std::string& path, bool smooth) {
+		return this->request(qsf::resource_type::texture, name, path, smooth);
+	}
+	qsf::resource_handle qsf::resource_loader::add_font(const std::string& name, const std::string& path) {
+		return this->request(qsf::resource_type::font, name, path, false);
+	}
+	qsf::resource_handle qsf::resource_loader::add_sound(const std::string& name, const std::string& path) {
+		return this->request(qsf::resource_type::sound, name, path, false);
+	}
+	qsf::resource_handle qsf::resource_loader::add_image(const std::string& name, const std::string& path) {
+		return this->request(qsf::resource_type::image, name, path, false);
+	}
+
+	qsf::resource_handle qsf::resource_loader::request(qsf::resource_type type, const std::string& name, const std::string& path, bool smooth) {
+		if (!this->resources) {
+			this->resources = &qsf::detail::resources;
+		}
+		auto key = resource_request_key(type, path);
+
+		std::lock_guard lock(this->mutex);
+		auto found = this->in_flight.find(key);
+		if (found != this->in_flight.cend()) {
+			auto& names = found->second->names;
+			if (std::find(names.cbegin(), names.cend(), name) == names.cend()) {
+				names.push_back(name);
+			}
+			return qsf::resource_handle{ found->second };
+		}
+
+		auto request = std::make_shared<qsf::detail::resource_request>();
+		request->type = type;
+		request->path = path;
+		request->names.push_back(name);
+		request->smooth = smooth;
+		request->future = request->promise.get_future().share();
+		this->in_flight[key] = request;
+
+		this->pool.push([this, request]() {
+			this->decode(*request);
+			{
+				std::lock_guard lock(this->mutex);
+				this->decoded.push_back(request);
+			}
+			this->decoded_signal.notify_all();
+		});
+		return qsf::resource_handle{ request };
+	}
+	void qsf::resource_loader::decode(qsf::detail::resource_request& request) const {
+		auto memory = this->archive.find(request.path);
+		bool from_archive = this->archive.contains(request.path);
+
+		bool success = false;
+		try {
+			switch (request.type) {
+			case qsf::resource_type::texture:
+			case qsf::resource_type::image:
+				success = from_archive ? request.image.loadFromMemory(memory.data(), memory.size()) : request.image.loadFromFile(request.path);
+				break;
+			case qsf::resource_type::font:
+				if (from_archive) {
+					request.font_memory = std::make_shared<const std::string>(memory.data(), memory.size());
+					success = request.font.loadFromMemory(request.font_memory->data(), request.font_memory->size());
+				}
+				else {
+					success = request.font.loadFromFile(request.path);
+				}
+				break;
+			case qsf::resource_type::sound: {
+				sf::InputSoundFile file;
+				success = from_archive ? file.openFromMemory(memory.data(), memory.size()) : file.openFromFile(request.path);
+				if (success) {
+					request.samples.resize(qpl::size_cast(file.getSampleCount()));
+					request.samples.resize(qpl::size_cast(file.read(request.samples.data(), request.samples.size())));
+					request.channel_count = file.getChannelCount();
+					request.sample_rate = file.getSampleRate();
+				}
+			} break;
+			}
+		}
+		catch (const std::exception& exception) {
+			request.error = exception.what();
+			return;
+		}
+		if (!success) {
+			request.error = qpl::to_string("resource_loader: couldn't find / load \"", request.path, "\"");
+		}
+	}
+	void qsf::resource_loader::finalize(qsf::detail::resource_request& request) {
+		std::vector<std::string> names;
+		{
+			std::lock_guard lock(this->mutex);
+			names = request.names;
+			this->in_flight.erase(resource_request_key(request.type, request.path));
+		}
+
+		if (request.error.empty()) {
+			for (auto& name : names) {
+				switch (request.type) {
+				case qsf::resource_type::texture: {
+					auto& texture = this->resources->textures[name];
+					if (!texture.loadFromImage(request.image)) {
+						request.error = qpl::to_string("resource_loader: couldn't create texture for \"", request.path, "\"");
+					}
+					texture.setSmooth(request.smooth);
+				} break;
+				case qsf::resource_type::image:
+					this->resources->images[name] = request.image;
+					break;
+				case qsf::resource_type::font:
+					this->resources->fonts[name] = request.font;
+					if (request.font_memory) {
+						this->resources->font_memory[name] = request.font_memory;
+					}
+					else {
+						this->resources->font_memory.erase(name);
+					}
+					break;
+				case qsf::resource_type::sound:
+					if (!this->resources->sounds[name].loadFromSamples(request.samples.data(), request.samples.size(), request.channel_count, request.sample_rate)) {
+						request.error = qpl::to_string("resource_loader: couldn't create sound buffer for \"", request.path, "\"");
+					}
+					break;
+				}
+			}
+		}
+
+		request.image = sf::Image{};
+		request.font = sf::Font{};
+		request.font_memory.reset();
+		request.samples = std::vector<sf::Int16>{};
+
+		request.finished = true;
+		if (request.error.empty()) {
+			request.promise.set_value();
+		}
+		else {
+			request.promise.set_exception(std::make_exception_ptr(qpl::exception(request.error)));
+		}
+	}
+	void qsf::resource_loader::fail_remaining(const std::string& error) {
+		std::deque<std::shared_ptr<qsf::detail::resource_request>> remaining;
+		{
+			std::lock_guard lock(this->mutex);
+			remaining.swap(this->decoded);
+			for (auto& request : remaining) {
+				this->in_flight.erase(resource_request_key(request->type, request->path));
+			}
+		}
+		for (auto& request : remaining) {
+			request->image = sf::Image{};
+			request->font = sf::Font{};
+			request->font_memory.reset();
+			request->samples = std::vector<sf::Int16>{};
+			request->error = qpl::to_string(error, " \"", request->path, "\"");
+			request->finished = true;
+			request->promise.set_exception(std::make_exception_ptr(qpl::exception(request->error)));
+		}
+	}
+	qpl::size qsf::resource_loader::update(qpl::time budget) {
+		qpl::small_clock clock;
+		qpl::size count = 0u;
+		while (true) {
+			std::shared_ptr<qsf::detail::resource_request> request;
+			{
+				std::lock_guard lock(this->mutex);
+				if (this->decoded.empty()) {
+					break;
+				}
+				request = this->decoded.front();
+				this->decoded.pop_front();
+			}
+			this->finalize(*request);
+			++count;
+			if (clock.elapsed() >= budget) {
+				break;
+			}
+		}
+		return count;
+	}
+	void qsf::resource_loader::finish() {
+		while (true) {
+			{
+				std::unique_lock lock(this->mutex);
+				if (this->in_flight.empty()) {
+					return;
+				}
+				this->decoded_signal.wait(lock, [&]() {
+					return !this->decoded.empty();
+				});
+			}
+			this->update(qpl::time(qpl::u64_max));
+		}
+	}
+	qpl::size qsf::resource_loader::pending() const {
+		std::lock_guard lock(this->mutex);
+		return this->in_flight.size();
+	}
+	bool qsf::resource_loader::done() const {
+		return this->pending() == 0u;
+	}
 }
 #endif
\ No newline at end of file
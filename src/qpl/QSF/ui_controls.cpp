@@ -2623,6 +2623,22 @@ namespace qsf {
 		draw.draw(this->knob);
 	}
 
+	namespace {
+		//same result as splitting (before + text), without touching the rows that already exist
+		void append_split(std::vector<std::wstring>& split, const std::wstring& text) {
+			if (text.empty()) {
+				return;
+			}
+			auto parts = qpl::string_split_allow_empty(text, L'\n');
+			if (split.empty()) {
+				split = std::move(parts);
+				return;
+			}
+			split.back() += parts.front();
+			split.insert(split.end(), std::make_move_iterator(parts.begin() + 1), std::make_move_iterator(parts.end()));
+		}
+	}
+
 	void qsf::console::print() {
 		qpl::use_default_print_functions();
 		qpl::println("string: ", this->string.string());
@@ -2952,6 +2968,45 @@ namespace qsf {
 			this->colored_text.create(this->string_and_input, a, b);
 		}
 	}
+	void qsf::console::set_scrollback_limit(qpl::size rows) {
+		this->scrollback_limit = rows;
+		this->trim_scrollback();
+	}
+	void qsf::console::trim_scrollback() {
+		if (!this->scrollback_limit || this->string_split.size() <= this->scrollback_limit + qpl::max(qpl::size{ 1 }, this->scrollback_limit / 8)) {
+			return;
+		}
+		auto remove = this->string_split.size() - this->scrollback_limit;
+
+		//the input always follows the last row of string, so the leading rows are the same in both
+		this->string.remove_leading_lines(remove);
+		this->string_and_input.remove_leading_lines(remove);
+		this->string_split.erase(this->string_split.begin(), this->string_split.begin() + remove);
+		this->string_and_input_split.erase(this->string_and_input_split.begin(), this->string_and_input_split.begin() + qpl::min(remove, this->string_and_input_split.size()));
+
+		auto shift = remove * this->colored_text.get_line_spacing_pixels();
+		this->view_row = qpl::max(0ll, this->view_row - qpl::signed_cast(remove));
+		this->view.position.y = qpl::max(0.f, this->view.position.y - shift);
+		this->scroll_transition_start = qpl::max(0.0, this->scroll_transition_start - shift);
+		this->scroll_transition_end = qpl::max(0.0, this->scroll_transition_end - shift);
+		this->before_input_text_position.y -= shift;
+		this->before_input_text_rows -= qpl::min(remove, this->before_input_text_rows);
+		this->selection_rectangle.clear();
+		this->selection_rectangle_start = this->selection_rectangle_end = qpl::vec2f{ 0.f, 0.f };
+
+		this->colored_text.clear();
+		this->reset_visible_range();
+		this->update_text_range();
+
+		if (this->accept_input) {
+			//lay out the output alone so the tracked sizes end where the input starts, then append the input again
+			auto a = this->visible_y_min * this->character_size.y;
+			auto b = this->visible_y_max * this->character_size.y;
+			this->colored_text.create(this->string, a, b);
+			this->track_before_input_values();
+			this->update_input_text_graphics();
+		}
+	}
 	void qsf::console::process_character_size() {
 
 		this->reset_visible_range();
@@ -3141,13 +3196,32 @@ namespace qsf {
 		this->update_string_and_input_split();
 	}
 	void qsf::console::add(const qpl::styled_string<qpl::u32_string>& string) {
-		this->colored_text.add(string);
+		//only rows inside the current visible range get vertices, update_text_range lays out the rest once the view gets there
+		auto a = this->visible_y_min * this->character_size.y;
+		auto b = this->visible_y_max * this->character_size.y;
+		this->colored_text.add(string, a, b);
 		this->string << string;
-		this->process_text();
+
+		auto text = qpl::to_basic_string<wchar_t>(string.string());
+		append_split(this->string_split, text);
+		if (this->input_string.string().empty()) {
+			this->string_and_input << string;
+			append_split(this->string_and_input_split, text);
+		}
+		else {
+			this->update_string_and_input_split();
+		}
+		this->trim_scrollback();
+
+		this->update_visible_rows_count();
+		this->scroll_bar.set_progress(this->view_row / qpl::f32_cast(this->scroll_bar.integer_step));
+		this->update_cursor_position();
 	}
 	void qsf::console::create(const qpl::styled_string<qpl::u32_string>& string) {
 		this->colored_text.clear();
 		this->string.clear();
+		this->string_split.clear();
+		this->update_string_and_input_split();
 		this->add(string);
 		this->update_cursor_position(true);
 	}
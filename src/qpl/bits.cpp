@@ -1,5 +1,12 @@
 #include <qpl/bits.hpp>
 
+#include <algorithm>
+#include <iterator>
+
+#if defined(__AVX2__) || defined(__AVX512F__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 namespace qpl {
 	void qpl::bit_string_ostream::clear() const {
 		this->value = 0;
@@ -73,4 +80,760 @@ namespace qpl {
 	void qpl::bit_string_istream::set_position(qpl::size position) {
 		this->position = position;
 	}
+
+	qpl::bit_writer::bit_writer(qpl::size reserve_bytes) {
+		this->reserve(reserve_bytes);
+	}
+	void qpl::bit_writer::reserve(qpl::size bytes) {
+		if (bytes > this->m_buffer.size()) {
+			this->m_buffer.resize(bytes);
+		}
+	}
+	void qpl::bit_writer::clear() {
+		this->m_size = 0u;
+		this->m_word = 0u;
+		this->m_count = 0u;
+		this->m_bit_size = 0u;
+	}
+	void qpl::bit_writer::finish() {
+		if (this->m_count) {
+			this->write_word();
+			this->m_word = 0u;
+			this->m_count = 0u;
+		}
+	}
+	qpl::size qpl::bit_writer::size() const {
+		return this->m_size;
+	}
+	qpl::size qpl::bit_writer::bit_size() const {
+		return this->m_bit_size;
+	}
+	std::span<const qpl::u8> qpl::bit_writer::span() {
+		this->finish();
+		return std::span<const qpl::u8>(reinterpret_cast<const qpl::u8*>(this->m_buffer.data()), this->m_size);
+	}
+	std::string qpl::bit_writer::string() {
+		this->finish();
+		return this->m_buffer.substr(0u, this->m_size);
+	}
+	void qpl::bit_writer::add(std::string_view bytes) {
+		this->finish();
+		if (this->m_size + bytes.size() > this->m_buffer.size()) {
+			this->grow(bytes.size());
+		}
+		std::memcpy(this->m_buffer.data() + this->m_size, bytes.data(), bytes.size());
+		this->m_size += bytes.size();
+		this->m_bit_size += bytes.size() * qpl::bits_in_byte();
+	}
+	void qpl::bit_writer::grow(qpl::size bytes) {
+		this->m_buffer.resize(qpl::max(this->m_buffer.size() * 2u, this->m_size + bytes, qpl::size{ 64u }));
+	}
+
+	qpl::bit_reader::bit_reader(std::span<const qpl::u8> data) {
+		this->set(data);
+	}
+	qpl::bit_reader::bit_reader(std::string_view data) {
+		this->set(data);
+	}
+	void qpl::bit_reader::set(std::span<const qpl::u8> data) {
+		this->m_data = data;
+		this->m_origin = 0u;
+		this->m_position = 0u;
+		this->m_window = 0u;
+		this->m_available = 0u;
+	}
+	void qpl::bit_reader::set(std::string_view data) {
+		this->set(std::span<const qpl::u8>(reinterpret_cast<const qpl::u8*>(data.data()), data.size()));
+	}
+	bool qpl::bit_reader::is_done() const {
+		return !this->remaining_bits();
+	}
+	qpl::size qpl::bit_reader::remaining_bits() const {
+		auto bits = (this->m_data.size() - this->m_origin) * qpl::bits_in_byte();
+		return bits > this->m_position ? bits - this->m_position : 0u;
+	}
+	std::span<const qpl::u8> qpl::bit_reader::get_next_span(qpl::size bytes) {
+		auto word_bits = qpl::bits_in_type<qpl::u64>();
+		auto start = qpl::min(this->m_origin + (this->m_position + word_bits - 1u) / word_bits * qpl::bytes_in_type<qpl::u64>(), this->m_data.size());
+		auto result = this->m_data.subspan(start, qpl::min(bytes, this->m_data.size() - start));
+		this->m_origin = start + result.size();
+		this->m_position = 0u;
+		this->m_window = 0u;
+		this->m_available = 0u;
+		return result;
+	}
+	void qpl::bit_reader::set_position_next_u64_multiple() {
+		this->get_next_span(0u);
+	}
+
+	namespace {
+#if defined(__AVX2__) && !defined(__AVX512VPOPCNTDQ__)
+		//Mula's nibble lookup popcount, 32 bytes at a time
+		__m256i popcount_256(__m256i v) {
+			const auto lookup = _mm256_setr_epi8(
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			const auto low_mask = _mm256_set1_epi8(0x0f);
+			auto low = _mm256_and_si256(v, low_mask);
+			auto high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+			auto count = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+			return _mm256_sad_epu8(count, _mm256_setzero_si256());
+		}
+#endif
+
+		template<typename F>
+		void bits_combine(qpl::u64* destination, const qpl::u64* source, qpl::size words, F&& function) {
+			qpl::size i = 0u;
+#if defined(__AVX512F__)
+			for (; i + 8u <= words; i += 8u) {
+				auto a = _mm512_loadu_si512(destination + i);
+				auto b = _mm512_loadu_si512(source + i);
+				_mm512_storeu_si512(destination + i, function(a, b));
+			}
+#elif defined(__AVX2__)
+			for (; i + 4u <= words; i += 4u) {
+				auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination + i));
+				auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), function(a, b));
+			}
+#endif
+			for (; i < words; ++i) {
+				destination[i] = function(destination[i], source[i]);
+			}
+		}
+	}
+
+	void qpl::detail::bits_or(qpl::u64* destination, const qpl::u64* source, qpl::size words) {
+		bits_combine(destination, source, words, [](auto a, auto b) {
+			if constexpr (std::is_same_v<decltype(a), qpl::u64>) {
+				return a | b;
+			}
+#if defined(__AVX512F__)
+			else return _mm512_or_si512(a, b);
+#elif defined(__AVX2__)
+			else return _mm256_or_si256(a, b);
+#endif
+		});
+	}
+	void qpl::detail::bits_and(qpl::u64* destination, const qpl::u64* source, qpl::size words) {
+		bits_combine(destination, source, words, [](auto a, auto b) {
+			if constexpr (std::is_same_v<decltype(a), qpl::u64>) {
+				return a & b;
+			}
+#if defined(__AVX512F__)
+			else return _mm512_and_si512(a, b);
+#elif defined(__AVX2__)
+			else return _mm256_and_si256(a, b);
+#endif
+		});
+	}
+	void qpl::detail::bits_xor(qpl::u64* destination, const qpl::u64* source, qpl::size words) {
+		bits_combine(destination, source, words, [](auto a, auto b) {
+			if constexpr (std::is_same_v<decltype(a), qpl::u64>) {
+				return a ^ b;
+			}
+#if defined(__AVX512F__)
+			else return _mm512_xor_si512(a, b);
+#elif defined(__AVX2__)
+			else return _mm256_xor_si256(a, b);
+#endif
+		});
+	}
+	void qpl::detail::bits_and_not(qpl::u64* destination, const qpl::u64* source, qpl::size words) {
+		bits_combine(destination, source, words, [](auto a, auto b) {
+			if constexpr (std::is_same_v<decltype(a), qpl::u64>) {
+				return a & ~b;
+			}
+#if defined(__AVX512F__)
+			else return _mm512_andnot_si512(b, a);
+#elif defined(__AVX2__)
+			else return _mm256_andnot_si256(b, a);
+#endif
+		});
+	}
+	qpl::size qpl::detail::bits_count(const qpl::u64* data, qpl::size words) {
+		qpl::size i = 0u;
+		qpl::size result = 0u;
+#if defined(__AVX512VPOPCNTDQ__)
+		auto sum = _mm512_setzero_si512();
+		for (; i + 8u <= words; i += 8u) {
+			sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_loadu_si512(data + i)));
+		}
+		result += qpl::size_cast(_mm512_reduce_add_epi64(sum));
+#elif defined(__AVX2__)
+		auto sum = _mm256_setzero_si256();
+		for (; i + 4u <= words; i += 4u) {
+			sum = _mm256_add_epi64(sum, popcount_256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))));
+		}
+		alignas(32) qpl::u64 lanes[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sum);
+		result += qpl::size_cast(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#endif
+		for (; i < words; ++i) {
+			result += qpl::size_cast(std::popcount(data[i]));
+		}
+		return result;
+	}
+	bool qpl::detail::bits_none(const qpl::u64* data, qpl::size words) {
+		return qpl::detail::bits_find_next(data, words, 0u) == qpl::size_max;
+	}
+	bool qpl::detail::bits_equal(const qpl::u64* a, const qpl::u64* b, qpl::size words) {
+		qpl::size i = 0u;
+#if defined(__AVX512F__)
+		for (; i + 8u <= words; i += 8u) {
+			if (_mm512_cmpneq_epi64_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i))) {
+				return false;
+			}
+		}
+#elif defined(__AVX2__)
+		for (; i + 4u <= words; i += 4u) {
+			auto x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+			if (!_mm256_testz_si256(x, x)) {
+				return false;
+			}
+		}
+#endif
+		for (; i < words; ++i) {
+			if (a[i] != b[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+	qpl::size qpl::detail::bits_find_next(const qpl::u64* data, qpl::size words, qpl::size index) {
+		auto i = index / 64u;
+		if (i >= words) {
+			return qpl::size_max;
+		}
+		auto word = data[i] & (~qpl::u64{} << (index % 64u));
+		if (word) {
+			return i * 64u + qpl::size_cast(std::countr_zero(word));
+		}
+		++i;
+#if defined(__AVX512F__)
+		for (; i + 8u <= words; i += 8u) {
+			if (_mm512_test_epi64_mask(_mm512_loadu_si512(data + i), _mm512_set1_epi64(-1))) {
+				break;
+			}
+		}
+#elif defined(__AVX2__)
+		for (; i + 4u <= words; i += 4u) {
+			auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			if (!_mm256_testz_si256(v, v)) {
+				break;
+			}
+		}
+#endif
+		for (; i < words; ++i) {
+			if (data[i]) {
+				return i * 64u + qpl::size_cast(std::countr_zero(data[i]));
+			}
+		}
+		return qpl::size_max;
+	}
+	qpl::size qpl::detail::bits_rank(const qpl::u64* data, qpl::size words, qpl::size index) {
+		auto full = qpl::min(index / 64u, words);
+		auto result = qpl::detail::bits_count(data, full);
+		if (full < words && index % 64u) {
+			result += qpl::size_cast(std::popcount(data[full] & ((qpl::u64{ 1 } << (index % 64u)) - 1u)));
+		}
+		return result;
+	}
+	qpl::size qpl::detail::bits_select(const qpl::u64* data, qpl::size words, qpl::size rank) {
+		for (qpl::size i = 0u; i < words; ++i) {
+			auto count = qpl::size_cast(std::popcount(data[i]));
+			if (rank < count) {
+				return i * 64u + qpl::detail::bits_select_word(data[i], rank);
+			}
+			rank -= count;
+		}
+		return qpl::size_max;
+	}
+	qpl::size qpl::detail::bits_select_word(qpl::u64 word, qpl::size rank) {
+		if (rank >= qpl::size_cast(std::popcount(word))) {
+			return qpl::size_max;
+		}
+#if defined(__BMI2__)
+		return qpl::size_cast(std::countr_zero(_pdep_u64(qpl::u64{ 1 } << rank, word)));
+#else
+		for (; rank; --rank) {
+			word &= word - 1u;
+		}
+		return qpl::size_cast(std::countr_zero(word));
+#endif
+	}
+
+	qpl::dynamic_bitset::dynamic_bitset(qpl::size size, bool value) {
+		this->resize(size, value);
+	}
+	qpl::size qpl::dynamic_bitset::size() const {
+		return this->m_size;
+	}
+	void qpl::dynamic_bitset::resize(qpl::size size, bool value) {
+		auto old_size = this->m_size;
+		this->data.resize((size + 63u) / 64u, value ? ~qpl::u64{} : qpl::u64{});
+		this->m_size = size;
+		if (value && old_size < size && old_size % 64u) {
+			this->data[old_size / 64u] |= ~qpl::u64{} << (old_size % 64u);
+		}
+		this->clear_unused_bits();
+	}
+	void qpl::dynamic_bitset::push_back(bool value) {
+		if (this->m_size % 64u == 0u) {
+			this->data.push_back(0u);
+		}
+		++this->m_size;
+		this->set(this->m_size - 1u, value);
+	}
+	void qpl::dynamic_bitset::clear() {
+		std::fill(this->data.begin(), this->data.end(), qpl::u64{});
+	}
+	void qpl::dynamic_bitset::fill(bool value) {
+		std::fill(this->data.begin(), this->data.end(), value ? ~qpl::u64{} : qpl::u64{});
+		this->clear_unused_bits();
+	}
+	bool qpl::dynamic_bitset::get(qpl::size index) const {
+		return (this->data[index / 64u] >> (index % 64u)) & 1u;
+	}
+	void qpl::dynamic_bitset::set(qpl::size index, bool value) {
+		auto mask = qpl::u64{ 1 } << (index % 64u);
+		if (value) {
+			this->data[index / 64u] |= mask;
+		}
+		else {
+			this->data[index / 64u] &= ~mask;
+		}
+	}
+	void qpl::dynamic_bitset::flip(qpl::size index) {
+		this->data[index / 64u] ^= qpl::u64{ 1 } << (index % 64u);
+	}
+	bool qpl::dynamic_bitset::operator[](qpl::size index) const {
+		return this->get(index);
+	}
+	qpl::size qpl::dynamic_bitset::number_of_set_bits() const {
+		return qpl::detail::bits_count(this->data.data(), this->data.size());
+	}
+	bool qpl::dynamic_bitset::empty() const {
+		return qpl::detail::bits_none(this->data.data(), this->data.size());
+	}
+	bool qpl::dynamic_bitset::full() const {
+		return this->number_of_set_bits() == this->m_size;
+	}
+	qpl::size qpl::dynamic_bitset::find_first() const {
+		return qpl::detail::bits_find_next(this->data.data(), this->data.size(), 0u);
+	}
+	qpl::size qpl::dynamic_bitset::find_next(qpl::size index) const {
+		return qpl::detail::bits_find_next(this->data.data(), this->data.size(), index + 1);
+	}
+	qpl::size qpl::dynamic_bitset::rank(qpl::size index) const {
+		return qpl::detail::bits_rank(this->data.data(), this->data.size(), qpl::min(index, this->m_size));
+	}
+	qpl::size qpl::dynamic_bitset::select(qpl::size rank) const {
+		return qpl::detail::bits_select(this->data.data(), this->data.size(), rank);
+	}
+	qpl::dynamic_bitset& qpl::dynamic_bitset::operator|=(const dynamic_bitset& other) {
+		this->size_check(other, "|=");
+		qpl::detail::bits_or(this->data.data(), other.data.data(), this->data.size());
+		return *this;
+	}
+	qpl::dynamic_bitset& qpl::dynamic_bitset::operator&=(const dynamic_bitset& other) {
+		this->size_check(other, "&=");
+		qpl::detail::bits_and(this->data.data(), other.data.data(), this->data.size());
+		return *this;
+	}
+	qpl::dynamic_bitset& qpl::dynamic_bitset::operator^=(const dynamic_bitset& other) {
+		this->size_check(other, "^=");
+		qpl::detail::bits_xor(this->data.data(), other.data.data(), this->data.size());
+		return *this;
+	}
+	qpl::dynamic_bitset qpl::dynamic_bitset::operator|(const dynamic_bitset& other) const {
+		auto copy = *this;
+		return copy |= other;
+	}
+	qpl::dynamic_bitset qpl::dynamic_bitset::operator&(const dynamic_bitset& other) const {
+		auto copy = *this;
+		return copy &= other;
+	}
+	qpl::dynamic_bitset qpl::dynamic_bitset::operator^(const dynamic_bitset& other) const {
+		auto copy = *this;
+		return copy ^= other;
+	}
+	qpl::dynamic_bitset qpl::dynamic_bitset::operator~() const {
+		auto copy = *this;
+		for (auto& word : copy.data) {
+			word = ~word;
+		}
+		copy.clear_unused_bits();
+		return copy;
+	}
+	qpl::dynamic_bitset& qpl::dynamic_bitset::operator<<=(qpl::size shift) {
+		auto words = shift / 64u;
+		auto bits = shift % 64u;
+		if (words >= this->data.size()) {
+			this->clear();
+			return *this;
+		}
+		for (auto i = this->data.size(); i-- > words;) {
+			auto value = this->data[i - words] << bits;
+			if (bits && i > words) {
+				value |= this->data[i - words - 1u] >> (64u - bits);
+			}
+			this->data[i] = value;
+		}
+		std::fill_n(this->data.begin(), words, qpl::u64{});
+		this->clear_unused_bits();
+		return *this;
+	}
+	qpl::dynamic_bitset& qpl::dynamic_bitset::operator>>=(qpl::size shift) {
+		auto words = shift / 64u;
+		auto bits = shift % 64u;
+		if (words >= this->data.size()) {
+			this->clear();
+			return *this;
+		}
+		auto size = this->data.size();
+		for (qpl::size i = 0u; i + words < size; ++i) {
+			auto value = this->data[i + words] >> bits;
+			if (bits && i + words + 1u < size) {
+				value |= this->data[i + words + 1u] << (64u - bits);
+			}
+			this->data[i] = value;
+		}
+		std::fill(this->data.end() - words, this->data.end(), qpl::u64{});
+		return *this;
+	}
+	qpl::dynamic_bitset qpl::dynamic_bitset::operator<<(qpl::size shift) const {
+		auto copy = *this;
+		return copy <<= shift;
+	}
+	qpl::dynamic_bitset qpl::dynamic_bitset::operator>>(qpl::size shift) const {
+		auto copy = *this;
+		return copy >>= shift;
+	}
+	bool qpl::dynamic_bitset::operator==(const dynamic_bitset& other) const {
+		return this->m_size == other.m_size && qpl::detail::bits_equal(this->data.data(), other.data.data(), this->data.size());
+	}
+	std::string qpl::dynamic_bitset::string() const {
+		std::string result(this->m_size, '0');
+		this->for_each_set_bit([&](qpl::size index) {
+			result[this->m_size - index - 1] = '1';
+		});
+		return result;
+	}
+	void qpl::dynamic_bitset::size_check(const dynamic_bitset& other, const char* operation) const {
+		if (this->m_size != other.m_size) {
+			throw qpl::exception("qpl::dynamic_bitset::operator", operation, " : size mismatch (", this->m_size, " and ", other.m_size, ")");
+		}
+	}
+	void qpl::dynamic_bitset::clear_unused_bits() {
+		if (this->m_size % 64u) {
+			this->data.back() &= (qpl::u64{ 1 } << (this->m_size % 64u)) - 1u;
+		}
+	}
+
+	namespace {
+		constexpr qpl::size roaring_array_limit = 4096u;
+		constexpr qpl::size roaring_bitmap_words = 65536u / 64u;
+	}
+
+	void qpl::roaring_bitmap::container::to_bitmap() {
+		this->bitmap.assign(roaring_bitmap_words, 0u);
+		for (auto& low : this->array) {
+			this->bitmap[low / 64u] |= qpl::u64{ 1 } << (low % 64u);
+		}
+		this->array.clear();
+		this->array.shrink_to_fit();
+	}
+	void qpl::roaring_bitmap::container::to_array() {
+		this->array.clear();
+		this->array.reserve(this->cardinality);
+		qpl::detail::bits_for_each(this->bitmap.data(), this->bitmap.size(), [&](qpl::size low) {
+			this->array.push_back(qpl::u16_cast(low));
+		});
+		this->bitmap.clear();
+		this->bitmap.shrink_to_fit();
+	}
+	void qpl::roaring_bitmap::container::normalize() {
+		if (this->is_bitmap()) {
+			this->cardinality = qpl::detail::bits_count(this->bitmap.data(), this->bitmap.size());
+			if (this->cardinality <= roaring_array_limit) {
+				this->to_array();
+			}
+		}
+		else {
+			this->cardinality = this->array.size();
+			if (this->cardinality > roaring_array_limit) {
+				this->to_bitmap();
+			}
+		}
+	}
+
+	bool qpl::roaring_bitmap::add(qpl::u32 value) {
+		auto key = qpl::u16_cast(value >> 16);
+		auto low = qpl::u16_cast(value & 0xffffu);
+		auto it = std::lower_bound(this->m_containers.begin(), this->m_containers.end(), key, [](const container& c, qpl::u16 key) {
+			return c.key < key;
+		});
+		if (it == this->m_containers.end() || it->key != key) {
+			it = this->m_containers.insert(it, container{});
+			it->key = key;
+		}
+		if (it->is_bitmap()) {
+			auto& word = it->bitmap[low / 64u];
+			auto mask = qpl::u64{ 1 } << (low % 64u);
+			if (word & mask) {
+				return false;
+			}
+			word |= mask;
+		}
+		else {
+			auto position = std::lower_bound(it->array.begin(), it->array.end(), low);
+			if (position != it->array.end() && *position == low) {
+				return false;
+			}
+			it->array.insert(position, low);
+			if (it->array.size() > roaring_array_limit) {
+				it->to_bitmap();
+			}
+		}
+		++it->cardinality;
+		return true;
+	}
+	bool qpl::roaring_bitmap::remove(qpl::u32 value) {
+		auto key = qpl::u16_cast(value >> 16);
+		auto low = qpl::u16_cast(value & 0xffffu);
+		auto it = std::lower_bound(this->m_containers.begin(), this->m_containers.end(), key, [](const container& c, qpl::u16 key) {
+			return c.key < key;
+		});
+		if (it == this->m_containers.end() || it->key != key) {
+			return false;
+		}
+		if (it->is_bitmap()) {
+			auto& word = it->bitmap[low / 64u];
+			auto mask = qpl::u64{ 1 } << (low % 64u);
+			if (!(word & mask)) {
+				return false;
+			}
+			word &= ~mask;
+			--it->cardinality;
+			if (it->cardinality <= roaring_array_limit) {
+				it->to_array();
+			}
+		}
+		else {
+			auto position = std::lower_bound(it->array.begin(), it->array.end(), low);
+			if (position == it->array.end() || *position != low) {
+				return false;
+			}
+			it->array.erase(position);
+			--it->cardinality;
+		}
+		if (!it->cardinality) {
+			this->m_containers.erase(it);
+		}
+		return true;
+	}
+	bool qpl::roaring_bitmap::contains(qpl::u32 value) const {
+		auto key = qpl::u16_cast(value >> 16);
+		auto low = qpl::u16_cast(value & 0xffffu);
+		auto it = std::lower_bound(this->m_containers.begin(), this->m_containers.end(), key, [](const container& c, qpl::u16 key) {
+			return c.key < key;
+		});
+		if (it == this->m_containers.end() || it->key != key) {
+			return false;
+		}
+		if (it->is_bitmap()) {
+			return (it->bitmap[low / 64u] >> (low % 64u)) & 1u;
+		}
+		return std::binary_search(it->array.begin(), it->array.end(), low);
+	}
+	qpl::size qpl::roaring_bitmap::cardinality() const {
+		qpl::size result = 0u;
+		for (auto& container : this->m_containers) {
+			result += container.cardinality;
+		}
+		return result;
+	}
+	bool qpl::roaring_bitmap::empty() const {
+		return this->m_containers.empty();
+	}
+	void qpl::roaring_bitmap::clear() {
+		this->m_containers.clear();
+	}
+	qpl::u32 qpl::roaring_bitmap::minimum() const {
+		if (this->m_containers.empty()) {
+			throw qpl::exception("qpl::roaring_bitmap::minimum : bitmap is empty");
+		}
+		auto& front = this->m_containers.front();
+		auto low = front.is_bitmap() ? qpl::detail::bits_find_next(front.bitmap.data(), front.bitmap.size(), 0u) : qpl::size{ front.array.front() };
+		return (qpl::u32_cast(front.key) << 16) | qpl::u32_cast(low);
+	}
+	qpl::u32 qpl::roaring_bitmap::maximum() const {
+		if (this->m_containers.empty()) {
+			throw qpl::exception("qpl::roaring_bitmap::maximum : bitmap is empty");
+		}
+		auto& back = this->m_containers.back();
+		qpl::size low = 0u;
+		if (back.is_bitmap()) {
+			for (auto i = back.bitmap.size(); i-- > 0u;) {
+				if (back.bitmap[i]) {
+					low = i * 64u + 63u - qpl::size_cast(std::countl_zero(back.bitmap[i]));
+					break;
+				}
+			}
+		}
+		else {
+			low = back.array.back();
+		}
+		return (qpl::u32_cast(back.key) << 16) | qpl::u32_cast(low);
+	}
+	qpl::size qpl::roaring_bitmap::rank(qpl::u32 value) const {
+		auto key = qpl::u16_cast(value >> 16);
+		auto low = qpl::u16_cast(value & 0xffffu);
+		qpl::size result = 0u;
+		for (auto& container : this->m_containers) {
+			if (container.key < key) {
+				result += container.cardinality;
+			}
+			else if (container.key == key) {
+				if (container.is_bitmap()) {
+					result += qpl::detail::bits_rank(container.bitmap.data(), container.bitmap.size(), low);
+				}
+				else {
+					result += qpl::size_cast(std::lower_bound(container.array.begin(), container.array.end(), low) - container.array.begin());
+				}
+			}
+			else {
+				break;
+			}
+		}
+		return result;
+	}
+	qpl::size qpl::roaring_bitmap::memory_size() const {
+		auto result = sizeof(roaring_bitmap) + this->m_containers.capacity() * sizeof(container);
+		for (auto& container : this->m_containers) {
+			result += container.array.capacity() * sizeof(qpl::u16) + container.bitmap.capacity() * sizeof(qpl::u64);
+		}
+		return result;
+	}
+	std::vector<qpl::u32> qpl::roaring_bitmap::values() const {
+		std::vector<qpl::u32> result;
+		result.reserve(this->cardinality());
+		this->for_each([&](qpl::u32 value) {
+			result.push_back(value);
+		});
+		return result;
+	}
+	qpl::roaring_bitmap& qpl::roaring_bitmap::operator|=(const roaring_bitmap& other) {
+		if (this == &other) {
+			return *this;
+		}
+		std::vector<container> result;
+		result.reserve(this->m_containers.size() + other.m_containers.size());
+		auto a = this->m_containers.begin();
+		auto b = other.m_containers.begin();
+		while (a != this->m_containers.end() || b != other.m_containers.end()) {
+			if (b == other.m_containers.end() || (a != this->m_containers.end() && a->key < b->key)) {
+				result.push_back(std::move(*a++));
+			}
+			else if (a == this->m_containers.end() || b->key < a->key) {
+				result.push_back(*b++);
+			}
+			else {
+				auto& merged = result.emplace_back(std::move(*a++));
+				if (!merged.is_bitmap() && !b->is_bitmap() && merged.cardinality + b->cardinality <= roaring_array_limit) {
+					std::vector<qpl::u16> array;
+					array.reserve(merged.cardinality + b->cardinality);
+					std::set_union(merged.array.begin(), merged.array.end(), b->array.begin(), b->array.end(), std::back_inserter(array));
+					merged.array = std::move(array);
+				}
+				else {
+					if (!merged.is_bitmap()) {
+						merged.to_bitmap();
+					}
+					if (b->is_bitmap()) {
+						qpl::detail::bits_or(merged.bitmap.data(), b->bitmap.data(), roaring_bitmap_words);
+					}
+					else {
+						for (auto& low : b->array) {
+							merged.bitmap[low / 64u] |= qpl::u64{ 1 } << (low % 64u);
+						}
+					}
+				}
+				merged.normalize();
+				++b;
+			}
+		}
+		this->m_containers = std::move(result);
+		return *this;
+	}
+	qpl::roaring_bitmap& qpl::roaring_bitmap::operator&=(const roaring_bitmap& other) {
+		if (this == &other) {
+			return *this;
+		}
+		std::vector<container> result;
+		auto b = other.m_containers.begin();
+		for (auto& a : this->m_containers) {
+			while (b != other.m_containers.end() && b->key < a.key) {
+				++b;
+			}
+			if (b == other.m_containers.end()) {
+				break;
+			}
+			if (b->key != a.key) {
+				continue;
+			}
+			auto& merged = result.emplace_back(std::move(a));
+			if (merged.is_bitmap() && b->is_bitmap()) {
+				qpl::detail::bits_and(merged.bitmap.data(), b->bitmap.data(), roaring_bitmap_words);
+			}
+			else if (merged.is_bitmap()) {
+				std::vector<qpl::u16> array;
+				for (auto& low : b->array) {
+					if ((merged.bitmap[low / 64u] >> (low % 64u)) & 1u) {
+						array.push_back(low);
+					}
+				}
+				merged.bitmap = {};
+				merged.array = std::move(array);
+			}
+			else if (b->is_bitmap()) {
+				std::erase_if(merged.array, [&](qpl::u16 low) {
+					return !((b->bitmap[low / 64u] >> (low % 64u)) & 1u);
+				});
+			}
+			else {
+				std::vector<qpl::u16> array;
+				std::set_intersection(merged.array.begin(), merged.array.end(), b->array.begin(), b->array.end(), std::back_inserter(array));
+				merged.array = std::move(array);
+			}
+			merged.normalize();
+			if (!merged.cardinality) {
+				result.pop_back();
+			}
+		}
+		this->m_containers = std::move(result);
+		return *this;
+	}
+	qpl::roaring_bitmap qpl::roaring_bitmap::operator|(const roaring_bitmap& other) const {
+		auto copy = *this;
+		return copy |= other;
+	}
+	qpl::roaring_bitmap qpl::roaring_bitmap::operator&(const roaring_bitmap& other) const {
+		auto copy = *this;
+		return copy &= other;
+	}
+	bool qpl::roaring_bitmap::operator==(const roaring_bitmap& other) const {
+		if (this->m_containers.size() != other.m_containers.size()) {
+			return false;
+		}
+		for (qpl::size i = 0u; i < this->m_containers.size(); ++i) {
+			auto& a = this->m_containers[i];
+			auto& b = other.m_containers[i];
+			if (a.key != b.key || a.cardinality != b.cardinality || a.array != b.array || a.bitmap != b.bitmap) {
+				return false;
+			}
+		}
+		return true;
+	}
 }
\ No newline at end of file
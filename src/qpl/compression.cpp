@@ -2,6 +2,33 @@
 
 namespace qpl {
 
+	void qpl::huffman_compression::fast_decompression_map::set_max_bits(qpl::u8 max_bits) {
+		this->max_bits = max_bits;
+		this->lookup_bits = qpl::min(max_bits, max_lookup_bits);
+		this->values.assign(qpl::size_cast(max_bits) + 1u, {});
+		this->lookup.assign(qpl::size{ 1u } << this->lookup_bits, lookup_entry{});
+	}
+	bool qpl::huffman_compression::fast_decompression_map::add(qpl::u32 bits, qpl::u8 width, char meaning) {
+		if (width > this->max_bits || (qpl::u64_cast(bits) >> width)) {
+			return false;
+		}
+		if (!this->values[width].insert(std::make_pair(bits, meaning)).second) {
+			return false;
+		}
+		if (!width || width > this->lookup_bits) {
+			return true;
+		}
+		auto shift = this->lookup_bits - width;
+		auto begin = qpl::size_cast(bits) << shift;
+		auto end = begin + (qpl::size{ 1u } << shift);
+		for (auto i = begin; i < end; ++i) {
+			if (this->lookup[i].width) {
+				return false;
+			}
+			this->lookup[i] = lookup_entry{ meaning, width };
+		}
+		return true;
+	}
 	void qpl::huffman_compression::fast_decompression_map::reset() {
 		this->bits = 0;
 		this->length = 0;
@@ -64,26 +91,26 @@ namespace qpl {
 		else this->bits_mode = mode::b32;
 	}
 	std::optional<qpl::huffman_compression::fast_decompression_map> qpl::huffman_compression::character_table::get_decompression_map() const {
+		if (this->max_bits_length > qpl::bits_in_type<qpl::u32>()) {
+			return {};
+		}
 		fast_decompression_map result;
-		result.values.resize(this->max_bits_length + 1);
+		result.set_max_bits(this->max_bits_length);
 
 		switch (this->bits_mode) {
 		case character_table::mode::b8:
 			for (auto& i : this->data8) {
-				if (i.width >= result.values.size()) return {};
-				result.values[i.width].insert(std::make_pair(qpl::u32_cast(i.bits), i.meaning));
+				if (!result.add(qpl::u32_cast(i.bits), i.width, i.meaning)) return {};
 			}
 			break;
 		case character_table::mode::b16:
 			for (auto& i : this->data16) {
-				if (i.width >= result.values.size()) return {};
-				result.values[i.width].insert(std::make_pair(qpl::u32_cast(i.bits), i.meaning));
+				if (!result.add(qpl::u32_cast(i.bits), i.width, i.meaning)) return {};
 			}
 			break;
 		case character_table::mode::b32:
 			for (auto& i : this->data32) {
-				if (i.width >= result.values.size()) return {};
-				result.values[i.width].insert(std::make_pair(qpl::u32_cast(i.bits), i.meaning));
+				if (!result.add(qpl::u32_cast(i.bits), i.width, i.meaning)) return {};
 			}
 			break;
 		}
@@ -138,12 +165,11 @@ namespace qpl {
 		return 0;
 	}
 	std::string qpl::huffman_compression::character_table::get_header_string() const {
-		qpl::bit_string_ostream stream;
+		qpl::bit_writer stream(2u + this->data_size() * qpl::bytes_in_type<qpl::u64>());
 
 		stream.add(this->max_bits_length);
 		stream.add(this->max_width_length);
 
-		stream.reset_position();
 		switch (this->bits_mode) {
 		case character_table::mode::b8:
 			for (auto& i : this->data8) {
@@ -169,11 +195,13 @@ namespace qpl {
 		}
 		return stream.string();
 	}
-	bool qpl::huffman_compression::character_table::create(qpl::bit_string_istream& stream, qpl::u16 data_size) {
+	bool qpl::huffman_compression::character_table::create(qpl::bit_reader& reader, qpl::u16 data_size) {
 
-		this->max_bits_length = stream.get_next<qpl::u8>();
-		this->max_width_length = stream.get_next<qpl::u8>();
-		stream.note_u64_position_offset();
+		this->max_bits_length = reader.get_next<qpl::u8>();
+		this->max_width_length = reader.get_next<qpl::u8>();
+		if (this->max_bits_length > qpl::bits_in_type<qpl::u32>() || this->max_width_length > qpl::bits_in_byte()) {
+			return false;
+		}
 
 		if (this->max_bits_length <= 8) this->bits_mode = mode::b8;
 		else if (this->max_bits_length <= 16) this->bits_mode = mode::b16;
@@ -186,11 +214,11 @@ namespace qpl {
 		case character_table::mode::b8:
 			this->data8.resize(data_size);
 			for (qpl::u16 i = 0u; i < data_size; ++i) {
-				n = stream.get_next_bits<qpl::u64>(block_size);
+				n = reader.get_next_bits<qpl::u64>(block_size);
 				this->data8[i].bits = qpl::u8_cast(n >> (block_size - this->max_bits_length));
 				this->data8[i].width = qpl::u8_cast((n >> qpl::bits_in_byte()) & ~(qpl::u64_max << this->max_width_length));
 				this->data8[i].meaning = qpl::u8_cast(n);
-				if (stream.is_done()) {
+				if (reader.is_done()) {
 					break;
 				}
 			}
@@ -198,11 +226,11 @@ namespace qpl {
 		case character_table::mode::b16:
 			this->data16.resize(data_size);
 			for (qpl::u16 i = 0u; i < data_size; ++i) {
-				n = stream.get_next_bits<qpl::u64>(block_size);
+				n = reader.get_next_bits<qpl::u64>(block_size);
 				this->data16[i].bits = qpl::u16_cast(n >> (block_size - this->max_bits_length));
 				this->data16[i].width = qpl::u8_cast((n >> qpl::bits_in_byte()) & ~(qpl::u64_max << this->max_width_length));
 				this->data16[i].meaning = qpl::u8_cast(n);
-				if (stream.is_done()) {
+				if (reader.is_done()) {
 					break;
 				}
 			}
@@ -210,11 +238,11 @@ namespace qpl {
 		case character_table::mode::b32:
 			this->data32.resize(data_size);
 			for (qpl::u16 i = 0u; i < data_size; ++i) {
-				n = stream.get_next_bits<qpl::u64>(block_size);
+				n = reader.get_next_bits<qpl::u64>(block_size);
 				this->data32[i].bits = qpl::u32_cast(n >> (block_size - this->max_bits_length));
 				this->data32[i].width = qpl::u8_cast((n >> qpl::bits_in_byte()) & ~(qpl::u64_max << this->max_width_length));
 				this->data32[i].meaning = qpl::u8_cast(n);
-				if (stream.is_done()) {
+				if (reader.is_done()) {
 					break;
 				}
 			}
@@ -299,11 +327,15 @@ namespace qpl {
 		return result;
 	}
 
-	void qpl::huffman_compression::compress(const std::string& string) {
+	void qpl::huffman_compression::compress(const std::string& string, std::pmr::memory_resource* resource) {
 		if (string.empty()) {
 			this->result = "";
 			return;
 		}
+		qpl::arena_resource arena;
+		if (!resource) {
+			resource = &arena;
+		}
 		std::unordered_map<qpl::u8, qpl::u32> count_map;
 
 		for (auto& i : string) {
@@ -334,7 +366,7 @@ namespace qpl {
 			sorted_count.insert({ i.second, qpl::u16_cast(i.first) });
 		}
 
-		std::vector<tree> trees;
+		std::pmr::vector<tree> trees(resource);
 		trees.reserve(sorted_count.size());
 		if (sorted_count.size() == 1) {
 			trees.push_back({});
@@ -384,14 +416,14 @@ namespace qpl {
 
 		table.make_map();
 
-		qpl::bit_string_ostream stream;
 		auto header = table.get_header_string();
+
+		//no code is wider than max_bits_length, so this is an upper bound and the writer never has to grow
+		qpl::bit_writer stream(6u + header.length() + (string.length() * table.max_bits_length / qpl::bits_in_type<qpl::u64>() + 1u) * qpl::bytes_in_type<qpl::u64>());
 		stream.add(qpl::u32_cast(string.length()));
 		stream.add(qpl::u16_cast(table.data_size()));
 		stream.add(header);
 
-		stream.reset_position();
-
 		switch (table.bits_mode) {
 		case character_table::mode::b8:
 			for (auto& i : string) {
@@ -421,55 +453,56 @@ namespace qpl {
 			return true;
 		}
 
-		qpl::bit_string_istream istream;
-		istream.set(string);
+		qpl::bit_reader reader(string);
 
-		auto s_len = istream.get_next<qpl::u32>();
-		auto d_len = istream.get_next<qpl::u16>();
+		auto s_len = reader.get_next<qpl::u32>();
+		auto d_len = reader.get_next<qpl::u16>();
 
 		character_table table;
-		if (!table.create(istream, d_len)) {
+		if (!table.create(reader, d_len)) {
 			this->result = "";
 			return false;
 		}
-		istream.set_position_next_u64_multiple();
+		reader.set_position_next_u64_multiple();
 
 		auto decompression_t = table.get_decompression_map();
 		if (!decompression_t.has_value()) {
 			this->result = "";
 			return false;
 		}
-		auto decompression = decompression_t.value();
-
-		std::ostringstream stream;
+		const auto& decompression = decompression_t.value();
 
-		qpl::u32 ctr = 0u;
-		bool done = false;
-		while (!done && !istream.is_done()) {
-			auto n = istream.get_next<qpl::u64>();
+		//a tree with a single character has a code of width 0 and no code bits are written
+		if (!decompression.values.front().empty()) {
+			this->result.assign(s_len, decompression.values.front().cbegin()->second);
+			return true;
+		}
 
-			for (qpl::u32 i = 0u; i < qpl::bits_in_type<qpl::u64>(); ++i) {
-				auto b = qpl::bool_cast(n & (qpl::u64{ 1 } << (qpl::bits_in_type<qpl::u64>() - 1 - i)));
+		std::string result;
+		result.resize(s_len);
 
-				decompression.add_bit(b);
-				if (decompression.is_invalid()) {
-					this->result = "";
-					return false;
-				}
-				if (decompression.is_found()) {
-					auto c = decompression.get_char();
-					decompression.reset();
-
-					stream << c;
-					++ctr;
-					if (ctr >= s_len) {
-						done = true;
-						break;
-					}
+		for (qpl::u32 ctr = 0u; ctr < s_len; ++ctr) {
+			if (reader.available() < decompression.max_bits) {
+				reader.refill();
+			}
+			auto entry = decompression.lookup[qpl::size_cast(reader.peek(decompression.lookup_bits))];
+
+			//codes longer than lookup_bits are rare, look them up by width
+			for (auto width = qpl::u8_cast(decompression.lookup_bits + 1u); !entry.width && width <= decompression.max_bits; ++width) {
+				auto& values = decompression.values[width];
+				auto it = values.find(qpl::u32_cast(reader.peek(width)));
+				if (it != values.cend()) {
+					entry = { it->second, width };
 				}
 			}
+			if (!entry.width || entry.width > reader.available()) {
+				this->result = "";
+				return false;
+			}
+			reader.consume(entry.width);
+			result[ctr] = entry.meaning;
 		}
-		this->result = stream.str();
+		this->result = std::move(result);
 		return true;
 	}
 	std::string qpl::huffman_compression::get_result() const {
@@ -3,6 +3,7 @@
 #include <qpl/string.hpp>
 #include <qpl/time.hpp>
 #include <qpl/filesys.hpp>
+#include <qpl/exception.hpp>
 
 #include <sstream>
 
@@ -269,22 +270,110 @@ namespace qpl {
 		return s.str();
 	}
 
+	void qpl::xxh64::reset(qpl::u64 seed) {
+		this->seed = seed;
+		this->state[0] = seed + prime1 + prime2;
+		this->state[1] = seed + prime2;
+		this->state[2] = seed;
+		this->state[3] = seed - prime1;
+		this->total_length = 0u;
+		this->buffer_size = 0u;
+	}
+	void qpl::xxh64::consume_stripe(const qpl::u8* data) {
+		for (qpl::size i = 0u; i < this->state.size(); ++i) {
+			qpl::u64 lane;
+			memcpy(&lane, data + i * 8u, 8u);
+			this->state[i] = round(this->state[i], lane);
+		}
+	}
+	void qpl::xxh64::update(const std::string_view& data) {
+		auto input = reinterpret_cast<const qpl::u8*>(data.data());
+		auto length = data.size();
+		this->total_length += length;
+
+		if (this->buffer_size + length < stripe_size) {
+			memcpy(this->buffer.data() + this->buffer_size, input, length);
+			this->buffer_size += length;
+			return;
+		}
+		if (this->buffer_size) {
+			auto fill = stripe_size - this->buffer_size;
+			memcpy(this->buffer.data() + this->buffer_size, input, fill);
+			this->consume_stripe(this->buffer.data());
+			input += fill;
+			length -= fill;
+			this->buffer_size = 0u;
+		}
+		while (length >= stripe_size) {
+			this->consume_stripe(input);
+			input += stripe_size;
+			length -= stripe_size;
+		}
+		memcpy(this->buffer.data(), input, length);
+		this->buffer_size = length;
+	}
+	qpl::u64 qpl::xxh64::digest() const {
+		qpl::u64 hash;
+		if (this->total_length >= stripe_size) {
+			hash = rotl(this->state[0], 1u) + rotl(this->state[1], 7u) + rotl(this->state[2], 12u) + rotl(this->state[3], 18u);
+			for (auto& i : this->state) {
+				hash = merge_round(hash, i);
+			}
+		}
+		else {
+			hash = this->seed + prime5;
+		}
+		hash += this->total_length;
+
+		qpl::size index = 0u;
+		for (; index + 8u <= this->buffer_size; index += 8u) {
+			qpl::u64 lane;
+			memcpy(&lane, this->buffer.data() + index, 8u);
+			hash ^= round(0u, lane);
+			hash = rotl(hash, 27u) * prime1 + prime4;
+		}
+		if (index + 4u <= this->buffer_size) {
+			qpl::u32 lane;
+			memcpy(&lane, this->buffer.data() + index, 4u);
+			hash ^= qpl::u64_cast(lane) * prime1;
+			hash = rotl(hash, 23u) * prime2 + prime3;
+			index += 4u;
+		}
+		for (; index < this->buffer_size; ++index) {
+			hash ^= this->buffer[index] * prime5;
+			hash = rotl(hash, 11u) * prime1;
+		}
+
+		hash ^= hash >> 33u;
+		hash *= prime2;
+		hash ^= hash >> 29u;
+		hash *= prime3;
+		hash ^= hash >> 32u;
+		return hash;
+	}
+
 	qpl::sha256 qpl::detail::sha256_t;
 	qpl::sha512 qpl::detail::sha512_t;
 
+	//a local state per call, the hashes run on pool workers through mgf1 / OAEP / PSS
 	std::string qpl::sha256_hash(const std::string_view& string) {
-		qpl::detail::sha256_t.reset();
-		qpl::detail::sha256_t.update(string);
-		auto digest = qpl::detail::sha256_t.digest();
+		qpl::sha256 sha;
+		sha.update(string);
+		auto digest = sha.digest();
 		return qpl::sha256::to_string(digest);
 	}
 
 	std::string qpl::sha512_hash(const std::string_view& string) {
-		qpl::detail::sha512_t.reset();
-		qpl::detail::sha512_t.update(string);
-		auto digest = qpl::detail::sha512_t.digest();
+		qpl::sha512 sha;
+		sha.update(string);
+		auto digest = sha.digest();
 		return qpl::sha512::to_string(digest);
 	}
+	qpl::u64 qpl::xxh64_hash(const std::string_view& string, qpl::u64 seed) {
+		qpl::xxh64 hash(seed);
+		hash.update(string);
+		return hash.digest();
+	}
 	std::string qpl::mgf1(const std::string_view& seed, qpl::size length, hash_type hash_object) {
 		if (length == 0u) {
 			return "";
@@ -1200,12 +1289,238 @@ namespace qpl {
 #endif
 
 #ifdef QPL_RSA
+	namespace {
+		//the global engine behind qpl::get_random_string_full_range isn't safe to share between the batch workers
+		std::string random_bytes(qpl::size length) {
+			thread_local qpl::random_engine<64> engine = []() {
+				qpl::random_engine<64> result;
+				result.seed_random();
+				return result;
+			}();
+
+			std::string result;
+			result.resize(length);
+			for (qpl::size i = 0u; i < length; i += 8u) {
+				auto value = engine.generate();
+				for (qpl::size b = 0u; b < 8u && i + b < length; ++b) {
+					result[i + b] = qpl::char_cast(value >> (b * 8u));
+				}
+			}
+			return result;
+		}
+
+		mpz_class import_bytes(const std::string_view& bytes) {
+			mpz_class result;
+			mpz_import(result.get_mpz_t(), bytes.size(), 1, 1, 1, 0, bytes.data());
+			return result;
+		}
+		std::string export_bytes(const mpz_class& value, qpl::size length) {
+			std::string result(length, '\0');
+			auto count = (mpz_sizeinbase(value.get_mpz_t(), 2) + 7u) / 8u;
+			if (value == 0 || count > length) {
+				return result;
+			}
+			mpz_export(result.data() + (length - count), nullptr, 1, 1, 1, 0, value.get_mpz_t());
+			return result;
+		}
+
+		mpz_class crt_powm(const mpz_class& message, const mpz_class& exponent1, const mpz_class& exponent2, const qpl::RSA& rsa) {
+			mpz_class m1, m2;
+			mpz_powm(m1.get_mpz_t(), message.get_mpz_t(), exponent1.get_mpz_t(), rsa.prime1.get_mpz_t());
+			mpz_powm(m2.get_mpz_t(), message.get_mpz_t(), exponent2.get_mpz_t(), rsa.prime2.get_mpz_t());
+
+			mpz_class h = m1 - m2;
+			h *= rsa.coefficient;
+			mpz_mod(h.get_mpz_t(), h.get_mpz_t(), rsa.prime1.get_mpz_t());
+			return mpz_class{ m2 + h * rsa.prime2 };
+		}
+
+		//set_primes derives the exponents itself, stored ones that don't match mean a damaged key and the crt path is skipped
+		void set_key_primes(qpl::RSA& rsa, const qpl::RSA_key_pair& key, const mpz_class& exponent1, const mpz_class& exponent2) {
+			if (!key.has_primes()) {
+				return;
+			}
+			rsa.set_primes(key.prime1, key.prime2);
+			if (!rsa.has_primes()) {
+				return;
+			}
+			if (key.exponent1 != exponent1 || key.exponent2 != exponent2 || key.coefficient != rsa.coefficient) {
+				rsa.clear_primes();
+			}
+		}
+
+		//block sizes are derived from the key size, without a key they would divide by zero
+		void check_key_bits(const qpl::RSA& rsa, const char* function) {
+			if (rsa.get_bits() < 8u) {
+				throw qpl::exception("RSA::", function, ": no key set");
+			}
+		}
+
+		std::optional<std::string> OAEP_encode(const std::string_view& message, const std::string& label, qpl::hash_type hash_object, qpl::size bits) {
+			auto hash_size = hash_object.second / 8u;
+			auto k = bits / 4;
+			auto lhash = hash_object.first(label);
+
+			auto ps_length = qpl::signed_cast(k) - 2 * qpl::signed_cast(message.length()) - 4 * qpl::signed_cast(hash_size) - 3;
+
+			if (ps_length < 0) {
+				return std::nullopt;
+			}
+			std::string ps;
+			ps.resize(ps_length, '0');
+
+			auto seed = random_bytes(hash_size);
+
+			std::string db;
+			db.append(lhash);
+			db.append(ps);
+			db.append("1");
+			db.append(qpl::hex_string(message));
+
+			auto db_mask_size = k - 2 * hash_size - 1;
+			auto db_mask = qpl::mgf1(seed, db_mask_size, hash_object);
+			auto masked_db = qpl::hex_string_xor(db, db_mask);
+			auto seed_mask = qpl::mgf1(qpl::from_hex_string(masked_db), hash_size * 2, hash_object);
+			auto masked_seed = qpl::hex_string_xor(seed_mask, qpl::hex_string(seed));
+
+			std::string em;
+			em.append("0");
+			em.append(masked_seed);
+			em.append(masked_db);
+			return em;
+		}
+		std::optional<std::string> OAEP_decode(const std::string& em, const std::string& label, qpl::hash_type hash_object, qpl::size bits) {
+			auto hash_size = hash_object.second / 8u;
+			auto k = bits / 4;
+			auto lhash = hash_object.first(label);
+			auto db_mask_size = k - 2 * hash_size - 1;
+			auto masked_seed = em.substr(2u, hash_size * 2);
+			auto masked_db = em.substr(hash_size * 2 + 2u);
+			auto seed_mask = qpl::mgf1(qpl::from_hex_string(masked_db), hash_size * 2, hash_object);
+			auto seed = qpl::from_hex_string(qpl::hex_string_xor(seed_mask, masked_seed));
+			auto db_mask = qpl::mgf1(seed, db_mask_size, hash_object);
+			auto db = qpl::hex_string_xor(db_mask, masked_db);
+			auto check_lhash = db.substr(0u, lhash.length());
+
+			if (check_lhash != lhash) {
+				return std::nullopt;
+			}
+			qpl::size ps_index = lhash.length();
+			while (ps_index < db.length() && db[ps_index] == '0') {
+				++ps_index;
+			}
+			if (ps_index == db.length() || db[ps_index] != '1') {
+				return std::nullopt;
+			}
+
+			return qpl::from_hex_string(db.substr(ps_index + 1u));
+		}
+
+		std::string PSS_encode(const std::string_view& signature, qpl::hash_type hash_object, qpl::size salt_length, qpl::size bits) {
+			if (salt_length == qpl::size_max) {
+				salt_length = hash_object.second / 8u;
+			}
+
+			auto hash = hash_object.first(signature);
+			auto hash_size = hash_object.second / 4u;
+			auto k = bits / 4;
+			auto m_size = 16 + hash_size + salt_length * 2;
+			auto db_size = k - m_size - 1;
+			auto ps_size = db_size - salt_length * 2 - 1;
+
+			auto salt = random_bytes(salt_length);
+
+			std::string padding;
+			padding.resize(16, '0');
+
+			std::string m;
+			m.append(padding);
+			m.append(hash);
+			m.append(qpl::hex_string(salt));
+
+
+			std::string ps;
+			ps.resize(ps_size, '0');
+
+			std::string db;
+			db.append(ps);
+			db.append("1");
+			db.append(qpl::hex_string(salt));
+
+			auto mhash = qpl::mgf1(hash_object.first(m), m_size, hash_object);
+			auto db_mask = qpl::mgf1(mhash, db_size, hash_object);
+			auto masked_db = qpl::hex_string_xor(db, db_mask);
+
+			std::string em;
+			em.append("0");
+			em.append(masked_db);
+			em.append(mhash);
+			return em;
+		}
+		bool PSS_verify(const std::string& em, const std::string_view& signature, qpl::hash_type hash_object, qpl::size salt_length, qpl::size bits) {
+			if (salt_length == qpl::size_max) {
+				salt_length = hash_object.second / 8u;
+			}
+			auto hash_size = hash_object.second / 4u;
+			auto k = bits / 4;
+			auto m_size = 16 + hash_size + salt_length * 2;
+			auto db_size = k - m_size - 1;
+
+			auto hash = hash_object.first(signature);
+
+			auto masked_db = em.substr(1u, db_size);
+			auto mhash = em.substr(1u + db_size);
+			auto db_mask = qpl::mgf1(mhash, db_size, hash_object);
+			auto db = qpl::hex_string_xor(db_mask, masked_db);
+
+			qpl::size db_index = 0u;
+			while (db_index < db.length() && db[db_index] == '0') {
+				++db_index;
+			}
+			if (db_index == db.length() || db[db_index] != '1') {
+				return false;
+			}
+			auto salt = db.substr(db_index + 1u);
+
+			std::string padding;
+			padding.resize(16, '0');
+
+			std::string m;
+			m.append(padding);
+			m.append(hash);
+			m.append(salt);
+
+			auto check_mhash = qpl::mgf1(hash_object.first(m), m_size, hash_object);
+			return check_mhash == mhash;
+		}
+	}
+
 	bool qpl::RSA_key_pair::empty() const {
 		return this->mod == 0 || this->key == 0;
 	}
+	bool qpl::RSA_key_pair::has_primes() const {
+		return this->prime1 != 0 && this->prime2 != 0;
+	}
+	void qpl::RSA_key_pair::clear_primes() {
+		this->prime1 = 0;
+		this->prime2 = 0;
+		this->exponent1 = 0;
+		this->exponent2 = 0;
+		this->coefficient = 0;
+	}
 	void qpl::RSA_key_pair::set(const std::string_view& mod, const std::string_view& key) {
 		this->mod.set_str(mod.data(), 16);
 		this->key.set_str(key.data(), 16);
+		this->clear_primes();
+	}
+	void qpl::RSA_key_pair::set(const std::string_view& mod, const std::string_view& key, const std::string_view& prime1, const std::string_view& prime2, const std::string_view& exponent1, const std::string_view& exponent2, const std::string_view& coefficient) {
+		this->mod.set_str(mod.data(), 16);
+		this->key.set_str(key.data(), 16);
+		this->prime1.set_str(prime1.data(), 16);
+		this->prime2.set_str(prime2.data(), 16);
+		this->exponent1.set_str(exponent1.data(), 16);
+		this->exponent2.set_str(exponent2.data(), 16);
+		this->coefficient.set_str(coefficient.data(), 16);
 	}
 	void qpl::RSA_key_pair::set_base64(const std::string_view& mod, const std::string_view& key) {
 		auto hex_mod = qpl::base64_to_hex_string(mod);
@@ -1213,31 +1528,75 @@ namespace qpl {
 
 		this->mod.set_str(hex_mod, 16);
 		this->key.set_str(hex_key, 16);
+		this->clear_primes();
 	}
 	std::string qpl::RSA_key_pair::string() {
-		return qpl::to_string("\"", this->mod.get_str(16), "\",\n\"", this->key.get_str(16), "\"");
+		auto result = qpl::to_string("\"", this->mod.get_str(16), "\",\n\"", this->key.get_str(16), "\"");
+		if (this->has_primes()) {
+			for (auto& i : { this->prime1, this->prime2, this->exponent1, this->exponent2, this->coefficient }) {
+				result.append(qpl::to_string(",\n\"", i.get_str(16), "\""));
+			}
+		}
+		return result;
 	}
 	qpl::size qpl::RSA_key_pair::bits() const {
-		return this->mod.get_str(2u).length();
+		return mpz_sizeinbase(this->mod.get_mpz_t(), 2);
+	}
+
+	void qpl::RSA::set_primes(const mpz_class& prime1, const mpz_class& prime2) {
+		if (prime1 < 2 || prime2 < 2 || prime1 == prime2 || mpz_class{ prime1 * prime2 } != this->mod) {
+			this->clear_primes();
+			return;
+		}
+		this->prime1 = prime1;
+		this->prime2 = prime2;
+		this->coefficient = qpl::mod_inverse(this->prime2, this->prime1);
+
+		auto p1 = mpz_class{ this->prime1 - 1 };
+		auto p2 = mpz_class{ this->prime2 - 1 };
+		mpz_mod(this->private_exponent1.get_mpz_t(), this->private_key.get_mpz_t(), p1.get_mpz_t());
+		mpz_mod(this->private_exponent2.get_mpz_t(), this->private_key.get_mpz_t(), p2.get_mpz_t());
+		mpz_mod(this->public_exponent1.get_mpz_t(), this->public_key.get_mpz_t(), p1.get_mpz_t());
+		mpz_mod(this->public_exponent2.get_mpz_t(), this->public_key.get_mpz_t(), p2.get_mpz_t());
+	}
+	void qpl::RSA::clear_primes() {
+		this->prime1 = 0;
+		this->prime2 = 0;
+		this->coefficient = 0;
+		this->private_exponent1 = 0;
+		this->private_exponent2 = 0;
+		this->public_exponent1 = 0;
+		this->public_exponent2 = 0;
+	}
+	bool qpl::RSA::has_primes() const {
+		return this->prime1 != 0 && this->prime2 != 0;
 	}
 
 	void qpl::RSA::set_decryption_key(const mpz_class& key, const mpz_class& mod) {
 		this->private_key = key;
 		this->mod = mod;
 
-		this->bits = this->mod.get_str(2).length();
+		this->bits = mpz_sizeinbase(this->mod.get_mpz_t(), 2);
+		if (this->has_primes()) {
+			this->set_primes(mpz_class{ this->prime1 }, mpz_class{ this->prime2 });
+		}
 	}
 	void qpl::RSA::set_encryption_key(const mpz_class& key, const mpz_class& mod) {
 		this->public_key = key;
 		this->mod = mod;
 
-		this->bits = this->mod.get_str(2).length();
+		this->bits = mpz_sizeinbase(this->mod.get_mpz_t(), 2);
+		if (this->has_primes()) {
+			this->set_primes(mpz_class{ this->prime1 }, mpz_class{ this->prime2 });
+		}
 	}
 	void qpl::RSA::set_decryption_key(const RSA_key_pair& key) {
 		this->set_decryption_key(key.key, key.mod);
+		set_key_primes(*this, key, this->private_exponent1, this->private_exponent2);
 	}
 	void qpl::RSA::set_encryption_key(const RSA_key_pair& key) {
 		this->set_encryption_key(key.key, key.mod);
+		set_key_primes(*this, key, this->public_exponent1, this->public_exponent2);
 	}
 
 	qpl::RSA_key_pair qpl::RSA::get_public_key() const {
@@ -1250,6 +1609,13 @@ namespace qpl {
 		RSA_key_pair result;
 		result.mod = this->mod;
 		result.key = this->private_key;
+		if (this->has_primes()) {
+			result.prime1 = this->prime1;
+			result.prime2 = this->prime2;
+			result.exponent1 = this->private_exponent1;
+			result.exponent2 = this->private_exponent2;
+			result.coefficient = this->coefficient;
+		}
 		return result;
 	}
 	qpl::size qpl::RSA::get_bits() const {
@@ -1277,7 +1643,7 @@ namespace qpl {
 		}
 
 		this->mod = mpz_class{ prime1 * prime2 };
-		this->bits = this->mod.get_str(2).length();
+		this->bits = mpz_sizeinbase(this->mod.get_mpz_t(), 2);
 
 		mpz_class e = (1 << 15) + 1u;
 		for (; e < lambda; ++e) {
@@ -1290,6 +1656,7 @@ namespace qpl {
 				}
 			}
 		}
+		this->set_primes(prime1, prime2);
 	}
 	bool qpl::RSA::check(mpz_class prime1, mpz_class prime2) {
 
@@ -1304,7 +1671,7 @@ namespace qpl {
 			return false;
 		}
 		auto mod = mpz_class{ prime1 * prime2 };
-		if (mod.get_str(2u).length() % 8u) {
+		if (mpz_sizeinbase(mod.get_mpz_t(), 2) % 8u) {
 			return false;
 		}
 
@@ -1312,11 +1679,17 @@ namespace qpl {
 		return true;
 	}
 	mpz_class qpl::RSA::encrypt_integer(mpz_class message) const {
+		if (this->has_primes()) {
+			return crt_powm(message, this->public_exponent1, this->public_exponent2, *this);
+		}
 		mpz_class result;
 		mpz_powm(result.get_mpz_t(), message.get_mpz_t(), this->public_key.get_mpz_t(), this->mod.get_mpz_t());
 		return result;
 	}
 	mpz_class qpl::RSA::decrypt_integer(mpz_class message) const {
+		if (this->has_primes()) {
+			return crt_powm(message, this->private_exponent1, this->private_exponent2, *this);
+		}
 		mpz_class result;
 		mpz_powm(result.get_mpz_t(), message.get_mpz_t(), this->private_key.get_mpz_t(), this->mod.get_mpz_t());
 		return result;
@@ -1349,64 +1722,15 @@ namespace qpl {
 	}
 
 	std::optional<std::string> qpl::RSA::encrypt_hex_OAEP(const std::string_view& message, std::string label, qpl::hash_type hash_object) const {
-		auto hash_size = hash_object.second / 8u;
-		auto k = this->get_bits() / 4;
-		auto lhash = hash_object.first(label);
-
-		auto ps_length = qpl::signed_cast(k) - 2 * qpl::signed_cast(message.length()) - 4 * qpl::signed_cast(hash_size) - 3;
-
-		if (ps_length < 0) {
+		auto em = OAEP_encode(message, label, hash_object, this->get_bits());
+		if (!em.has_value()) {
 			return std::nullopt;
 		}
-		std::string ps;
-		ps.resize(ps_length, '0');
-
-		auto seed = qpl::get_random_string_full_range(hash_size);
-
-		std::string db;
-		db.append(lhash);
-		db.append(ps);
-		db.append("1");
-		db.append(qpl::hex_string(message));
-
-		auto db_mask_size = k - 2 * hash_size - 1;
-		auto db_mask = qpl::mgf1(seed, db_mask_size, hash_object);
-		auto masked_db = qpl::hex_string_xor(db, db_mask);
-		auto seed_mask = qpl::mgf1(qpl::from_hex_string(masked_db), hash_size * 2, hash_object);
-		auto masked_seed = qpl::hex_string_xor(seed_mask, qpl::hex_string(seed));
-
-		std::string em;
-		em.append("0");
-		em.append(masked_seed);
-		em.append(masked_db);
-		return this->encrypt_single_hex(em);
+		return this->encrypt_single_hex(em.value());
 	}
 	std::optional<std::string> qpl::RSA::decrypt_hex_OAEP(const std::string_view& message, std::string label, qpl::hash_type hash_object) const {
 		auto em = this->decrypt_single_hex(std::string{ message });
-		auto hash_size = hash_object.second / 8u;
-		auto k = this->get_bits() / 4;
-		auto lhash = hash_object.first(label);
-		auto db_mask_size = k - 2 * hash_size - 1;
-		auto masked_seed = em.substr(2u, hash_size * 2);
-		auto masked_db = em.substr(hash_size * 2 + 2u);
-		auto seed_mask = qpl::mgf1(qpl::from_hex_string(masked_db), hash_size * 2, hash_object);
-		auto seed = qpl::from_hex_string(qpl::hex_string_xor(seed_mask, masked_seed));
-		auto db_mask = qpl::mgf1(seed, db_mask_size, hash_object);
-		auto db = qpl::hex_string_xor(db_mask, masked_db);
-		auto check_lhash = db.substr(0u, lhash.length());
-
-		if (check_lhash != lhash) {
-			return std::nullopt;
-		}
-		qpl::size ps_index = lhash.length();
-		while (db[ps_index] == '0') {
-			++ps_index;
-		}
-		if (db[ps_index] != '1') {
-			return std::nullopt;
-		}
-
-		return qpl::from_hex_string(db.substr(ps_index + 1u));
+		return OAEP_decode(em, label, hash_object, this->get_bits());
 	}
 
 	std::optional<std::string> qpl::RSA::encrypt(const std::string_view& message, std::string label, qpl::hash_type hash_object) const {
@@ -1450,84 +1774,115 @@ namespace qpl {
 	}
 
 	std::string qpl::RSA::sign_RSASSA_PSS(const std::string_view& signature, qpl::hash_type hash_object, qpl::size salt_length) const {
-		if (salt_length == qpl::size_max) {
-			salt_length = hash_object.second / 8u;
-		}
-
-		auto hash = hash_object.first(signature);
-		auto hash_size = hash_object.second / 4u;
-		auto k = this->get_bits() / 4;
-		auto m_size = 16 + hash_size + salt_length * 2;
-		auto db_size = k - m_size - 1;
-		auto ps_size = db_size - salt_length * 2 - 1;
-
-		auto salt = qpl::get_random_string_full_range(salt_length);
-
-		std::string padding;
-		padding.resize(16, '0');
-
-		std::string m;
-		m.append(padding);
-		m.append(hash);
-		m.append(qpl::hex_string(salt));
-
-
-		std::string ps;
-		ps.resize(ps_size, '0');
-
-		std::string db;
-		db.append(ps);
-		db.append("1");
-		db.append(qpl::hex_string(salt));
-
-		auto mhash = qpl::mgf1(hash_object.first(m), m_size, hash_object);
-		auto db_mask = qpl::mgf1(mhash, db_size, hash_object);
-		auto masked_db = qpl::hex_string_xor(db, db_mask);
-
-		std::string em;
-		em.append("0");
-		em.append(masked_db);
-		em.append(mhash);
-
+		auto em = PSS_encode(signature, hash_object, salt_length, this->get_bits());
 		return this->encrypt_single_hex(em);
 	}
 	bool qpl::RSA::verify_RSASSA_PSS(const std::string& message, const std::string_view& signature, qpl::hash_type hash_object, qpl::size salt_length) const {
-		if (salt_length == qpl::size_max) {
-			salt_length = hash_object.second / 8u;
-		}
-		auto hash_size = hash_object.second / 4u;
-		auto k = this->get_bits() / 4;
-		auto m_size = 16 + hash_size + salt_length * 2;
-		auto db_size = k - m_size - 1;
-		auto ps_size = db_size - salt_length * 2 - 1;
-
-		auto hash = hash_object.first(signature);
 		auto em = this->decrypt_single_hex(message);
+		return PSS_verify(em, signature, hash_object, salt_length, this->get_bits());
+	}
 
-		auto masked_db = em.substr(1u, db_size);
-		auto mhash = em.substr(1u + db_size);
-		auto db_mask = qpl::mgf1(mhash, db_size, hash_object);
-		auto db = qpl::hex_string_xor(db_mask, masked_db);
+	std::string qpl::RSA::encrypt_block(const std::string_view& block) const {
+		return export_bytes(this->encrypt_integer(import_bytes(block)), this->get_bits() / 8);
+	}
+	std::string qpl::RSA::decrypt_block(const std::string_view& block) const {
+		return export_bytes(this->decrypt_integer(import_bytes(block)), this->get_bits() / 8);
+	}
+	std::optional<std::string> qpl::RSA::encrypt_binary(const std::string_view& message, std::string label, qpl::hash_type hash_object) const {
+		check_key_bits(*this, "encrypt_binary");
+		auto message_length = this->get_max_message_length(hash_object);
+		auto block_length = this->get_bits() / 8;
+		if (!message_length || message_length >= block_length) {
+			throw qpl::exception("RSA::encrypt_binary: a ", this->get_bits(), " bit key is too small for a ", hash_object.second, " bit hash");
+		}
+		auto message_blocks = qpl::signed_cast(message.length() - 1) / qpl::signed_cast(message_length) + 1;
+
+		std::string result;
+		result.reserve(message_blocks * block_length);
 
-		qpl::size db_index = 0u;
-		while (db[db_index] == '0') {
-			++db_index;
+		for (qpl::isize i = 0; i < message_blocks; ++i) {
+			auto sub = message.substr(i * message_length, message_length);
+			auto em = OAEP_encode(sub, label, hash_object, this->get_bits());
+			if (!em.has_value()) {
+				return std::nullopt;
+			}
+			mpz_class n;
+			n.set_str(em.value(), 16);
+			result.append(export_bytes(this->encrypt_integer(n), block_length));
 		}
-		if (db[db_index] != '1') {
-			return false;
+		return result;
+	}
+	std::optional<std::string> qpl::RSA::decrypt_binary(const std::string_view& message, std::string label, qpl::hash_type hash_object) const {
+		check_key_bits(*this, "decrypt_binary");
+		auto block_length = this->get_bits() / 8;
+		auto blocks = message.length() / block_length;
+
+		if (message.length() % block_length) {
+			return std::nullopt;
 		}
-		auto salt = db.substr(db_index + 1u);
 
-		std::string padding;
-		padding.resize(16, '0');
+		std::string result;
+		result.reserve(block_length * blocks);
 
-		std::string m;
-		m.append(padding);
-		m.append(hash);
-		m.append(salt);
+		for (qpl::size i = 0u; i < blocks; ++i) {
+			auto em = this->decrypt_integer(import_bytes(message.substr(i * block_length, block_length))).get_str(16);
+			this->pad_string(em);
+			auto d = OAEP_decode(em, label, hash_object, this->get_bits());
 
-		auto check_mhash = qpl::mgf1(hash_object.first(m), m_size, hash_object);
-		return check_mhash == mhash;
+			if (!d.has_value()) {
+				return std::nullopt;
+			}
+			result.append(d.value());
+		}
+		return result;
+	}
+	std::string qpl::RSA::sign_RSASSA_PSS_binary(const std::string_view& signature, qpl::hash_type hash_object, qpl::size salt_length) const {
+		auto em = PSS_encode(signature, hash_object, salt_length, this->get_bits());
+		mpz_class n;
+		n.set_str(em, 16);
+		return export_bytes(this->encrypt_integer(n), this->get_bits() / 8);
+	}
+	bool qpl::RSA::verify_RSASSA_PSS_binary(const std::string_view& message, const std::string_view& signature, qpl::hash_type hash_object, qpl::size salt_length) const {
+		auto em = this->decrypt_integer(import_bytes(message)).get_str(16);
+		this->pad_string(em);
+		return PSS_verify(em, signature, hash_object, salt_length, this->get_bits());
+	}
+
+	std::vector<std::optional<std::string>> qpl::RSA::encrypt_batch(std::span<const std::string> messages, std::string label, qpl::hash_type hash_object, qpl::thread_pool& pool) const {
+		check_key_bits(*this, "encrypt_batch");
+		std::vector<std::optional<std::string>> result(messages.size());
+		pool.parallel_for(messages.size(), [&](qpl::size i) {
+			result[i] = this->encrypt_binary(messages[i], label, hash_object);
+		});
+		return result;
+	}
+	std::vector<std::optional<std::string>> qpl::RSA::decrypt_batch(std::span<const std::string> messages, std::string label, qpl::hash_type hash_object, qpl::thread_pool& pool) const {
+		check_key_bits(*this, "decrypt_batch");
+		std::vector<std::optional<std::string>> result(messages.size());
+		pool.parallel_for(messages.size(), [&](qpl::size i) {
+			result[i] = this->decrypt_binary(messages[i], label, hash_object);
+		});
+		return result;
+	}
+	std::vector<std::string> qpl::RSA::sign_RSASSA_PSS_batch(std::span<const std::string> signatures, qpl::hash_type hash_object, qpl::thread_pool& pool) const {
+		check_key_bits(*this, "sign_RSASSA_PSS_batch");
+		std::vector<std::string> result(signatures.size());
+		pool.parallel_for(signatures.size(), [&](qpl::size i) {
+			result[i] = this->sign_RSASSA_PSS_binary(signatures[i], hash_object);
+		});
+		return result;
+	}
+	std::vector<bool> qpl::RSA::verify_RSASSA_PSS_batch(std::span<const std::string> messages, std::span<const std::string> signatures, qpl::hash_type hash_object, qpl::thread_pool& pool) const {
+		if (messages.size() != signatures.size()) {
+			throw qpl::exception("RSA::verify_RSASSA_PSS_batch: ", messages.size(), " messages but ", signatures.size(), " signatures");
+		}
+		check_key_bits(*this, "verify_RSASSA_PSS_batch");
+		//std::vector<bool> packs bits, so concurrent writes go through a byte vector first
+		std::vector<qpl::u8> verified(messages.size());
+		pool.parallel_for(messages.size(), [&](qpl::size i) {
+			verified[i] = this->verify_RSASSA_PSS_binary(messages[i], signatures[i], hash_object);
+		});
+		return std::vector<bool>(verified.cbegin(), verified.cend());
 	}
 
 	std::optional<std::string> qpl::RSA_encrypt(const std::string_view& message, const RSA_key_pair& private_key, std::string label, qpl::hash_type hash_object) {
@@ -1558,17 +1913,33 @@ namespace qpl {
 	}
 	void qpl::RSASSA_PSS_OAEP::load_keys(const std::string& data) {
 		auto lines = qpl::string_split(data, '\n');
-		if (lines.size() != 5u) {
+		if (lines.size() != 5u && lines.size() != 10u && lines.size() != 15u) {
 			qpl::println("qpl::RSASSA_PSS_OAEP::load_keys : invalid keys file");
 			return;
 		}
 		for (auto& i : lines) {
-			if (i.back() == '\r') {
+			if (!i.empty() && i.back() == '\r') {
 				i.pop_back();
 			}
 		}
-		this->set_cipher_key(lines[0], lines[1]);
-		this->set_signature_key(lines[3], lines[4]);
+		//with 10 lines only one of the keys has crt parameters, if line 7 isn't a key value it's the separator
+		auto is_hex = [](const std::string& line) {
+			return !line.empty() && line.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+		};
+		auto cipher_lines = qpl::size{ 2u };
+		if (lines.size() == 15u || (lines.size() == 10u && !is_hex(lines[7]))) {
+			cipher_lines = 7u;
+		}
+		auto set_key = [&](qpl::RSA_key_pair& key, qpl::size begin, qpl::size size) {
+			if (size == 7u) {
+				key.set(lines[begin], lines[begin + 1], lines[begin + 2], lines[begin + 3], lines[begin + 4], lines[begin + 5], lines[begin + 6]);
+			}
+			else {
+				key.set(lines[begin], lines[begin + 1]);
+			}
+		};
+		set_key(this->cipher_key, 0u, cipher_lines);
+		set_key(this->signature_key, cipher_lines + 1u, lines.size() - cipher_lines - 1u);
 	}
 	void qpl::RSASSA_PSS_OAEP::load_keys_from_file(const std::string& path) {
 		this->load_keys(qpl::filesys::read_file(path));
@@ -1583,28 +1954,41 @@ namespace qpl {
 		if (this->empty()) {
 			return std::nullopt;
 		}
+		qpl::RSA signer;
+		signer.set_encryption_key(this->signature_key);
+		qpl::RSA cipher;
+		cipher.set_encryption_key(this->cipher_key);
+
 		std::string result;
-		auto signature_string = qpl::RSASSA_PSS_sign(signature, this->signature_key, hash_object);
-		auto encrypted_string = qpl::RSA_encrypt(message, this->cipher_key, label, hash_object);
+		auto signature_string = signer.sign_RSASSA_PSS_binary(signature, hash_object);
+		auto encrypted_string = cipher.encrypt_binary(message, label, hash_object);
 		if (!encrypted_string.has_value()) {
 			return std::nullopt;
 		}
-		result.append(qpl::from_hex_string(signature_string));
-		result.append(qpl::from_hex_string(encrypted_string.value()));
+		result.append(signature_string);
+		result.append(encrypted_string.value());
 		return result;
 	}
 	std::optional<std::string> qpl::RSASSA_PSS_OAEP::verify_and_decrypt(const std::string& message, const std::string_view& signature, std::string label, qpl::hash_type hash_object) const {
 		if (this->empty()) {
 			return std::nullopt;
 		}
+		qpl::RSA verifier;
+		verifier.set_decryption_key(this->signature_key);
+		qpl::RSA cipher;
+		cipher.set_decryption_key(this->cipher_key);
+
 		auto signature_offset = this->signature_key.bits() / 8u;
-		auto verify_string = message.substr(0u, signature_offset);
-		auto verified = qpl::RSASSA_PSS_verify(qpl::hex_string(verify_string), signature, this->signature_key, hash_object);
+		if (message.length() < signature_offset) {
+			return std::nullopt;
+		}
+		auto verify_string = std::string_view{ message }.substr(0u, signature_offset);
+		auto verified = verifier.verify_RSASSA_PSS_binary(verify_string, signature, hash_object);
 
 		if (!verified) {
 			return std::nullopt;
 		}
-		auto decrypted_string = qpl::RSA_decrypt(qpl::hex_string(message.substr(signature_offset)), this->cipher_key, label, hash_object);
+		auto decrypted_string = cipher.decrypt_binary(std::string_view{ message }.substr(signature_offset), label, hash_object);
 		if (!decrypted_string.has_value()) {
 			return std::nullopt;
 		}
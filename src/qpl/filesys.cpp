@@ -4,10 +4,17 @@
 #include <qpl/system.hpp>
 #include <qpl/time.hpp>
 #include <qpl/encryption.hpp>
+#include <map>
+#include <random>
+#include <unordered_set>
 
 namespace qpl {
 
   namespace filesys {
+    namespace detail {
+      qpl::filesys::paths search_tree_where(const qpl::filesys::path& root, const std::function<bool(const qpl::filesys::path&)>& check);
+    }
+
     qpl::filesys::path& qpl::filesys::path::operator=(const std::wstring_view& str) {
       std::wstring wstr(str);
       return this->operator=(std::string_view{ qpl::wstring_to_utf8(wstr) });
@@ -981,15 +988,7 @@ namespace qpl {
       return { list };
     }
     qpl::filesys::paths qpl::filesys::path::list_current_directory_tree() const {
-      if (!this->exists()) {
-        return {};
-      }
-      qpl::filesys::paths list;
-      auto str = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(str, std::filesystem::directory_options::skip_permission_denied)) {
-        list.push_back({ i.path().wstring() });
-      }
-      return { list };
+      return detail::search_tree_where(*this, nullptr);
     }
     qpl::filesys::paths qpl::filesys::path::list_current_directory_tree_include_self() const {
       if (!this->exists()) {
@@ -997,11 +996,10 @@ namespace qpl {
       }
       qpl::filesys::paths list;
       list.push_back(*this);
-      auto str = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(str, std::filesystem::directory_options::skip_permission_denied)) {
-        list.push_back({ i.path().wstring() });
+      for (auto& i : detail::search_tree_where(*this, nullptr)) {
+        list.push_back(i);
       }
-      return { list };
+      return list;
     }
     void qpl::filesys::path::print_current_directory() const {
       auto list = this->list_current_directory();
@@ -1407,15 +1405,9 @@ namespace qpl {
 
 
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_equals(const std::string_view& extension) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.extension_equals(extension)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.extension_equals(extension);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_equals(const char* extension) const {
       return this->search_recursively_where_extension_equals(std::string_view{ extension });
@@ -1424,15 +1416,9 @@ namespace qpl {
       return this->search_recursively_where_extension_equals(std::string_view{ extension });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_contains(const std::string_view& str) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.extension_contains(str)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.extension_contains(str);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_contains(const char* str) const {
       return this->search_recursively_where_extension_contains(std::string_view{ str });
@@ -1441,27 +1427,15 @@ namespace qpl {
       return this->search_recursively_where_extension_contains(std::string_view{ str });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_matches(const std::regex& regex) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.extension_matches(regex)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.extension_matches(regex);
+      });
     }
 
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_equals(const std::string_view& name) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.name_equals(name)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.name_equals(name);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_equals(const char* name) const {
       return this->search_recursively_where_name_equals(std::string_view{ name });
@@ -1470,15 +1444,9 @@ namespace qpl {
       return this->search_recursively_where_name_equals(std::string_view{ name });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_contains(const std::string_view& str) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.name_contains(str)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.name_contains(str);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_contains(const char* str) const {
       return this->search_recursively_where_name_contains(std::string_view{ str });
@@ -1487,27 +1455,15 @@ namespace qpl {
       return this->search_recursively_where_name_contains(std::string_view{ str });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_matches(const std::regex& regex) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.name_matches(regex)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.name_matches(regex);
+      });
     }
 
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_equals(const std::string_view& file_name) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.file_name_equals(file_name)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.file_name_equals(file_name);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_equals(const char* file_name) const {
       return this->search_recursively_where_file_name_equals(std::string_view{ file_name });
@@ -1516,15 +1472,9 @@ namespace qpl {
       return this->search_recursively_where_file_name_equals(std::string_view{ file_name });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_contains(const std::string_view& str) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.file_name_contains(str)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.file_name_contains(str);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_contains(const char* str) const {
       return this->search_recursively_where_file_name_contains(std::string_view{ str });
@@ -1533,27 +1483,15 @@ namespace qpl {
       return this->search_recursively_where_file_name_contains(std::string_view{ str });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_matches(const std::regex& regex) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.file_name_matches(regex)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.file_name_matches(regex);
+      });
     }
 
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_doesnt_equal(const std::string_view& extension) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.extension_equals(extension)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.extension_equals(extension);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_doesnt_equal(const char* extension) const {
       return this->search_recursively_where_extension_doesnt_equal(std::string_view{ extension });
@@ -1562,15 +1500,9 @@ namespace qpl {
       return this->search_recursively_where_extension_doesnt_equal(std::string_view{ extension });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_doesnt_contain(const std::string_view& str) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.extension_contains(str)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.extension_contains(str);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_doesnt_contain(const char* str) const {
       return this->search_recursively_where_extension_doesnt_contain(std::string_view{ str });
@@ -1579,27 +1511,15 @@ namespace qpl {
       return this->search_recursively_where_extension_doesnt_contain(std::string_view{ str });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_extension_doesnt_match(const std::regex& regex) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.extension_matches(regex)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.extension_matches(regex);
+      });
     }
 
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_doesnt_equal(const std::string_view& str) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.name_equals(str)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.name_equals(str);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_doesnt_equal(const char* str) const {
       return this->search_recursively_where_name_doesnt_equal(std::string_view{ str });
@@ -1608,15 +1528,9 @@ namespace qpl {
       return this->search_recursively_where_name_doesnt_equal(std::string_view{ str });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_doesnt_contain(const std::string_view& str) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.name_contains(str)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.name_contains(str);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_doesnt_contain(const char* str) const {
       return this->search_recursively_where_name_doesnt_contain(std::string_view{ str });
@@ -1625,27 +1539,15 @@ namespace qpl {
       return this->search_recursively_where_name_doesnt_contain(std::string_view{ str });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_name_doesnt_match(const std::regex& regex) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.name_matches(regex)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.name_matches(regex);
+      });
     }
 
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_doesnt_equal(const std::string_view& str) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.file_name_equals(str)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.file_name_equals(str);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_doesnt_equal(const char* str) const {
       return this->search_recursively_where_file_name_doesnt_equal(std::string_view{ str });
@@ -1654,15 +1556,9 @@ namespace qpl {
       return this->search_recursively_where_file_name_doesnt_equal(std::string_view{ str });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_doesnt_contain(const std::string_view& str) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.file_name_contains(str)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.file_name_contains(str);
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_doesnt_contain(const char* str) const {
       return this->search_recursively_where_file_name_doesnt_contain(std::string_view{ str });
@@ -1671,39 +1567,25 @@ namespace qpl {
       return this->search_recursively_where_file_name_doesnt_contain(std::string_view{ str });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_where_file_name_doesnt_match(const std::regex& regex) const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (!path.file_name_matches(regex)) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return !path.file_name_matches(regex);
+      });
     }
 
 
     qpl::filesys::paths qpl::filesys::path::search_recursively_directories() const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.is_directory()) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.is_directory();
+      });
     }
     qpl::filesys::paths qpl::filesys::path::search_recursively_files() const {
-      qpl::filesys::paths result;
-      auto directory = this->is_directory() ? this->wstring() : this->get_parent_branch().wstring();
-      for (auto i : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
-        qpl::filesys::path path = i;
-        if (path.is_file()) {
-          result.emplace_back(path);
-        }
-      }
-      return result;
+      return detail::search_tree_where(*this, [&](const qpl::filesys::path& path) {
+        return path.is_file();
+      });
+    }
+
+    qpl::filesys::paths qpl::filesys::path::search_recursively_where(const qpl::filesys::walk_filter& filter, qpl::size thread_count) const {
+      return qpl::filesys::search_tree_parallel(*this, filter, thread_count);
     }
 
     void qpl::filesys::path::update() const {
@@ -2932,52 +2814,1057 @@ namespace qpl {
       auto content = qpl::filesys::file_decrypt(source_path, key, mode);
       qpl::filesys::write_data_file(content, dest_path);
     }
-  }
 
-  std::string qpl::read_file(const std::string& path) {
-    return qpl::filesys::read_file(path);
-  }
-  std::wstring qpl::wread_file(const std::wstring& path) {
-    return qpl::filesys::wread_file(path);
-  }
-  void qpl::write_to_file(const std::string& text, const std::string& path) {
-    return qpl::filesys::write_to_file(text, path);
-  }
-  void qpl::write_data_file(const std::string& data, const std::string& path) {
-    return qpl::filesys::write_data_file(data, path);
-  }
-  void qpl::write_text_file(const std::string& data, const std::string& path) {
-    return qpl::filesys::write_text_file(data, path);
-  }
+    namespace detail {
+      std::string native_path_to_utf8(const std::filesystem::path& path) {
+#ifdef _WIN32
+        auto result = qpl::wstring_to_utf8(path.native());
+#else
+        auto result = path.native();
+#endif
+        for (auto& c : result) {
+          if (c == '\\') {
+            c = '/';
+          }
+        }
+        return result;
+      }
+      std::filesystem::path walk_root(const qpl::filesys::path& root) {
+        auto directory = root.is_directory() ? root : root.get_parent_branch();
+        auto string = directory.string();
+        //a root like "/" or "C:/" keeps its separator, "C:" alone would be the current directory of drive C
+        while (string.size() > 1u && string.back() == '/' && std::filesystem::path(qpl::utf8_to_wstring(string)).has_relative_path()) {
+          string.pop_back();
+        }
+        return std::filesystem::path(qpl::utf8_to_wstring(string));
+      }
+      std::string_view entry_name_view(std::string_view path) {
+        auto position = path.find_last_of('/');
+        if (position == std::string_view::npos) {
+          return path;
+        }
+        return path.substr(position + 1);
+      }
+      std::string_view entry_extension_view(std::string_view full_name) {
+        auto position = full_name.find_last_of('.');
+        if (position == std::string_view::npos) {
+          return {};
+        }
+        return full_name.substr(position + 1);
+      }
 
-  void qpl::file_encrypter::clear() {
-    this->paths.clear();
-    this->additions = 0u;
-    this->part_paths.clear();
-  }
-  void qpl::file_encrypter::add(std::string path) {
-    auto file_path = qpl::filesys::path(path);
+      struct walk_queue {
+        std::mutex mutex;
+        std::deque<std::pair<std::filesystem::path, qpl::size>> directories;
+      };
 
-    auto adding = file_path.get_file_extension().starts_with(this->keyword_string_part);
+      //work-stealing walk: every worker pops its own newest directory and steals the oldest one of another worker when idle
+      void walk_tree_parallel(const std::filesystem::path& root, const qpl::filesys::walk_filter& filter, const std::function<void(qpl::filesys::walk_entry&&, qpl::size)>& sink, qpl::size thread_count, const std::atomic_bool* cancel) {
+        if (!thread_count) {
+          thread_count = qpl::max(qpl::size{ 1u }, qpl::size_cast(std::thread::hardware_concurrency()));
+        }
 
-    if (adding) {
-      if (!this->adding_parts) {
-        ++this->additions;
+        std::vector<walk_queue> queues(thread_count);
+        std::atomic<qpl::size> pending = 1u;
+        std::atomic<qpl::size> queued = 1u;
+        std::atomic_bool failed = false;
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
+        std::mutex idle_mutex;
+        std::condition_variable idle;
+        queues.front().directories.emplace_back(root, 0u);
+
+        auto wake = [&](bool all) {
+          {
+            std::lock_guard lock(idle_mutex);
+          }
+          if (all) {
+            idle.notify_all();
+          }
+          else {
+            idle.notify_one();
+          }
+        };
+
+        auto pop = [&](qpl::size id, std::pair<std::filesystem::path, qpl::size>& result) {
+          {
+            std::lock_guard lock(queues[id].mutex);
+            auto& own = queues[id].directories;
+            if (!own.empty()) {
+              result = std::move(own.back());
+              own.pop_back();
+              queued.fetch_sub(1u);
+              return true;
+            }
+          }
+          for (qpl::size i = 1u; i < thread_count; ++i) {
+            auto& other = queues[(id + i) % thread_count];
+            std::lock_guard lock(other.mutex);
+            if (!other.directories.empty()) {
+              result = std::move(other.directories.front());
+              other.directories.pop_front();
+              queued.fetch_sub(1u);
+              return true;
+            }
+          }
+          return false;
+        };
+
+        auto stopped = [&]() {
+          return failed.load(std::memory_order_relaxed) || (cancel && cancel->load(std::memory_order_relaxed));
+        };
+
+        auto work = [&](qpl::size id) {
+          std::pair<std::filesystem::path, qpl::size> directory;
+          while (!stopped()) {
+            if (!pop(id, directory)) {
+              if (pending.load() == 0u) {
+                return;
+              }
+              //the timeout only matters for an external cancel, everything else wakes the idle workers
+              std::unique_lock lock(idle_mutex);
+              idle.wait_for(lock, std::chrono::milliseconds(10), [&]() {
+                return queued.load() || !pending.load() || stopped();
+              });
+              continue;
+            }
+            try {
+              auto depth = directory.second;
+              std::error_code ec;
+              std::filesystem::directory_iterator it(directory.first, std::filesystem::directory_options::skip_permission_denied, ec);
+              for (; !ec && it != std::filesystem::directory_iterator{} && !stopped(); it.increment(ec)) {
+                const auto& entry = *it;
+                std::error_code type_ec;
+                bool is_directory = entry.is_directory(type_ec);
+                bool is_symlink = entry.is_symlink(type_ec);
+
+                if (is_directory && !is_symlink && depth < filter.max_depth && (!filter.descend_predicate || filter.descend_predicate(entry))) {
+                  pending.fetch_add(1u);
+                  {
+                    std::lock_guard lock(queues[id].mutex);
+                    queues[id].directories.emplace_back(entry.path(), depth + 1);
+                  }
+                  queued.fetch_add(1u);
+                  wake(false);
+                }
+
+                if (is_directory ? !filter.include_directories : !filter.include_files) {
+                  continue;
+                }
+                auto name = detail::native_path_to_utf8(entry.path().filename());
+                if (!filter.accepts_name(name, is_directory)) {
+                  continue;
+                }
+                if (filter.predicate && !filter.predicate(entry)) {
+                  continue;
+                }
+
+                qpl::filesys::walk_entry result;
+                result.path = detail::native_path_to_utf8(entry.path());
+                result.depth = depth;
+                result.is_directory = is_directory;
+                result.is_file = !is_directory && (entry.is_regular_file(type_ec) || entry.is_block_file(type_ec) || entry.is_character_file(type_ec));
+                if (filter.read_metadata) {
+                  if (result.is_file) {
+                    result.file_size = entry.file_size(type_ec);
+                  }
+                  result.last_write_time = entry.last_write_time(type_ec);
+                }
+                sink(std::move(result), id);
+              }
+            }
+            catch (...) {
+              std::lock_guard lock(exception_mutex);
+              if (!exception) {
+                exception = std::current_exception();
+              }
+              failed = true;
+              wake(true);
+            }
+            if (pending.fetch_sub(1u) == 1u) {
+              wake(true);
+            }
+          }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count - 1);
+        for (qpl::size i = 1u; i < thread_count; ++i) {
+          threads.emplace_back(work, i);
+        }
+        work(0u);
+        for (auto& thread : threads) {
+          thread.join();
+        }
+        if (exception) {
+          std::rethrow_exception(exception);
+        }
       }
-      auto name = file_path.get_file_name();
-      this->part_paths[name].push_back(file_path);
-    }
-    else {
-      this->paths.push_back(path);
-      ++this->additions;
     }
-    this->adding_parts = adding;
 
-    if (this->common_branch.empty()) {
-      this->common_branch = path;
+    std::string_view qpl::filesys::walk_entry::get_full_name_view() const {
+      return detail::entry_name_view(this->path);
     }
-    else {
-      this->common_branch = this->common_branch.get_common_branch(path);
+    std::string_view qpl::filesys::walk_entry::get_file_extension_view() const {
+      if (!this->is_file) {
+        return {};
+      }
+      return detail::entry_extension_view(this->get_full_name_view());
+    }
+    qpl::filesys::path qpl::filesys::walk_entry::to_path() const {
+      return qpl::filesys::path(this->path);
+    }
+
+    bool qpl::filesys::walk_filter::accepts_name(std::string_view full_name, bool is_directory) const {
+      if (!this->extensions.empty()) {
+        if (is_directory) {
+          return false;
+        }
+        auto extension = detail::entry_extension_view(full_name);
+        bool found = false;
+        for (auto& i : this->extensions) {
+          std::string_view view = i;
+          if (!view.empty() && view.front() == '.') {
+            view.remove_prefix(1);
+          }
+          if (extension == view) {
+            found = true;
+            break;
+          }
+        }
+        if (!found) {
+          return false;
+        }
+      }
+      if (!this->name_equals.empty() && full_name != this->name_equals) {
+        return false;
+      }
+      if (!this->name_contains.empty() && full_name.find(this->name_contains) == std::string_view::npos) {
+        return false;
+      }
+      return true;
+    }
+
+    void qpl::filesys::walk_directory_tree(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, const std::function<void(const qpl::filesys::walk_entry&)>& callback, qpl::size thread_count) {
+      if (!root.exists()) {
+        return;
+      }
+      detail::walk_tree_parallel(detail::walk_root(root), filter, [&](qpl::filesys::walk_entry&& entry, qpl::size) {
+        callback(entry);
+      }, thread_count, nullptr);
+    }
+    std::vector<qpl::filesys::walk_entry> qpl::filesys::walk_directory_tree(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, qpl::size thread_count) {
+      if (!root.exists()) {
+        return {};
+      }
+      if (!thread_count) {
+        thread_count = qpl::max(qpl::size{ 1u }, qpl::size_cast(std::thread::hardware_concurrency()));
+      }
+      std::vector<std::vector<qpl::filesys::walk_entry>> results(thread_count);
+      detail::walk_tree_parallel(detail::walk_root(root), filter, [&](qpl::filesys::walk_entry&& entry, qpl::size id) {
+        results[id].emplace_back(std::move(entry));
+      }, thread_count, nullptr);
+
+      qpl::size size = 0u;
+      for (auto& i : results) {
+        size += i.size();
+      }
+      std::vector<qpl::filesys::walk_entry> result;
+      result.reserve(size);
+      for (auto& i : results) {
+        std::move(i.begin(), i.end(), std::back_inserter(result));
+      }
+      return result;
+    }
+    qpl::filesys::paths qpl::filesys::search_tree_parallel(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, qpl::size thread_count) {
+      auto entries = qpl::filesys::walk_directory_tree(root, filter, thread_count);
+      qpl::filesys::paths result;
+      result.reserve(entries.size());
+      for (auto& i : entries) {
+        result.push_back(i.to_path());
+      }
+      return result;
+    }
+
+    qpl::filesys::paths detail::search_tree_where(const qpl::filesys::path& root, const std::function<bool(const qpl::filesys::path&)>& check) {
+      if (!root.exists()) {
+        return {};
+      }
+      auto thread_count = qpl::max(qpl::size{ 1u }, qpl::size_cast(std::thread::hardware_concurrency()));
+      std::vector<std::vector<qpl::filesys::path>> results(thread_count);
+      detail::walk_tree_parallel(detail::walk_root(root), qpl::filesys::walk_filter{}, [&](qpl::filesys::walk_entry&& entry, qpl::size id) {
+        qpl::filesys::path path = entry.path;
+        if (!check || check(path)) {
+          results[id].push_back(std::move(path));
+        }
+      }, thread_count, nullptr);
+
+      std::vector<qpl::filesys::path> list;
+      for (auto& i : results) {
+        std::move(i.begin(), i.end(), std::back_inserter(list));
+      }
+      //the walk order depends on the scheduling, sorting keeps the result deterministic
+      std::sort(list.begin(), list.end(), [](const qpl::filesys::path& a, const qpl::filesys::path& b) {
+        return a.string() < b.string();
+      });
+      return list;
+    }
+
+    void qpl::filesys::walk_channel::start(const qpl::filesys::path& root, const qpl::filesys::walk_filter& filter, qpl::size thread_count, qpl::size capacity) {
+      this->stop();
+      this->m_cancel = false;
+      this->m_finished = false;
+      this->m_capacity = qpl::max(qpl::size{ 1u }, capacity);
+
+      this->m_exception = nullptr;
+
+      this->m_thread = std::thread([this, root, filter, thread_count]() {
+        std::exception_ptr exception;
+        try {
+          if (root.exists()) {
+            detail::walk_tree_parallel(detail::walk_root(root), filter, [&](qpl::filesys::walk_entry&& entry, qpl::size) {
+              std::unique_lock lock(this->m_mutex);
+              this->m_popped.wait(lock, [&]() {
+                return this->m_entries.size() < this->m_capacity || this->m_cancel.load();
+              });
+              if (this->m_cancel) {
+                return;
+              }
+              this->m_entries.emplace_back(std::move(entry));
+              this->m_pushed.notify_one();
+            }, thread_count, &this->m_cancel);
+          }
+        }
+        catch (...) {
+          exception = std::current_exception();
+        }
+        std::lock_guard lock(this->m_mutex);
+        this->m_exception = exception;
+        this->m_finished = true;
+        this->m_pushed.notify_all();
+      });
+    }
+    void qpl::filesys::walk_channel::stop() {
+      if (!this->m_thread.joinable()) {
+        return;
+      }
+      {
+        std::lock_guard lock(this->m_mutex);
+        this->m_cancel = true;
+      }
+      this->m_popped.notify_all();
+      this->m_thread.join();
+      this->m_entries.clear();
+      this->m_exception = nullptr;
+      this->m_finished = true;
+    }
+    bool qpl::filesys::walk_channel::pop(qpl::filesys::walk_entry& entry) {
+      std::unique_lock lock(this->m_mutex);
+      this->m_pushed.wait(lock, [&]() {
+        return !this->m_entries.empty() || this->m_finished;
+      });
+      if (this->m_entries.empty()) {
+        this->rethrow_failure();
+        return false;
+      }
+      entry = std::move(this->m_entries.front());
+      this->m_entries.pop_front();
+      this->m_popped.notify_one();
+      return true;
+    }
+    bool qpl::filesys::walk_channel::try_pop(qpl::filesys::walk_entry& entry) {
+      std::lock_guard lock(this->m_mutex);
+      if (this->m_entries.empty()) {
+        if (this->m_finished) {
+          this->rethrow_failure();
+        }
+        return false;
+      }
+      entry = std::move(this->m_entries.front());
+      this->m_entries.pop_front();
+      this->m_popped.notify_one();
+      return true;
+    }
+    bool qpl::filesys::walk_channel::finished() const {
+      std::lock_guard lock(this->m_mutex);
+      return this->m_finished && this->m_entries.empty();
+    }
+    bool qpl::filesys::walk_channel::failed() const {
+      std::lock_guard lock(this->m_mutex);
+      return this->m_exception != nullptr;
+    }
+    void qpl::filesys::walk_channel::rethrow_failure() {
+      if (this->m_exception) {
+        auto exception = std::exchange(this->m_exception, nullptr);
+        std::rethrow_exception(exception);
+      }
+    }
+
+    void qpl::filesys::metadata_cache::build(const qpl::filesys::path& root, qpl::size thread_count) {
+      this->clear();
+      if (!root.exists()) {
+        return;
+      }
+      auto root_path = detail::walk_root(root);
+      this->m_root = detail::native_path_to_utf8(root_path);
+
+      std::error_code ec;
+      auto& root_entry = this->m_entries[this->m_root];
+      root_entry.is_directory = true;
+      root_entry.last_write_time = std::filesystem::last_write_time(root_path, ec);
+
+      qpl::filesys::walk_filter filter;
+      filter.read_metadata = true;
+      auto entries = qpl::filesys::walk_directory_tree(this->m_root, filter, thread_count);
+      this->m_entries.reserve(entries.size() + 1);
+      this->insert(entries);
+    }
+    qpl::size qpl::filesys::metadata_cache::refresh(qpl::size thread_count) {
+      if (this->m_root.empty()) {
+        return 0u;
+      }
+      if (!thread_count) {
+        thread_count = qpl::max(qpl::size{ 1u }, qpl::size_cast(std::thread::hardware_concurrency()));
+      }
+
+      struct directory_update {
+        std::string key;
+        std::filesystem::file_time_type last_write_time;
+        bool removed = false;
+        bool relisted = false;
+        std::vector<qpl::filesys::walk_entry> listing;
+        std::vector<std::pair<std::string, entry>> changed_files;
+      };
+
+      std::vector<directory_update> updates;
+      for (auto& i : this->m_entries) {
+        if (i.second.is_directory) {
+          updates.push_back({});
+          updates.back().key = i.first;
+        }
+      }
+
+      std::atomic<qpl::size> next = 0u;
+      auto work = [&]() {
+        for (auto index = next.fetch_add(1u); index < updates.size(); index = next.fetch_add(1u)) {
+          auto& update = updates[index];
+          const auto& cached = this->m_entries.at(update.key);
+          std::filesystem::path directory_path(qpl::utf8_to_wstring(update.key));
+
+          std::error_code ec;
+          update.last_write_time = std::filesystem::last_write_time(directory_path, ec);
+          if (ec || !std::filesystem::is_directory(directory_path, ec)) {
+            update.removed = true;
+            continue;
+          }
+          if (update.last_write_time == cached.last_write_time) {
+            for (auto& child : cached.children) {
+              const auto& child_entry = this->m_entries.at(child);
+              if (child_entry.is_directory) {
+                continue;
+              }
+              std::filesystem::path child_path(qpl::utf8_to_wstring(child));
+              entry changed;
+              changed.last_write_time = std::filesystem::last_write_time(child_path, ec);
+              changed.file_size = ec ? 0u : std::filesystem::file_size(child_path, ec);
+              if (ec) {
+                continue;
+              }
+              if (changed.last_write_time != child_entry.last_write_time || changed.file_size != child_entry.file_size) {
+                update.changed_files.emplace_back(child, std::move(changed));
+              }
+            }
+            continue;
+          }
+
+          update.relisted = true;
+          qpl::filesys::walk_filter filter;
+          filter.read_metadata = true;
+          filter.max_depth = 0u;
+          detail::walk_tree_parallel(directory_path, filter, [&](qpl::filesys::walk_entry&& entry, qpl::size) {
+            update.listing.emplace_back(std::move(entry));
+          }, 1u, nullptr);
+        }
+      };
+
+      std::vector<std::thread> threads;
+      for (qpl::size i = 1u; i < qpl::min(thread_count, qpl::max(qpl::size{ 1u }, updates.size())); ++i) {
+        threads.emplace_back(work);
+      }
+      work();
+      for (auto& thread : threads) {
+        thread.join();
+      }
+
+      qpl::size changes = 0u;
+      std::vector<std::string> new_directories;
+      for (auto& update : updates) {
+        auto it = this->m_entries.find(update.key);
+        if (it == this->m_entries.cend()) {
+          continue;
+        }
+        if (update.removed) {
+          if (update.key == this->m_root) {
+            changes += this->m_entries.size();
+            this->clear();
+            return changes;
+          }
+          auto parent = this->m_entries.find(update.key.substr(0, update.key.find_last_of('/')));
+          if (parent != this->m_entries.cend()) {
+            std::erase(parent->second.children, update.key);
+          }
+          changes += this->m_entries.size();
+          this->erase_recursively(update.key);
+          changes -= this->m_entries.size();
+          continue;
+        }
+        for (auto& file : update.changed_files) {
+          this->m_entries[file.first].last_write_time = file.second.last_write_time;
+          this->m_entries[file.first].file_size = file.second.file_size;
+          ++changes;
+        }
+        if (!update.relisted) {
+          continue;
+        }
+        it->second.last_write_time = update.last_write_time;
+
+        std::unordered_set<std::string> listed;
+        for (auto& child : update.listing) {
+          listed.insert(child.path);
+          auto found = this->m_entries.find(child.path);
+          if (found == this->m_entries.cend()) {
+            this->insert({ child });
+            ++changes;
+            if (child.is_directory) {
+              new_directories.push_back(child.path);
+            }
+          }
+          else if (!found->second.is_directory && (found->second.last_write_time != child.last_write_time || found->second.file_size != child.file_size)) {
+            found->second.last_write_time = child.last_write_time;
+            found->second.file_size = child.file_size;
+            ++changes;
+          }
+        }
+        auto children = this->m_entries[update.key].children;
+        for (auto& child : children) {
+          if (listed.find(child) == listed.cend()) {
+            changes += this->m_entries.size();
+            this->erase_recursively(child);
+            changes -= this->m_entries.size();
+            std::erase(this->m_entries[update.key].children, child);
+          }
+        }
+      }
+
+      qpl::filesys::walk_filter filter;
+      filter.read_metadata = true;
+      for (auto& directory : new_directories) {
+        auto entries = qpl::filesys::walk_directory_tree(directory, filter, thread_count);
+        this->insert(entries);
+        changes += entries.size();
+      }
+      return changes;
+    }
+    void qpl::filesys::metadata_cache::clear() {
+      this->m_entries.clear();
+      this->m_root.clear();
+    }
+    const qpl::filesys::metadata_cache::entry* qpl::filesys::metadata_cache::find(const qpl::filesys::path& path) const {
+      auto key = path.string();
+      while (key.size() > 1u && key.back() == '/') {
+        key.pop_back();
+      }
+      auto it = this->m_entries.find(key);
+      if (it == this->m_entries.cend()) {
+        return nullptr;
+      }
+      return &it->second;
+    }
+    bool qpl::filesys::metadata_cache::exists(const qpl::filesys::path& path) const {
+      return this->find(path) != nullptr;
+    }
+    bool qpl::filesys::metadata_cache::is_file(const qpl::filesys::path& path) const {
+      auto entry = this->find(path);
+      return entry && !entry->is_directory;
+    }
+    bool qpl::filesys::metadata_cache::is_directory(const qpl::filesys::path& path) const {
+      auto entry = this->find(path);
+      return entry && entry->is_directory;
+    }
+    qpl::u64 qpl::filesys::metadata_cache::file_size(const qpl::filesys::path& path) const {
+      auto entry = this->find(path);
+      return entry ? entry->file_size : qpl::u64{ 0u };
+    }
+    std::filesystem::file_time_type qpl::filesys::metadata_cache::last_write_time(const qpl::filesys::path& path) const {
+      auto entry = this->find(path);
+      return entry ? entry->last_write_time : std::filesystem::file_time_type{};
+    }
+    qpl::filesys::paths qpl::filesys::metadata_cache::search(const qpl::filesys::walk_filter& filter) const {
+      qpl::filesys::paths result;
+      for (auto& i : this->m_entries) {
+        if (i.first == this->m_root) {
+          continue;
+        }
+        bool is_directory = i.second.is_directory;
+        if (is_directory ? !filter.include_directories : !filter.include_files) {
+          continue;
+        }
+        if (filter.max_depth != qpl::size_max) {
+          auto depth = qpl::size_cast(std::count(i.first.cbegin() + this->m_root.size() + 1, i.first.cend(), '/'));
+          if (depth > filter.max_depth) {
+            continue;
+          }
+        }
+        if (!filter.accepts_name(detail::entry_name_view(i.first), is_directory)) {
+          continue;
+        }
+        if (filter.predicate) {
+          std::error_code ec;
+          std::filesystem::directory_entry entry(std::filesystem::path(qpl::utf8_to_wstring(i.first)), ec);
+          if (ec || !filter.predicate(entry)) {
+            continue;
+          }
+        }
+        result.push_back(qpl::filesys::path(i.first));
+      }
+      return result;
+    }
+    qpl::size qpl::filesys::metadata_cache::size() const {
+      return this->m_entries.size();
+    }
+    bool qpl::filesys::metadata_cache::empty() const {
+      return this->m_entries.empty();
+    }
+    const std::string& qpl::filesys::metadata_cache::root() const {
+      return this->m_root;
+    }
+    void qpl::filesys::metadata_cache::insert(const std::vector<qpl::filesys::walk_entry>& entries) {
+      //parallel walks don't report parents before their children, so every entry has to exist before linking
+      for (auto& i : entries) {
+        auto& entry = this->m_entries[i.path];
+        entry.is_directory = i.is_directory;
+        entry.file_size = i.file_size;
+        entry.last_write_time = i.last_write_time;
+      }
+      for (auto& i : entries) {
+        auto parent = this->m_entries.find(i.path.substr(0, i.path.find_last_of('/')));
+        if (parent != this->m_entries.cend()) {
+          parent->second.children.push_back(i.path);
+        }
+      }
+    }
+    void qpl::filesys::metadata_cache::erase_recursively(const std::string& key) {
+      auto it = this->m_entries.find(key);
+      if (it == this->m_entries.cend()) {
+        return;
+      }
+      auto children = std::move(it->second.children);
+      this->m_entries.erase(it);
+      for (auto& child : children) {
+        this->erase_recursively(child);
+      }
+    }
+
+    namespace detail {
+      //thread_count = 0 shares the default pool, otherwise a pool of that size is used for this call. exceptions are rethrown on the calling thread
+      template<typename F>
+      void parallel_for(qpl::size count, qpl::size thread_count, F&& function) {
+        if (!thread_count) {
+          qpl::default_thread_pool().parallel_for(count, function);
+          return;
+        }
+        if (thread_count == 1u || count <= 1u) {
+          for (qpl::size i = 0u; i < count; ++i) {
+            function(i);
+          }
+          return;
+        }
+        qpl::thread_pool pool(qpl::min(thread_count, count) - 1u);
+        pool.parallel_for(count, function);
+      }
+
+      constexpr qpl::size hash_read_size = 1u << 20;
+
+      struct index_hashes {
+        qpl::u64 partial_hash = 0u;
+        qpl::u64 full_hash = 0u;
+        bool has_full_hash = false;
+      };
+
+      //files that fit into head and tail get fully hashed in the same read, so the partial hash doubles as the full hash
+      index_hashes hash_index_file(const qpl::filesys::path& path, qpl::u64 file_size, qpl::size bytes) {
+        index_hashes result;
+        if (file_size <= bytes * 2u) {
+          result.full_hash = qpl::filesys::file_content_hash(path);
+          result.partial_hash = result.full_hash;
+          result.has_full_hash = true;
+        }
+        else {
+          result.partial_hash = qpl::filesys::file_partial_hash(path, bytes);
+        }
+        return result;
+      }
+    }
+
+    qpl::u64 qpl::filesys::file_partial_hash(const qpl::filesys::path& path, qpl::size bytes) {
+      std::ifstream file(path.wstring(), std::ios::ate | std::ios::binary);
+      if (!file.is_open()) {
+        throw qpl::exception("qpl::filesys::file_partial_hash: failed to open file \"", path.string(), "\"");
+      }
+      auto file_size = qpl::size_cast(file.tellg());
+      if (file_size <= bytes * 2u) {
+        file.close();
+        return qpl::filesys::file_content_hash(path);
+      }
+
+      qpl::xxh64 hash(file_size);
+      std::string buffer;
+      buffer.resize(bytes);
+
+      file.seekg(0);
+      file.read(buffer.data(), bytes);
+      hash.update(buffer);
+
+      file.seekg(file_size - bytes);
+      file.read(buffer.data(), bytes);
+      hash.update(buffer);
+      return hash.digest();
+    }
+    qpl::u64 qpl::filesys::file_content_hash(const qpl::filesys::path& path) {
+      std::ifstream file(path.wstring(), std::ios::binary);
+      if (!file.is_open()) {
+        throw qpl::exception("qpl::filesys::file_content_hash: failed to open file \"", path.string(), "\"");
+      }
+      qpl::xxh64 hash;
+      std::string buffer;
+      buffer.resize(detail::hash_read_size);
+      while (file) {
+        file.read(buffer.data(), buffer.size());
+        auto read = qpl::size_cast(file.gcount());
+        if (!read) {
+          break;
+        }
+        hash.update(std::string_view(buffer.data(), read));
+      }
+      return hash.digest();
+    }
+
+    bool qpl::filesys::file_index_difference::empty() const {
+      return this->added.empty() && this->removed.empty() && this->changed.empty() && this->failed.empty();
+    }
+
+    void qpl::filesys::file_index::build(const qpl::filesys::path& root, qpl::size thread_count) {
+      this->clear();
+      if (!root.exists()) {
+        return;
+      }
+      this->root = detail::native_path_to_utf8(detail::walk_root(root));
+      this->update(thread_count);
+    }
+    qpl::filesys::file_index_difference qpl::filesys::file_index::update(qpl::size thread_count) {
+      qpl::filesys::file_index_difference result;
+      if (this->root.empty()) {
+        return result;
+      }
+
+      qpl::filesys::walk_filter filter;
+      filter.include_directories = false;
+      filter.read_metadata = true;
+      auto files = qpl::filesys::walk_directory_tree(this->root, filter, thread_count);
+
+      std::unordered_set<std::string> listed;
+      listed.reserve(files.size());
+      std::vector<std::pair<std::string, entry>> work;
+      for (auto& file : files) {
+        //root can end in a separator itself ("/", "C:/"), so the prefix and every following '/' are stripped
+        auto key = file.path.substr(qpl::min(file.path.find_first_not_of('/', this->root.size()), file.path.size()));
+        auto it = this->entries.find(key);
+        if (it != this->entries.cend() && it->second.file_size == file.file_size && it->second.last_write_time == file.last_write_time) {
+          listed.insert(std::move(key));
+          continue;
+        }
+        entry entry;
+        entry.file_size = file.file_size;
+        entry.last_write_time = file.last_write_time;
+        work.emplace_back(key, entry);
+        listed.insert(std::move(key));
+      }
+
+      //a file can vanish or become unreadable between listing and hashing, it is reported as failed instead of aborting the scan
+      std::vector<char> failed(work.size(), false);
+      detail::parallel_for(work.size(), thread_count, [&](qpl::size index) {
+        auto& [key, entry] = work[index];
+        try {
+          auto path = this->full_path(key);
+          auto hashes = detail::hash_index_file(path, entry.file_size, this->partial_hash_bytes);
+          entry.partial_hash = hashes.partial_hash;
+          entry.full_hash = hashes.full_hash;
+          entry.has_full_hash = hashes.has_full_hash;
+
+          auto it = this->entries.find(key);
+          if (it != this->entries.cend() && it->second.has_full_hash && !entry.has_full_hash && it->second.file_size == entry.file_size && it->second.partial_hash == entry.partial_hash) {
+            entry.full_hash = qpl::filesys::file_content_hash(path);
+            entry.has_full_hash = true;
+          }
+        }
+        catch (...) {
+          failed[index] = true;
+        }
+      });
+
+      for (qpl::size i = 0u; i < work.size(); ++i) {
+        auto& [key, entry] = work[i];
+        //an indexed file that failed to hash still exists, its old entry is kept as it was
+        if (failed[i]) {
+          result.failed.push_back(key);
+          continue;
+        }
+        auto it = this->entries.find(key);
+        if (it == this->entries.cend()) {
+          result.added.push_back(key);
+          this->entries.emplace(key, entry);
+          continue;
+        }
+        auto& old = it->second;
+        bool same_content = old.file_size == entry.file_size && old.partial_hash == entry.partial_hash && old.has_full_hash && entry.has_full_hash && old.full_hash == entry.full_hash;
+        if (!same_content) {
+          result.changed.push_back(key);
+        }
+        old = entry;
+      }
+      for (auto it = this->entries.begin(); it != this->entries.end();) {
+        if (listed.find(it->first) == listed.cend()) {
+          result.removed.push_back(it->first);
+          it = this->entries.erase(it);
+        }
+        else {
+          ++it;
+        }
+      }
+      return result;
+    }
+    void qpl::filesys::file_index::clear() {
+      this->entries.clear();
+      this->root.clear();
+    }
+    void qpl::filesys::file_index::save(qpl::save_state& state) const {
+      state.save(this->root);
+      state.save(this->partial_hash_bytes);
+      state.save(this->entries.size());
+      for (auto& [key, entry] : this->entries) {
+        std::array<qpl::u64, 4> values = { entry.file_size, qpl::u64_cast(entry.last_write_time.time_since_epoch().count()), entry.partial_hash, entry.full_hash };
+        state.save(key);
+        state.save(values);
+        state.save(entry.has_full_hash);
+      }
+    }
+    void qpl::filesys::file_index::load(qpl::load_state& state) {
+      this->clear();
+      qpl::size size;
+      state.load(this->root);
+      state.load(this->partial_hash_bytes);
+      state.load(size);
+      this->entries.reserve(size);
+      for (qpl::size i = 0u; i < size; ++i) {
+        std::string key;
+        std::array<qpl::u64, 4> values;
+        entry entry;
+        state.load(key);
+        state.load(values);
+        state.load(entry.has_full_hash);
+        entry.file_size = values[0];
+        entry.last_write_time = std::filesystem::file_time_type(std::filesystem::file_time_type::duration(static_cast<std::filesystem::file_time_type::rep>(values[1])));
+        entry.partial_hash = values[2];
+        entry.full_hash = values[3];
+        this->entries.emplace(std::move(key), entry);
+      }
+    }
+    void qpl::filesys::file_index::file_save(const qpl::filesys::path& path) const {
+      qpl::save_state state;
+      this->save(state);
+      state.file_save(path.string());
+    }
+    void qpl::filesys::file_index::file_load(const qpl::filesys::path& path) {
+      qpl::load_state state;
+      state.file_load(path.string());
+      this->load(state);
+    }
+    std::vector<std::string> qpl::filesys::file_index::ensure_full_hashes(const std::vector<std::string>& relative_paths, qpl::size thread_count) {
+      std::vector<entry*> missing;
+      std::vector<const std::string*> keys;
+      for (auto& key : relative_paths) {
+        auto it = this->entries.find(key);
+        if (it != this->entries.cend() && !it->second.has_full_hash) {
+          missing.push_back(&it->second);
+          keys.push_back(&it->first);
+        }
+      }
+      std::vector<char> failed(missing.size(), false);
+      detail::parallel_for(missing.size(), thread_count, [&](qpl::size index) {
+        try {
+          missing[index]->full_hash = qpl::filesys::file_content_hash(this->full_path(*keys[index]));
+          missing[index]->has_full_hash = true;
+        }
+        catch (...) {
+          failed[index] = true;
+        }
+      });
+
+      std::vector<std::string> result;
+      for (qpl::size i = 0u; i < missing.size(); ++i) {
+        if (failed[i]) {
+          result.push_back(*keys[i]);
+        }
+      }
+      return result;
+    }
+    std::vector<qpl::filesys::paths> qpl::filesys::file_index::duplicate_groups(qpl::size thread_count) {
+      std::unordered_map<qpl::u64, std::vector<const std::string*>> partial_groups;
+      for (auto& [key, entry] : this->entries) {
+        partial_groups[entry.partial_hash ^ qpl::xxh64::round(0u, entry.file_size)].push_back(&key);
+      }
+
+      std::vector<std::string> candidates;
+      for (auto& group : partial_groups) {
+        if (group.second.size() > 1u) {
+          for (auto& key : group.second) {
+            candidates.push_back(*key);
+          }
+        }
+      }
+      this->ensure_full_hashes(candidates, thread_count);
+
+      std::map<std::pair<qpl::u64, qpl::u64>, std::vector<std::string>> full_groups;
+      for (auto& key : candidates) {
+        auto& entry = this->entries.at(key);
+        if (!entry.has_full_hash) {
+          continue;
+        }
+        full_groups[std::make_pair(entry.file_size, entry.full_hash)].push_back(key);
+      }
+
+      std::vector<qpl::filesys::paths> result;
+      for (auto& group : full_groups) {
+        if (group.second.size() > 1u) {
+          qpl::filesys::paths paths;
+          paths.reserve(group.second.size());
+          for (auto& key : group.second) {
+            paths.push_back(this->full_path(key));
+          }
+          result.push_back(paths);
+        }
+      }
+      return result;
+    }
+    qpl::filesys::file_index_difference qpl::filesys::file_index::difference(qpl::filesys::file_index& other, qpl::size thread_count) {
+      qpl::filesys::file_index_difference result;
+      std::vector<std::string> candidates;
+
+      //partial hashes over a different number of bytes can't be compared, only sizes and full hashes can
+      bool same_partial = this->partial_hash_bytes == other.partial_hash_bytes;
+      for (auto& [key, entry] : this->entries) {
+        auto it = other.entries.find(key);
+        if (it == other.entries.cend()) {
+          result.removed.push_back(key);
+        }
+        else if (it->second.file_size != entry.file_size || (same_partial && it->second.partial_hash != entry.partial_hash)) {
+          result.changed.push_back(key);
+        }
+        else if (!entry.has_full_hash || !it->second.has_full_hash) {
+          candidates.push_back(key);
+        }
+        else if (it->second.full_hash != entry.full_hash) {
+          result.changed.push_back(key);
+        }
+      }
+      for (auto& [key, entry] : other.entries) {
+        if (this->entries.find(key) == this->entries.cend()) {
+          result.added.push_back(key);
+        }
+      }
+
+      auto failed = this->ensure_full_hashes(candidates, thread_count);
+      auto other_failed = other.ensure_full_hashes(candidates, thread_count);
+      failed.insert(failed.end(), other_failed.begin(), other_failed.end());
+      std::sort(failed.begin(), failed.end());
+      failed.erase(std::unique(failed.begin(), failed.end()), failed.end());
+
+      for (auto& key : candidates) {
+        if (std::binary_search(failed.cbegin(), failed.cend(), key)) {
+          continue;
+        }
+        if (this->entries.at(key).full_hash != other.entries.at(key).full_hash) {
+          result.changed.push_back(key);
+        }
+      }
+      result.failed = std::move(failed);
+      return result;
+    }
+    const qpl::filesys::file_index::entry* qpl::filesys::file_index::find(const std::string& relative_path) const {
+      auto it = this->entries.find(relative_path);
+      if (it == this->entries.cend()) {
+        return nullptr;
+      }
+      return &it->second;
+    }
+    qpl::filesys::path qpl::filesys::file_index::full_path(const std::string& relative_path) const {
+      if (!this->root.empty() && this->root.back() == '/') {
+        return qpl::filesys::path(qpl::to_string(this->root, relative_path));
+      }
+      return qpl::filesys::path(qpl::to_string(this->root, '/', relative_path));
+    }
+    qpl::size qpl::filesys::file_index::size() const {
+      return this->entries.size();
+    }
+    bool qpl::filesys::file_index::empty() const {
+      return this->entries.empty();
+    }
+  }
+
+  std::string qpl::read_file(const std::string& path) {
+    return qpl::filesys::read_file(path);
+  }
+  std::wstring qpl::wread_file(const std::wstring& path) {
+    return qpl::filesys::wread_file(path);
+  }
+  void qpl::write_to_file(const std::string& text, const std::string& path) {
+    return qpl::filesys::write_to_file(text, path);
+  }
+  void qpl::write_data_file(const std::string& data, const std::string& path) {
+    return qpl::filesys::write_data_file(data, path);
+  }
+  void qpl::write_text_file(const std::string& data, const std::string& path) {
+    return qpl::filesys::write_text_file(data, path);
+  }
+
+  void qpl::file_encrypter::clear() {
+    this->paths.clear();
+    this->additions = 0u;
+    this->part_paths.clear();
+  }
+  void qpl::file_encrypter::add(std::string path) {
+    auto file_path = qpl::filesys::path(path);
+
+    auto adding = file_path.get_file_extension().starts_with(this->keyword_string_part);
+
+    if (adding) {
+      if (!this->adding_parts) {
+        ++this->additions;
+      }
+      auto name = file_path.get_file_name();
+      this->part_paths[name].push_back(file_path);
+    }
+    else {
+      this->paths.push_back(path);
+      ++this->additions;
+    }
+    this->adding_parts = adding;
+
+    if (this->common_branch.empty()) {
+      this->common_branch = path;
+    }
+    else {
+      this->common_branch = this->common_branch.get_common_branch(path);
     }
 
     if (file_path.is_file()) {
@@ -3029,4 +3916,509 @@ namespace qpl {
     }
     return {};
   }
+  namespace detail {
+    constexpr std::string_view archive_magic = "QPLARC03";
+    constexpr qpl::size archive_salt_size = 16u;
+    constexpr qpl::size archive_header_size = archive_magic.size() + archive_salt_size;
+    constexpr qpl::size archive_mac_size = 64u;
+    constexpr qpl::size archive_trailer_size = 3 * sizeof(qpl::u64) + archive_mac_size + archive_magic.size();
+    constexpr qpl::size archive_nonce_size = archive_salt_size + 2 * sizeof(qpl::u64);
+    constexpr qpl::u64 archive_index_file = qpl::u64_max;
+
+    //random per archive, so the same files packed twice with the same key don't give the same ciphertext
+    std::string archive_salt() {
+      std::array<qpl::u32, archive_salt_size / sizeof(qpl::u32)> salt;
+      std::random_device source;
+      std::generate(salt.begin(), salt.end(), std::ref(source));
+      return qpl::container_memory_to_string(salt);
+    }
+
+    //every chunk starts with a nonce block made of the archive salt, its file index and chunk number.
+    //aes runs in cbc mode from a zero iv, so the encrypted nonce acts as an iv unique to the archive and chunk
+    std::string archive_nonce(const std::string& salt, qpl::u64 file, qpl::u64 chunk) {
+      std::array<qpl::u64, 2> position = { file, chunk };
+      return salt + qpl::container_memory_to_string(position);
+    }
+
+    //keyed hash, nested so it can't be length extended
+    std::string archive_mac(const std::string& key, const std::string_view& data) {
+      auto inner = qpl::sha256_hash(qpl::to_string(key, data));
+      return qpl::sha256_hash(qpl::to_string(key, inner));
+    }
+    bool archive_mac_equal(const std::string_view& a, const std::string_view& b) {
+      if (a.size() != b.size()) {
+        return false;
+      }
+      qpl::u8 difference = 0u;
+      for (qpl::size i = 0u; i < a.size(); ++i) {
+        difference |= qpl::u8_cast(a[i] ^ b[i]);
+      }
+      return !difference;
+    }
+
+    //the ciphertext of a chunk is followed by a mac over its nonce and the ciphertext
+    constexpr qpl::u64 archive_encrypted_size(qpl::u64 size) {
+      return ((size + archive_nonce_size + 15u) / 16u) * 16u + archive_mac_size;
+    }
+    std::string archive_encrypted(const std::string_view& data, const std::string& salt, qpl::u64 file, qpl::u64 chunk, const std::string& key, qpl::aes::mode mode) {
+      thread_local qpl::aes cipher;
+      cipher.set_mode(mode);
+      auto nonce = archive_nonce(salt, file, chunk);
+      auto message = nonce;
+      message.append(data);
+      auto result = cipher.encrypted(reinterpret_cast<const qpl::u8*>(message.data()), message.size(), key);
+      result.append(archive_mac(key, nonce + result));
+      return result;
+    }
+    std::string archive_decrypted(const std::string_view& data, qpl::u64 size, const std::string& salt, qpl::u64 file, qpl::u64 chunk, const std::string& key, qpl::aes::mode mode) {
+      auto nonce = archive_nonce(salt, file, chunk);
+      if (data.size() < archive_mac_size) {
+        throw qpl::exception("qpl::encrypted_archive_reader: chunk ", chunk, " of file ", file, " is truncated");
+      }
+      auto encrypted = data.substr(0u, data.size() - archive_mac_size);
+      if (!archive_mac_equal(data.substr(encrypted.size()), archive_mac(key, nonce + std::string(encrypted)))) {
+        throw qpl::exception("qpl::encrypted_archive_reader: chunk ", chunk, " of file ", file, " failed authentication");
+      }
+
+      thread_local qpl::aes cipher;
+      cipher.set_mode(mode);
+      auto result = cipher.decrypted(reinterpret_cast<const qpl::u8*>(encrypted.data()), encrypted.size(), key);
+      if (result.size() < archive_nonce_size + size || std::string_view(result).substr(0u, archive_nonce_size) != nonce) {
+        throw qpl::exception("qpl::encrypted_archive_reader: chunk ", chunk, " of file ", file, " failed to decrypt");
+      }
+      result.erase(0u, archive_nonce_size);
+      result.resize(size);
+      return result;
+    }
+
+    class archive_output {
+    public:
+      archive_output(const std::string& base, qpl::size split_size, const std::string& part_keyword) : m_base(base), m_part_keyword(part_keyword), m_split_size(split_size) {
+
+      }
+      //parts are written under a temporary name and only renamed by commit(), a failed write removes them
+      ~archive_output() {
+        this->close();
+        if (this->m_committed) {
+          return;
+        }
+        for (auto& path : this->m_temporary) {
+          std::error_code error;
+          std::filesystem::remove(path.wstring(), error);
+        }
+      }
+      void write(std::string_view data) {
+        while (!data.empty()) {
+          if (!this->m_file.is_open() || this->m_part_written == this->m_split_size) {
+            this->next_part();
+          }
+          auto size = qpl::min(data.size(), this->m_split_size - this->m_part_written);
+          this->m_file.write(data.data(), size);
+          this->m_part_written += size;
+          this->position += size;
+          data.remove_prefix(size);
+        }
+      }
+      void close() {
+        if (this->m_file.is_open()) {
+          this->m_file.close();
+        }
+      }
+      void commit() {
+        this->close();
+        for (qpl::size i = 0u; i < this->paths.size(); ++i) {
+          qpl::filesys::rename(this->m_temporary[i], this->paths[i]);
+        }
+        this->m_committed = true;
+      }
+
+      qpl::u64 position = 0u;
+      qpl::filesys::paths paths;
+
+    private:
+      void next_part() {
+        this->close();
+        qpl::filesys::path path = this->m_base;
+        if (this->m_split_size != qpl::size_max) {
+          path.append(qpl::to_string('.', this->m_part_keyword, this->paths.size()));
+        }
+        qpl::filesys::path temporary = qpl::to_string(path, ".tmp");
+        this->m_file.open(temporary.wstring(), std::ios::binary);
+        if (!this->m_file.is_open()) {
+          throw qpl::exception("qpl::encrypted_archive_writer: failed to open \"", temporary.string(), "\"");
+        }
+        this->m_part_written = 0u;
+        this->paths.push_back(path);
+        this->m_temporary.push_back(temporary);
+      }
+
+      std::ofstream m_file;
+      std::string m_base;
+      std::string m_part_keyword;
+      qpl::size m_split_size = qpl::size_max;
+      qpl::size m_part_written = 0u;
+      qpl::filesys::paths m_temporary;
+      bool m_committed = false;
+    };
+  }
+
+  void qpl::encrypted_archive_writer::clear() {
+    this->paths.clear();
+    this->common_branch.clear();
+  }
+  void qpl::encrypted_archive_writer::add(const qpl::filesys::path& path) {
+    auto add_single = [&](qpl::filesys::path path) {
+      if (path.is_directory() && path.string().back() != '/') {
+        path.append("/");
+      }
+      this->paths.push_back(path);
+      if (this->common_branch.empty()) {
+        this->common_branch = path;
+      }
+      else {
+        this->common_branch = this->common_branch.get_common_branch(path);
+      }
+    };
+    add_single(path);
+    if (path.is_file()) {
+      return;
+    }
+    for (auto& i : path.list_current_directory_tree()) {
+      add_single(i);
+    }
+  }
+  qpl::filesys::paths qpl::encrypted_archive_writer::write(const std::string& key, const std::string& output_name, qpl::filesys::path destination_path, qpl::size split_size) {
+    if (!destination_path.empty() && destination_path.string().back() != '/') {
+      destination_path.append("/");
+    }
+    if (this->paths.empty()) {
+      return {};
+    }
+    split_size = qpl::max(split_size, qpl::size{ 1u });
+
+    auto first_part = [&](const std::string& base) {
+      if (split_size == qpl::size_max) {
+        return qpl::filesys::path(base);
+      }
+      return qpl::filesys::path(qpl::to_string(base, '.', this->keyword_string_part, 0));
+    };
+    auto base = qpl::to_string(destination_path, output_name, '.', this->keyword_string_enrypted);
+    qpl::size ctr = 0u;
+    while (first_part(base).exists()) {
+      base = qpl::to_string(destination_path, output_name, '.', this->keyword_string_enrypted, ctr);
+      ++ctr;
+    }
+
+    auto common = this->common_branch.string();
+    while (common.size() > 1u && common.back() == '/') {
+      common.pop_back();
+    }
+    auto prefix = common.substr(0, common.find_last_of('/') + 1);
+
+    std::vector<qpl::encrypted_archive_reader::file_info> files(this->paths.size());
+    for (qpl::size i = 0u; i < files.size(); ++i) {
+      auto string = this->paths[i].string();
+      files[i].path = string.starts_with(prefix) ? string.substr(prefix.size()) : string;
+      files[i].is_file = this->paths[i].is_file();
+    }
+
+    auto salt = detail::archive_salt();
+    detail::archive_output output(base, split_size, this->keyword_string_part);
+    output.write(detail::archive_magic);
+    output.write(salt);
+
+    qpl::thread_pool pool(this->thread_count);
+    auto max_in_flight = pool.size() * 2u;
+    auto mode = this->mode;
+
+    struct chunk_job {
+      std::future<std::string> encrypted;
+      qpl::size file;
+      qpl::u64 size;
+    };
+    std::deque<chunk_job> in_flight;
+    auto drain = [&]() {
+      auto& job = in_flight.front();
+      auto encrypted = job.encrypted.get();
+      files[job.file].chunks.push_back({ output.position, encrypted.size(), job.size });
+      output.write(encrypted);
+      in_flight.pop_front();
+    };
+
+    for (qpl::size i = 0u; i < files.size(); ++i) {
+      if (!files[i].is_file) {
+        continue;
+      }
+      std::ifstream file(this->paths[i].wstring(), std::ios::binary);
+      if (!file.is_open()) {
+        throw qpl::exception("qpl::encrypted_archive_writer: failed to open file \"", this->paths[i].string(), "\"");
+      }
+      qpl::u64 chunk = 0u;
+      while (file) {
+        std::string buffer;
+        buffer.resize(this->chunk_size);
+        file.read(buffer.data(), buffer.size());
+        auto read = qpl::size_cast(file.gcount());
+        if (!read) {
+          break;
+        }
+        buffer.resize(read);
+        files[i].file_size += read;
+
+        auto encrypted = pool.submit([buffer = std::move(buffer), file = qpl::u64_cast(i), chunk, &salt, &key, mode]() {
+          return detail::archive_encrypted(buffer, salt, file, chunk, key, mode);
+        });
+        in_flight.push_back({ std::move(encrypted), i, read });
+        ++chunk;
+        while (in_flight.size() >= max_in_flight) {
+          drain();
+        }
+      }
+    }
+    while (!in_flight.empty()) {
+      drain();
+    }
+
+    qpl::save_state state;
+    state.save(files.size());
+    for (auto& file : files) {
+      std::vector<std::array<qpl::u64, 3>> chunks(file.chunks.size());
+      for (qpl::size i = 0u; i < chunks.size(); ++i) {
+        chunks[i] = { file.chunks[i].offset, file.chunks[i].encrypted_size, file.chunks[i].size };
+      }
+      state.save(file.path, file.file_size, file.is_file, chunks);
+    }
+    auto index = state.get_finalized_string();
+    auto encrypted_index = detail::archive_encrypted(index, salt, detail::archive_index_file, 0u, key, mode);
+
+    std::array<qpl::u64, 3> trailer = { output.position, encrypted_index.size(), index.size() };
+    auto trailer_string = qpl::container_memory_to_string(trailer);
+    output.write(encrypted_index);
+    output.write(trailer_string);
+    output.write(detail::archive_mac(key, salt + encrypted_index + trailer_string));
+    output.write(detail::archive_magic);
+    output.commit();
+
+    this->clear();
+    return output.paths;
+  }
+
+  void qpl::encrypted_archive_reader::open(const qpl::filesys::path& path, const std::string& key) {
+    this->clear();
+    this->m_key = key;
+
+    if (path.get_file_extension().starts_with(this->keyword_string_part)) {
+      auto name = path.get_file_name();
+      std::vector<std::pair<qpl::size, qpl::filesys::path>> sorted_parts;
+      for (auto& i : path.list_current_directory()) {
+        if (i.is_file() && i.get_file_name() == name && i.get_file_extension().starts_with(this->keyword_string_part)) {
+          sorted_parts.emplace_back(qpl::size_cast(i.get_file_extension().substr(this->keyword_string_part.length())), i);
+        }
+      }
+      qpl::sort(sorted_parts, [](const auto& a, const auto& b) {
+        return a.first < b.first;
+      });
+      for (auto& i : sorted_parts) {
+        this->m_parts.push_back({ i.second, this->m_size, i.second.file_size() });
+        this->m_size += this->m_parts.back().size;
+      }
+    }
+    else {
+      this->m_parts.push_back({ path, 0u, path.file_size() });
+      this->m_size = this->m_parts.back().size;
+    }
+
+    if (this->m_size < detail::archive_header_size + detail::archive_trailer_size) {
+      throw qpl::exception("qpl::encrypted_archive_reader: \"", path.string(), "\" is not an archive");
+    }
+    auto header = this->read_range(0u, detail::archive_header_size);
+    if (std::string_view(header).substr(0u, detail::archive_magic.size()) != detail::archive_magic) {
+      throw qpl::exception("qpl::encrypted_archive_reader: \"", path.string(), "\" is not an archive");
+    }
+    this->m_salt = header.substr(detail::archive_magic.size());
+    auto trailer_string = this->read_range(this->m_size - detail::archive_trailer_size, detail::archive_trailer_size);
+    auto trailer_view = std::string_view(trailer_string);
+    if (trailer_view.substr(3 * sizeof(qpl::u64) + detail::archive_mac_size) != detail::archive_magic) {
+      throw qpl::exception("qpl::encrypted_archive_reader: \"", path.string(), "\" is incomplete");
+    }
+    std::array<qpl::u64, 3> trailer;
+    memcpy(trailer.data(), trailer_string.data(), 3 * sizeof(qpl::u64));
+
+    //nothing of the index is trusted before its sizes line up and the mac matches
+    auto index_end = this->m_size - detail::archive_trailer_size;
+    if (trailer[0] < detail::archive_header_size || trailer[0] > index_end || trailer[1] != index_end - trailer[0] || trailer[2] > trailer[1] || trailer[1] != detail::archive_encrypted_size(trailer[2])) {
+      throw qpl::exception("qpl::encrypted_archive_reader: corrupted index in \"", path.string(), "\"");
+    }
+    auto encrypted_index = this->read_range(trailer[0], trailer[1]);
+    auto mac = detail::archive_mac(key, this->m_salt + encrypted_index + std::string(trailer_view.substr(0u, 3 * sizeof(qpl::u64))));
+    if (!detail::archive_mac_equal(trailer_view.substr(3 * sizeof(qpl::u64), detail::archive_mac_size), mac)) {
+      throw qpl::exception("qpl::encrypted_archive_reader: wrong key or corrupted index in \"", path.string(), "\"");
+    }
+
+    auto index = detail::archive_decrypted(encrypted_index, trailer[2], this->m_salt, detail::archive_index_file, 0u, key, this->mode);
+    qpl::load_state state;
+    try {
+      state.set_string(index);
+    }
+    catch (...) {
+      throw qpl::exception("qpl::encrypted_archive_reader: wrong key or corrupted index in \"", path.string(), "\"");
+    }
+
+    qpl::size size;
+    state.load(size);
+    this->m_files.resize(size);
+    for (qpl::size i = 0u; i < size; ++i) {
+      auto& file = this->m_files[i];
+      std::vector<std::array<qpl::u64, 3>> chunks;
+      state.load(file.path, file.file_size, file.is_file, chunks);
+      file.chunks.resize(chunks.size());
+      qpl::u64 total = 0u;
+      for (qpl::size c = 0u; c < chunks.size(); ++c) {
+        file.chunks[c] = { chunks[c][0], chunks[c][1], chunks[c][2] };
+        auto& chunk = file.chunks[c];
+        if (chunk.offset < detail::archive_header_size || chunk.offset > trailer[0] || chunk.encrypted_size > trailer[0] - chunk.offset || chunk.size > chunk.encrypted_size || chunk.encrypted_size != detail::archive_encrypted_size(chunk.size)) {
+          throw qpl::exception("qpl::encrypted_archive_reader: corrupted chunk ", c, " of \"", file.path, "\" in \"", path.string(), "\"");
+        }
+        total += chunk.size;
+      }
+      if (total != file.file_size) {
+        throw qpl::exception("qpl::encrypted_archive_reader: corrupted size of \"", file.path, "\" in \"", path.string(), "\"");
+      }
+      this->m_lookup[file.path] = i;
+    }
+  }
+  void qpl::encrypted_archive_reader::clear() {
+    this->m_parts.clear();
+    this->m_streams.clear();
+    this->m_files.clear();
+    this->m_lookup.clear();
+    this->m_key.clear();
+    this->m_salt.clear();
+    this->m_size = 0u;
+  }
+  const std::vector<qpl::encrypted_archive_reader::file_info>& qpl::encrypted_archive_reader::files() const {
+    return this->m_files;
+  }
+  const qpl::encrypted_archive_reader::file_info* qpl::encrypted_archive_reader::find(const std::string& relative_path) const {
+    auto it = this->m_lookup.find(relative_path);
+    if (it == this->m_lookup.cend()) {
+      return nullptr;
+    }
+    return &this->m_files[it->second];
+  }
+  std::string qpl::encrypted_archive_reader::read_file(const std::string& relative_path) {
+    auto file = this->find(relative_path);
+    if (!file) {
+      throw qpl::exception("qpl::encrypted_archive_reader::read_file: \"", relative_path, "\" is not in the archive");
+    }
+    std::ostringstream stream;
+    this->write_file(*file, stream);
+    return stream.str();
+  }
+  qpl::filesys::path qpl::encrypted_archive_reader::extract_file(const std::string& relative_path, qpl::filesys::path destination_path) {
+    if (!destination_path.empty() && destination_path.string().back() != '/') {
+      destination_path.append("/");
+    }
+    auto file = this->find(relative_path);
+    if (!file) {
+      throw qpl::exception("qpl::encrypted_archive_reader::extract_file: \"", relative_path, "\" is not in the archive");
+    }
+    qpl::filesys::path path = qpl::to_string(destination_path, file->path);
+    path.ensure_branches_exist();
+    if (file->is_file) {
+      std::ofstream stream(path.wstring(), std::ios::binary);
+      this->write_file(*file, stream);
+    }
+    return path;
+  }
+  qpl::filesys::paths qpl::encrypted_archive_reader::extract_all(qpl::filesys::path destination_path) {
+    if (!destination_path.empty() && destination_path.string().back() != '/') {
+      destination_path.append("/");
+    }
+    qpl::filesys::paths tree;
+    for (auto& file : this->m_files) {
+      qpl::filesys::path path = qpl::to_string(destination_path, file.path);
+      path.ensure_branches_exist();
+      if (file.is_file) {
+        std::ofstream stream(path.wstring(), std::ios::binary);
+        this->write_file(file, stream);
+      }
+      tree.push_back(path);
+    }
+    return tree;
+  }
+  std::string qpl::encrypted_archive_reader::read_range(qpl::u64 offset, qpl::u64 size) const {
+    std::string result;
+    result.resize(size);
+    qpl::u64 written = 0u;
+    for (qpl::size i = 0u; i < this->m_parts.size(); ++i) {
+      auto& part = this->m_parts[i];
+      if (written == size) {
+        break;
+      }
+      if (offset + written >= part.offset + part.size) {
+        continue;
+      }
+      auto local = offset + written - part.offset;
+      auto count = qpl::min(size - written, part.size - local);
+
+      if (this->m_streams.size() != this->m_parts.size()) {
+        this->m_streams.resize(this->m_parts.size());
+      }
+      auto& file = this->m_streams[i];
+      if (!file.is_open()) {
+        file.open(part.path.wstring(), std::ios::binary);
+        if (!file.is_open()) {
+          throw qpl::exception("qpl::encrypted_archive_reader: failed to open \"", part.path.string(), "\"");
+        }
+      }
+      file.clear();
+      file.seekg(local);
+      file.read(result.data() + written, count);
+      if (qpl::u64_cast(file.gcount()) != count) {
+        throw qpl::exception("qpl::encrypted_archive_reader: failed to read \"", part.path.string(), "\"");
+      }
+      written += count;
+    }
+    if (written != size) {
+      throw qpl::exception("qpl::encrypted_archive_reader: archive is truncated");
+    }
+    return result;
+  }
+  qpl::thread_pool& qpl::encrypted_archive_reader::pool() {
+    if (!this->m_pool) {
+      this->m_pool = std::make_unique<qpl::thread_pool>(this->thread_count);
+    }
+    else if (this->m_pool_thread_count != this->thread_count) {
+      this->m_pool->start(this->thread_count);
+    }
+    this->m_pool_thread_count = this->thread_count;
+    return *this->m_pool;
+  }
+  void qpl::encrypted_archive_reader::write_file(const file_info& file, std::ostream& stream) {
+    auto& pool = this->pool();
+    auto max_in_flight = pool.size() * 2u;
+    auto mode = this->mode;
+    const auto& key = this->m_key;
+    const auto& salt = this->m_salt;
+
+    auto index = qpl::u64_cast(&file - this->m_files.data());
+
+    std::deque<std::future<std::string>> in_flight;
+    for (qpl::size c = 0u; c < file.chunks.size(); ++c) {
+      auto& chunk = file.chunks[c];
+      auto encrypted = this->read_range(chunk.offset, chunk.encrypted_size);
+      in_flight.push_back(pool.submit([encrypted = std::move(encrypted), size = chunk.size, index, chunk = qpl::u64_cast(c), &salt, &key, mode]() {
+        return detail::archive_decrypted(encrypted, size, salt, index, chunk, key, mode);
+      }));
+      while (in_flight.size() >= max_in_flight) {
+        stream << in_flight.front().get();
+        in_flight.pop_front();
+      }
+    }
+    while (!in_flight.empty()) {
+      stream << in_flight.front().get();
+      in_flight.pop_front();
+    }
+  }
 }
\ No newline at end of file
@@ -1,8 +1,314 @@
 #include <qpl/maths.hpp>
 #include <qpl/algorithm.hpp>
 #include <qpl/string.hpp>
+#include <qpl/thread_pool.hpp>
+
+#include <bit>
+#include <cstring>
+#include <numeric>
+#include <span>
+
+#if defined _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace qpl {
+	namespace {
+		qpl::u64 mul_mod(qpl::u64 a, qpl::u64 b, qpl::u64 mod) {
+#if defined _MSC_VER
+			qpl::u64 high;
+			auto low = _umul128(a, b, &high);
+			qpl::u64 remainder;
+			_udiv128(high, low, mod, &remainder);
+			return remainder;
+#else
+			return static_cast<qpl::u64>(static_cast<unsigned __int128>(a) * b % mod);
+#endif
+		}
+		qpl::u64 pow_mod(qpl::u64 base, qpl::u64 exponent, qpl::u64 mod) {
+			qpl::u64 result = 1u;
+			base %= mod;
+			while (exponent) {
+				if (exponent & 1u) {
+					result = mul_mod(result, base, mod);
+				}
+				base = mul_mod(base, base, mod);
+				exponent >>= 1u;
+			}
+			return result;
+		}
+
+		qpl::u64 isqrt(qpl::u64 value) {
+			auto result = qpl::min(static_cast<qpl::u64>(std::sqrt(static_cast<long double>(value))), qpl::u64{ 0xFFFF'FFFFu });
+			while (result * result > value) {
+				--result;
+			}
+			while (result < 0xFFFF'FFFFu && (result + 1u) * (result + 1u) <= value) {
+				++result;
+			}
+			return result;
+		}
+
+		//one byte per odd number, 32 KiB fits the L1 data cache
+		constexpr qpl::size sieve_segment_size = 32768u;
+		constexpr std::array<qpl::u64, 6u> wheel_primes = { 2u, 3u, 5u, 7u, 11u, 13u };
+		constexpr qpl::size wheel_period = 3u * 5u * 7u * 11u * 13u;
+
+		//index j stands for the odd number 2j + 1, the pattern repeats every wheel_period indices
+		const std::vector<qpl::u8>& wheel_pattern() {
+			static const std::vector<qpl::u8> pattern = []() {
+				std::vector<qpl::u8> result(wheel_period);
+				for (qpl::size j = 0u; j < wheel_period; ++j) {
+					auto value = 2u * j + 1u;
+					result[j] = (value % 3u && value % 5u && value % 7u && value % 11u && value % 13u) ? 1u : 0u;
+				}
+				return result;
+			}();
+			return pattern;
+		}
+
+		std::vector<qpl::u32> base_primes(qpl::u64 limit) {
+			std::vector<qpl::u32> result;
+			if (limit < 2u) {
+				return result;
+			}
+			result.push_back(2u);
+			std::vector<qpl::u8> composite(qpl::size_cast(limit / 2u + 1u));
+			for (qpl::u64 i = 3u; i <= limit; i += 2u) {
+				if (composite[qpl::size_cast(i / 2u)]) {
+					continue;
+				}
+				result.push_back(qpl::u32_cast(i));
+				for (auto j = i * i; j <= limit; j += 2u * i) {
+					composite[qpl::size_cast(j / 2u)] = 1u;
+				}
+			}
+			return result;
+		}
+
+		//sieves the odd numbers low, low + 2, ... (size of them). primes must not contain the wheel primes
+		void sieve_segment(qpl::u64 low, qpl::size size, std::span<const qpl::u32> primes, std::vector<qpl::u8>& sieve) {
+			sieve.resize(size);
+			const auto& pattern = wheel_pattern();
+			auto offset = qpl::size_cast(((low - 1u) / 2u) % wheel_period);
+			for (qpl::size i = 0u; i < size;) {
+				auto count = qpl::min(size - i, wheel_period - offset);
+				std::memcpy(sieve.data() + i, pattern.data() + offset, count);
+				i += count;
+				offset = 0u;
+			}
+
+			auto high = low + 2u * size;
+			for (auto prime : primes) {
+				auto p = qpl::u64{ prime };
+				auto start = p * p;
+				if (start >= high) {
+					break;
+				}
+				if (start < low) {
+					start = (low + p - 1u) / p * p;
+					if (start % 2u == 0u) {
+						start += p;
+					}
+				}
+				for (auto j = qpl::size_cast((start - low) / 2u); j < size; j += prime) {
+					sieve[j] = 0u;
+				}
+			}
+		}
+
+		//runs function(low, sieve) for every segment of [begin, end) above the wheel primes in parallel and collects the results in order
+		template<typename R, typename F>
+		std::vector<R> sieve_segments(qpl::u64 begin, qpl::u64 end, F&& function) {
+			auto low = qpl::max(begin, qpl::u64{ 17u });
+			if (low % 2u == 0u) {
+				++low;
+			}
+			if (low >= end) {
+				return {};
+			}
+			auto primes = base_primes(isqrt(end - 1u));
+			auto first = std::find_if(primes.cbegin(), primes.cend(), [](qpl::u32 p) {
+				return p > 13u;
+			});
+			std::span<const qpl::u32> sieving_primes(first, primes.cend());
+
+			auto odd_count = (end - low + 1u) / 2u;
+			auto segments = qpl::size_cast((odd_count + sieve_segment_size - 1u) / sieve_segment_size);
+			std::vector<R> result(segments);
+			qpl::default_thread_pool().parallel_for(segments, [&](qpl::size i) {
+				std::vector<qpl::u8> sieve;
+				auto offset = qpl::u64{ i } * sieve_segment_size;
+				auto segment_low = low + 2u * offset;
+				auto size = qpl::size_cast(qpl::min(qpl::u64{ sieve_segment_size }, odd_count - offset));
+				sieve_segment(segment_low, size, sieving_primes, sieve);
+				result[i] = function(segment_low, sieve);
+			});
+			return result;
+		}
+
+		qpl::u64 pollard_rho(qpl::u64 n) {
+			if (n % 2u == 0u) {
+				return 2u;
+			}
+			auto difference = [](qpl::u64 a, qpl::u64 b) {
+				return a > b ? a - b : b - a;
+			};
+			for (qpl::u64 c = 1u;; ++c) {
+				auto f = [&](qpl::u64 value) {
+					auto result = mul_mod(value, value, n) + c;
+					if (result >= n || result < c) {
+						result -= n;
+					}
+					return result;
+				};
+
+				constexpr qpl::u64 m = 128u;
+				qpl::u64 y = 2u;
+				qpl::u64 x = y;
+				qpl::u64 ys = y;
+				qpl::u64 q = 1u;
+				qpl::u64 g = 1u;
+				for (qpl::u64 r = 1u; g == 1u; r *= 2u) {
+					x = y;
+					for (qpl::u64 i = 0u; i < r; ++i) {
+						y = f(y);
+					}
+					for (qpl::u64 k = 0u; k < r && g == 1u; k += m) {
+						ys = y;
+						auto steps = qpl::min(m, r - k);
+						for (qpl::u64 i = 0u; i < steps; ++i) {
+							y = f(y);
+							q = mul_mod(q, difference(x, y), n);
+						}
+						g = std::gcd(q, n);
+					}
+				}
+				if (g == n) {
+					do {
+						ys = f(ys);
+						g = std::gcd(difference(x, ys), n);
+					} while (g == 1u);
+				}
+				if (g != n) {
+					return g;
+				}
+			}
+		}
+	}
+
+	bool qpl::is_prime_u64(qpl::u64 value) {
+		if (value < 2u) {
+			return false;
+		}
+		constexpr std::array<qpl::u64, 12u> small_primes = { 2u, 3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u, 29u, 31u, 37u };
+		for (auto p : small_primes) {
+			if (value % p == 0u) {
+				return value == p;
+			}
+		}
+		if (value < 37u * 37u) {
+			return true;
+		}
+
+		auto shift = std::countr_zero(value - 1u);
+		auto d = (value - 1u) >> shift;
+
+		constexpr std::array<qpl::u64, 7u> bases = { 2u, 325u, 9375u, 28178u, 450775u, 9780504u, 1795265022u };
+		for (auto base : bases) {
+			auto a = base % value;
+			if (a == 0u) {
+				continue;
+			}
+			auto x = pow_mod(a, d, value);
+			if (x == 1u || x == value - 1u) {
+				continue;
+			}
+			bool composite = true;
+			for (qpl::i32 r = 1; r < shift; ++r) {
+				x = mul_mod(x, x, value);
+				if (x == value - 1u) {
+					composite = false;
+					break;
+				}
+			}
+			if (composite) {
+				return false;
+			}
+		}
+		return true;
+	}
+	std::vector<qpl::u64> qpl::sieve_primes(qpl::u64 begin, qpl::u64 end) {
+		std::vector<qpl::u64> result;
+		for (auto p : wheel_primes) {
+			if (p >= begin && p < end) {
+				result.push_back(p);
+			}
+		}
+		auto found = sieve_segments<std::vector<qpl::u64>>(begin, end, [](qpl::u64 low, const std::vector<qpl::u8>& sieve) {
+			std::vector<qpl::u64> primes;
+			for (qpl::size j = 0u; j < sieve.size(); ++j) {
+				if (sieve[j]) {
+					primes.push_back(low + 2u * j);
+				}
+			}
+			return primes;
+		});
+		qpl::size size = result.size();
+		for (const auto& primes : found) {
+			size += primes.size();
+		}
+		result.reserve(size);
+		for (const auto& primes : found) {
+			result.insert(result.end(), primes.cbegin(), primes.cend());
+		}
+		return result;
+	}
+	qpl::size qpl::count_primes(qpl::u64 begin, qpl::u64 end) {
+		qpl::size result = 0u;
+		for (auto p : wheel_primes) {
+			if (p >= begin && p < end) {
+				++result;
+			}
+		}
+		auto counts = sieve_segments<qpl::size>(begin, end, [](qpl::u64, const std::vector<qpl::u8>& sieve) {
+			return qpl::size_cast(std::count(sieve.cbegin(), sieve.cend(), qpl::u8{ 1u }));
+		});
+		for (auto count : counts) {
+			result += count;
+		}
+		return result;
+	}
+	std::vector<qpl::u64> qpl::factorize(qpl::u64 value) {
+		std::vector<qpl::u64> result;
+		if (value < 2u) {
+			return result;
+		}
+		for (qpl::u64 p = 2u; p < 100u && p * p <= value; p += (p == 2u ? 1u : 2u)) {
+			while (value % p == 0u) {
+				result.push_back(p);
+				value /= p;
+			}
+		}
+		std::vector<qpl::u64> stack;
+		if (value > 1u) {
+			stack.push_back(value);
+		}
+		while (!stack.empty()) {
+			auto n = stack.back();
+			stack.pop_back();
+			if (qpl::is_prime_u64(n)) {
+				result.push_back(n);
+				continue;
+			}
+			auto divisor = pollard_rho(n);
+			stack.push_back(divisor);
+			stack.push_back(n / divisor);
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
 	
 	void qpl::exponential_moving_average::reset() {
 		this->last_ma = 0.0;
@@ -20,19 +326,19 @@ namespace qpl {
 	}
 
 	void qpl::moving_average::reset() {
-		this->array.clear();
+		this->statistics.clear();
 	}
 	void qpl::moving_average::add(qpl::f64 value) {
-		this->array.add(value);
+		this->statistics.add(value);
 	}
 	qpl::f64 qpl::moving_average::get_average() const {
-		return this->array.get_average();
+		return this->statistics.mean();
 	}
 	qpl::size qpl::moving_average::time_period() const {
-		return this->array.size();
+		return this->statistics.window();
 	}
 	void qpl::moving_average::set_time_period(qpl::size time_period) {
-		this->array.resize(time_period);
+		this->statistics.set_window(time_period);
 	}
 	std::string qpl::mathematical_operation_string(mathematical_operation op) {
 		switch (op) {
@@ -0,0 +1,266 @@
+#include <qpl/memory_resource.hpp>
+#include <qpl/algorithm.hpp>
+
+#include <array>
+#include <bit>
+#include <memory>
+#include <mutex>
+
+namespace qpl {
+
+	qpl::counting_resource::counting_resource(std::pmr::memory_resource* upstream) : m_upstream(upstream) {
+
+	}
+	qpl::size qpl::counting_resource::allocations() const {
+		return this->m_allocations.load(std::memory_order_relaxed);
+	}
+	qpl::size qpl::counting_resource::deallocations() const {
+		return this->m_deallocations.load(std::memory_order_relaxed);
+	}
+	qpl::size qpl::counting_resource::bytes_allocated() const {
+		return this->m_bytes_allocated.load(std::memory_order_relaxed);
+	}
+	qpl::size qpl::counting_resource::bytes_in_use() const {
+		return this->m_bytes_in_use.load(std::memory_order_relaxed);
+	}
+	qpl::size qpl::counting_resource::peak_bytes_in_use() const {
+		return this->m_peak_bytes_in_use.load(std::memory_order_relaxed);
+	}
+	void qpl::counting_resource::reset_statistics() {
+		this->m_allocations = 0u;
+		this->m_deallocations = 0u;
+		this->m_bytes_allocated = 0u;
+		this->m_peak_bytes_in_use = this->m_bytes_in_use.load();
+	}
+	std::pmr::memory_resource* qpl::counting_resource::upstream() const {
+		return this->m_upstream;
+	}
+	void* qpl::counting_resource::do_allocate(qpl::size bytes, qpl::size alignment) {
+		auto ptr = this->m_upstream->allocate(bytes, alignment);
+		this->m_allocations.fetch_add(1u, std::memory_order_relaxed);
+		this->m_bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+		auto in_use = this->m_bytes_in_use.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		auto peak = this->m_peak_bytes_in_use.load(std::memory_order_relaxed);
+		while (in_use > peak && !this->m_peak_bytes_in_use.compare_exchange_weak(peak, in_use, std::memory_order_relaxed)) {
+
+		}
+		return ptr;
+	}
+	void qpl::counting_resource::do_deallocate(void* ptr, qpl::size bytes, qpl::size alignment) {
+		this->m_upstream->deallocate(ptr, bytes, alignment);
+		this->m_deallocations.fetch_add(1u, std::memory_order_relaxed);
+		this->m_bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+	}
+	bool qpl::counting_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+
+	qpl::arena_resource::arena_resource(qpl::size initial_block_size, std::pmr::memory_resource* upstream) : m_upstream(upstream) {
+		this->m_initial_block_size = qpl::max(initial_block_size, qpl::size{ 64u });
+		this->m_next_block_size = this->m_initial_block_size;
+	}
+	qpl::arena_resource::arena_resource(std::span<std::byte> initial_buffer, std::pmr::memory_resource* upstream) : m_upstream(upstream), m_initial_buffer(initial_buffer) {
+		this->m_initial_block_size = qpl::max(initial_buffer.size() * 2u, qpl::size{ 64u });
+		this->m_next_block_size = this->m_initial_block_size;
+		this->m_current = initial_buffer.data();
+		this->m_remaining = initial_buffer.size();
+	}
+	qpl::arena_resource::~arena_resource() {
+		this->release();
+	}
+	void qpl::arena_resource::release() {
+		for (auto& block : this->m_blocks) {
+			this->m_upstream->deallocate(block.data, block.size, block.alignment);
+		}
+		this->m_blocks.clear();
+		this->m_current = this->m_initial_buffer.data();
+		this->m_remaining = this->m_initial_buffer.size();
+		this->m_next_block_size = this->m_initial_block_size;
+		this->m_bytes_used = 0u;
+	}
+	qpl::size qpl::arena_resource::bytes_used() const {
+		return this->m_bytes_used;
+	}
+	qpl::size qpl::arena_resource::bytes_reserved() const {
+		qpl::size result = this->m_initial_buffer.size();
+		for (auto& block : this->m_blocks) {
+			result += block.size;
+		}
+		return result;
+	}
+	void* qpl::arena_resource::do_allocate(qpl::size bytes, qpl::size alignment) {
+		void* ptr = this->m_current;
+		auto space = this->m_remaining;
+		if (!ptr || !std::align(alignment, bytes, ptr, space)) {
+			auto size = qpl::max(this->m_next_block_size, bytes + alignment);
+			auto block_alignment = qpl::max(alignment, alignof(std::max_align_t));
+			auto data = static_cast<std::byte*>(this->m_upstream->allocate(size, block_alignment));
+			this->m_blocks.push_back({ data, size, block_alignment });
+			this->m_next_block_size = size * 2u;
+
+			ptr = data;
+			space = size;
+			std::align(alignment, bytes, ptr, space);
+		}
+		this->m_current = static_cast<std::byte*>(ptr) + bytes;
+		this->m_remaining = space - bytes;
+		this->m_bytes_used += bytes;
+		return ptr;
+	}
+	void qpl::arena_resource::do_deallocate(void* ptr, qpl::size bytes, qpl::size alignment) {
+
+	}
+	bool qpl::arena_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+
+	qpl::pool_resource::pool_resource(qpl::size object_size, qpl::size objects_per_chunk, std::pmr::memory_resource* upstream) : m_upstream(upstream) {
+		auto alignment = alignof(std::max_align_t);
+		this->m_object_size = (qpl::max(object_size, sizeof(void*)) + alignment - 1u) / alignment * alignment;
+		this->m_objects_per_chunk = qpl::max(objects_per_chunk, qpl::size{ 1u });
+	}
+	qpl::pool_resource::~pool_resource() {
+		this->release();
+	}
+	void qpl::pool_resource::release() {
+		for (auto& chunk : this->m_chunks) {
+			this->m_upstream->deallocate(chunk, this->m_object_size * this->m_objects_per_chunk, alignof(std::max_align_t));
+		}
+		this->m_chunks.clear();
+		this->m_free = nullptr;
+		this->m_in_use = 0u;
+	}
+	qpl::size qpl::pool_resource::object_size() const {
+		return this->m_object_size;
+	}
+	qpl::size qpl::pool_resource::objects_in_use() const {
+		return this->m_in_use;
+	}
+	qpl::size qpl::pool_resource::capacity() const {
+		return this->m_chunks.size() * this->m_objects_per_chunk;
+	}
+	void* qpl::pool_resource::do_allocate(qpl::size bytes, qpl::size alignment) {
+		if (bytes > this->m_object_size || alignment > alignof(std::max_align_t)) {
+			return this->m_upstream->allocate(bytes, alignment);
+		}
+		if (!this->m_free) {
+			auto chunk = static_cast<std::byte*>(this->m_upstream->allocate(this->m_object_size * this->m_objects_per_chunk, alignof(std::max_align_t)));
+			this->m_chunks.push_back(chunk);
+			for (qpl::size i = this->m_objects_per_chunk; i-- > 0u;) {
+				auto slot = chunk + i * this->m_object_size;
+				*reinterpret_cast<void**>(slot) = this->m_free;
+				this->m_free = slot;
+			}
+		}
+		auto result = this->m_free;
+		this->m_free = *static_cast<void**>(result);
+		++this->m_in_use;
+		return result;
+	}
+	void qpl::pool_resource::do_deallocate(void* ptr, qpl::size bytes, qpl::size alignment) {
+		if (bytes > this->m_object_size || alignment > alignof(std::max_align_t)) {
+			this->m_upstream->deallocate(ptr, bytes, alignment);
+			return;
+		}
+		*static_cast<void**>(ptr) = this->m_free;
+		this->m_free = ptr;
+		--this->m_in_use;
+	}
+	bool qpl::pool_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+
+	namespace {
+		constexpr qpl::size size_classes = 7u;
+		constexpr qpl::size smallest_class = 16u;
+		constexpr qpl::size largest_class = smallest_class << (size_classes - 1u);
+		constexpr qpl::size thread_chunk_size = 64u * 1024u;
+
+		qpl::size size_class(qpl::size bytes) {
+			auto size = std::bit_ceil(qpl::max(bytes, smallest_class));
+			return qpl::size_cast(std::countr_zero(size) - std::countr_zero(smallest_class));
+		}
+
+		//blocks cached by threads that exited
+		struct depot_t {
+			std::mutex mutex;
+			std::array<void*, size_classes> lists{};
+		};
+		depot_t& depot() {
+			static depot_t* depot = new depot_t;
+			return *depot;
+		}
+
+		struct thread_cache {
+			std::array<void*, size_classes> lists{};
+
+			~thread_cache() {
+				auto& shared = depot();
+				std::lock_guard lock(shared.mutex);
+				for (qpl::size c = 0u; c < size_classes; ++c) {
+					if (!this->lists[c]) {
+						continue;
+					}
+					auto tail = this->lists[c];
+					while (*static_cast<void**>(tail)) {
+						tail = *static_cast<void**>(tail);
+					}
+					*static_cast<void**>(tail) = shared.lists[c];
+					shared.lists[c] = this->lists[c];
+				}
+			}
+
+			void refill(qpl::size c) {
+				auto& shared = depot();
+				{
+					std::lock_guard lock(shared.mutex);
+					if (shared.lists[c]) {
+						this->lists[c] = shared.lists[c];
+						shared.lists[c] = nullptr;
+						return;
+					}
+				}
+				auto size = smallest_class << c;
+				auto chunk = static_cast<std::byte*>(std::pmr::new_delete_resource()->allocate(thread_chunk_size, alignof(std::max_align_t)));
+				for (auto i = thread_chunk_size / size; i-- > 0u;) {
+					auto slot = chunk + i * size;
+					*reinterpret_cast<void**>(slot) = this->lists[c];
+					this->lists[c] = slot;
+				}
+			}
+		};
+		thread_local thread_cache cache;
+
+		struct thread_local_resource_t : std::pmr::memory_resource {
+			void* do_allocate(qpl::size bytes, qpl::size alignment) override {
+				if (bytes > largest_class || alignment > alignof(std::max_align_t)) {
+					return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+				}
+				auto c = size_class(bytes);
+				if (!cache.lists[c]) {
+					cache.refill(c);
+				}
+				auto result = cache.lists[c];
+				cache.lists[c] = *static_cast<void**>(result);
+				return result;
+			}
+			void do_deallocate(void* ptr, qpl::size bytes, qpl::size alignment) override {
+				if (bytes > largest_class || alignment > alignof(std::max_align_t)) {
+					std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+					return;
+				}
+				auto c = size_class(bytes);
+				*static_cast<void**>(ptr) = cache.lists[c];
+				cache.lists[c] = ptr;
+			}
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+		};
+	}
+
+	std::pmr::memory_resource* qpl::thread_local_resource() {
+		static thread_local_resource_t resource;
+		return &resource;
+	}
+}
@@ -2,18 +2,144 @@
 #include <qpl/type_traits.hpp>
 #include <qpl/memory.hpp>
 #include <qpl/string.hpp>
+#include <qpl/algorithm.hpp>
+#include <qpl/exception.hpp>
 #include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <cmath>
+#include <utility>
+#include <bit>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace qpl {
 	std::string qpl::pixel_rgb::string() const {
 		return qpl::to_string("(", qpl::i32_cast(this->r), ", ", qpl::i32_cast(this->g), ", ", qpl::i32_cast(this->b), ")");
 	}
 
+	void qpl::detail::throw_image_view_sub(qpl::u32 x, qpl::u32 y, qpl::u32 width, qpl::u32 height, qpl::u32 view_width, qpl::u32 view_height) {
+		throw qpl::exception("qpl::image_view::sub: rectangle (", x, ", ", y, ", ", width, ", ", height, ") is outside of ", view_width, "x", view_height);
+	}
+
 	void qpl::pixels::load(std::string_view sv) {
 		qpl::string_to_heap_memory(sv, this->data);
 	}
+	namespace {
+		qpl::u32 read_u32_le(std::string_view sv, qpl::size offset) {
+			return qpl::u32_cast(qpl::u8_cast(sv[offset])) | (qpl::u32_cast(qpl::u8_cast(sv[offset + 1])) << 8) | (qpl::u32_cast(qpl::u8_cast(sv[offset + 2])) << 16) | (qpl::u32_cast(qpl::u8_cast(sv[offset + 3])) << 24);
+		}
+		qpl::u32 read_u16_le(std::string_view sv, qpl::size offset) {
+			return qpl::u32_cast(qpl::u8_cast(sv[offset])) | (qpl::u32_cast(qpl::u8_cast(sv[offset + 1])) << 8);
+		}
+		qpl::size bmp_row_stride(qpl::size width, qpl::size bits) {
+			return ((width * bits + 31) / 32) * 4;
+		}
+
+		//ppm header token: skips whitespace and # comments
+		qpl::u32 read_ppm_number(std::string_view sv, qpl::size& position) {
+			while (position < sv.size()) {
+				if (sv[position] == '#') {
+					while (position < sv.size() && sv[position] != '\n') {
+						++position;
+					}
+				}
+				else if (std::isspace(qpl::u8_cast(sv[position]))) {
+					++position;
+				}
+				else {
+					break;
+				}
+			}
+			qpl::u32 result = 0u;
+			auto begin = position;
+			while (position < sv.size() && sv[position] >= '0' && sv[position] <= '9') {
+				result = result * 10u + qpl::u32_cast(sv[position] - '0');
+				++position;
+			}
+			if (begin == position) {
+				throw qpl::exception("qpl::pixels::load_ppm: malformed header");
+			}
+			return result;
+		}
+	}
+
 	void qpl::pixels::load_bmp(std::string_view sv) {
-		qpl::string_to_heap_memory(sv.substr(64), this->data);
+		constexpr auto header_size = qpl::detail::file_header_size + qpl::detail::info_header_size;
+		if (sv.size() < header_size || sv[0] != 'B' || sv[1] != 'M') {
+			throw qpl::exception("qpl::pixels::load_bmp: not a bmp file");
+		}
+		auto offset = read_u32_le(sv, 10);
+		auto width = static_cast<qpl::i32>(read_u32_le(sv, 18));
+		auto height = static_cast<qpl::i32>(read_u32_le(sv, 22));
+		auto bits = read_u16_le(sv, 28);
+		auto compression = read_u32_le(sv, 30);
+
+		if (width < 0 || (bits != 24u && bits != 32u) || (compression != 0u && !(bits == 32u && compression == 3u))) {
+			throw qpl::exception("qpl::pixels::load_bmp: unsupported format (", bits, " bits, compression ", compression, ")");
+		}
+		auto top_down = height < 0;
+		auto rows = qpl::u32_cast(top_down ? -qpl::i64{ height } : qpl::i64{ height });
+		auto stride = bmp_row_stride(qpl::size_cast(width), bits);
+		if (offset + stride * rows > sv.size()) {
+			throw qpl::exception("qpl::pixels::load_bmp: file is truncated");
+		}
+
+		this->set_dimension(qpl::u32_cast(width), rows);
+		for (qpl::u32 y = 0u; y < rows; ++y) {
+			auto source = sv.data() + offset + (top_down ? (rows - 1 - y) : y) * stride;
+			auto destination = this->data.data() + qpl::size{ y } * this->width;
+			if (bits == 24u) {
+				memcpy(destination, source, this->width * qpl::pixel_rgb::pixel_bytes());
+			}
+			else {
+				for (qpl::u32 x = 0u; x < this->width; ++x) {
+					destination[x].b = qpl::u8_cast(source[x * 4 + 0]);
+					destination[x].g = qpl::u8_cast(source[x * 4 + 1]);
+					destination[x].r = qpl::u8_cast(source[x * 4 + 2]);
+				}
+			}
+		}
+	}
+	void qpl::pixels::load_ppm(std::string_view sv) {
+		if (sv.size() < 2 || sv[0] != 'P' || sv[1] != '6') {
+			throw qpl::exception("qpl::pixels::load_ppm: only binary (P6) ppm is supported");
+		}
+		qpl::size position = 2u;
+		auto width = read_ppm_number(sv, position);
+		auto height = read_ppm_number(sv, position);
+		auto max_value = read_ppm_number(sv, position);
+		if (!max_value || max_value > 255u) {
+			throw qpl::exception("qpl::pixels::load_ppm: unsupported max value ", max_value);
+		}
+		++position;
+		if (position + qpl::size{ width } * height * 3 > sv.size()) {
+			throw qpl::exception("qpl::pixels::load_ppm: file is truncated");
+		}
+
+		this->set_dimension(width, height);
+		auto source = reinterpret_cast<const qpl::u8*>(sv.data() + position);
+		for (qpl::u32 y = 0u; y < height; ++y) {
+			auto row = source + qpl::size{ height - 1 - y } * width * 3;
+			auto destination = this->data.data() + qpl::size{ y } * width;
+			if (max_value == 255u) {
+				for (qpl::u32 x = 0u; x < width; ++x) {
+					destination[x].r = row[x * 3 + 0];
+					destination[x].g = row[x * 3 + 1];
+					destination[x].b = row[x * 3 + 2];
+				}
+			}
+			else {
+				for (qpl::u32 x = 0u; x < width; ++x) {
+					destination[x].r = qpl::u8_cast((row[x * 3 + 0] * 255u + max_value / 2) / max_value);
+					destination[x].g = qpl::u8_cast((row[x * 3 + 1] * 255u + max_value / 2) / max_value);
+					destination[x].b = qpl::u8_cast((row[x * 3 + 2] * 255u + max_value / 2) / max_value);
+				}
+			}
+		}
 	}
 	void qpl::pixels::set_dimension(qpl::u32 width, qpl::u32 height) { 
 		this->width = width;
@@ -31,22 +157,74 @@ namespace qpl {
 
 		return result;
 	}
-	std::string qpl::pixels::generate_bmp_string() const {
-		char padding[3] = { 0, 0, 0 };
-		int padding_size = (4 - (this->width * qpl::pixel_rgb::pixel_bytes()) % 4) % 4;
+	void qpl::pixels::assign(qpl::image_view<const qpl::pixel_rgb> view) {
+		this->set_dimension(view.width, view.height);
+		qpl::blit(view, this->view());
+	}
+	qpl::image_view<qpl::pixel_rgb> qpl::pixels::view() {
+		return qpl::image_view<qpl::pixel_rgb>(this->data.data(), this->width, this->height);
+	}
+	qpl::image_view<const qpl::pixel_rgb> qpl::pixels::view() const {
+		return qpl::image_view<const qpl::pixel_rgb>(this->data.data(), this->width, this->height);
+	}
 
-		auto file_header = qpl::detail::create_bitmap_file_header(this->width,this->height, padding_size);
-		auto info_header = qpl::detail::create_bitmap_info_header(this->width,this->height);
+	qpl::size qpl::pixels::bmp_size() const {
+		return qpl::detail::file_header_size + qpl::detail::info_header_size + bmp_row_stride(this->width, 24u) * this->height;
+	}
+	qpl::size qpl::pixels::encode_bmp(std::span<char> output) const {
+		auto size = this->bmp_size();
+		if (output.size() < size) {
+			throw qpl::exception("qpl::pixels::encode_bmp: output holds ", output.size(), " bytes, need ", size);
+		}
+		auto row_size = this->width * qpl::pixel_rgb::pixel_bytes();
+		auto stride = bmp_row_stride(this->width, 24u);
+		auto padding_size = stride - row_size;
+
+		auto file_header = qpl::detail::create_bitmap_file_header(this->width, this->height, padding_size);
+		auto info_header = qpl::detail::create_bitmap_info_header(this->width, this->height);
 
-		std::ostringstream stream;
-		stream.write(file_header.data(), file_header.size());
-		stream.write(info_header.data(), info_header.size());
+		auto ptr = output.data();
+		memcpy(ptr, file_header.data(), file_header.size());
+		ptr += file_header.size();
+		memcpy(ptr, info_header.data(), info_header.size());
+		ptr += info_header.size();
 
 		for (qpl::u32 i = 0u; i < this->height; ++i) {
-			stream.write(reinterpret_cast<const char*>(this->data.data()) + (i * qpl::pixel_rgb::pixel_bytes() * this->width), qpl::pixel_rgb::pixel_bytes() * this->width);
-			stream.write(padding, padding_size);
+			memcpy(ptr, this->data.data() + qpl::size{ i } * this->width, row_size);
+			memset(ptr + row_size, 0, padding_size);
+			ptr += stride;
+		}
+		return size;
+	}
+	qpl::size qpl::pixels::ppm_size() const {
+		return qpl::detail::ppm_header(this->width, this->height).size() + this->size() * qpl::pixel_rgb::pixel_bytes();
+	}
+	qpl::size qpl::pixels::encode_ppm(std::span<char> output) const {
+		auto header = qpl::detail::ppm_header(this->width, this->height);
+		auto size = header.size() + this->size() * qpl::pixel_rgb::pixel_bytes();
+		if (output.size() < size) {
+			throw qpl::exception("qpl::pixels::encode_ppm: output holds ", output.size(), " bytes, need ", size);
+		}
+		memcpy(output.data(), header.data(), header.size());
+		auto ptr = reinterpret_cast<qpl::u8*>(output.data() + header.size());
+
+		//ppm is top row first and RGB
+		for (qpl::u32 y = 0u; y < this->height; ++y) {
+			auto row = this->data.data() + qpl::size{ this->height - 1 - y } * this->width;
+			for (qpl::u32 x = 0u; x < this->width; ++x) {
+				ptr[x * 3 + 0] = row[x].r;
+				ptr[x * 3 + 1] = row[x].g;
+				ptr[x * 3 + 2] = row[x].b;
+			}
+			ptr += qpl::size{ this->width } * 3;
 		}
-		return stream.str();
+		return size;
+	}
+
+	std::string qpl::pixels::generate_bmp_string() const {
+		std::string result(this->bmp_size(), '\0');
+		this->encode_bmp(result);
+		return result;
 	}
 	void qpl::pixels::generate_bmp(std::string filename) const {
 		auto memory = this->generate_bmp_string();
@@ -58,10 +236,411 @@ namespace qpl {
 
 		fclose(file);
 	}
+	std::string qpl::pixels::generate_ppm_string() const {
+		std::string result(this->ppm_size(), '\0');
+		this->encode_ppm(result);
+		return result;
+	}
+	void qpl::pixels::generate_ppm(std::string filename) const {
+		auto memory = this->generate_ppm_string();
+
+		FILE* file;
+		fopen_s(&file, filename.c_str(), "wb");
+
+		fwrite(memory.c_str(), 1, memory.size(), file);
+
+		fclose(file);
+	}
 	qpl::size qpl::pixels::size() const {
 		return this->data.size();
 	}
 
+	namespace {
+		//the kernels below work on the raw channel bytes of a row, so the same code serves pixel_rgb and pixel_rgba.
+		//the byte loops use AVX2 / SSE2 when the library is built with it, the scalar loops handle the tails
+
+		template<typename P>
+		const qpl::u8* row_bytes(qpl::image_view<const P> view, qpl::u32 y) {
+			return reinterpret_cast<const qpl::u8*>(view.row(y));
+		}
+		template<typename P>
+		qpl::u8* row_bytes(qpl::image_view<P> view, qpl::u32 y) {
+			return reinterpret_cast<qpl::u8*>(view.row(y));
+		}
+
+		//out[i] = |a[i] - b[i]|
+		void absolute_difference(const qpl::u8* a, const qpl::u8* b, qpl::u8* out, qpl::size size) {
+			qpl::size i = 0u;
+#if defined(__AVX2__)
+			for (; i + 32u <= size; i += 32u) {
+				auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+				auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va)));
+			}
+#elif defined(__SSE2__)
+			for (; i + 16u <= size; i += 16u) {
+				auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+				auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)));
+			}
+#endif
+			for (; i < size; ++i) {
+				out[i] = qpl::u8_cast(a[i] > b[i] ? a[i] - b[i] : b[i] - a[i]);
+			}
+		}
+
+		//accumulator[i] += row[i]
+		void accumulate_bytes(qpl::u64* accumulator, const qpl::u8* row, qpl::size size) {
+			qpl::size i = 0u;
+#if defined(__AVX2__)
+			for (; i + 4u <= size; i += 4u) {
+				qpl::i32 bytes;
+				memcpy(&bytes, row + i, sizeof(bytes));
+				auto sum = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulator + i)), _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulator + i), sum);
+			}
+#endif
+			for (; i < size; ++i) {
+				accumulator[i] += row[i];
+			}
+		}
+
+		//out[i] = top[i] * top_weight + bottom[i] * bottom_weight, the weights add up to 256 so every product fits 16 bits
+		void blend_rows(const qpl::u8* top, const qpl::u8* bottom, qpl::u32 top_weight, qpl::u32 bottom_weight, qpl::u32* out, qpl::size size) {
+			qpl::size i = 0u;
+#if defined(__AVX2__)
+			auto vt = _mm256_set1_epi16(static_cast<qpl::i16>(top_weight));
+			auto vb = _mm256_set1_epi16(static_cast<qpl::i16>(bottom_weight));
+			for (; i + 16u <= size; i += 16u) {
+				auto a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(top + i)));
+				auto b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + i)));
+				auto sum = _mm256_add_epi16(_mm256_mullo_epi16(a, vt), _mm256_mullo_epi16(b, vb));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtepu16_epi32(_mm256_castsi256_si128(sum)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 8u), _mm256_cvtepu16_epi32(_mm256_extracti128_si256(sum, 1)));
+			}
+#elif defined(__SSE2__)
+			auto zero = _mm_setzero_si128();
+			auto vt = _mm_set1_epi16(static_cast<qpl::i16>(top_weight));
+			auto vb = _mm_set1_epi16(static_cast<qpl::i16>(bottom_weight));
+			for (; i + 8u <= size; i += 8u) {
+				auto a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(top + i)), zero);
+				auto b = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bottom + i)), zero);
+				auto sum = _mm_add_epi16(_mm_mullo_epi16(a, vt), _mm_mullo_epi16(b, vb));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi16(sum, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4u), _mm_unpackhi_epi16(sum, zero));
+			}
+#endif
+			for (; i < size; ++i) {
+				out[i] = top[i] * top_weight + bottom[i] * bottom_weight;
+			}
+		}
+
+		//rgba pixels are 32 bit lanes: the channel differences are summed with sad and the per pixel maximum is found by shifting within the lane.
+		//returns the number of pixels handled, the caller finishes the rest
+		qpl::size compare_rgba_simd(const qpl::u8* a, const qpl::u8* b, qpl::size pixels, qpl::u8 threshold, qpl::u64& total, qpl::u32& maximum, qpl::size& different) {
+			qpl::size x = 0u;
+#if defined(__AVX2__)
+			auto zero = _mm256_setzero_si256();
+			auto low_byte = _mm256_set1_epi32(0xff);
+			auto limit = _mm256_set1_epi32(threshold);
+			auto sums = _mm256_setzero_si256();
+			auto maxima = _mm256_setzero_si256();
+			for (; x + 8u <= pixels; x += 8u) {
+				auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + x * 4u));
+				auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + x * 4u));
+				auto difference = _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va));
+				sums = _mm256_add_epi64(sums, _mm256_sad_epu8(difference, zero));
+				auto pixel_max = _mm256_max_epu8(difference, _mm256_srli_epi32(difference, 8));
+				pixel_max = _mm256_and_si256(_mm256_max_epu8(pixel_max, _mm256_srli_epi32(pixel_max, 16)), low_byte);
+				maxima = _mm256_max_epu8(maxima, pixel_max);
+				different += std::popcount(qpl::u32_cast(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(pixel_max, limit)))));
+			}
+			alignas(32) std::array<qpl::u64, 4> sum_lanes;
+			alignas(32) std::array<qpl::u32, 8> max_lanes;
+			_mm256_store_si256(reinterpret_cast<__m256i*>(sum_lanes.data()), sums);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(max_lanes.data()), maxima);
+#elif defined(__SSE2__)
+			auto zero = _mm_setzero_si128();
+			auto low_byte = _mm_set1_epi32(0xff);
+			auto limit = _mm_set1_epi32(threshold);
+			auto sums = _mm_setzero_si128();
+			auto maxima = _mm_setzero_si128();
+			for (; x + 4u <= pixels; x += 4u) {
+				auto va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + x * 4u));
+				auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + x * 4u));
+				auto difference = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+				sums = _mm_add_epi64(sums, _mm_sad_epu8(difference, zero));
+				auto pixel_max = _mm_max_epu8(difference, _mm_srli_epi32(difference, 8));
+				pixel_max = _mm_and_si128(_mm_max_epu8(pixel_max, _mm_srli_epi32(pixel_max, 16)), low_byte);
+				maxima = _mm_max_epu8(maxima, pixel_max);
+				different += std::popcount(qpl::u32_cast(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(pixel_max, limit)))));
+			}
+			alignas(16) std::array<qpl::u64, 2> sum_lanes;
+			alignas(16) std::array<qpl::u32, 4> max_lanes;
+			_mm_store_si128(reinterpret_cast<__m128i*>(sum_lanes.data()), sums);
+			_mm_store_si128(reinterpret_cast<__m128i*>(max_lanes.data()), maxima);
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+			for (auto i : sum_lanes) {
+				total += i;
+			}
+			for (auto i : max_lanes) {
+				maximum = qpl::max(maximum, i);
+			}
+#endif
+			return x;
+		}
+
+		template<typename P>
+		void blit_impl(qpl::image_view<const P> source, qpl::image_view<P> destination, qpl::i32 x, qpl::i32 y) {
+			auto source_x = qpl::i64{ qpl::max(0, -x) };
+			auto source_y = qpl::i64{ qpl::max(0, -y) };
+			auto destination_x = qpl::i64{ qpl::max(0, x) };
+			auto destination_y = qpl::i64{ qpl::max(0, y) };
+			auto width = qpl::min(qpl::i64{ source.width } - source_x, qpl::i64{ destination.width } - destination_x);
+			auto height = qpl::min(qpl::i64{ source.height } - source_y, qpl::i64{ destination.height } - destination_y);
+			if (width <= 0 || height <= 0) {
+				return;
+			}
+			for (qpl::i64 j = 0; j < height; ++j) {
+				memcpy(destination.row(qpl::u32_cast(destination_y + j)) + destination_x, source.row(qpl::u32_cast(source_y + j)) + source_x, qpl::size_cast(width) * sizeof(P));
+			}
+		}
+
+		template<typename P>
+		void scale_box_impl(qpl::image_view<const P> source, qpl::image_view<P> destination) {
+			constexpr auto channels = sizeof(P);
+			if (source.empty() || destination.empty()) {
+				return;
+			}
+			auto range = [](qpl::u32 i, qpl::u32 source_size, qpl::u32 destination_size) {
+				auto begin = qpl::u32_cast(qpl::u64{ i } * source_size / destination_size);
+				auto end = qpl::u32_cast(qpl::u64{ i + 1 } * source_size / destination_size);
+				return std::make_pair(begin, qpl::max(end, begin + 1));
+			};
+
+			std::vector<std::pair<qpl::u32, qpl::u32>> columns(destination.width);
+			for (qpl::u32 x = 0u; x < destination.width; ++x) {
+				columns[x] = range(x, source.width, destination.width);
+			}
+			//u64 so that shrinking a large picture into few pixels can't overflow the sums
+			std::vector<qpl::u64> accumulator(qpl::size{ source.width } * channels);
+
+			for (qpl::u32 y = 0u; y < destination.height; ++y) {
+				auto [row_begin, row_end] = range(y, source.height, destination.height);
+
+				std::fill(accumulator.begin(), accumulator.end(), qpl::u64{ 0u });
+				for (auto j = row_begin; j < row_end; ++j) {
+					accumulate_bytes(accumulator.data(), row_bytes(source, j), accumulator.size());
+				}
+
+				auto out = row_bytes(destination, y);
+				for (qpl::u32 x = 0u; x < destination.width; ++x) {
+					auto [column_begin, column_end] = columns[x];
+					auto count = qpl::u64{ column_end - column_begin } * (row_end - row_begin);
+					for (qpl::size c = 0u; c < channels; ++c) {
+						qpl::u64 sum = 0u;
+						for (auto i = column_begin; i < column_end; ++i) {
+							sum += accumulator[i * channels + c];
+						}
+						out[x * channels + c] = qpl::u8_cast((sum + count / 2) / count);
+					}
+				}
+			}
+		}
+
+		struct bilinear_sample {
+			qpl::u32 first;
+			qpl::u32 second;
+			qpl::u32 weight;
+		};
+		//pixel centers are aligned, weight is 8 bit fixed point
+		bilinear_sample bilinear_position(qpl::u32 i, qpl::u32 source_size, qpl::u32 destination_size) {
+			auto position = (i + 0.5) * source_size / destination_size - 0.5;
+			position = qpl::clamp(0.0, position, static_cast<double>(source_size - 1));
+			auto first = qpl::u32_cast(std::floor(position));
+			auto second = qpl::min(first + 1, source_size - 1);
+			auto weight = qpl::u32_cast(std::lround((position - first) * 256));
+			return bilinear_sample{ first, second, weight };
+		}
+
+		template<typename P>
+		void scale_bilinear_impl(qpl::image_view<const P> source, qpl::image_view<P> destination) {
+			constexpr auto channels = sizeof(P);
+			if (source.empty() || destination.empty()) {
+				return;
+			}
+			std::vector<bilinear_sample> columns(destination.width);
+			for (qpl::u32 x = 0u; x < destination.width; ++x) {
+				columns[x] = bilinear_position(x, source.width, destination.width);
+			}
+			std::vector<qpl::u32> blended(qpl::size{ source.width } * channels);
+
+			for (qpl::u32 y = 0u; y < destination.height; ++y) {
+				auto sample = bilinear_position(y, source.height, destination.height);
+				auto top = row_bytes(source, sample.first);
+				auto bottom = row_bytes(source, sample.second);
+				blend_rows(top, bottom, 256u - sample.weight, sample.weight, blended.data(), blended.size());
+
+				auto out = row_bytes(destination, y);
+				for (qpl::u32 x = 0u; x < destination.width; ++x) {
+					auto column = columns[x];
+					auto left_weight = 256u - column.weight;
+					for (qpl::size c = 0u; c < channels; ++c) {
+						auto value = blended[column.first * channels + c] * left_weight + blended[column.second * channels + c] * column.weight;
+						out[x * channels + c] = qpl::u8_cast((value + 32768u) >> 16);
+					}
+				}
+			}
+		}
+
+		template<typename A, typename B>
+		void check_same_dimension(qpl::image_view<A> a, qpl::image_view<B> b, const char* function) {
+			if (a.width != b.width || a.height != b.height) {
+				throw qpl::exception("qpl::", function, ": dimensions differ (", a.width, "x", a.height, " and ", b.width, "x", b.height, ")");
+			}
+		}
+
+		template<typename P>
+		qpl::image_difference image_compare_impl(qpl::image_view<const P> a, qpl::image_view<const P> b, qpl::u8 threshold) {
+			constexpr auto channels = sizeof(P);
+			check_same_dimension(a, b, "image_compare");
+
+			qpl::image_difference result;
+			for (qpl::u32 y = 0u; y < a.height; ++y) {
+				auto row_a = row_bytes(a, y);
+				auto row_b = row_bytes(b, y);
+				qpl::u64 total = 0u;
+				qpl::u32 maximum = 0u;
+				qpl::size different = 0u;
+				qpl::u32 x = 0u;
+				if constexpr (channels == 4u) {
+					x = qpl::u32_cast(compare_rgba_simd(row_a, row_b, a.width, threshold, total, maximum, different));
+				}
+				for (; x < a.width; ++x) {
+					qpl::u32 pixel_max = 0u;
+					for (qpl::size c = 0u; c < channels; ++c) {
+						auto i = x * channels + c;
+						auto difference = qpl::u32_cast(row_a[i] > row_b[i] ? row_a[i] - row_b[i] : row_b[i] - row_a[i]);
+						total += difference;
+						pixel_max = qpl::max(pixel_max, difference);
+					}
+					maximum = qpl::max(maximum, pixel_max);
+					different += (pixel_max > threshold);
+				}
+				result.total_difference += total;
+				result.different_pixels += different;
+				result.max_difference = qpl::u8_cast(qpl::max(qpl::u32{ result.max_difference }, maximum));
+			}
+			return result;
+		}
+
+		template<typename P>
+		void image_difference_map_impl(qpl::image_view<const P> a, qpl::image_view<const P> b, qpl::image_view<P> destination) {
+			check_same_dimension(a, b, "image_difference_map");
+			check_same_dimension(a, destination, "image_difference_map");
+
+			auto bytes = qpl::size{ a.width } * sizeof(P);
+			for (qpl::u32 y = 0u; y < a.height; ++y) {
+				absolute_difference(row_bytes(a, y), row_bytes(b, y), row_bytes(destination, y), bytes);
+			}
+		}
+
+		//two alternating tables so that runs of equal colors don't serialize on the same counter
+		template<typename P>
+		qpl::image_histogram histogram_impl(qpl::image_view<const P> source) {
+			std::array<qpl::image_histogram, 2> tables;
+			for (qpl::u32 y = 0u; y < source.height; ++y) {
+				auto row = source.row(y);
+				for (qpl::u32 x = 0u; x < source.width; ++x) {
+					auto& table = tables[x & 1u];
+					++table.r[row[x].r];
+					++table.g[row[x].g];
+					++table.b[row[x].b];
+					if constexpr (std::is_same_v<std::remove_const_t<P>, qpl::pixel_rgba>) {
+						++table.a[row[x].a];
+					}
+				}
+			}
+			for (qpl::size i = 0u; i < 256u; ++i) {
+				tables[0].r[i] += tables[1].r[i];
+				tables[0].g[i] += tables[1].g[i];
+				tables[0].b[i] += tables[1].b[i];
+				tables[0].a[i] += tables[1].a[i];
+			}
+			if constexpr (std::is_same_v<std::remove_const_t<P>, qpl::pixel_rgb>) {
+				tables[0].a[qpl::u8_max] = qpl::u32_cast(source.size());
+			}
+			return tables[0];
+		}
+	}
+
+	void qpl::blit(qpl::image_view<const qpl::pixel_rgb> source, qpl::image_view<qpl::pixel_rgb> destination, qpl::i32 x, qpl::i32 y) {
+		blit_impl(source, destination, x, y);
+	}
+	void qpl::blit(qpl::image_view<const qpl::pixel_rgba> source, qpl::image_view<qpl::pixel_rgba> destination, qpl::i32 x, qpl::i32 y) {
+		blit_impl(source, destination, x, y);
+	}
+	void qpl::scale_box(qpl::image_view<const qpl::pixel_rgb> source, qpl::image_view<qpl::pixel_rgb> destination) {
+		scale_box_impl(source, destination);
+	}
+	void qpl::scale_box(qpl::image_view<const qpl::pixel_rgba> source, qpl::image_view<qpl::pixel_rgba> destination) {
+		scale_box_impl(source, destination);
+	}
+	void qpl::scale_bilinear(qpl::image_view<const qpl::pixel_rgb> source, qpl::image_view<qpl::pixel_rgb> destination) {
+		scale_bilinear_impl(source, destination);
+	}
+	void qpl::scale_bilinear(qpl::image_view<const qpl::pixel_rgba> source, qpl::image_view<qpl::pixel_rgba> destination) {
+		scale_bilinear_impl(source, destination);
+	}
+	void qpl::convert_pixels(qpl::image_view<const qpl::pixel_rgb> source, qpl::image_view<qpl::pixel_rgba> destination, qpl::u8 alpha) {
+		check_same_dimension(source, destination, "convert_pixels");
+		for (qpl::u32 y = 0u; y < source.height; ++y) {
+			auto in = source.row(y);
+			auto out = destination.row(y);
+			for (qpl::u32 x = 0u; x < source.width; ++x) {
+				out[x].r = in[x].r;
+				out[x].g = in[x].g;
+				out[x].b = in[x].b;
+				out[x].a = alpha;
+			}
+		}
+	}
+	void qpl::convert_pixels(qpl::image_view<const qpl::pixel_rgba> source, qpl::image_view<qpl::pixel_rgb> destination) {
+		check_same_dimension(source, destination, "convert_pixels");
+		for (qpl::u32 y = 0u; y < source.height; ++y) {
+			auto in = source.row(y);
+			auto out = destination.row(y);
+			for (qpl::u32 x = 0u; x < source.width; ++x) {
+				out[x].r = in[x].r;
+				out[x].g = in[x].g;
+				out[x].b = in[x].b;
+			}
+		}
+	}
+	qpl::image_difference qpl::image_compare(qpl::image_view<const qpl::pixel_rgb> a, qpl::image_view<const qpl::pixel_rgb> b, qpl::u8 threshold) {
+		return image_compare_impl(a, b, threshold);
+	}
+	qpl::image_difference qpl::image_compare(qpl::image_view<const qpl::pixel_rgba> a, qpl::image_view<const qpl::pixel_rgba> b, qpl::u8 threshold) {
+		return image_compare_impl(a, b, threshold);
+	}
+	void qpl::image_difference_map(qpl::image_view<const qpl::pixel_rgb> a, qpl::image_view<const qpl::pixel_rgb> b, qpl::image_view<qpl::pixel_rgb> destination) {
+		image_difference_map_impl(a, b, destination);
+	}
+	void qpl::image_difference_map(qpl::image_view<const qpl::pixel_rgba> a, qpl::image_view<const qpl::pixel_rgba> b, qpl::image_view<qpl::pixel_rgba> destination) {
+		image_difference_map_impl(a, b, destination);
+	}
+	qpl::image_histogram qpl::histogram(qpl::image_view<const qpl::pixel_rgb> source) {
+		return histogram_impl(source);
+	}
+	qpl::image_histogram qpl::histogram(qpl::image_view<const qpl::pixel_rgba> source) {
+		return histogram_impl(source);
+	}
+
+	std::string qpl::detail::ppm_header(qpl::size width, qpl::size height) {
+		return qpl::to_string("P6\n", width, " ", height, "\n255\n");
+	}
+
 	std::array<char, qpl::detail::info_header_size> qpl::detail::create_bitmap_info_header(qpl::size width, qpl::size height) {
 		static std::array<char, qpl::detail::info_header_size> info_header = {
 			0,0,0,0, /// header size
@@ -0,0 +1,352 @@
+#include <qpl/shared_memory.hpp>
+#include <qpl/string.hpp>
+
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace qpl {
+#ifdef _WIN32
+	void* qpl::shared_memory::get() {
+		if (this->is_array()) {
+			return reinterpret_cast<char*>(this->ptr) + qpl::bytes_in_type<qpl::size>();
+		}
+		else {
+			return this->ptr;
+		}
+	}
+	qpl::size qpl::shared_memory::array_byte_size() const {
+		if (!this->is_array()) {
+			return 0u;
+		}
+		return *reinterpret_cast<qpl::size*>(this->ptr);
+	}
+	bool qpl::shared_memory::is_array() const {
+		return this->array;
+	}
+	bool qpl::shared_memory::create(const std::string& name, qpl::size size) {
+		this->array = false;
+		this->hMapFile = CreateFileMappingW(
+			INVALID_HANDLE_VALUE,    // use paging file
+			NULL,                    // default security
+			PAGE_READWRITE,          // read/write access
+			0,                       // maximum object size (high-order DWORD)
+			qpl::u32_cast(size),                // maximum object size (low-order DWORD)
+			qpl::string_to_wstring(name).c_str());                 // name of mapping object
+
+		if (this->hMapFile == nullptr) {
+			qpl::println("qpl::shared_memory::create: could not create file mapping object (", GetLastError(), ")");
+			return false;
+		}
+		if (GetLastError() == ERROR_ALREADY_EXISTS) {
+			qpl::println("qpl::shared_memory::create: file mapping object \"", name, "\" already exists");
+			CloseHandle(this->hMapFile);
+			this->hMapFile = nullptr;
+			return false;
+		}
+		this->ptr = MapViewOfFile(this->hMapFile,   
+			FILE_MAP_ALL_ACCESS, 
+			0,
+			0,
+			size);
+
+		if (this->ptr == nullptr) {
+			qpl::println("qpl::shared_memory::create: could not map view of file (", GetLastError(), ")");
+
+			CloseHandle(this->hMapFile);
+
+			return false;
+		}
+		return true;
+	}
+	bool qpl::shared_memory::create_array(const std::string& name, qpl::size size) {
+		auto result = this->create(name, size + qpl::bytes_in_type<qpl::size>());
+		if (!result) return false;
+		this->array = true;
+		reinterpret_cast<qpl::size*>(this->ptr)[0] = size;
+		return true;
+	}
+
+	bool qpl::shared_memory::open(const std::string& name, qpl::size size) {
+		this->array = false;
+		this->hMapFile = OpenFileMappingW(
+			FILE_MAP_ALL_ACCESS,   // read/write access
+			FALSE,                 // do not inherit the name
+			qpl::string_to_wstring(name).c_str());               // name of mapping object
+
+		if (this->hMapFile == nullptr) {
+			qpl::println("qpl::shared_memory::create: could not open file mapping object (", GetLastError(), ")");
+			return false;
+		}
+
+		this->ptr = MapViewOfFile(hMapFile, // handle to map object
+			FILE_MAP_ALL_ACCESS,  // read/write permission
+			0,
+			0,
+			size);
+
+		if (this->ptr == nullptr) {
+			qpl::println("qpl::shared_memory::create: could not map view of file (", GetLastError(), ")");
+
+			CloseHandle(this->hMapFile);
+
+			return false;
+		}
+		return true;
+	}
+	bool qpl::shared_memory::open_array(const std::string& name) {
+		this->array = true;
+		this->hMapFile = OpenFileMappingW(
+			FILE_MAP_ALL_ACCESS,   // read/write access
+			FALSE,                 // do not inherit the name
+			qpl::string_to_wstring(name).c_str());               // name of mapping object
+
+		if (this->hMapFile == nullptr) {
+			qpl::println("qpl::shared_memory::create: could not open file mapping object (", GetLastError(), ")");
+			return false;
+		}
+
+		this->ptr = MapViewOfFile(hMapFile, // handle to map object
+			FILE_MAP_ALL_ACCESS,  // read/write permission
+			0,
+			0,
+			qpl::bytes_in_type<qpl::size>());
+
+		if (this->ptr == nullptr) {
+			qpl::println("qpl::shared_memory::create: could not map view of file (", GetLastError(), ")");
+
+			CloseHandle(this->hMapFile);
+
+			return false;
+		}
+		auto size = this->array_byte_size();
+		UnmapViewOfFile(this->ptr);
+		this->ptr = MapViewOfFile(hMapFile, // handle to map object
+			FILE_MAP_ALL_ACCESS,  // read/write permission
+			0,
+			0,
+			size);
+
+		return true;
+	}
+
+	void qpl::shared_memory::destroy() {
+		UnmapViewOfFile(this->ptr);
+		CloseHandle(this->hMapFile);
+	}
+	namespace detail {
+		std::unordered_map<std::string, qpl::shared_memory> qpl::detail::shared_memories;
+	}
+
+	qpl::size qpl::get_shared_memory_array_byte_size(std::string name) {
+		return qpl::detail::shared_memories[name].array_byte_size();
+	}
+	void qpl::create_shared_memory_array(std::string name, qpl::size size) {
+		qpl::detail::shared_memories[name].create_array(name, size);
+	}
+	void qpl::open_shared_memory_array(std::string name) {
+		qpl::detail::shared_memories[name].open_array(name);
+	}
+	void qpl::create_shared_memory(std::string name, qpl::size size) {
+		qpl::detail::shared_memories[name].create(name, size);
+	}
+	void qpl::open_shared_memory(std::string name, qpl::size size) {
+		qpl::detail::shared_memories[name].open(name, size);
+	}
+	bool qpl::find_shared_memory(std::string name) {
+		qpl::detail::shared_memories[name].hMapFile = OpenFileMappingW(
+			FILE_MAP_ALL_ACCESS,   // read/write access
+			FALSE,                 // do not inherit the name
+			qpl::string_to_wstring(name).c_str());               // name of mapping object
+
+		return (qpl::detail::shared_memories[name].hMapFile != nullptr);
+	}
+
+#else
+
+	namespace detail {
+		std::string shared_memory_name(const std::string& name) {
+			if (!name.empty() && name.front() == '/') {
+				return name;
+			}
+			return qpl::to_string('/', name);
+		}
+	}
+
+	void* qpl::shared_memory::get() {
+		if (this->is_array()) {
+			return reinterpret_cast<char*>(this->ptr) + qpl::bytes_in_type<qpl::size>();
+		}
+		else {
+			return this->ptr;
+		}
+	}
+	qpl::size qpl::shared_memory::array_byte_size() const {
+		if (!this->is_array()) {
+			return 0u;
+		}
+		return *reinterpret_cast<qpl::size*>(this->ptr);
+	}
+	bool qpl::shared_memory::is_array() const {
+		return this->array;
+	}
+	bool qpl::shared_memory::create(const std::string& name, qpl::size size) {
+		this->destroy();
+		this->array = false;
+		this->name = qpl::detail::shared_memory_name(name);
+		//O_EXCL: an existing segment belongs to someone else, it must not be resized, overwritten or unlinked by destroy()
+		this->file_descriptor = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+		if (this->file_descriptor == -1) {
+			if (errno == EEXIST) {
+				qpl::println("qpl::shared_memory::create: shared memory object \"", name, "\" already exists");
+			}
+			else {
+				qpl::println("qpl::shared_memory::create: could not create shared memory object (", errno, ")");
+			}
+			return false;
+		}
+		this->owner = true;
+		if (ftruncate(this->file_descriptor, static_cast<off_t>(size)) == -1) {
+			qpl::println("qpl::shared_memory::create: could not resize shared memory object (", errno, ")");
+			this->destroy();
+			return false;
+		}
+		return this->open(name, size);
+	}
+	bool qpl::shared_memory::create_array(const std::string& name, qpl::size size) {
+		auto result = this->create(name, size + qpl::bytes_in_type<qpl::size>());
+		if (!result) return false;
+		this->array = true;
+		reinterpret_cast<qpl::size*>(this->ptr)[0] = size;
+		return true;
+	}
+
+	bool qpl::shared_memory::open(const std::string& name, qpl::size size) {
+		this->array = false;
+		if (this->file_descriptor == -1) {
+			this->name = qpl::detail::shared_memory_name(name);
+			this->file_descriptor = shm_open(this->name.c_str(), O_RDWR, 0600);
+			if (this->file_descriptor == -1) {
+				qpl::println("qpl::shared_memory::open: could not open shared memory object (", errno, ")");
+				return false;
+			}
+		}
+		if (this->ptr) {
+			munmap(this->ptr, this->mapped_size);
+			this->ptr = nullptr;
+		}
+
+		//a segment that is smaller than requested would fault on access, e.g. when the creator hasn't resized it yet
+		struct stat status;
+		if (fstat(this->file_descriptor, &status) == -1 || qpl::size_cast(status.st_size) < size) {
+			qpl::println("qpl::shared_memory::open: shared memory object is smaller than ", size, " bytes");
+			this->destroy();
+			return false;
+		}
+
+		auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->file_descriptor, 0);
+		if (ptr == MAP_FAILED) {
+			qpl::println("qpl::shared_memory::open: could not map shared memory object (", errno, ")");
+			this->destroy();
+			return false;
+		}
+		this->ptr = ptr;
+		this->mapped_size = size;
+		return true;
+	}
+	bool qpl::shared_memory::open_array(const std::string& name) {
+		if (!this->open(name, qpl::bytes_in_type<qpl::size>())) {
+			return false;
+		}
+		auto size = *reinterpret_cast<qpl::size*>(this->ptr);
+		if (!this->open(name, size + qpl::bytes_in_type<qpl::size>())) {
+			return false;
+		}
+		this->array = true;
+		return true;
+	}
+
+	void qpl::shared_memory::destroy() {
+		if (this->ptr) {
+			munmap(this->ptr, this->mapped_size);
+			this->ptr = nullptr;
+		}
+		if (this->file_descriptor != -1) {
+			close(this->file_descriptor);
+			this->file_descriptor = -1;
+		}
+		if (this->owner) {
+			shm_unlink(this->name.c_str());
+			this->owner = false;
+		}
+		this->mapped_size = 0u;
+	}
+	namespace detail {
+		std::unordered_map<std::string, qpl::shared_memory> qpl::detail::shared_memories;
+	}
+
+	qpl::size qpl::get_shared_memory_array_byte_size(std::string name) {
+		return qpl::detail::shared_memories[name].array_byte_size();
+	}
+	void qpl::create_shared_memory_array(std::string name, qpl::size size) {
+		qpl::detail::shared_memories[name].create_array(name, size);
+	}
+	void qpl::open_shared_memory_array(std::string name) {
+		qpl::detail::shared_memories[name].open_array(name);
+	}
+	void qpl::create_shared_memory(std::string name, qpl::size size) {
+		qpl::detail::shared_memories[name].create(name, size);
+	}
+	void qpl::open_shared_memory(std::string name, qpl::size size) {
+		qpl::detail::shared_memories[name].open(name, size);
+	}
+	bool qpl::find_shared_memory(std::string name) {
+		auto file_descriptor = shm_open(qpl::detail::shared_memory_name(name).c_str(), O_RDWR, 0600);
+		if (file_descriptor == -1) {
+			return false;
+		}
+		close(file_descriptor);
+		return true;
+	}
+#endif
+
+#if defined(__linux__)
+	void qpl::detail::shared_wait(std::atomic<qpl::u32>* address, qpl::u32 expected) {
+		static_assert(sizeof(std::atomic<qpl::u32>) == sizeof(qpl::u32));
+		syscall(SYS_futex, reinterpret_cast<qpl::u32*>(address), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+	}
+	void qpl::detail::shared_wake(std::atomic<qpl::u32>* address) {
+		syscall(SYS_futex, reinterpret_cast<qpl::u32*>(address), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+	}
+#else
+	void qpl::detail::shared_wait(std::atomic<qpl::u32>* address, qpl::u32 expected) {
+		for (qpl::size i = 0u; i < 64u && address->load() == expected; ++i) {
+			std::this_thread::yield();
+		}
+		if (address->load() == expected) {
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+	}
+	void qpl::detail::shared_wake(std::atomic<qpl::u32>*) {
+
+	}
+#endif
+}
@@ -1,4 +1,5 @@
 #include <qpl/string.hpp>
+#include <qpl/memory.hpp>
 #include <qpl/random.hpp>
 #include <locale>
 #include <cwctype>
@@ -1344,13 +1345,14 @@ namespace qpl {
 		return found;
 	}
 	std::vector<std::string> qpl::string_split(const std::string_view& string, char by_what) {
-		std::vector<std::string> result;
+		//collect views first, so the returned vector is allocated once with the final size
+		qpl::small_vector<std::string_view, 32> parts;
 
 		qpl::size before = 0;
 		for (qpl::size i = 0u; i < string.length(); ) {
 			if (string[i] == by_what) {
 				if (i - before) {
-					result.emplace_back(std::string{ string.substr(before, i - before) });
+					parts.push_back(string.substr(before, i - before));
 				}
 				++i;
 				while (i < string.length() && string[i] == by_what) {
@@ -1363,18 +1365,18 @@ namespace qpl {
 			}
 		}
 		if (before != string.length()) {
-			result.emplace_back(std::string{ string.substr(before) });
+			parts.push_back(string.substr(before));
 		}
-		return result;
+		return std::vector<std::string>(parts.cbegin(), parts.cend());
 	}
 	std::vector<std::string> qpl::string_split_whitespace(const std::string_view& string) {
-		std::vector<std::string> result;
+		qpl::small_vector<std::string_view, 32> parts;
 
 		qpl::size before = 0;
 		for (qpl::size i = 0u; i < string.length(); ) {
 			if (qpl::is_character_white_space(string[i])) {
 				if (i - before) {
-					result.emplace_back(std::string{ string.substr(before, i - before) });
+					parts.push_back(string.substr(before, i - before));
 				}
 				++i;
 				while (i < string.length() && qpl::is_character_white_space(string[i])) {
@@ -1387,9 +1389,9 @@ namespace qpl {
 			}
 		}
 		if (before != string.length()) {
-			result.emplace_back(std::string{ string.substr(before) });
+			parts.push_back(string.substr(before));
 		}
-		return result;
+		return std::vector<std::string>(parts.cbegin(), parts.cend());
 	}
 
 	std::vector<std::wstring> qpl::string_split_whitespace(const std::wstring_view& string) {
@@ -1662,7 +1664,7 @@ namespace qpl {
 					qpl::size begin = i;
 
 					if (i < string.length() && string[i] != para[1]) {
-						std::vector<char> inside_extra_quotes(additional_quotes.length());
+						qpl::small_vector<char, 8> inside_extra_quotes(additional_quotes.length());
 						for (auto& extra : inside_extra_quotes) {
 							extra = false;
 						}
@@ -1812,13 +1814,13 @@ namespace qpl {
 		return result;
 	}
 	std::vector<std::string> qpl::string_split(const std::string_view& string) {
-		std::vector<std::string> result;
+		qpl::small_vector<std::string_view, 32> parts;
 
 		qpl::size before = 0u;
 		for (qpl::size i = 0u; i < string.length(); ) {
 			if (std::isspace(string[i])) {
 				if (i - before) {
-					result.emplace_back(std::string{ string.substr(before, i - before) });
+					parts.push_back(string.substr(before, i - before));
 				}
 				++i;
 				while (i < string.length() && std::isspace(string[i])) {
@@ -1831,9 +1833,9 @@ namespace qpl {
 			}
 		}
 		if (before != string.length()) {
-			result.emplace_back(std::string{ string.substr(before) });
+			parts.push_back(string.substr(before));
 		}
-		return result;
+		return std::vector<std::string>(parts.cbegin(), parts.cend());
 	}
 	std::vector<std::string> qpl::string_split_allow_empty(const std::string_view& string, char by_what) {
 		std::vector<std::string> result;
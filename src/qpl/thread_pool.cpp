@@ -0,0 +1,82 @@
+#include <qpl/thread_pool.hpp>
+
+namespace qpl {
+	qpl::size qpl::hardware_thread_count() {
+		auto count = std::thread::hardware_concurrency();
+		return count ? qpl::size{ count } : qpl::size{ 1u };
+	}
+
+	void qpl::thread_pool::start(qpl::size thread_count) {
+		this->stop();
+		if (!thread_count) {
+			thread_count = qpl::hardware_thread_count();
+		}
+		this->m_stop = false;
+		this->m_threads.reserve(thread_count);
+		for (qpl::size i = 0u; i < thread_count; ++i) {
+			this->m_threads.emplace_back([this]() {
+				this->work();
+			});
+		}
+	}
+	void qpl::thread_pool::stop() {
+		{
+			std::lock_guard lock(this->m_mutex);
+			this->m_stop = true;
+		}
+		this->m_task_available.notify_all();
+		for (auto& thread : this->m_threads) {
+			thread.join();
+		}
+		this->m_threads.clear();
+	}
+	void qpl::thread_pool::push(std::function<void()> task) {
+		{
+			std::lock_guard lock(this->m_mutex);
+			this->m_tasks.emplace_back(std::move(task));
+		}
+		this->m_task_available.notify_one();
+	}
+	void qpl::thread_pool::wait() {
+		std::unique_lock lock(this->m_mutex);
+		this->m_idle.wait(lock, [&]() {
+			return this->m_tasks.empty() && this->m_active == 0u;
+		});
+	}
+	qpl::size qpl::thread_pool::size() const {
+		return this->m_threads.size();
+	}
+	qpl::size qpl::thread_pool::pending() const {
+		std::lock_guard lock(this->m_mutex);
+		return this->m_tasks.size() + this->m_active;
+	}
+	void qpl::thread_pool::work() {
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock lock(this->m_mutex);
+				this->m_task_available.wait(lock, [&]() {
+					return this->m_stop || !this->m_tasks.empty();
+				});
+				if (this->m_tasks.empty()) {
+					return;
+				}
+				task = std::move(this->m_tasks.front());
+				this->m_tasks.pop_front();
+				++this->m_active;
+			}
+			task();
+
+			std::lock_guard lock(this->m_mutex);
+			--this->m_active;
+			if (this->m_tasks.empty() && this->m_active == 0u) {
+				this->m_idle.notify_all();
+			}
+		}
+	}
+
+	qpl::thread_pool& qpl::default_thread_pool() {
+		static qpl::thread_pool pool;
+		return pool;
+	}
+}
@@ -1033,8 +1033,8 @@ namespace qpl {
 		return qpl::to_string(buffer, qpl::prepended_to_string_to_fit(qpl::to_string(millis), '0', 3));
 	}
 
-	std::unordered_map<std::string, std::unordered_map<std::string, qpl::halted_clock>> qpl::detail::sub_benchmark_clocks;
-	std::unordered_map<std::string, qpl::halted_clock> qpl::detail::benchmark_clocks;
+	qpl::flat_hash_map<std::string, qpl::flat_hash_map<std::string, qpl::halted_clock>> qpl::detail::sub_benchmark_clocks;
+	qpl::flat_hash_map<std::string, qpl::halted_clock> qpl::detail::benchmark_clocks;
 	std::string qpl::detail::last_benchmark_name;
 	std::string qpl::detail::last_sub_benchmark_name;
 